@@ -277,5 +277,7 @@
 #define __compiler_atomic_load(p) __atomic_load_n((p), __ATOMIC_RELAXED)
 #define __compiler_atomic_store(p, val) \
 	__atomic_store_n((p), (val), __ATOMIC_RELAXED)
+#define __compiler_atomic_fetch_and_release(p, val) \
+	__atomic_fetch_and((p), (val), __ATOMIC_RELEASE)
 
 #endif /*COMPILER_H*/
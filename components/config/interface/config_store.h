@@ -38,7 +38,10 @@ enum config_classifier
 	CONFIG_CLASSIFIER_HW_FEATURE,
 
 	/* A classifier for an opaque configuration blob */
-	CONFIG_CLASSIFIER_BLOB
+	CONFIG_CLASSIFIER_BLOB,
+
+	/* A classifier for a numeric run-time parameter of a deployment */
+	CONFIG_CLASSIFIER_PARAMETER
 };
 
 
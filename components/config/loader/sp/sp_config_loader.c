@@ -99,6 +99,37 @@ static bool load_blob(const struct ffa_name_value_pair_v1_0 *value_pair)
 	return true;
 }
 
+/* Adds the u32 properties of an optional manifest node to the config store */
+static bool load_u32_properties(const void *fdt, int root, const char *compatible,
+				enum config_classifier classifier)
+{
+	int node = fdt_node_offset_by_compatible(fdt, root, compatible);
+
+	if (node >= 0) {
+		const char *prop_name = NULL;
+		uint32_t prop_value = 0;
+		int prop_offset = 0;
+
+		fdt_for_each_property_offset(prop_offset, fdt, node) {
+			if (!dt_get_u32_by_offset(fdt, prop_offset, &prop_name, &prop_value)) {
+				/* skip other properties in the node, e.g. the compatible string */
+				DMSG("skipping non-u32 property '%s' in %s", prop_name, compatible);
+				continue;
+			}
+
+			if (!config_store_add(classifier, prop_name, 0,
+					      &prop_value, sizeof(prop_value))) {
+				EMSG("failed to add %s property to config store", compatible);
+				return false;
+			}
+		}
+	} else {
+		DMSG("%s node not present in SP manifest", compatible);
+	}
+
+	return true;
+}
+
 static bool load_fdt(const void *fdt, size_t fdt_size)
 {
 	int root = -1, node = -1, subnode = -1, rc = -1;
@@ -235,28 +266,12 @@ static bool load_fdt(const void *fdt, size_t fdt_size)
 	}
 
 	/* Find hardware features */
-	node = fdt_node_offset_by_compatible(fdt, root, "arm,hw-features");
-	if (node >= 0) {
-		const char *prop_name = NULL;
-		uint32_t prop_value = 0;
-		int prop_offset = 0;
-
-		fdt_for_each_property_offset(prop_offset, fdt, node) {
-			if (!dt_get_u32_by_offset(fdt, prop_offset, &prop_name, &prop_value)) {
-				/* skip other properties in the node, e.g. the compatible string */
-				DMSG("skipping non-u32 property '%s' in hw-features", prop_name);
-				continue;
-			}
+	if (!load_u32_properties(fdt, root, "arm,hw-features", CONFIG_CLASSIFIER_HW_FEATURE))
+		return false;
 
-			if (!config_store_add(CONFIG_CLASSIFIER_HW_FEATURE, prop_name, 0,
-					      &prop_value, sizeof(prop_value))) {
-				EMSG("failed to add HW feature to config store");
-				return false;
-			}
-		}
-	} else {
-		DMSG("arm,hw-features node not present in SP manifest");
-	}
+	/* Find run-time parameters */
+	if (!load_u32_properties(fdt, root, "arm,sp-parameters", CONFIG_CLASSIFIER_PARAMETER))
+		return false;
 
 	return true;
 }
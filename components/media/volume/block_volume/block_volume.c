@@ -199,21 +199,19 @@ static int block_volume_read(
 		uint64_t lba = this_instance->file_pos / this_instance->partition_info.block_size;
 		size_t offset = this_instance->file_pos % this_instance->partition_info.block_size;
 
-		size_t bytes_remaining_in_block = this_instance->partition_info.block_size - offset;
 		size_t bytes_remaining_in_file = this_instance->size - this_instance->file_pos;
 
 		size_t bytes_remaining = length - bytes_read;
 		if (bytes_remaining > bytes_remaining_in_file) bytes_remaining = bytes_remaining_in_file;
 
-		size_t requested_len = (bytes_remaining < bytes_remaining_in_block) ?
-			bytes_remaining : bytes_remaining_in_block;
 		size_t actual_len = 0;
 
-		psa_status_t psa_status = block_store_read(
+		/* Transfer the whole range in one go, the block_store may clip it */
+		psa_status_t psa_status = block_store_read_blocks(
 			this_instance->block_store, 0,
 			this_instance->partition_handle,
 			lba, offset,
-			requested_len,
+			bytes_remaining,
 			(uint8_t*)(buffer + bytes_read),
 			&actual_len);
 
@@ -246,22 +244,20 @@ static int block_volume_write(
 		uint64_t lba = this_instance->file_pos / this_instance->partition_info.block_size;
 		size_t offset = this_instance->file_pos % this_instance->partition_info.block_size;
 
-		size_t bytes_remaining_in_block = this_instance->partition_info.block_size - offset;
 		size_t bytes_remaining_in_file = this_instance->size - this_instance->file_pos;
 
 		size_t bytes_remaining = length - bytes_written;
 		if (bytes_remaining > bytes_remaining_in_file) bytes_remaining = bytes_remaining_in_file;
 
-		size_t requested_len = (bytes_remaining < bytes_remaining_in_block) ?
-			bytes_remaining : bytes_remaining_in_block;
 		size_t actual_len = 0;
 
-		psa_status_t psa_status = block_store_write(
+		/* Transfer the whole range in one go, the block_store may clip it */
+		psa_status_t psa_status = block_store_write_blocks(
 			this_instance->block_store, 0,
 			this_instance->partition_handle,
 			lba, offset,
 			(uint8_t*)(buffer + bytes_written),
-			requested_len,
+			bytes_remaining,
 			&actual_len);
 
 		if (psa_status != PSA_SUCCESS)
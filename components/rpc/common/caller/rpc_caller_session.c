@@ -6,17 +6,89 @@
 
 #include "rpc_caller_session.h"
 #include "util.h"
+#include <stdlib.h>
 #include <string.h>
 
+static void initialize_slot(struct rpc_caller_session *session,
+			    struct rpc_caller_session_slot *slot)
+{
+	slot->session = session;
+	slot->shared_memory = (struct rpc_caller_shared_memory){ 0 };
+	slot->is_call_transaction_in_progress = false;
+	slot->request_length = 0;
+}
+
+static rpc_status_t release_slots(struct rpc_caller_session *session, size_t num_slots)
+{
+	rpc_status_t status = RPC_SUCCESS;
+
+	for (size_t i = 0; i < num_slots; i++) {
+		rpc_status_t slot_status = rpc_caller_release_shared_memory(
+			session->caller, &session->slots[i].shared_memory);
+
+		if (slot_status != RPC_SUCCESS)
+			status = slot_status;
+	}
+
+	free(session->slots);
+	session->slots = NULL;
+	session->num_slots = 0;
+
+	return status;
+}
+
+static rpc_status_t initialize_slots(struct rpc_caller_session *session,
+				     struct rpc_caller_interface *caller,
+				     size_t shared_memory_size, size_t num_slots)
+{
+	rpc_status_t status = RPC_ERROR_INTERNAL;
+
+	session->slots = calloc(num_slots, sizeof(struct rpc_caller_session_slot));
+	if (!session->slots)
+		return RPC_ERROR_INTERNAL;
+
+	/* Register the shared memory of all slots up front */
+	for (size_t i = 0; i < num_slots; i++) {
+		initialize_slot(session, &session->slots[i]);
+
+		status = rpc_caller_create_shared_memory(caller, shared_memory_size,
+							 &session->slots[i].shared_memory);
+		if (status) {
+			release_slots(session, i);
+			return status;
+		}
+	}
+
+	session->num_slots = num_slots;
+	session->shared_memory_policy = alloc_for_each_slot;
+
+	return RPC_SUCCESS;
+}
+
 static rpc_status_t initalize_shared_memory(struct rpc_caller_session *session,
 					    struct rpc_caller_interface *caller,
-					    size_t shared_memory_size)
+					    size_t shared_memory_size, size_t num_slots)
 {
-	if (shared_memory_size) {
+	session->caller = caller;
+	session->slots = NULL;
+	session->num_slots = 0;
+	session->slots_in_use = 0;
+
+	initialize_slot(session, &session->call_slot);
+
+	if (num_slots > 1) {
+		rpc_status_t status = RPC_ERROR_INTERNAL;
+
+		status = initialize_slots(session, caller, shared_memory_size, num_slots);
+		if (status) {
+			rpc_caller_close_session(caller);
+			return status;
+		}
+	} else if (shared_memory_size) {
 		rpc_status_t status = RPC_ERROR_INTERNAL;
 
 		status = rpc_caller_create_shared_memory(caller, shared_memory_size,
-							 &session->shared_memory);
+							 &session->call_slot.shared_memory);
 		if (status) {
 			rpc_caller_close_session(caller);
 			return status;
@@ -24,62 +96,100 @@ static rpc_status_t initalize_shared_memory(struct rpc_caller_session *session,
 
 		session->shared_memory_policy = alloc_for_session;
 	} else {
-		session->shared_memory = (struct rpc_caller_shared_memory){ 0 };
 		session->shared_memory_policy = alloc_for_each_call;
 	}
 
 	return RPC_SUCCESS;
 }
 
+static bool is_slot_count_valid(size_t shared_memory_size, size_t num_slots)
+{
+	/* Sessions with several slots need a shared memory size for allocating the slots */
+	return num_slots && num_slots <= RPC_CALLER_SESSION_MAX_SLOTS &&
+	       (num_slots == 1 || shared_memory_size);
+}
+
+static struct rpc_caller_session_slot *claim_slot(struct rpc_caller_session *session)
+{
+	uint32_t all_slots = UINT32_MAX >> (RPC_CALLER_SESSION_MAX_SLOTS - session->num_slots);
+	uint32_t slots_in_use = __compiler_atomic_load(&session->slots_in_use);
+
+	/* Set the lowest clear bit. Retry if another thread has changed the bitmap meanwhile. */
+	while ((slots_in_use & all_slots) != all_slots) {
+		unsigned int index = __builtin_ctz(~slots_in_use);
+
+		if (__compiler_compare_and_swap(&session->slots_in_use, &slots_in_use,
+						slots_in_use | (UINT32_C(1) << index)))
+			return &session->slots[index];
+	}
+
+	return NULL;
+}
+
+static void release_slot(struct rpc_caller_session_slot *slot)
+{
+	struct rpc_caller_session *session = slot->session;
+	size_t index = slot - session->slots;
+
+	__compiler_atomic_fetch_and_release(&session->slots_in_use, ~(UINT32_C(1) << index));
+}
+
 rpc_status_t rpc_caller_session_open(struct rpc_caller_session *session,
 				     struct rpc_caller_interface *caller,
 				     const struct rpc_uuid *service_uuid,
 				     uint16_t endpoint_id,
 				     size_t shared_memory_size)
+{
+	return rpc_caller_session_open_with_slots(session, caller, service_uuid, endpoint_id,
+						  shared_memory_size, 1);
+}
+
+rpc_status_t rpc_caller_session_find_and_open(struct rpc_caller_session *session,
+					      struct rpc_caller_interface *caller,
+					      const struct rpc_uuid *service_uuid,
+					      size_t shared_memory_size)
+{
+	return rpc_caller_session_find_and_open_with_slots(session, caller, service_uuid,
+							   shared_memory_size, 1);
+}
+
+rpc_status_t rpc_caller_session_open_with_slots(struct rpc_caller_session *session,
+						struct rpc_caller_interface *caller,
+						const struct rpc_uuid *service_uuid,
+						uint16_t endpoint_id,
+						size_t shared_memory_size,
+						size_t num_slots)
 {
 	rpc_status_t status = RPC_ERROR_INTERNAL;
 
-	if (!session || !caller || !service_uuid)
+	if (!session || !caller || !service_uuid ||
+	    !is_slot_count_valid(shared_memory_size, num_slots))
 		return RPC_ERROR_INVALID_VALUE;
 
 	status = rpc_caller_open_session(caller, service_uuid, endpoint_id);
 	if (status)
 		return status;
 
-	status = initalize_shared_memory(session, caller, shared_memory_size);
-	if (status)
-		return status;
-
-	session->caller = caller;
-	session->is_call_transaction_in_progress = false;
-	session->request_length = 0;
-
-	return status;
+	return initalize_shared_memory(session, caller, shared_memory_size, num_slots);
 }
 
-rpc_status_t rpc_caller_session_find_and_open(struct rpc_caller_session *session,
-					      struct rpc_caller_interface *caller,
-					      const struct rpc_uuid *service_uuid,
-					      size_t shared_memory_size)
+rpc_status_t rpc_caller_session_find_and_open_with_slots(struct rpc_caller_session *session,
+							 struct rpc_caller_interface *caller,
+							 const struct rpc_uuid *service_uuid,
+							 size_t shared_memory_size,
+							 size_t num_slots)
 {
 	rpc_status_t status = RPC_ERROR_INTERNAL;
 
-	if (!session || !caller || !service_uuid)
+	if (!session || !caller || !service_uuid ||
+	    !is_slot_count_valid(shared_memory_size, num_slots))
 		return RPC_ERROR_INVALID_VALUE;
 
 	status = rpc_caller_find_and_open_session(caller, service_uuid);
 	if (status)
 		return status;
 
-	status = initalize_shared_memory(session, caller, shared_memory_size);
-	if (status)
-		return status;
-
-	session->caller = caller;
-	session->is_call_transaction_in_progress = false;
-	session->request_length = 0;
-
-	return status;
+	return initalize_shared_memory(session, caller, shared_memory_size, num_slots);
 }
 
 rpc_status_t rpc_caller_session_close(struct rpc_caller_session *session)
@@ -87,14 +197,21 @@ rpc_status_t rpc_caller_session_close(struct rpc_caller_session *session)
 	if (!session)
 		return RPC_ERROR_INVALID_VALUE;
 
-	if (session->is_call_transaction_in_progress)
+	if (session->call_slot.is_call_transaction_in_progress ||
+	    __compiler_atomic_load(&session->slots_in_use))
 		return RPC_ERROR_INVALID_STATE;
 
 	if (session->shared_memory_policy == alloc_for_session) {
 		rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
 
 		rpc_status = rpc_caller_release_shared_memory(session->caller,
-							      &session->shared_memory);
+							      &session->call_slot.shared_memory);
+		if (rpc_status != RPC_SUCCESS)
+			return rpc_status;
+	} else if (session->shared_memory_policy == alloc_for_each_slot) {
+		rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+
+		rpc_status = release_slots(session, session->num_slots);
 		if (rpc_status != RPC_SUCCESS)
 			return rpc_status;
 	}
@@ -108,101 +225,126 @@ rpc_call_handle rpc_caller_session_begin(struct rpc_caller_session *session,
 {
 	rpc_status_t status = RPC_ERROR_INTERNAL;
 	size_t required_buffer_length = MAX(request_length, response_max_length);
+	struct rpc_caller_session_slot *slot = NULL;
 
 	if (required_buffer_length > UINT32_MAX)
 		return NULL;
 
-	if (!session || !request_buffer || session->is_call_transaction_in_progress)
+	if (!session || !request_buffer)
 		return NULL;
 
+	if (session->shared_memory_policy == alloc_for_each_slot) {
+		slot = claim_slot(session);
+		if (!slot)
+			return NULL; /* All slots are in use */
+
+		if (slot->shared_memory.size < required_buffer_length) {
+			release_slot(slot);
+			return NULL; /* The allocated shared memory is too small */
+		}
+	} else {
+		slot = &session->call_slot;
+
+		if (slot->is_call_transaction_in_progress)
+			return NULL;
+	}
+
 	switch (session->shared_memory_policy) {
 	case alloc_for_each_call:
-		if (session->shared_memory.buffer || session->shared_memory.size)
+		if (slot->shared_memory.buffer || slot->shared_memory.size)
 			return NULL; /* There's already a shared memory */
 
 		status = rpc_caller_create_shared_memory(session->caller, required_buffer_length,
-							 &session->shared_memory);
+							 &slot->shared_memory);
 		if (status)
 			return NULL; /* Failed to create shared memory */
 		break;
 
 	case alloc_for_session:
-		if (!session->shared_memory.buffer || !session->shared_memory.size)
+		if (!slot->shared_memory.buffer || !slot->shared_memory.size)
 			return NULL; /* There's no shared memory */
 
-		if (session->shared_memory.size < required_buffer_length)
+		if (slot->shared_memory.size < required_buffer_length)
 			return NULL; /* The allocated shared memory is too small */
 		break;
 
+	case alloc_for_each_slot:
+		/* The slot's shared memory has been checked on claiming the slot */
+		break;
+
 	default:
 		/* Invalid shared memory policy */
 		return NULL;
 	}
 
-	*request_buffer = session->shared_memory.buffer;
+	*request_buffer = slot->shared_memory.buffer;
 
-	session->is_call_transaction_in_progress = true;
-	session->request_length = request_length;
+	slot->is_call_transaction_in_progress = true;
+	slot->request_length = request_length;
 
-	return (rpc_call_handle)session;
+	return (rpc_call_handle)slot;
 }
 
 rpc_status_t rpc_caller_session_invoke(rpc_call_handle handle, uint32_t opcode,
 				       uint8_t **response_buffer, size_t *response_length,
 				       service_status_t *service_status)
 {
-	struct rpc_caller_session *session = (struct rpc_caller_session *)handle;
+	struct rpc_caller_session_slot *slot = (struct rpc_caller_session_slot *)handle;
 	rpc_status_t status = RPC_ERROR_INTERNAL;
 
 	if (!handle || !response_buffer || !response_length)
 		return RPC_ERROR_INVALID_VALUE;
 
-	if (!session->is_call_transaction_in_progress)
+	if (!slot->is_call_transaction_in_progress)
 		return RPC_ERROR_INVALID_STATE;
 
-	if (session->request_length &&
-	    (!session->shared_memory.buffer || !session->shared_memory.size))
+	if (slot->request_length &&
+	    (!slot->shared_memory.buffer || !slot->shared_memory.size))
 		return RPC_ERROR_INVALID_STATE;
 
-	status = rpc_caller_call(session->caller, opcode, &session->shared_memory,
-				session->request_length, response_length, service_status);
-	if (status || *response_length > session->shared_memory.size) {
+	status = rpc_caller_call(slot->session->caller, opcode, &slot->shared_memory,
+				slot->request_length, response_length, service_status);
+	if (status || *response_length > slot->shared_memory.size) {
 		*response_buffer = NULL;
 		*response_length = 0;
 		return status;
 	}
 
-	*response_buffer = session->shared_memory.buffer;
+	*response_buffer = slot->shared_memory.buffer;
 
 	return status;
 }
 
 rpc_status_t rpc_caller_session_end(rpc_call_handle handle)
 {
-	struct rpc_caller_session *session = (struct rpc_caller_session *)handle;
+	struct rpc_caller_session_slot *slot = (struct rpc_caller_session_slot *)handle;
+	struct rpc_caller_session *session = NULL;
 	rpc_status_t status = RPC_ERROR_INTERNAL;
 
 	if (!handle)
 		return RPC_ERROR_INVALID_VALUE;
 
-	if (!session->is_call_transaction_in_progress)
+	if (!slot->is_call_transaction_in_progress)
 		return RPC_ERROR_INVALID_STATE;
 
-	if (session->request_length &&
-	    (!session->shared_memory.buffer || !session->shared_memory.size))
+	if (slot->request_length &&
+	    (!slot->shared_memory.buffer || !slot->shared_memory.size))
 		return RPC_ERROR_INVALID_STATE; /* There's no shared memory */
 
+	session = slot->session;
+
 	switch (session->shared_memory_policy) {
 	case alloc_for_each_call:
 		status = rpc_caller_release_shared_memory(session->caller,
-								&session->shared_memory);
+								&slot->shared_memory);
 		if (status)
 			return status; /* Failed to release shared memory */
 
-		session->shared_memory = (struct rpc_caller_shared_memory){ 0 };
+		slot->shared_memory = (struct rpc_caller_shared_memory){ 0 };
 		break;
 
 	case alloc_for_session:
+	case alloc_for_each_slot:
 		/* Nothing to do */
 		break;
 
@@ -210,8 +352,11 @@ rpc_status_t rpc_caller_session_end(rpc_call_handle handle)
 		return RPC_ERROR_INVALID_STATE;
 	}
 
-	session->is_call_transaction_in_progress = false;
-	session->request_length = 0;
+	slot->is_call_transaction_in_progress = false;
+	slot->request_length = 0;
+
+	if (session->shared_memory_policy == alloc_for_each_slot)
+		release_slot(slot);
 
 	return RPC_SUCCESS;
 }
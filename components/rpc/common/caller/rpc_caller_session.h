@@ -20,27 +20,29 @@ extern "C" {
 
 typedef void *rpc_call_handle;
 
+/* Maximal number of call slots of a session, limited by the width of the slot bitmap */
+#define RPC_CALLER_SESSION_MAX_SLOTS	(32)
+
 enum rpc_caller_memory_policy {
 	alloc_for_each_call = 0,
 	alloc_for_session,
+	alloc_for_each_slot,
 };
 
+struct rpc_caller_session;
+
 /**
- * @brief RPC caller session
+ * @brief RPC caller session slot
  *
- * Builds a session on top of the rpc_caller_interface. It provides high level functions for service
- * caller implementations and for prior service discovery.
+ * Holds the state of a single call transaction. The handle of a started call points to its slot.
  */
-struct rpc_caller_session {
-	/** Caller interface */
-	struct rpc_caller_interface *caller;
+struct rpc_caller_session_slot {
+	/** The session which the slot belongs to */
+	struct rpc_caller_session *session;
 
 	/** Shared memory instance for the exchanging of RPC request and response parameters. */
 	struct rpc_caller_shared_memory shared_memory;
 
-	/** Controls how and when the shared memory is allocated for the RPC calls. */
-	enum rpc_caller_memory_policy shared_memory_policy;
-
 	/**
 	 * Indicates if a call transaction has been started by the begin function but was not
 	 * finished yet (i.e. end was not called).
@@ -54,6 +56,36 @@ struct rpc_caller_session {
 	size_t request_length;
 };
 
+/**
+ * @brief RPC caller session
+ *
+ * Builds a session on top of the rpc_caller_interface. It provides high level functions for service
+ * caller implementations and for prior service discovery.
+ *
+ * A session opened with several slots allows a call to be in progress in each slot, so concurrent
+ * threads can make calls through the same session. Each slot has its own shared memory that is
+ * registered when the session is opened. Slots are claimed and released without locking.
+ */
+struct rpc_caller_session {
+	/** Caller interface */
+	struct rpc_caller_interface *caller;
+
+	/** Controls how and when the shared memory is allocated for the RPC calls. */
+	enum rpc_caller_memory_policy shared_memory_policy;
+
+	/** Call slot of sessions that allow a single call at a time */
+	struct rpc_caller_session_slot call_slot;
+
+	/** Call slots of sessions opened with the alloc_for_each_slot policy */
+	struct rpc_caller_session_slot *slots;
+
+	/** Number of entries in slots */
+	size_t num_slots;
+
+	/** Bitmap of the slots with a call in progress. Only accessed atomically. */
+	uint32_t slots_in_use;
+};
+
 /**
  * @brief
  *
@@ -86,6 +118,43 @@ rpc_status_t rpc_caller_session_find_and_open(struct rpc_caller_session *session
 					      const struct rpc_uuid *service_uuid,
 					      size_t shared_memory_size);
 
+/**
+ * @brief Opens an RPC caller session that allows several calls to be in progress
+ *
+ * @param session Caller session instance
+ * @param caller Caller interface
+ * @param service_uuid Service UUID
+ * @param endpoint_id Endpoint ID of the service
+ * @param shared_memory_size Size of the shared memory of each slot
+ * @param num_slots Number of call slots (at most RPC_CALLER_SESSION_MAX_SLOTS)
+ * @return RPC_CALLER_EXPORTED
+ */
+RPC_CALLER_EXPORTED
+rpc_status_t rpc_caller_session_open_with_slots(struct rpc_caller_session *session,
+						struct rpc_caller_interface *caller,
+						const struct rpc_uuid *service_uuid,
+						uint16_t endpoint_id,
+						size_t shared_memory_size,
+						size_t num_slots);
+
+/**
+ * @brief Finds a service and opens an RPC caller session that allows several calls to be in
+ *        progress
+ *
+ * @param session Caller session instance
+ * @param caller Caller interface
+ * @param service_uuid Service UUID
+ * @param shared_memory_size Size of the shared memory of each slot
+ * @param num_slots Number of call slots (at most RPC_CALLER_SESSION_MAX_SLOTS)
+ * @return RPC_CALLER_EXPORTED
+ */
+RPC_CALLER_EXPORTED
+rpc_status_t rpc_caller_session_find_and_open_with_slots(struct rpc_caller_session *session,
+							 struct rpc_caller_interface *caller,
+							 const struct rpc_uuid *service_uuid,
+							 size_t shared_memory_size,
+							 size_t num_slots);
+
 /**
  * @brief Closes the RPC caller session
  *
@@ -98,7 +167,8 @@ rpc_status_t rpc_caller_session_close(struct rpc_caller_session *session);
 /**
  * @brief Begins an RPC call
  *
- * The function returns a buffer where the service caller can build the request.
+ * The function returns a buffer where the service caller can build the request. For sessions
+ * opened with slots, NULL is returned if all slots are in use.
  *
  * @param session Caller session instance
  * @param request_buffer Pointer of the request buffer
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: BSD-3-Clause
 /*
- * Copyright (c) 2021-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  */
 
 #include "components/rpc/mm_communicate/common/mm_communicate_call_args.h"
@@ -33,12 +33,55 @@ bool mm_communicate_call_ep_init(struct mm_communicate_ep *call_ep, uint8_t *com
 		entry->iface = NULL;
 	}
 
+	memset(call_ep->service_hash_table, 0x00, sizeof(call_ep->service_hash_table));
+
 	return true;
 }
 
+static size_t guid_hash(const EFI_GUID *guid)
+{
+	uint32_t words[4] = { 0 };
+	uint32_t hash = 0;
+
+	memcpy(words, guid, MIN(sizeof(words), sizeof(*guid)));
+
+	/*
+	 * GUIDs of related services may differ in a few bits of any word, so all
+	 * bits are mixed into the low bits used for the table index.
+	 */
+	hash = words[0] ^ words[1] ^ words[2] ^ words[3];
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35u;
+	hash ^= hash >> 16;
+
+	return hash % MM_COMMUNICATE_SERVICE_HASH_TABLE_SIZE;
+}
+
+static const struct mm_service_entry *find_service(const struct mm_communicate_ep *call_ep,
+						   const EFI_GUID *guid)
+{
+	size_t slot = guid_hash(guid);
+	uint8_t index = 0;
+
+	/* Entries are never removed so the probe ends at the first empty slot */
+	while ((index = call_ep->service_hash_table[slot]) != 0) {
+		const struct mm_service_entry *entry = &call_ep->service_table[index - 1];
+
+		if (memcmp(guid, &entry->guid, sizeof(entry->guid)) == 0)
+			return entry;
+
+		slot = (slot + 1) % MM_COMMUNICATE_SERVICE_HASH_TABLE_SIZE;
+	}
+
+	return NULL;
+}
+
 static int32_t invoke_mm_service(struct mm_communicate_ep *call_ep, uint16_t source_id,
 				 struct mm_service_interface *iface,
 				 EFI_MM_COMMUNICATE_HEADER *header,
+				 size_t message_length,
 				 size_t buffer_size)
 {
 	struct mm_service_call_req call_req = { 0 };
@@ -47,7 +90,7 @@ static int32_t invoke_mm_service(struct mm_communicate_ep *call_ep, uint16_t sou
 	call_req.guid = &header->HeaderGuid;
 
 	call_req.req_buf.data = header->Data;
-	call_req.req_buf.data_length = header->MessageLength;
+	call_req.req_buf.data_length = message_length;
 	call_req.req_buf.size = buffer_size;
 
 	call_req.resp_buf.data = header->Data;
@@ -67,8 +110,10 @@ static int32_t handle_mm_communicate(struct mm_communicate_ep *call_ep, uint16_t
 	size_t header_end_offset = 0;
 	size_t request_end_offset = 0;
 	size_t buffer_size = 0;
+	size_t message_length = 0;
 	EFI_MM_COMMUNICATE_HEADER *header = NULL;
-	unsigned int i = 0;
+	EFI_GUID guid = { 0 };
+	const struct mm_service_entry *entry = NULL;
 
 	if (ADD_OVERFLOW(buffer_offset, EFI_MM_COMMUNICATE_HEADER_SIZE, &header_end_offset))
 		return MM_RETURN_CODE_INVALID_PARAMETER;
@@ -76,9 +121,15 @@ static int32_t handle_mm_communicate(struct mm_communicate_ep *call_ep, uint16_t
 	if (call_ep->comm_buffer_size < header_end_offset)
 		return MM_RETURN_CODE_INVALID_PARAMETER;
 
-	/* Validating comm buffer contents */
+	/*
+	 * Validating comm buffer contents. The header fields are read once so the
+	 * service gets the values that were validated.
+	 */
 	header = (EFI_MM_COMMUNICATE_HEADER *)(call_ep->comm_buffer + buffer_offset);
-	if (ADD_OVERFLOW(header_end_offset, header->MessageLength, &request_end_offset))
+	message_length = header->MessageLength;
+	memcpy(&guid, &header->HeaderGuid, sizeof(guid));
+
+	if (ADD_OVERFLOW(header_end_offset, message_length, &request_end_offset))
 		return MM_RETURN_CODE_INVALID_PARAMETER;
 
 	if (call_ep->comm_buffer_size < request_end_offset)
@@ -86,17 +137,16 @@ static int32_t handle_mm_communicate(struct mm_communicate_ep *call_ep, uint16_t
 
 	buffer_size = call_ep->comm_buffer_size - header_end_offset;
 
-	/* Finding iface_id by GUID */
-	for (i = 0; i < ARRAY_SIZE(call_ep->service_table); i++) {
-		const struct mm_service_entry *entry = &call_ep->service_table[i];
+	/* Finding iface by GUID */
+	entry = find_service(call_ep, &guid);
+	if (!entry)
+		return MM_RETURN_CODE_NOT_SUPPORTED;
 
-		if (entry->iface != NULL &&
-		    memcmp(&header->HeaderGuid, &entry->guid, sizeof(entry->guid)) == 0)
-			return invoke_mm_service(call_ep, source_id, entry->iface, header,
-						 buffer_size);
-	}
+	if (message_length < entry->iface->min_req_length)
+		return MM_RETURN_CODE_DENIED;
 
-	return MM_RETURN_CODE_NOT_SUPPORTED;
+	return invoke_mm_service(call_ep, source_id, entry->iface, header, message_length,
+				 buffer_size);
 }
 
 void mm_communicate_call_ep_attach_service(struct mm_communicate_ep *call_ep, const EFI_GUID *guid,
@@ -105,6 +155,7 @@ void mm_communicate_call_ep_attach_service(struct mm_communicate_ep *call_ep, co
 	unsigned int i = 0;
 	struct mm_service_entry *entry = NULL;
 	struct mm_service_entry *empty_entry = NULL;
+	size_t slot = 0;
 
 	assert(guid != NULL);
 	assert(iface != NULL);
@@ -122,6 +173,17 @@ void mm_communicate_call_ep_attach_service(struct mm_communicate_ep *call_ep, co
 
 	memcpy(&empty_entry->guid, guid, sizeof(empty_entry->guid));
 	empty_entry->iface = iface;
+
+	/*
+	 * Adding the entry at the end of the probe sequence, so if the GUID is
+	 * already bound the first binding stays in use.
+	 */
+	slot = guid_hash(guid);
+
+	while (call_ep->service_hash_table[slot] != 0)
+		slot = (slot + 1) % MM_COMMUNICATE_SERVICE_HASH_TABLE_SIZE;
+
+	call_ep->service_hash_table[slot] = i + 1;
 }
 
 void mm_communicate_call_ep_receive(struct mm_communicate_ep *mm_communicate_call_ep,
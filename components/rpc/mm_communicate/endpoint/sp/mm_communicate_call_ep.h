@@ -1,6 +1,6 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  */
 
 #ifndef MM_COMMUNICATE_CALL_EP_H_
@@ -20,6 +20,13 @@ extern "C" {
 #define MM_COMMUNICATE_MAX_SERVICE_BINDINGS				(8)
 #endif
 
+#if MM_COMMUNICATE_MAX_SERVICE_BINDINGS > 255
+#error "MM_COMMUNICATE_MAX_SERVICE_BINDINGS must fit the service hash table entries"
+#endif
+
+/* Kept at most half full so that lookups of unknown GUIDs end quickly */
+#define MM_COMMUNICATE_SERVICE_HASH_TABLE_SIZE	(2 * MM_COMMUNICATE_MAX_SERVICE_BINDINGS)
+
 /**
  * MM communication specialized call request structure which contains the GUID
  * of the called service and the request/response buffers.
@@ -32,11 +39,14 @@ struct mm_service_call_req {
 
 /**
  * MM communicate service definition. The receive function should return an
- * MM communication return code.
+ * MM communication return code. Requests shorter than min_req_length are
+ * denied by the endpoint so the receive function doesn't have to check for
+ * its fixed size headers.
  */
 struct mm_service_interface {
 	void *context;
 	int32_t (*receive)(struct mm_service_interface *iface, struct mm_service_call_req *req);
+	size_t min_req_length;
 };
 
 /**
@@ -58,6 +68,9 @@ struct mm_communicate_ep {
 
 	/* Array of binding entries between GUIDs and RPC ifaces. */
 	struct mm_service_entry service_table[MM_COMMUNICATE_MAX_SERVICE_BINDINGS];
+
+	/* Open addressing hash table of service_table indexes plus one, keyed by GUID */
+	uint8_t service_hash_table[MM_COMMUNICATE_SERVICE_HASH_TABLE_SIZE];
 };
 
 bool mm_communicate_call_ep_init(struct mm_communicate_ep *call_ep, uint8_t *comm_buffer,
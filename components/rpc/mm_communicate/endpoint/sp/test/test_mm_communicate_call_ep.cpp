@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: BSD-3-Clause
 /*
- * Copyright (c) 2021-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  */
 
 #include <CppUTest/TestHarness.h>
@@ -13,6 +13,18 @@
 
 static uint8_t comm_buffer[4096] __attribute__((aligned(4096)));
 
+/* Records the called service without the overhead of the mock */
+static struct mm_service_interface *called_iface;
+
+static int32_t recording_mm_service_receive(struct mm_service_interface *iface,
+					    struct mm_service_call_req *req)
+{
+	called_iface = iface;
+	req->resp_buf.data_length = req->req_buf.data_length;
+
+	return MM_RETURN_CODE_SUCCESS;
+}
+
 TEST_GROUP(mm_communicate_call_ep)
 {
 	TEST_SETUP()
@@ -42,7 +54,36 @@ TEST_GROUP(mm_communicate_call_ep)
 		UNSIGNED_LONGLONGS_EQUAL(arg4,  msg->args.args64[4]);
 	}
 
+	void attach_all_services()
+	{
+		CHECK_TRUE(mm_communicate_call_ep_init(&call_ep, comm_buffer, sizeof(comm_buffer)));
+
+		/* GUIDs differ in a single byte like those of related services */
+		for (int i = 0; i < MM_COMMUNICATE_MAX_SERVICE_BINDINGS; i++) {
+			guids[i] = guid0;
+			guids[i].Data4[7] = i;
+			ifaces[i].context = NULL;
+			ifaces[i].receive = recording_mm_service_receive;
+			ifaces[i].min_req_length = 0;
+
+			mm_communicate_call_ep_attach_service(&call_ep, &guids[i], &ifaces[i]);
+		}
+	}
+
+	int32_t call_service(const EFI_GUID *guid)
+	{
+		memcpy(&header->HeaderGuid, guid, sizeof(*guid));
+		header->MessageLength = 16;
+		called_iface = NULL;
+
+		mm_communicate_call_ep_receive(&call_ep, &req_msg, &resp_msg);
+
+		return resp_msg.args.args64[0];
+	}
+
 	struct mm_communicate_ep call_ep;
+	struct mm_service_interface ifaces[MM_COMMUNICATE_MAX_SERVICE_BINDINGS];
+	EFI_GUID guids[MM_COMMUNICATE_MAX_SERVICE_BINDINGS];
 	struct ffa_direct_msg req_msg;
 	struct ffa_direct_msg resp_msg;
 	EFI_MM_COMMUNICATE_HEADER *header = (EFI_MM_COMMUNICATE_HEADER *)comm_buffer;
@@ -322,3 +363,48 @@ TEST(mm_communicate_call_ep, mm_communicate_two_handlers)
 
 	check_sp_msg(&resp_msg, MM_RETURN_CODE_SUCCESS, 0, 0, 0, 0);
 }
+
+TEST(mm_communicate_call_ep, mm_communicate_all_handlers)
+{
+	attach_all_services();
+
+	for (int i = 0; i < MM_COMMUNICATE_MAX_SERVICE_BINDINGS; i++) {
+		LONGS_EQUAL(MM_RETURN_CODE_SUCCESS, call_service(&guids[i]));
+		POINTERS_EQUAL(&ifaces[i], called_iface);
+		UNSIGNED_LONGLONGS_EQUAL(16, header->MessageLength);
+	}
+
+	LONGS_EQUAL(MM_RETURN_CODE_NOT_SUPPORTED, call_service(&guid1));
+	POINTERS_EQUAL(NULL, called_iface);
+}
+
+TEST(mm_communicate_call_ep, mm_communicate_same_guid_first_handler)
+{
+	struct mm_service_interface iface0 = {
+		.context = NULL,
+		.receive = recording_mm_service_receive
+	};
+	struct mm_service_interface iface1 = iface0;
+
+	CHECK_TRUE(mm_communicate_call_ep_init(&call_ep, comm_buffer, sizeof(comm_buffer)));
+	mm_communicate_call_ep_attach_service(&call_ep, &guid0, &iface0);
+	mm_communicate_call_ep_attach_service(&call_ep, &guid0, &iface1);
+
+	LONGS_EQUAL(MM_RETURN_CODE_SUCCESS, call_service(&guid0));
+	POINTERS_EQUAL(&iface0, called_iface);
+}
+
+TEST(mm_communicate_call_ep, mm_communicate_short_request)
+{
+	struct mm_service_interface iface = {
+		.context = NULL,
+		.receive = recording_mm_service_receive,
+		.min_req_length = 24
+	};
+
+	CHECK_TRUE(mm_communicate_call_ep_init(&call_ep, comm_buffer, sizeof(comm_buffer)));
+	mm_communicate_call_ep_attach_service(&call_ep, &guid0, &iface);
+
+	LONGS_EQUAL(MM_RETURN_CODE_DENIED, call_service(&guid0));
+	POINTERS_EQUAL(NULL, called_iface);
+}
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -18,16 +19,91 @@
 #include <psa_ipc_caller.h>
 #include "service_psa_ipc_openamp_lib.h"
 
-static inline void *unaligned_memcpy(void *dst_init, const void *src_init,
-				     size_t len)
+/*
+ * The shared buffer of the openamp transport may be mapped as device memory,
+ * where unaligned accesses fault. memcpy() is free to use those, so copies to
+ * and from the shared buffer only make naturally aligned accesses on the
+ * shared side. The client side is normal memory, where the word accesses made
+ * through memcpy() of a constant size don't need to be aligned.
+ */
+#define PSA_IPC_COPY_WORD_SIZE		(sizeof(uint64_t))
+#define PSA_IPC_COPY_BLOCK_WORDS	(4)
+
+static inline bool psa_ipc_is_word_aligned(const volatile void *ptr)
+{
+	return !((uintptr_t)ptr & (PSA_IPC_COPY_WORD_SIZE - 1));
+}
+
+static void copy_to_shared(void *dst_init, const void *src_init, size_t len)
 {
-	char *dst = dst_init;
-	const char *src = src_init;
+	volatile uint8_t *dst = dst_init;
+	const uint8_t *src = src_init;
+	uint64_t words[PSA_IPC_COPY_BLOCK_WORDS];
+	size_t i = 0;
+
+	while (len && !psa_ipc_is_word_aligned(dst)) {
+		*dst++ = *src++;
+		len--;
+	}
+
+	while (len >= sizeof(words)) {
+		memcpy(words, src, sizeof(words));
+
+		for (i = 0; i < PSA_IPC_COPY_BLOCK_WORDS; i++)
+			((volatile uint64_t *)dst)[i] = words[i];
+
+		dst += sizeof(words);
+		src += sizeof(words);
+		len -= sizeof(words);
+	}
+
+	while (len >= PSA_IPC_COPY_WORD_SIZE) {
+		memcpy(words, src, PSA_IPC_COPY_WORD_SIZE);
+		*(volatile uint64_t *)dst = words[0];
+
+		dst += PSA_IPC_COPY_WORD_SIZE;
+		src += PSA_IPC_COPY_WORD_SIZE;
+		len -= PSA_IPC_COPY_WORD_SIZE;
+	}
 
 	while (len--)
 		*dst++ = *src++;
+}
+
+static void copy_from_shared(void *dst_init, const void *src_init, size_t len)
+{
+	uint8_t *dst = dst_init;
+	const volatile uint8_t *src = src_init;
+	uint64_t words[PSA_IPC_COPY_BLOCK_WORDS];
+	size_t i = 0;
+
+	while (len && !psa_ipc_is_word_aligned(src)) {
+		*dst++ = *src++;
+		len--;
+	}
+
+	while (len >= sizeof(words)) {
+		for (i = 0; i < PSA_IPC_COPY_BLOCK_WORDS; i++)
+			words[i] = ((const volatile uint64_t *)src)[i];
+
+		memcpy(dst, words, sizeof(words));
 
-	return dst_init;
+		dst += sizeof(words);
+		src += sizeof(words);
+		len -= sizeof(words);
+	}
+
+	while (len >= PSA_IPC_COPY_WORD_SIZE) {
+		words[0] = *(const volatile uint64_t *)src;
+		memcpy(dst, words, PSA_IPC_COPY_WORD_SIZE);
+
+		dst += PSA_IPC_COPY_WORD_SIZE;
+		src += PSA_IPC_COPY_WORD_SIZE;
+		len -= PSA_IPC_COPY_WORD_SIZE;
+	}
+
+	while (len--)
+		*dst++ = *src++;
 }
 
 static struct psa_invec *psa_call_in_vec_param(uint8_t *req)
@@ -155,8 +231,8 @@ static psa_status_t __psa_call(struct rpc_caller_interface *caller, psa_handle_t
 		in_vec_param[i].base = psa_virt_to_phys_u32(caller, payload);
 		in_vec_param[i].len = in_vec[i].len;
 
-		unaligned_memcpy(payload, psa_u32_to_ptr(in_vec[i].base),
-				 in_vec[i].len);
+		copy_to_shared(payload, psa_u32_to_ptr(in_vec[i].base),
+			       in_vec[i].len);
 		payload += in_vec[i].len;
 	}
 
@@ -181,7 +257,7 @@ static psa_status_t __psa_call(struct rpc_caller_interface *caller, psa_handle_t
 
 	for (i = 0; i < resp_msg->params.out_len; i++) {
 		out_vec[i].len = out_vec_param[i].len;
-		unaligned_memcpy(psa_u32_to_ptr(out_vec[i].base),
+		copy_from_shared(psa_u32_to_ptr(out_vec[i].base),
 				 psa_ipc_phys_to_virt(caller,
 				      psa_u32_to_ptr(out_vec_param[i].base)),
 				 out_vec[i].len);
@@ -0,0 +1,22 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+if (NOT DEFINED TGT)
+	message(FATAL_ERROR "mandatory parameter TGT is not defined.")
+endif()
+
+# The psa_ipc client is tested over a stub openamp caller that stands in
+# for the secure enclave.
+target_sources(${TGT} PRIVATE
+	"${CMAKE_CURRENT_LIST_DIR}/../service_psa_ipc.c"
+	"${CMAKE_CURRENT_LIST_DIR}/service_psa_ipc_tests.cpp"
+	)
+
+target_include_directories(${TGT} PRIVATE
+	"${CMAKE_CURRENT_LIST_DIR}/.."
+	"${CMAKE_CURRENT_LIST_DIR}/../caller/sp"
+	"${TS_ROOT}/components/messaging/openamp/sp"
+	)
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include <sys/mman.h>
+#include <protocols/rpc/common/packed-c/status.h>
+#include <psa/client.h>
+#include <CppUTest/TestHarness.h>
+
+extern "C" {
+#include <psa_ipc_caller.h>
+}
+
+/* Included last as compiler.h defines names used by the C++ library */
+#include "service_psa_ipc_openamp_lib.h"
+
+/*
+ * A stub openamp caller standing in for the secure enclave. Requests are
+ * built in a shared buffer that is addressed by the enclave with physical
+ * addresses. The stub service returns each input vector in the output vector
+ * of the same index.
+ */
+#define STUB_SHARED_PHYS_BASE	(0x10000000u)
+#define STUB_SHARED_SIZE	(16 * 1024)
+#define STUB_RESP_OFFSET	(STUB_SHARED_SIZE / 2)
+
+static uint8_t stub_shared[STUB_SHARED_SIZE] __attribute__((aligned(8)));
+static size_t stub_resp_data_offset;
+
+extern "C" {
+
+void *psa_ipc_phys_to_virt(void *context, void *pa)
+{
+	return &stub_shared[(uintptr_t)pa - STUB_SHARED_PHYS_BASE];
+}
+
+void *psa_ipc_virt_to_phys(void *context, void *va)
+{
+	return (void *)(STUB_SHARED_PHYS_BASE + ((uint8_t *)va - stub_shared));
+}
+
+psa_ipc_call_handle psa_ipc_caller_begin(struct rpc_caller_interface *caller,
+					 uint8_t **request_buffer,
+					 size_t request_length)
+{
+	if (request_length > STUB_RESP_OFFSET)
+		return NULL;
+
+	*request_buffer = stub_shared;
+
+	return stub_shared;
+}
+
+rpc_status_t psa_ipc_caller_invoke(psa_ipc_call_handle handle, uint32_t opcode,
+				   uint8_t **response_buffer,
+				   size_t *response_length)
+{
+	struct ns_openamp_msg req_msg;
+	struct s_openamp_msg resp_msg;
+	struct psa_invec in_vec[PSA_MAX_IOVEC];
+	struct psa_outvec out_vec[PSA_MAX_IOVEC];
+	uint8_t *resp = &stub_shared[STUB_RESP_OFFSET];
+	size_t data_offset = STUB_RESP_OFFSET + sizeof(resp_msg) + sizeof(out_vec) +
+			     stub_resp_data_offset;
+	uint32_t in_len = 0;
+	uint32_t out_len = 0;
+
+	memcpy(&req_msg, stub_shared, sizeof(req_msg));
+
+	in_len = req_msg.params.psa_call_params.in_len;
+	out_len = req_msg.params.psa_call_params.out_len;
+
+	memcpy(in_vec, psa_ipc_phys_to_virt(NULL,
+		(void *)(uintptr_t)req_msg.params.psa_call_params.in_vec),
+		in_len * sizeof(in_vec[0]));
+	memcpy(out_vec, psa_ipc_phys_to_virt(NULL,
+		(void *)(uintptr_t)req_msg.params.psa_call_params.out_vec),
+		out_len * sizeof(out_vec[0]));
+
+	for (uint32_t i = 0; i < out_len; i++) {
+		const uint8_t *in = NULL;
+		uint32_t len = 0;
+
+		if (i < in_len) {
+			in = (const uint8_t *)psa_ipc_phys_to_virt(NULL,
+				(void *)(uintptr_t)in_vec[i].base);
+			len = (in_vec[i].len < out_vec[i].len) ? in_vec[i].len : out_vec[i].len;
+		}
+
+		if (data_offset + len > STUB_SHARED_SIZE)
+			return RPC_ERROR_INTERNAL;
+
+		memcpy(&stub_shared[data_offset], in, len);
+
+		out_vec[i].base = psa_ptr_to_u32(psa_ipc_virt_to_phys(NULL,
+			&stub_shared[data_offset]));
+		out_vec[i].len = len;
+		data_offset += len;
+	}
+
+	memcpy(resp + sizeof(resp_msg), out_vec, sizeof(out_vec));
+
+	resp_msg.request_id = req_msg.request_id;
+	resp_msg.reply = PSA_SUCCESS;
+	resp_msg.params.out_vec = psa_ptr_to_u32(psa_ipc_virt_to_phys(NULL,
+		resp + sizeof(resp_msg)));
+	resp_msg.params.out_len = out_len;
+	memcpy(resp, &resp_msg, sizeof(resp_msg));
+
+	*response_buffer = resp;
+	*response_length = sizeof(resp_msg);
+
+	return RPC_SUCCESS;
+}
+
+rpc_status_t psa_ipc_caller_end(psa_ipc_call_handle handle)
+{
+	return RPC_SUCCESS;
+}
+
+}
+
+TEST_GROUP(PsaIpcCallTests)
+{
+	void setup()
+	{
+		/*
+		 * Client vectors carry 32-bit addresses so the client buffers
+		 * are mapped in the low 4GB of the address space.
+		 */
+		m_client_buf = (uint8_t *)mmap((void *)CLIENT_BUF_HINT, CLIENT_BUF_SIZE,
+					       PROT_READ | PROT_WRITE,
+					       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		CHECK_TRUE(m_client_buf != MAP_FAILED);
+
+		if ((uintptr_t)m_client_buf + CLIENT_BUF_SIZE > UINT32_MAX) {
+			munmap(m_client_buf, CLIENT_BUF_SIZE);
+			FAIL("Client buffer is not addressable with 32 bits");
+		}
+
+		memset(&m_caller, 0, sizeof(m_caller));
+		stub_resp_data_offset = 0;
+	}
+
+	void teardown()
+	{
+		munmap(m_client_buf, CLIENT_BUF_SIZE);
+	}
+
+	uint8_t *in_buf(size_t offset)
+	{
+		return &m_client_buf[offset];
+	}
+
+	uint8_t *out_buf(size_t offset)
+	{
+		return &m_client_buf[CLIENT_BUF_SIZE / 2 + offset];
+	}
+
+	psa_status_t call(const uint8_t *in, size_t in_size, uint8_t *out, size_t out_size,
+			  size_t *out_length)
+	{
+		struct psa_invec in_vec[] = {
+			{ .base = psa_ptr_const_to_u32(in), .len = (uint32_t)in_size },
+		};
+		struct psa_outvec out_vec[] = {
+			{ .base = psa_ptr_to_u32(out), .len = (uint32_t)out_size },
+		};
+		psa_status_t status = psa_call(&m_caller, TEST_HANDLE, PSA_IPC_CALL,
+					       in_vec, IOVEC_LEN(in_vec),
+					       out_vec, IOVEC_LEN(out_vec));
+
+		*out_length = out_vec[0].len;
+
+		return status;
+	}
+
+	void check_call(size_t in_offset, size_t out_offset, size_t len)
+	{
+		uint8_t *in = in_buf(in_offset);
+		uint8_t *out = out_buf(out_offset);
+		size_t out_length = 0;
+
+		for (size_t i = 0; i < len; i++)
+			in[i] = (uint8_t)(i * 7 + in_offset);
+
+		/* Guard bytes either side of the output */
+		memset(out - 1, 0x5a, len + 2);
+
+		LONGS_EQUAL(PSA_SUCCESS, call(in, len, out, len, &out_length));
+		UNSIGNED_LONGS_EQUAL(len, out_length);
+
+		for (size_t i = 0; i < len; i++)
+			BYTES_EQUAL(in[i], out[i]);
+
+		BYTES_EQUAL(0x5a, out[-1]);
+		BYTES_EQUAL(0x5a, out[len]);
+	}
+
+	static const uintptr_t CLIENT_BUF_HINT = 0x40000000;
+	static const size_t CLIENT_BUF_SIZE = 64 * 1024;
+	static const psa_handle_t TEST_HANDLE = 1;
+
+	struct rpc_caller_interface m_caller;
+	uint8_t *m_client_buf;
+};
+
+TEST(PsaIpcCallTests, copyAlignments)
+{
+	static const size_t lengths[] = { 0, 1, 7, 8, 9, 31, 32, 33, 100, 1024, 4096 };
+
+	for (size_t len : lengths) {
+		for (size_t in_offset = 0; in_offset < 8; in_offset++) {
+			for (size_t out_offset = 1; out_offset <= 8; out_offset++) {
+				stub_resp_data_offset = (in_offset + out_offset) % 8;
+				check_call(in_offset, out_offset, len);
+			}
+		}
+	}
+}
+
+TEST(PsaIpcCallTests, multipleVectors)
+{
+	uint8_t *in = in_buf(0);
+	uint8_t *out = out_buf(0);
+	struct psa_invec in_vec[] = {
+		{ .base = psa_ptr_to_u32(in), .len = 13 },
+		{ .base = psa_ptr_to_u32(in + 13), .len = 64 },
+	};
+	struct psa_outvec out_vec[] = {
+		{ .base = psa_ptr_to_u32(out), .len = 13 },
+		{ .base = psa_ptr_to_u32(out + 13), .len = 64 },
+	};
+
+	for (size_t i = 0; i < 77; i++)
+		in[i] = (uint8_t)i;
+
+	LONGS_EQUAL(PSA_SUCCESS, psa_call(&m_caller, TEST_HANDLE, PSA_IPC_CALL,
+					  in_vec, IOVEC_LEN(in_vec),
+					  out_vec, IOVEC_LEN(out_vec)));
+
+	UNSIGNED_LONGS_EQUAL(13, out_vec[0].len);
+	UNSIGNED_LONGS_EQUAL(64, out_vec[1].len);
+
+	for (size_t i = 0; i < 77; i++)
+		BYTES_EQUAL((uint8_t)i, out[i]);
+}
@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+#include <string.h>
+#include "mock_sp_discovery.h"
+#include "mock_sp_memory_management.h"
+#include "../ts_rpc_endpoint_sp.h"
+
+static const uint16_t own_id = 0x8001;
+static const uint16_t client_id = 0x1234;
+static uint8_t shared_buffer[FFA_MEM_TRANSACTION_PAGE_SIZE] __attribute__((aligned(4096)));
+
+static rpc_status_t echo_receive(void *context, struct rpc_request *request)
+{
+	unsigned int *call_count = (unsigned int *)context;
+
+	(*call_count)++;
+	request->response.data_length = request->request.data_length;
+	request->service_status = request->opcode;
+
+	return RPC_SUCCESS;
+}
+
+TEST_GROUP(ts_rpc_endpoint_sp)
+{
+	TEST_SETUP()
+	{
+		memset(&endpoint, 0x00, sizeof(endpoint));
+		memset(&service, 0x00, sizeof(service));
+		memset(&req, 0x00, sizeof(req));
+		memset(&resp, 0x00, sizeof(resp));
+
+		call_count = 0;
+		service.context = &call_count;
+		service.receive = echo_receive;
+	}
+
+	TEST_TEARDOWN()
+	{
+		mock().checkExpectations();
+		mock().clear();
+	}
+
+	void init_endpoint(size_t shared_memory_count)
+	{
+		expect_sp_discovery_own_id_get(&own_id, SP_RESULT_OK);
+		LONGS_EQUAL(RPC_SUCCESS,
+			    ts_rpc_endpoint_sp_init(&endpoint, 1, shared_memory_count));
+		LONGS_EQUAL(RPC_SUCCESS, ts_rpc_endpoint_sp_add_service(&endpoint, &service));
+	}
+
+	void setup_request(uint16_t source_id)
+	{
+		memset(&req, 0x00, sizeof(req));
+		memset(&resp, 0x00, sizeof(resp));
+
+		req.source_id = source_id;
+		req.destination_id = own_id;
+	}
+
+	void expect_retrieve(uint16_t source_id, uint64_t handle, sp_result result)
+	{
+		struct sp_memory_descriptor desc;
+		struct sp_memory_access_descriptor acc_desc;
+		struct sp_memory_region region;
+		uint32_t out_region_count = 1;
+
+		memset(&desc, 0x00, sizeof(desc));
+		memset(&acc_desc, 0x00, sizeof(acc_desc));
+
+		desc.sender_id = source_id;
+		desc.memory_type = sp_memory_type_not_specified;
+		desc.flags.transaction_type = sp_memory_transaction_type_share;
+		acc_desc.receiver_id = own_id;
+		acc_desc.data_access = sp_data_access_read_write;
+
+		region.address = shared_buffer;
+		region.page_count = 1;
+
+		expect_sp_memory_retrieve(&desc, &acc_desc, &acc_desc, NULL, &region, 0,
+					  &out_region_count, handle, result);
+	}
+
+	void expect_relinquish(uint64_t handle)
+	{
+		struct sp_memory_transaction_flags flags;
+
+		memset(&flags, 0x00, sizeof(flags));
+		expect_sp_memory_relinquish(handle, &own_id, 1, &flags, SP_RESULT_OK);
+	}
+
+	rpc_status_t retrieve(uint16_t source_id, uint64_t handle)
+	{
+		setup_request(source_id);
+		ts_rpc_abi_set_management_interface_id(req.args.args32);
+		ts_rpc_abi_set_opcode(req.args.args32, TS_RPC_ABI_MANAGEMENT_OPCODE_MEMORY_RETRIEVE);
+		ts_rpc_abi_set_memory_handle(req.args.args32, handle);
+
+		ts_rpc_endpoint_sp_receive(&endpoint, &req, &resp);
+
+		return ts_rpc_abi_get_rpc_status(resp.args.args32);
+	}
+
+	rpc_status_t relinquish(uint16_t source_id, uint64_t handle)
+	{
+		setup_request(source_id);
+		ts_rpc_abi_set_management_interface_id(req.args.args32);
+		ts_rpc_abi_set_opcode(req.args.args32,
+				      TS_RPC_ABI_MANAGEMENT_OPCODE_MEMORY_RELINQUISH);
+		ts_rpc_abi_set_memory_handle(req.args.args32, handle);
+
+		ts_rpc_endpoint_sp_receive(&endpoint, &req, &resp);
+
+		return ts_rpc_abi_get_rpc_status(resp.args.args32);
+	}
+
+	rpc_status_t call(uint16_t source_id, uint64_t handle, uint16_t opcode,
+			  uint32_t request_length)
+	{
+		setup_request(source_id);
+		ts_rpc_abi_set_interface_id(req.args.args32, 0);
+		ts_rpc_abi_set_opcode(req.args.args32, opcode);
+		ts_rpc_abi_set_memory_handle(req.args.args32, handle);
+		ts_rpc_abi_set_request_length(req.args.args32, request_length);
+
+		ts_rpc_endpoint_sp_receive(&endpoint, &req, &resp);
+
+		return ts_rpc_abi_get_rpc_status(resp.args.args32);
+	}
+
+	/* Checks that every memory of a full pool is found for its own owner only */
+	void check_full_pool(size_t shared_memory_count)
+	{
+		uint64_t handle = 0;
+
+		call_count = 0;
+		init_endpoint(shared_memory_count);
+
+		for (handle = 0; handle < shared_memory_count; handle++) {
+			expect_retrieve(client_id + (handle & 0x7), 0x1000 + handle, SP_RESULT_OK);
+			LONGS_EQUAL(RPC_SUCCESS, retrieve(client_id + (handle & 0x7), 0x1000 + handle));
+		}
+
+		for (handle = 0; handle < shared_memory_count; handle++) {
+			LONGS_EQUAL(RPC_SUCCESS,
+				    call(client_id + (handle & 0x7), 0x1000 + handle, 1, 16));
+			LONGS_EQUAL(RPC_ERROR_NOT_FOUND,
+				    call(client_id + ((handle + 1) & 0x7), 0x1000 + handle, 1, 16));
+		}
+
+		LONGS_EQUAL(RPC_ERROR_NOT_FOUND,
+			    call(client_id, 0x1000 + shared_memory_count, 1, 16));
+		UNSIGNED_LONGS_EQUAL(shared_memory_count, call_count);
+
+		for (handle = 0; handle < shared_memory_count; handle++)
+			expect_relinquish(0x1000 + handle);
+
+		LONGS_EQUAL(RPC_SUCCESS, ts_rpc_endpoint_sp_deinit(&endpoint));
+	}
+
+	struct ts_rpc_endpoint_sp endpoint;
+	struct rpc_service_interface service;
+	unsigned int call_count;
+	struct sp_msg req;
+	struct sp_msg resp;
+};
+
+TEST(ts_rpc_endpoint_sp, retrieve_call_relinquish)
+{
+	init_endpoint(4);
+
+	expect_retrieve(client_id, 0x10, SP_RESULT_OK);
+	LONGS_EQUAL(RPC_SUCCESS, retrieve(client_id, 0x10));
+
+	LONGS_EQUAL(RPC_SUCCESS, call(client_id, 0x10, 5, 32));
+	UNSIGNED_LONGS_EQUAL(32, ts_rpc_abi_get_response_length(resp.args.args32));
+	UNSIGNED_LONGS_EQUAL(5, ts_rpc_abi_get_service_status(resp.args.args32));
+
+	/* The memory is bound to its owner */
+	LONGS_EQUAL(RPC_ERROR_NOT_FOUND, call(client_id + 1, 0x10, 5, 32));
+	LONGS_EQUAL(RPC_ERROR_INVALID_VALUE,
+		    call(client_id, 0x10, 5, FFA_MEM_TRANSACTION_PAGE_SIZE + 1));
+
+	expect_relinquish(0x10);
+	LONGS_EQUAL(RPC_SUCCESS, relinquish(client_id, 0x10));
+
+	LONGS_EQUAL(RPC_ERROR_NOT_FOUND, call(client_id, 0x10, 5, 32));
+	LONGS_EQUAL(RPC_ERROR_NOT_FOUND, relinquish(client_id, 0x10));
+	UNSIGNED_LONGS_EQUAL(1, call_count);
+
+	LONGS_EQUAL(RPC_SUCCESS, ts_rpc_endpoint_sp_deinit(&endpoint));
+}
+
+TEST(ts_rpc_endpoint_sp, call_without_shared_memory)
+{
+	init_endpoint(1);
+
+	LONGS_EQUAL(RPC_SUCCESS, call(client_id, FFA_MEM_HANDLE_INVALID, 3, 0));
+	LONGS_EQUAL(RPC_ERROR_INVALID_VALUE, call(client_id, FFA_MEM_HANDLE_INVALID, 3, 1));
+
+	LONGS_EQUAL(RPC_SUCCESS, ts_rpc_endpoint_sp_deinit(&endpoint));
+}
+
+TEST(ts_rpc_endpoint_sp, pool_exhaustion_and_reuse)
+{
+	const size_t shared_memory_count = 5;
+	uint64_t handle = 0;
+
+	init_endpoint(shared_memory_count);
+
+	/* Failed retrieve doesn't use a slot */
+	expect_retrieve(client_id, 0x100, SP_RESULT_INVALID_PARAMETERS);
+	LONGS_EQUAL(RPC_ERROR_TRANSPORT_LAYER, retrieve(client_id, 0x100));
+
+	/* Fill the pool with the memories of two owners */
+	for (handle = 0; handle < shared_memory_count; handle++) {
+		uint16_t owner = client_id + (handle & 1);
+
+		expect_retrieve(owner, handle, SP_RESULT_OK);
+		LONGS_EQUAL(RPC_SUCCESS, retrieve(owner, handle));
+	}
+
+	LONGS_EQUAL(RPC_ERROR_NOT_FOUND, retrieve(client_id, 0x100));
+
+	for (handle = 0; handle < shared_memory_count; handle++) {
+		LONGS_EQUAL(RPC_SUCCESS, call(client_id + (handle & 1), handle, 0, 0));
+		LONGS_EQUAL(RPC_ERROR_NOT_FOUND, call(client_id + !(handle & 1), handle, 0, 0));
+	}
+
+	/* Release a slot from the middle of the pool and reuse it */
+	expect_relinquish(2);
+	LONGS_EQUAL(RPC_SUCCESS, relinquish(client_id, 2));
+
+	expect_retrieve(client_id, 0x100, SP_RESULT_OK);
+	LONGS_EQUAL(RPC_SUCCESS, retrieve(client_id, 0x100));
+	LONGS_EQUAL(RPC_SUCCESS, call(client_id, 0x100, 0, 0));
+	LONGS_EQUAL(RPC_ERROR_NOT_FOUND, call(client_id, 2, 0, 0));
+
+	/* Deinit only relinquishes the retained memories */
+	expect_relinquish(0);
+	expect_relinquish(1);
+	expect_relinquish(0x100);
+	expect_relinquish(3);
+	expect_relinquish(4);
+	LONGS_EQUAL(RPC_SUCCESS, ts_rpc_endpoint_sp_deinit(&endpoint));
+}
+
+TEST(ts_rpc_endpoint_sp, full_pool_lookup)
+{
+	check_full_pool(16);
+	check_full_pool(1024);
+}
@@ -11,34 +11,100 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define NO_SHARED_MEMORY (SIZE_MAX)
+
 static const struct ts_rpc_shared_memory null_shared_memory = {
 	.owner_id = 0xffff, .handle = FFA_MEM_HANDLE_INVALID, .data = NULL, .size = 0, .used = true
 };
 
-static struct ts_rpc_shared_memory *find_free_shared_memory_descriptor(
-	struct ts_rpc_endpoint_sp *endpoint)
+static size_t shared_memory_bucket(const struct ts_rpc_endpoint_sp *endpoint, uint16_t owner_id,
+				   uint64_t handle)
 {
-	struct ts_rpc_shared_memory *memory = endpoint->shared_memories;
-	struct ts_rpc_shared_memory *end = memory + endpoint->shared_memory_count;
+	/* Fibonacci hashing of the (owner, handle) pair, the bucket count is a power of two */
+	uint64_t key = (handle ^ ((uint64_t)owner_id << 48)) * UINT64_C(0x9e3779b97f4a7c15);
 
-	for (; memory < end; memory++)
-		if (!memory->used)
-			return memory;
+	return (size_t)(key >> 32) & (endpoint->shared_memory_bucket_count - 1);
+}
+
+static size_t *find_shared_memory_link(struct ts_rpc_endpoint_sp *endpoint, uint16_t owner_id,
+				       uint64_t handle)
+{
+	size_t *link = &endpoint->shared_memory_buckets[shared_memory_bucket(endpoint, owner_id,
+									     handle)];
+
+	while (*link != NO_SHARED_MEMORY) {
+		struct ts_rpc_shared_memory *memory = &endpoint->shared_memories[*link];
+
+		if (memory->owner_id == owner_id && memory->handle == handle)
+			return link;
+
+		link = &memory->next;
+	}
 
 	return NULL;
 }
 
+static struct ts_rpc_shared_memory *find_free_shared_memory_descriptor(
+	struct ts_rpc_endpoint_sp *endpoint)
+{
+	if (endpoint->free_shared_memory == NO_SHARED_MEMORY)
+		return NULL;
+
+	return &endpoint->shared_memories[endpoint->free_shared_memory];
+}
+
 static struct ts_rpc_shared_memory *find_shared_memory_descriptor(
 	struct ts_rpc_endpoint_sp *endpoint, uint16_t owner_id, uint64_t handle)
 {
-	struct ts_rpc_shared_memory *memory = endpoint->shared_memories;
-	struct ts_rpc_shared_memory *end = memory + endpoint->shared_memory_count;
+	size_t *link = find_shared_memory_link(endpoint, owner_id, handle);
 
-	for (; memory < end; memory++)
-		if (memory->used && memory->owner_id == owner_id && memory->handle == handle)
-			return memory;
+	return link ? &endpoint->shared_memories[*link] : NULL;
+}
 
-	return NULL;
+static void add_shared_memory_descriptor(struct ts_rpc_endpoint_sp *endpoint,
+					 struct ts_rpc_shared_memory *memory)
+{
+	size_t index = memory - endpoint->shared_memories;
+	size_t bucket = shared_memory_bucket(endpoint, memory->owner_id, memory->handle);
+
+	/* The descriptor is the head of the free list */
+	endpoint->free_shared_memory = memory->next;
+
+	memory->used = true;
+	memory->next = endpoint->shared_memory_buckets[bucket];
+	endpoint->shared_memory_buckets[bucket] = index;
+}
+
+static void remove_shared_memory_descriptor(struct ts_rpc_endpoint_sp *endpoint, size_t *link)
+{
+	size_t index = *link;
+	struct ts_rpc_shared_memory *memory = &endpoint->shared_memories[index];
+
+	*link = memory->next;
+
+	*memory = (struct ts_rpc_shared_memory){ 0 };
+	memory->next = endpoint->free_shared_memory;
+	endpoint->free_shared_memory = index;
+}
+
+static void init_shared_memory_index(struct ts_rpc_endpoint_sp *endpoint)
+{
+	size_t i = 0;
+
+	for (i = 0; i < endpoint->shared_memory_bucket_count; i++)
+		endpoint->shared_memory_buckets[i] = NO_SHARED_MEMORY;
+
+	/* Chain all descriptors into the free list */
+	for (i = 0; i < endpoint->shared_memory_count; i++)
+		endpoint->shared_memories[i].next = i + 1;
+
+	if (endpoint->shared_memory_count) {
+		endpoint->shared_memories[endpoint->shared_memory_count - 1].next =
+			NO_SHARED_MEMORY;
+		endpoint->free_shared_memory = 0;
+	} else {
+		endpoint->free_shared_memory = NO_SHARED_MEMORY;
+	}
 }
 
 static rpc_status_t handle_memory_retrieve(struct ts_rpc_endpoint_sp *endpoint, uint16_t source_id,
@@ -77,7 +143,7 @@ static rpc_status_t handle_memory_retrieve(struct ts_rpc_endpoint_sp *endpoint,
 	memory->handle = memory_handle;
 	memory->data = region.address;
 	memory->size = region.page_count * FFA_MEM_TRANSACTION_PAGE_SIZE;
-	memory->used = true;
+	add_shared_memory_descriptor(endpoint, memory);
 
 	return RPC_SUCCESS;
 }
@@ -92,23 +158,23 @@ static rpc_status_t handle_memory_relinquish(struct ts_rpc_endpoint_sp *endpoint
 		.zero_memory = false,
 		.operation_time_slicing = false,
 	};
-	struct ts_rpc_shared_memory *memory = NULL;
+	size_t *link = NULL;
 
-	memory = find_shared_memory_descriptor(endpoint, source_id, memory_handle);
-	if (!memory) {
+	link = find_shared_memory_link(endpoint, source_id, memory_handle);
+	if (!link) {
 		EMSG("Shared memory not found");
 		return RPC_ERROR_NOT_FOUND;
 	}
 
 	endpoints[0] = endpoint->own_id;
 
-	sp_res = sp_memory_relinquish(memory->handle, endpoints, endpoint_count, &flags);
+	sp_res = sp_memory_relinquish(memory_handle, endpoints, endpoint_count, &flags);
 	if (sp_res != SP_RESULT_OK) {
 		EMSG("Failed to relinquish memory: %d", sp_res);
 		return RPC_ERROR_TRANSPORT_LAYER;
 	}
 
-	*memory = (struct ts_rpc_shared_memory){ 0 };
+	remove_shared_memory_descriptor(endpoint, link);
 
 	return RPC_SUCCESS;
 }
@@ -267,6 +333,20 @@ rpc_status_t ts_rpc_endpoint_sp_init(struct ts_rpc_endpoint_sp *endpoint, size_t
 
 	endpoint->shared_memory_count = shared_memory_count;
 
+	endpoint->shared_memory_bucket_count = 1;
+	while (endpoint->shared_memory_bucket_count < shared_memory_count)
+		endpoint->shared_memory_bucket_count <<= 1;
+
+	endpoint->shared_memory_buckets = calloc(endpoint->shared_memory_bucket_count,
+						 sizeof(size_t));
+	if (!endpoint->shared_memory_buckets) {
+		free(endpoint->shared_memories);
+		free(endpoint->services);
+		return RPC_ERROR_RESOURCE_FAILURE;
+	}
+
+	init_shared_memory_index(endpoint);
+
 	return RPC_SUCCESS;
 }
 
@@ -283,6 +363,9 @@ rpc_status_t ts_rpc_endpoint_sp_deinit(struct ts_rpc_endpoint_sp *endpoint)
 	end = memory + endpoint->shared_memory_count;
 
 	for (; memory < end; memory++) {
+		if (!memory->used)
+			continue;
+
 		status = handle_memory_relinquish(endpoint, memory->owner_id, memory->handle);
 		if (status)
 			return status;
@@ -290,6 +373,7 @@ rpc_status_t ts_rpc_endpoint_sp_deinit(struct ts_rpc_endpoint_sp *endpoint)
 
 	free(endpoint->services);
 	free(endpoint->shared_memories);
+	free(endpoint->shared_memory_buckets);
 
 	*endpoint = (struct ts_rpc_endpoint_sp){ 0 };
 
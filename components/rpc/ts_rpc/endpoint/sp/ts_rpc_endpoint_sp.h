@@ -24,7 +24,8 @@ extern "C" {
  * The structure describes an FF-A shared memory slot in the endpoint implementation. The shared
  * memory is identified by its owner (FF-A ID) and handle (FF-A memory handle). After retrieval the
  * data and size fields are filled. The used field indicates if a given memory slot of the pool is
- * used and contains valid information.
+ * used and contains valid information. The next field links the slot either into the hash chain of
+ * its (owner, handle) pair if the slot is used or into the free list otherwise.
  */
 struct ts_rpc_shared_memory {
 	uint16_t owner_id;
@@ -32,6 +33,7 @@ struct ts_rpc_shared_memory {
 	void *data;
 	size_t size;
 	bool used;
+	size_t next;
 };
 
 /**
@@ -41,7 +43,9 @@ struct ts_rpc_shared_memory {
  * messages and shared memories.
  * The structure contains the endpoint's own FF-A ID to be used in FF-A calls.
  * It also contains of list of services. These services are selected based on the interface ID of
- * the RPC request. The endpoint handles the shared memory pool.
+ * the RPC request. The endpoint handles the shared memory pool. Used shared memory slots are
+ * indexed by a hash table keyed by the (owner ID, memory handle) pair and unused slots are kept on
+ * a free list, so finding a slot doesn't depend on the pool size.
  */
 struct ts_rpc_endpoint_sp {
 	uint16_t own_id;
@@ -49,6 +53,9 @@ struct ts_rpc_endpoint_sp {
 	size_t service_count;
 	struct ts_rpc_shared_memory *shared_memories;
 	size_t shared_memory_count;
+	size_t *shared_memory_buckets;
+	size_t shared_memory_bucket_count;
+	size_t free_shared_memory;
 };
 
 /**
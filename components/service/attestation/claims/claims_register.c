@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -18,6 +18,9 @@ static struct claims_register
     size_t num_sources;
     struct claim_source *sources[CLAIMS_REGISTER_MAX_CLAIM_SOURCES];
 
+    /* Never reset so that a generation is not reused by a re-initialized register */
+    uint32_t generation;
+
 } instance;
 
 static void query_collection_by_category(struct claim *collection,
@@ -29,11 +32,13 @@ void claims_register_init(void)
 {
     instance.num_sources = 0;
     memset(instance.sources, 0, sizeof(instance.sources));
+    claims_register_notify_change();
 }
 
 void claims_register_deinit(void)
 {
     instance.num_sources = 0;
+    claims_register_notify_change();
 }
 
 void claims_register_add_claim_source(uint32_t category_map,
@@ -45,9 +50,21 @@ void claims_register_add_claim_source(uint32_t category_map,
 
         instance.sources[instance.num_sources] = source;
         ++instance.num_sources;
+
+        claims_register_notify_change();
     }
 }
 
+void claims_register_notify_change(void)
+{
+    ++instance.generation;
+}
+
+uint32_t claims_register_generation(void)
+{
+    return instance.generation;
+}
+
 void claims_register_query_by_category(enum claim_category category,
                             struct claim_vector *result)
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -61,6 +61,26 @@ void claims_register_add_claim_source(uint32_t category_map,
 void claims_register_query_by_category(enum claim_category category,
                                 struct claim_vector *result);
 
+/**
+ * \brief Notify a change of claims
+ *
+ * Claims obtained from the claims_register may be cached by a report
+ * generator.  A claim_source that provides claims that may change after
+ * it has been registered should call this when they change.  Adding
+ * a claim_source is a change.
+ */
+void claims_register_notify_change(void);
+
+/**
+ * \brief Get the generation of the registered claims
+ *
+ * The generation is changed on every change of claims.  Used by a report
+ * generator to check if claims that it has cached are still valid.
+ *
+ * \return The current generation
+ */
+uint32_t claims_register_generation(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,9 +13,17 @@
 #include <service/attestation/claims/claim.h>
 #include "eat_serializer.h"
 
+/* CBOR map head, as defined by RFC8949 */
+#define CBOR_MAJOR_TYPE_MAP             (5)
+#define CBOR_HEAD_MAX_LEN               (9)
+
 static bool alloc_encode_buffer(const struct claim_vector *device_claims,
     const struct claim_vector *sw_claims, UsefulBuf *encode_buffer);
 
+static bool decode_map_head(const uint8_t *buf, size_t len,
+    uint64_t *num_pairs, size_t *head_len);
+static size_t encode_map_head(uint8_t *buf, uint64_t num_pairs);
+
 static void encode_claim(QCBOREncodeContext *encode_ctx, const struct claim *claim);
 static int eat_label(enum claim_subject_id subject_id);
 static int qcbor_to_psa_status(QCBORError qcbor_err);
@@ -74,6 +82,69 @@ int eat_serialize(const struct claim_vector *device_claims,
     return qcbor_to_psa_status(qcbor_error);
 }
 
+int eat_serialize_with_fragment(const struct claim_vector *device_claims,
+    const uint8_t *fragment, size_t fragment_len,
+    const uint8_t **token, size_t *token_len)
+{
+    /* The token is a map with the entries of the per-report claims followed
+     * by the entries of the fragment.  The per-report claims are serialized
+     * as a map and then the map head is replaced by one that counts all entries.
+     */
+    const struct claim_vector no_sw_claims = { 0 };
+    uint64_t fragment_pairs = 0;
+    size_t fragment_head_len = 0;
+    const uint8_t *map = NULL;
+    size_t map_len = 0;
+    uint64_t map_pairs = 0;
+    size_t map_head_len = 0;
+    uint8_t head[CBOR_HEAD_MAX_LEN];
+    size_t head_len = 0;
+    size_t body_len = 0;
+    uint8_t *buf = NULL;
+    int status = PSA_ERROR_GENERIC_ERROR;
+
+    *token = NULL;
+    *token_len = 0;
+
+    if (!decode_map_head(fragment, fragment_len, &fragment_pairs, &fragment_head_len))
+        return PSA_ERROR_INVALID_ARGUMENT;
+
+    status = eat_serialize(device_claims, &no_sw_claims, &map, &map_len);
+    if (status != PSA_SUCCESS)
+        return status;
+
+    if (!decode_map_head(map, map_len, &map_pairs, &map_head_len)) {
+
+        free((void*)map);
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    head_len = encode_map_head(head, map_pairs + fragment_pairs);
+    body_len = map_len - map_head_len;
+
+    buf = malloc(head_len + body_len + fragment_len - fragment_head_len);
+
+    if (buf) {
+
+        memcpy(buf, head, head_len);
+        memcpy(&buf[head_len], &map[map_head_len], body_len);
+        memcpy(&buf[head_len + body_len], &fragment[fragment_head_len],
+            fragment_len - fragment_head_len);
+
+        *token = buf;
+        *token_len = head_len + body_len + fragment_len - fragment_head_len;
+        status = PSA_SUCCESS;
+    }
+    else {
+
+        status = PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    free((void*)map);
+
+    return status;
+}
+
 static bool alloc_encode_buffer(const struct claim_vector *device_claims,
     const struct claim_vector *sw_claims, UsefulBuf *encode_buffer)
 {
@@ -177,6 +248,64 @@ static int eat_label(enum claim_subject_id subject_id)
     return label;
 }
 
+static bool decode_map_head(const uint8_t *buf, size_t len,
+    uint64_t *num_pairs, size_t *head_len)
+{
+    uint8_t additional_info = 0;
+    size_t arg_len = 0;
+
+    if (!len || (buf[0] >> 5) != CBOR_MAJOR_TYPE_MAP)
+        return false;
+
+    /* Only definite length heads, as produced by QCBOR */
+    additional_info = buf[0] & 0x1f;
+
+    if (additional_info < 24)
+        arg_len = 0;
+    else if (additional_info <= 27)
+        arg_len = (size_t)1 << (additional_info - 24);
+    else
+        return false;
+
+    if (len < 1 + arg_len)
+        return false;
+
+    *num_pairs = (arg_len) ? 0 : additional_info;
+
+    for (size_t i = 1; i <= arg_len; ++i)
+        *num_pairs = (*num_pairs << 8) | buf[i];
+
+    *head_len = 1 + arg_len;
+
+    return true;
+}
+
+static size_t encode_map_head(uint8_t *buf, uint64_t num_pairs)
+{
+    uint8_t additional_info = 24;
+    size_t arg_len = 1;
+
+    if (num_pairs < 24) {
+
+        buf[0] = (CBOR_MAJOR_TYPE_MAP << 5) | (uint8_t)num_pairs;
+        return 1;
+    }
+
+    /* Use the shortest of the 1, 2, 4 or 8 byte arguments that holds the value */
+    while ((arg_len < sizeof(num_pairs)) && (num_pairs >> (8 * arg_len))) {
+
+        arg_len <<= 1;
+        ++additional_info;
+    }
+
+    buf[0] = (CBOR_MAJOR_TYPE_MAP << 5) | additional_info;
+
+    for (size_t i = 0; i < arg_len; ++i)
+        buf[arg_len - i] = (uint8_t)(num_pairs >> (8 * i));
+
+    return 1 + arg_len;
+}
+
 static int qcbor_to_psa_status(QCBORError qcbor_err)
 {
     if (qcbor_err == QCBOR_SUCCESS)                 return PSA_SUCCESS;
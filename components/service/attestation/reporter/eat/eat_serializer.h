@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -33,6 +33,27 @@ int eat_serialize(const struct claim_vector *device_claims,
     const struct claim_vector *sw_claims,
     const uint8_t **token, size_t *token_len);
 
+/**
+ * \brief Serialize claims with a pre-serialized fragment
+ *
+ *  Serializes per-report claims and combines them with claims that
+ *  were serialized beforehand by eat_serialize().  Allows claims
+ *  that don't change between reports to be serialized once.  The
+ *  output token is the same as if all claims were serialized by
+ *  eat_serialize(), with the per-report claims first.
+ *
+ * \param[in] device_claims         Per-report device claims
+ * \param[in] fragment              Token serialized by eat_serialize()
+ * \param[in] fragment_len          The length of the fragment
+ * \param[out] token                The serialized token
+ * \param[out] token_len            The length of the token
+ *
+ * \return Operation status
+ */
+int eat_serialize_with_fragment(const struct claim_vector *device_claims,
+    const uint8_t *fragment, size_t fragment_len,
+    const uint8_t **token, size_t *token_len);
+
 
 #ifdef __cplusplus
 } /* extern "C" */
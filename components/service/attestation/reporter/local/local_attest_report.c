@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,7 +8,9 @@
  * An attestation reporter that creates attestation reports using claims
  * collected from claim sources registered with the local claims regsiter.
  * Reports are serialized using CBOR and signed using COSE in-line with
- * EAT conventions.
+ * EAT conventions.  Claims from claim sources are serialized once and
+ * cached until the claims register reports a change.  Only the claims
+ * that are specific to a report are serialized for each report.
  */
 
 #include <stdlib.h>
@@ -24,7 +26,18 @@
 /* Local defines */
 #define MAX_DEVICE_CLAIMS       (50)
 #define MAX_SW_CLAIMS           (50)
+#define MAX_REPORT_CLAIMS       (2)
 
+/* The serialized claims from claim sources */
+static struct claims_cache
+{
+    bool is_valid;
+    uint32_t generation;
+    const uint8_t *fragment;
+    size_t fragment_len;
+} claims_cache;
+
+static int update_claims_cache(void);
 static bool validate_challenge(size_t len);
 static void add_auth_challenge_claim(struct claim_vector *v, const uint8_t *data, size_t len);
 static void add_client_id_claim(struct claim_vector *v, int32_t client_id);
@@ -36,8 +49,7 @@ int attest_report_create(int32_t client_id,
     const uint8_t **report, size_t *report_len)
 {
     psa_status_t status = PSA_ERROR_GENERIC_ERROR;
-    struct claim_vector device_claims;
-    struct claim_vector sw_claims;
+    struct claim_vector report_claims;
     psa_key_id_t key_id;
 
     *report = NULL;
@@ -48,25 +60,20 @@ int attest_report_create(int32_t client_id,
     status = attest_key_mngr_get_iak_id(&key_id);
     if (status != PSA_SUCCESS) return status;
 
-    claim_vector_init(&device_claims, MAX_DEVICE_CLAIMS);
-    claim_vector_init(&sw_claims, MAX_SW_CLAIMS);
-
-    /* Add claims related to the requester */
-    add_auth_challenge_claim(&device_claims, auth_challenge_data, auth_challenge_len);
-    add_client_id_claim(&device_claims, client_id);
+    status = update_claims_cache();
+    if (status != PSA_SUCCESS) return status;
 
-    /* Collate all other claims to include in the report */
-    claims_register_query_by_category(CLAIM_CATEGORY_DEVICE, &device_claims);
-    claims_register_query_by_category(CLAIM_CATEGORY_VERIFICATION_SERVICE, &device_claims);
-    claims_register_query_by_category(CLAIM_CATEGORY_BOOT_MEASUREMENT, &sw_claims);
+    claim_vector_init(&report_claims, MAX_REPORT_CLAIMS);
 
-    /* And if there aren't any sw claims, indicate in report */
-    if (!sw_claims.size) add_no_sw_claim(&device_claims);
+    /* Add claims related to the requester */
+    add_auth_challenge_claim(&report_claims, auth_challenge_data, auth_challenge_len);
+    add_client_id_claim(&report_claims, client_id);
 
     /* Serialize and sign the collated claims to create the final EAT token */
     const uint8_t *unsigned_token = NULL;
     size_t unsigned_token_len = 0;
-    status = eat_serialize(&device_claims, &sw_claims,
+    status = eat_serialize_with_fragment(&report_claims,
+                    claims_cache.fragment, claims_cache.fragment_len,
                     &unsigned_token, &unsigned_token_len);
 
     if (status == PSA_SUCCESS) {
@@ -77,8 +84,7 @@ int attest_report_create(int32_t client_id,
 
     /* Free resource used */
     free((void*)unsigned_token);
-    claim_vector_deinit(&device_claims);
-    claim_vector_deinit(&sw_claims);
+    claim_vector_deinit(&report_claims);
 
     return status;
 }
@@ -88,6 +94,46 @@ void attest_report_destroy(const uint8_t *report)
     free((void*)report);
 }
 
+static int update_claims_cache(void)
+{
+    psa_status_t status = PSA_ERROR_GENERIC_ERROR;
+    struct claim_vector device_claims;
+    struct claim_vector sw_claims;
+    uint32_t generation = claims_register_generation();
+
+    if (claims_cache.is_valid && (claims_cache.generation == generation))
+        return PSA_SUCCESS;
+
+    free((void*)claims_cache.fragment);
+    claims_cache.is_valid = false;
+    claims_cache.fragment = NULL;
+    claims_cache.fragment_len = 0;
+
+    claim_vector_init(&device_claims, MAX_DEVICE_CLAIMS);
+    claim_vector_init(&sw_claims, MAX_SW_CLAIMS);
+
+    /* Collate all claims from claim sources */
+    claims_register_query_by_category(CLAIM_CATEGORY_DEVICE, &device_claims);
+    claims_register_query_by_category(CLAIM_CATEGORY_VERIFICATION_SERVICE, &device_claims);
+    claims_register_query_by_category(CLAIM_CATEGORY_BOOT_MEASUREMENT, &sw_claims);
+
+    /* And if there aren't any sw claims, indicate in report */
+    if (!sw_claims.size) add_no_sw_claim(&device_claims);
+
+    status = eat_serialize(&device_claims, &sw_claims,
+                    &claims_cache.fragment, &claims_cache.fragment_len);
+
+    if (status == PSA_SUCCESS) {
+        claims_cache.is_valid = true;
+        claims_cache.generation = generation;
+    }
+
+    claim_vector_deinit(&device_claims);
+    claim_vector_deinit(&sw_claims);
+
+    return status;
+}
+
 static bool validate_challenge(size_t len)
 {
     /* Only allow specific challenge lengths */
@@ -1,11 +1,14 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <cstring>
+#include <vector>
 #include <psa/error.h>
 #include <psa/crypto.h>
+#include <psa/initial_attestation.h>
 #include <psa/lifecycle.h>
 #include <qcbor/qcbor_spiffy_decode.h>
 #include <t_cose/t_cose_sign1_verify.h>
@@ -66,6 +69,41 @@ TEST_GROUP(AttestationReporterTests)
         local_attest_key_mngr_deinit();
     }
 
+    /* Creates a report and returns its verified body */
+    std::vector<uint8_t> create_report_body(int32_t client_id,
+        const uint8_t *auth_challenge, size_t auth_challenge_len)
+    {
+        psa_key_id_t iak_id;
+        LONGS_EQUAL(PSA_SUCCESS, attest_key_mngr_get_iak_id(&iak_id));
+
+        attest_report_destroy(report);
+        report = NULL;
+
+        LONGS_EQUAL(PSA_SUCCESS, attest_report_create(client_id,
+            auth_challenge, auth_challenge_len, &report, &report_len));
+
+        struct t_cose_sign1_verify_ctx verify_ctx;
+        struct t_cose_key key_pair;
+
+        key_pair.k.key_handle = iak_id;
+        key_pair.crypto_lib = T_COSE_CRYPTO_LIB_PSA;
+        UsefulBufC signed_cose;
+        UsefulBufC report_body;
+
+        signed_cose.ptr = report;
+        signed_cose.len = report_len;
+
+        t_cose_sign1_verify_init(&verify_ctx, 0);
+        t_cose_sign1_set_verification_key(&verify_ctx, key_pair);
+
+        LONGS_EQUAL(T_COSE_SUCCESS, t_cose_sign1_verify(&verify_ctx, signed_cose,
+            &report_body, NULL));
+
+        const uint8_t *body = (const uint8_t*)report_body.ptr;
+
+        return std::vector<uint8_t>(body, body + report_body.len);
+    }
+
     struct event_log_claim_source event_log_claim_source;
     struct boot_seed_generator boot_seed_claim_source;
     struct null_lifecycle_claim_source lifecycle_claim_source;
@@ -234,3 +272,35 @@ TEST(AttestationReporterTests, createReport)
     qcbor_error = QCBORDecode_Finish(&decode_ctx);
     LONGS_EQUAL(QCBOR_SUCCESS, qcbor_error);
 }
+
+TEST(AttestationReporterTests, cachedClaimsReport)
+{
+    const uint8_t auth_challenge[PSA_INITIAL_ATTEST_CHALLENGE_SIZE_32] = { 0x5c };
+
+    /* The first report collates the claims, the second uses the cached claims */
+    std::vector<uint8_t> collated_body =
+        create_report_body(0x552791aa, auth_challenge, sizeof(auth_challenge));
+    std::vector<uint8_t> cached_body =
+        create_report_body(0x552791aa, auth_challenge, sizeof(auth_challenge));
+
+    /* A change of claims causes the claims to be collated again */
+    claims_register_notify_change();
+
+    std::vector<uint8_t> recollated_body =
+        create_report_body(0x552791aa, auth_challenge, sizeof(auth_challenge));
+
+    /* Expect the same report body whether claims are cached or not */
+    CHECK_TRUE(!collated_body.empty());
+    UNSIGNED_LONGS_EQUAL(collated_body.size(), cached_body.size());
+    MEMCMP_EQUAL(collated_body.data(), cached_body.data(), collated_body.size());
+    UNSIGNED_LONGS_EQUAL(collated_body.size(), recollated_body.size());
+    MEMCMP_EQUAL(collated_body.data(), recollated_body.data(), collated_body.size());
+
+    /* Expect per-report claims to differ when taken from the cache */
+    std::vector<uint8_t> other_client_body =
+        create_report_body(0x11223344, auth_challenge, sizeof(auth_challenge));
+
+    UNSIGNED_LONGS_EQUAL(collated_body.size(), other_client_body.size());
+    CHECK_TRUE(memcmp(collated_body.data(), other_client_body.data(),
+        collated_body.size()) != 0);
+}
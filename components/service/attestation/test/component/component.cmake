@@ -10,4 +10,5 @@ endif()
 
 target_sources(${TGT} PRIVATE
 	"${CMAKE_CURRENT_LIST_DIR}/attestation_reporter_tests.cpp"
+	"${CMAKE_CURRENT_LIST_DIR}/eat_serializer_tests.cpp"
 	)
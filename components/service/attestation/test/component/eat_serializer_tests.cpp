@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstdlib>
+#include <psa/error.h>
+#include <qcbor/qcbor_decode.h>
+#include <service/attestation/claims/claim_vector.h>
+#include <service/attestation/reporter/eat/eat_serializer.h>
+#include <CppUTest/TestHarness.h>
+
+/*
+ * Checks that a token serialized from per-report claims and a fragment is
+ * byte-identical to the token serialized from all claims in one go.
+ */
+TEST_GROUP(EatSerializerTests)
+{
+    void add_integer_claims(struct claim_vector *v, size_t count, int32_t first_value)
+    {
+        for (size_t i = 0; i < count; ++i) {
+
+            struct claim claim = { };
+
+            claim.category = CLAIM_CATEGORY_DEVICE;
+            claim.subject_id = CLAIM_SUBJECT_ID_CLIENT_ID;
+            claim.variant_id = CLAIM_VARIANT_ID_INTEGER;
+            claim.variant.integer.value = first_value + (int32_t)i;
+
+            claim_vector_push_back(v, &claim);
+        }
+    }
+
+    void add_sw_claims(struct claim_vector *v, size_t count)
+    {
+        static const uint8_t digest[32] = { 0xd1, 0x6e, 0x57 };
+
+        for (size_t i = 0; i < count; ++i) {
+
+            struct claim claim = { };
+
+            claim.category = CLAIM_CATEGORY_BOOT_MEASUREMENT;
+            claim.subject_id = CLAIM_SUBJECT_ID_SW_COMPONENT;
+            claim.variant_id = CLAIM_VARIANT_ID_MEASUREMENT;
+            claim.variant.measurement.id.string = "BL_2";
+            claim.variant.measurement.digest.bytes = digest;
+            claim.variant.measurement.digest.len = sizeof(digest);
+
+            claim_vector_push_back(v, &claim);
+        }
+    }
+
+    void check_fragment_serialization(size_t num_report_claims,
+        size_t num_fragment_claims, size_t num_sw_claims)
+    {
+        struct claim_vector report_claims;
+        struct claim_vector fragment_claims;
+        struct claim_vector all_claims;
+        struct claim_vector sw_claims;
+        const uint8_t *fragment = NULL;
+        size_t fragment_len = 0;
+        const uint8_t *expected = NULL;
+        size_t expected_len = 0;
+        const uint8_t *token = NULL;
+        size_t token_len = 0;
+
+        claim_vector_init(&report_claims, num_report_claims);
+        claim_vector_init(&fragment_claims, num_fragment_claims);
+        claim_vector_init(&all_claims, num_report_claims + num_fragment_claims);
+        claim_vector_init(&sw_claims, num_sw_claims);
+
+        /* Per-report claims come first in the combined token */
+        add_integer_claims(&report_claims, num_report_claims, 1000);
+        add_integer_claims(&fragment_claims, num_fragment_claims, 2000);
+        add_integer_claims(&all_claims, num_report_claims, 1000);
+        add_integer_claims(&all_claims, num_fragment_claims, 2000);
+        add_sw_claims(&sw_claims, num_sw_claims);
+
+        LONGS_EQUAL(PSA_SUCCESS, eat_serialize(&all_claims, &sw_claims,
+            &expected, &expected_len));
+        LONGS_EQUAL(PSA_SUCCESS, eat_serialize(&fragment_claims, &sw_claims,
+            &fragment, &fragment_len));
+        LONGS_EQUAL(PSA_SUCCESS, eat_serialize_with_fragment(&report_claims,
+            fragment, fragment_len, &token, &token_len));
+
+        UNSIGNED_LONGS_EQUAL(expected_len, token_len);
+        MEMCMP_EQUAL(expected, token, token_len);
+
+        /* Expect the combined map head to count every entry */
+        QCBORDecodeContext decode_ctx;
+        QCBORItem item;
+        UsefulBufC encoded;
+
+        encoded.ptr = token;
+        encoded.len = token_len;
+
+        QCBORDecode_Init(&decode_ctx, encoded, QCBOR_DECODE_MODE_NORMAL);
+        LONGS_EQUAL(QCBOR_SUCCESS, QCBORDecode_GetNext(&decode_ctx, &item));
+        LONGS_EQUAL(QCBOR_TYPE_MAP, item.uDataType);
+        UNSIGNED_LONGS_EQUAL(num_report_claims + num_fragment_claims + (num_sw_claims ? 1 : 0),
+            item.val.uCount);
+
+        free((void*)token);
+        free((void*)fragment);
+        free((void*)expected);
+
+        claim_vector_deinit(&report_claims);
+        claim_vector_deinit(&fragment_claims);
+        claim_vector_deinit(&all_claims);
+        claim_vector_deinit(&sw_claims);
+    }
+};
+
+TEST(EatSerializerTests, fragmentWithSingleByteMapHeads)
+{
+    check_fragment_serialization(2, 5, 1);
+    check_fragment_serialization(2, 20, 1);
+}
+
+TEST(EatSerializerTests, fragmentWithMultiByteMapHeads)
+{
+    /* The combined map needs a multi-byte head although the parts don't */
+    check_fragment_serialization(2, 21, 1);
+    check_fragment_serialization(2, 22, 0);
+
+    /* Both the fragment and the combined map have multi-byte heads */
+    check_fragment_serialization(2, 30, 1);
+    check_fragment_serialization(1, 255, 0);
+    check_fragment_serialization(2, 300, 1);
+}
@@ -105,3 +105,169 @@ psa_status_t block_store_erase(struct block_store *block_store,
 		begin_lba,
 		num_blocks);
 }
+
+psa_status_t block_store_read_blocks(struct block_store *block_store,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	assert(block_store);
+	assert(block_store->interface);
+
+	/* Fall back to a single block read if multi-block reads aren't supported */
+	if (!block_store->interface->read_blocks)
+		return block_store_read(block_store, client_id, handle,
+			lba, offset, buffer_size, buffer, data_len);
+
+	return block_store->interface->read_blocks(block_store->context,
+		client_id,
+		handle,
+		lba,
+		offset,
+		buffer_size,
+		buffer,
+		data_len);
+}
+
+psa_status_t block_store_write_blocks(struct block_store *block_store,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	assert(block_store);
+	assert(block_store->interface);
+
+	/* Fall back to a single block write if multi-block writes aren't supported */
+	if (!block_store->interface->write_blocks)
+		return block_store_write(block_store, client_id, handle,
+			lba, offset, data, data_len, num_written);
+
+	return block_store->interface->write_blocks(block_store->context,
+		client_id,
+		handle,
+		lba,
+		offset,
+		data,
+		data_len,
+		num_written);
+}
+
+psa_status_t block_store_read_vec(struct block_store *block_store,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	const struct block_store_range *ranges,
+	size_t num_ranges,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	psa_status_t status = PSA_ERROR_NOT_SUPPORTED;
+	size_t total_len = 0;
+
+	assert(block_store);
+	assert(block_store->interface);
+
+	if (block_store->interface->read_vec) {
+
+		status = block_store->interface->read_vec(block_store->context,
+			client_id,
+			handle,
+			ranges,
+			num_ranges,
+			buffer_size,
+			buffer,
+			data_len);
+
+		if (status != PSA_ERROR_NOT_SUPPORTED)
+			return status;
+	}
+
+	/* Read each range in turn, stopping at the first short read */
+	status = PSA_SUCCESS;
+
+	for (size_t i = 0; i < num_ranges; ++i) {
+
+		size_t range_len = (ranges[i].len < buffer_size - total_len) ?
+			ranges[i].len : buffer_size - total_len;
+		size_t read_len = 0;
+
+		status = block_store_read_blocks(block_store, client_id, handle,
+			ranges[i].lba, ranges[i].offset, range_len, &buffer[total_len], &read_len);
+
+		if (status != PSA_SUCCESS)
+			break;
+
+		total_len += read_len;
+
+		if (read_len != ranges[i].len)
+			break;
+	}
+
+	*data_len = total_len;
+
+	return status;
+}
+
+psa_status_t block_store_write_vec(struct block_store *block_store,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	const struct block_store_range *ranges,
+	size_t num_ranges,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	psa_status_t status = PSA_ERROR_NOT_SUPPORTED;
+	size_t total_len = 0;
+
+	assert(block_store);
+	assert(block_store->interface);
+
+	if (block_store->interface->write_vec) {
+
+		status = block_store->interface->write_vec(block_store->context,
+			client_id,
+			handle,
+			ranges,
+			num_ranges,
+			data,
+			data_len,
+			num_written);
+
+		if (status != PSA_ERROR_NOT_SUPPORTED)
+			return status;
+	}
+
+	/* Write each range in turn, stopping at the first short write */
+	status = PSA_SUCCESS;
+
+	for (size_t i = 0; i < num_ranges; ++i) {
+
+		size_t range_len = (ranges[i].len < data_len - total_len) ?
+			ranges[i].len : data_len - total_len;
+		size_t write_len = 0;
+
+		status = block_store_write_blocks(block_store, client_id, handle,
+			ranges[i].lba, ranges[i].offset, &data[total_len], range_len, &write_len);
+
+		if (status != PSA_SUCCESS)
+			break;
+
+		total_len += write_len;
+
+		if (write_len != ranges[i].len)
+			break;
+	}
+
+	*num_written = total_len;
+
+	return status;
+}
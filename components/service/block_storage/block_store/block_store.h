@@ -49,6 +49,24 @@ struct storage_partition_info
 	struct uuid_octets parent_guid;
 };
 
+/**
+ * \brief A range of storage accessed by a vectored operation
+ *
+ * A range starts at an offset into the block identified by lba and may span
+ * the blocks that follow it.
+ */
+struct block_store_range
+{
+	/* The logical block address of the first block */
+	uint64_t lba;
+
+	/* Offset into the first block */
+	size_t offset;
+
+	/* Number of bytes to transfer */
+	size_t len;
+};
+
 /**
  * \brief Base block_store interface
  *
@@ -188,6 +206,130 @@ struct block_store_interface
 		storage_partition_handle_t handle,
 		uint64_t begin_lba,
 		size_t num_blocks);
+
+	/**
+	 * \brief Read from a run of contiguous blocks
+	 *
+	 * Optional operation. Like read but the read may continue beyond the end of the
+	 * block at lba into the blocks that follow it. A concrete block_store may return
+	 * fewer bytes than requested, for example when the end of the partition is reached or
+	 * when a transport limits the transfer size, so callers should continue from where the
+	 * read stopped. If not implemented, the base read is used.
+	 *
+	 * \param[in]  context         The concrete block_store context
+	 * \param[in]  client_id       The requesting client ID
+	 * \param[in]  handle          The handle corresponding to the open storage partition
+	 * \param[in]  lba             The logical block address of the first block
+	 * \param[in]  offset          Offset into the first block at which to begin reading
+	 * \param[in]  buffer_size     The size of the client provided buffer
+	 * \param[in]  buffer          The buffer to land read data into
+	 * \param[out] data_len        The number of bytes read.
+	 *
+	 * \return A status indicating whether the operation succeeded or not.
+	 *
+	 * \retval PSA_SUCCESS                     Operation completed successfully
+	 * \retval PSA_ERROR_INVALID_ARGUMENT      Invalid parameter e.g. LBA is invalid
+	 */
+	psa_status_t (*read_blocks)(void *context,
+		uint32_t client_id,
+		storage_partition_handle_t handle,
+		uint64_t lba,
+		size_t offset,
+		size_t buffer_size,
+		uint8_t *buffer,
+		size_t *data_len);
+
+	/**
+	 * \brief Write to a run of contiguous blocks
+	 *
+	 * Optional operation. Like write but the write may continue beyond the end of the
+	 * block at lba into the blocks that follow it. As for read_blocks, fewer bytes than
+	 * requested may be written. If not implemented, the base write is used.
+	 *
+	 * \param[in]  context         The concrete block_store context
+	 * \param[in]  client_id       The requesting client ID
+	 * \param[in]  handle          The handle corresponding to the open storage partition
+	 * \param[in]  lba             The logical block address of the first block
+	 * \param[in]  offset          Offset into the first block at which to begin writing
+	 * \param[in]  data            The data to write
+	 * \param[in]  data_len        The number of bytes to write.
+	 * \param[out] num_written     The number of bytes written.
+	 *
+	 * \return A status indicating whether the operation succeeded or not.
+	 *
+	 * \retval PSA_SUCCESS                     Operation completed successfully
+	 * \retval PSA_ERROR_INVALID_ARGUMENT      Invalid parameter e.g. LBA is invalid
+	 */
+	psa_status_t (*write_blocks)(void *context,
+		uint32_t client_id,
+		storage_partition_handle_t handle,
+		uint64_t lba,
+		size_t offset,
+		const uint8_t *data,
+		size_t data_len,
+		size_t *num_written);
+
+	/**
+	 * \brief Read from a list of ranges
+	 *
+	 * Optional operation. Reads each range in turn, packing the data for each range
+	 * into the buffer in order. Reading stops at the first range that can't be read
+	 * in full so data_len identifies how many ranges were read. If not implemented,
+	 * or if PSA_ERROR_NOT_SUPPORTED is returned, each range is read using read_blocks.
+	 *
+	 * \param[in]  context         The concrete block_store context
+	 * \param[in]  client_id       The requesting client ID
+	 * \param[in]  handle          The handle corresponding to the open storage partition
+	 * \param[in]  ranges          The ranges to read
+	 * \param[in]  num_ranges      The number of ranges
+	 * \param[in]  buffer_size     The size of the client provided buffer
+	 * \param[in]  buffer          The buffer to land read data into
+	 * \param[out] data_len        The number of bytes read.
+	 *
+	 * \return A status indicating whether the operation succeeded or not.
+	 *
+	 * \retval PSA_SUCCESS                     Operation completed successfully
+	 * \retval PSA_ERROR_INVALID_ARGUMENT      Invalid parameter e.g. LBA is invalid
+	 */
+	psa_status_t (*read_vec)(void *context,
+		uint32_t client_id,
+		storage_partition_handle_t handle,
+		const struct block_store_range *ranges,
+		size_t num_ranges,
+		size_t buffer_size,
+		uint8_t *buffer,
+		size_t *data_len);
+
+	/**
+	 * \brief Write to a list of ranges
+	 *
+	 * Optional operation. Writes each range in turn, taking the data for each range
+	 * from the data buffer in order. Writing stops at the first range that can't be
+	 * written in full. If not implemented, or if PSA_ERROR_NOT_SUPPORTED is returned,
+	 * each range is written using write_blocks.
+	 *
+	 * \param[in]  context         The concrete block_store context
+	 * \param[in]  client_id       The requesting client ID
+	 * \param[in]  handle          The handle corresponding to the open storage partition
+	 * \param[in]  ranges          The ranges to write
+	 * \param[in]  num_ranges      The number of ranges
+	 * \param[in]  data            The data to write
+	 * \param[in]  data_len        The number of bytes to write.
+	 * \param[out] num_written     The number of bytes written.
+	 *
+	 * \return A status indicating whether the operation succeeded or not.
+	 *
+	 * \retval PSA_SUCCESS                     Operation completed successfully
+	 * \retval PSA_ERROR_INVALID_ARGUMENT      Invalid parameter e.g. LBA is invalid
+	 */
+	psa_status_t (*write_vec)(void *context,
+		uint32_t client_id,
+		storage_partition_handle_t handle,
+		const struct block_store_range *ranges,
+		size_t num_ranges,
+		const uint8_t *data,
+		size_t data_len,
+		size_t *num_written);
 };
 
 /**
@@ -255,6 +397,42 @@ psa_status_t block_store_erase(struct block_store *block_store,
 	uint64_t begin_lba,
 	size_t num_blocks);
 
+psa_status_t block_store_read_blocks(struct block_store *block_store,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len);
+
+psa_status_t block_store_write_blocks(struct block_store *block_store,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written);
+
+psa_status_t block_store_read_vec(struct block_store *block_store,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	const struct block_store_range *ranges,
+	size_t num_ranges,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len);
+
+psa_status_t block_store_write_vec(struct block_store *block_store,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	const struct block_store_range *ranges,
+	size_t num_ranges,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,645 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "cached_block_store.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHED_BLOCK_STORE_PARTITION_HANDLE (0)
+#define NO_ENTRY (SIZE_MAX)
+
+static uint8_t *entry_data(const struct cached_block_store *this_instance, size_t index)
+{
+	return &this_instance->cache_buf[index * this_instance->storage_partition.block_size];
+}
+
+static void unlink_entry(struct cached_block_store *this_instance, size_t index)
+{
+	struct cached_block_store_entry *entry = &this_instance->entries[index];
+
+	if (entry->prev != NO_ENTRY)
+		this_instance->entries[entry->prev].next = entry->next;
+	else
+		this_instance->mru_entry = entry->next;
+
+	if (entry->next != NO_ENTRY)
+		this_instance->entries[entry->next].prev = entry->prev;
+	else
+		this_instance->lru_entry = entry->prev;
+}
+
+static void link_as_mru(struct cached_block_store *this_instance, size_t index)
+{
+	struct cached_block_store_entry *entry = &this_instance->entries[index];
+
+	entry->prev = NO_ENTRY;
+	entry->next = this_instance->mru_entry;
+
+	if (this_instance->mru_entry != NO_ENTRY)
+		this_instance->entries[this_instance->mru_entry].prev = index;
+	else
+		this_instance->lru_entry = index;
+
+	this_instance->mru_entry = index;
+}
+
+static void link_as_lru(struct cached_block_store *this_instance, size_t index)
+{
+	struct cached_block_store_entry *entry = &this_instance->entries[index];
+
+	entry->prev = this_instance->lru_entry;
+	entry->next = NO_ENTRY;
+
+	if (this_instance->lru_entry != NO_ENTRY)
+		this_instance->entries[this_instance->lru_entry].next = index;
+	else
+		this_instance->mru_entry = index;
+
+	this_instance->lru_entry = index;
+}
+
+static size_t find_entry(const struct cached_block_store *this_instance, uint64_t lba)
+{
+	/* Valid entries precede invalid ones so the search can stop at the first invalid entry */
+	size_t index = this_instance->mru_entry;
+
+	while ((index != NO_ENTRY) && this_instance->entries[index].is_valid) {
+		if (this_instance->entries[index].lba == lba)
+			return index;
+
+		index = this_instance->entries[index].next;
+	}
+
+	return NO_ENTRY;
+}
+
+static void invalidate_entry(struct cached_block_store *this_instance, size_t index)
+{
+	this_instance->entries[index].is_valid = false;
+	this_instance->entries[index].is_dirty = false;
+
+	unlink_entry(this_instance, index);
+	link_as_lru(this_instance, index);
+}
+
+static psa_status_t write_back_entry(struct cached_block_store *this_instance, size_t index)
+{
+	struct cached_block_store_entry *entry = &this_instance->entries[index];
+	size_t num_written = 0;
+	psa_status_t status = PSA_SUCCESS;
+
+	if (entry->is_valid && entry->is_dirty) {
+		size_t dirty_len = entry->dirty_end - entry->dirty_begin;
+
+		status = block_store_write(this_instance->back_store,
+					   this_instance->local_client_id,
+					   this_instance->back_store_handle, entry->lba,
+					   entry->dirty_begin,
+					   &entry_data(this_instance, index)[entry->dirty_begin],
+					   dirty_len, &num_written);
+
+		if ((status == PSA_SUCCESS) && (num_written != dirty_len))
+			status = PSA_ERROR_STORAGE_FAILURE;
+
+		if (status == PSA_SUCCESS)
+			entry->is_dirty = false;
+	}
+
+	return status;
+}
+
+static psa_status_t mark_dirty(struct cached_block_store *this_instance, size_t index,
+			       size_t offset, size_t len)
+{
+	/* Only bytes written by clients are written back as the back store may not allow
+	 * already written bytes to be written again. A write that isn't contiguous with
+	 * the dirty range writes the range back first so the gap between them isn't
+	 * written.
+	 */
+	struct cached_block_store_entry *entry = &this_instance->entries[index];
+
+	if (entry->is_dirty &&
+	    ((offset > entry->dirty_end) || (offset + len < entry->dirty_begin))) {
+		psa_status_t status = write_back_entry(this_instance, index);
+
+		if (status != PSA_SUCCESS)
+			return status;
+	}
+
+	if (entry->is_dirty) {
+		if (offset < entry->dirty_begin)
+			entry->dirty_begin = offset;
+
+		if (offset + len > entry->dirty_end)
+			entry->dirty_end = offset + len;
+	} else {
+		entry->dirty_begin = offset;
+		entry->dirty_end = offset + len;
+		entry->is_dirty = true;
+	}
+
+	return PSA_SUCCESS;
+}
+
+static psa_status_t allocate_entry(struct cached_block_store *this_instance, uint64_t lba,
+				   bool fill, size_t *index)
+{
+	/* Reuse the least recently used entry */
+	size_t victim = this_instance->lru_entry;
+	size_t block_size = this_instance->storage_partition.block_size;
+	psa_status_t status = write_back_entry(this_instance, victim);
+
+	if (status != PSA_SUCCESS)
+		return status;
+
+	this_instance->entries[victim].is_valid = false;
+
+	if (fill) {
+		size_t data_len = 0;
+
+		status = block_store_read(this_instance->back_store,
+					  this_instance->local_client_id,
+					  this_instance->back_store_handle, lba, 0, block_size,
+					  entry_data(this_instance, victim), &data_len);
+
+		/* Only whole blocks are cached */
+		if ((status == PSA_SUCCESS) && (data_len != block_size))
+			status = PSA_ERROR_INSUFFICIENT_DATA;
+
+		if (status != PSA_SUCCESS)
+			return status;
+	}
+
+	this_instance->entries[victim].lba = lba;
+	this_instance->entries[victim].is_valid = true;
+	this_instance->entries[victim].is_dirty = false;
+
+	unlink_entry(this_instance, victim);
+	link_as_mru(this_instance, victim);
+
+	*index = victim;
+
+	return PSA_SUCCESS;
+}
+
+static bool lookup_block(struct cached_block_store *this_instance, uint64_t lba, bool allocate,
+			 bool fill, size_t *index)
+{
+	size_t found = find_entry(this_instance, lba);
+
+	if (found != NO_ENTRY) {
+		++this_instance->stats.hits;
+
+		unlink_entry(this_instance, found);
+		link_as_mru(this_instance, found);
+
+		*index = found;
+		return true;
+	}
+
+	++this_instance->stats.misses;
+
+	return allocate && (allocate_entry(this_instance, lba, fill, index) == PSA_SUCCESS);
+}
+
+static size_t uncached_run_length(struct cached_block_store *this_instance, uint64_t lba,
+				  size_t first_len, size_t max_len)
+{
+	/* Extend a direct transfer over following blocks that aren't cached */
+	size_t block_size = this_instance->storage_partition.block_size;
+	size_t run_len = first_len;
+
+	while ((run_len < max_len) && (find_entry(this_instance, ++lba) == NO_ENTRY)) {
+		size_t remaining_len = max_len - run_len;
+
+		run_len += (remaining_len < block_size) ? remaining_len : block_size;
+		++this_instance->stats.misses;
+	}
+
+	return run_len;
+}
+
+static psa_status_t validate_request(const struct cached_block_store *this_instance,
+				     uint32_t client_id, storage_partition_handle_t handle)
+{
+	if (handle != CACHED_BLOCK_STORE_PARTITION_HANDLE)
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	if (!storage_partition_is_access_permitted(&this_instance->storage_partition, client_id))
+		return PSA_ERROR_NOT_PERMITTED;
+
+	return PSA_SUCCESS;
+}
+
+static size_t transfer_limit(const struct storage_partition *storage_partition, uint64_t lba,
+			     size_t offset, size_t requested_len, bool multi_block)
+{
+	size_t max_len = storage_partition->block_size - offset;
+
+	/* Single block transfers stop at the end of the block, multi-block at the partition end */
+	if (multi_block)
+		return storage_partition_clip_length(storage_partition, lba, offset,
+						     requested_len);
+
+	return (requested_len < max_len) ? requested_len : max_len;
+}
+
+static psa_status_t cached_block_store_get_partition_info(void *context,
+							  const struct uuid_octets *partition_guid,
+							  struct storage_partition_info *info)
+{
+	struct cached_block_store *this_instance = (struct cached_block_store *)context;
+
+	if (!storage_partition_is_guid_matched(&this_instance->storage_partition, partition_guid))
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	*info = this_instance->back_store_info;
+
+	return PSA_SUCCESS;
+}
+
+static psa_status_t cached_block_store_open(void *context, uint32_t client_id,
+					    const struct uuid_octets *partition_guid,
+					    storage_partition_handle_t *handle)
+{
+	struct cached_block_store *this_instance = (struct cached_block_store *)context;
+
+	if (!storage_partition_is_guid_matched(&this_instance->storage_partition, partition_guid))
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	if (!storage_partition_is_open_permitted(&this_instance->storage_partition, client_id,
+						 this_instance->authorizer))
+		return PSA_ERROR_NOT_PERMITTED;
+
+	*handle = CACHED_BLOCK_STORE_PARTITION_HANDLE;
+
+	return PSA_SUCCESS;
+}
+
+static psa_status_t cached_block_store_close(void *context, uint32_t client_id,
+					     storage_partition_handle_t handle)
+{
+	struct cached_block_store *this_instance = (struct cached_block_store *)context;
+
+	psa_status_t status = validate_request(this_instance, client_id, handle);
+
+	if (status == PSA_SUCCESS)
+		status = cached_block_store_flush(this_instance);
+
+	return status;
+}
+
+static psa_status_t read_data(void *context, uint32_t client_id,
+			      storage_partition_handle_t handle, uint64_t lba, size_t offset,
+			      size_t buffer_size, uint8_t *buffer, size_t *data_len,
+			      bool multi_block)
+{
+	struct cached_block_store *this_instance = (struct cached_block_store *)context;
+	const struct storage_partition *storage_partition = &this_instance->storage_partition;
+	size_t block_size = storage_partition->block_size;
+
+	psa_status_t status = validate_request(this_instance, client_id, handle);
+
+	*data_len = 0;
+
+	if (status != PSA_SUCCESS)
+		return status;
+
+	if (!storage_partition_is_lba_legal(storage_partition, lba) || (offset >= block_size))
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	size_t max_len = transfer_limit(storage_partition, lba, offset, buffer_size, multi_block);
+	size_t total = 0;
+
+	while (total < max_len) {
+		uint64_t block_lba = lba + (offset + total) / block_size;
+		size_t block_offset = (offset + total) % block_size;
+		size_t remaining_len = max_len - total;
+		size_t len = (remaining_len < block_size - block_offset) ? remaining_len :
+									    block_size - block_offset;
+		size_t index = 0;
+
+		if (lookup_block(this_instance, block_lba, !multi_block, true, &index)) {
+			memcpy(&buffer[total], &entry_data(this_instance, index)[block_offset], len);
+			total += len;
+			continue;
+		}
+
+		/* Not cached so read directly from the back store */
+		size_t run_len = uncached_run_length(this_instance, block_lba, len, remaining_len);
+		size_t run_data_len = 0;
+
+		if (multi_block)
+			status = block_store_read_blocks(this_instance->back_store,
+							 this_instance->local_client_id,
+							 this_instance->back_store_handle,
+							 block_lba, block_offset, run_len,
+							 &buffer[total], &run_data_len);
+		else
+			status = block_store_read(this_instance->back_store,
+						  this_instance->local_client_id,
+						  this_instance->back_store_handle, block_lba,
+						  block_offset, run_len, &buffer[total],
+						  &run_data_len);
+
+		if (status != PSA_SUCCESS)
+			break;
+
+		total += run_data_len;
+
+		if (run_data_len < run_len)
+			break;
+	}
+
+	*data_len = total;
+
+	/* A short multi-block read is reported as successful */
+	return (total) ? PSA_SUCCESS : status;
+}
+
+static psa_status_t write_data(void *context, uint32_t client_id,
+			       storage_partition_handle_t handle, uint64_t lba, size_t offset,
+			       const uint8_t *data, size_t data_len, size_t *num_written,
+			       bool multi_block)
+{
+	struct cached_block_store *this_instance = (struct cached_block_store *)context;
+	const struct storage_partition *storage_partition = &this_instance->storage_partition;
+	size_t block_size = storage_partition->block_size;
+	bool is_write_back = (this_instance->write_policy == CACHED_BLOCK_STORE_WRITE_BACK);
+
+	psa_status_t status = validate_request(this_instance, client_id, handle);
+
+	*num_written = 0;
+
+	if (status != PSA_SUCCESS)
+		return status;
+
+	if (!storage_partition_is_lba_legal(storage_partition, lba) || (offset >= block_size))
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	size_t max_len = transfer_limit(storage_partition, lba, offset, data_len, multi_block);
+	size_t total = 0;
+
+	while (total < max_len) {
+		uint64_t block_lba = lba + (offset + total) / block_size;
+		size_t block_offset = (offset + total) % block_size;
+		size_t remaining_len = max_len - total;
+		size_t len = (remaining_len < block_size - block_offset) ? remaining_len :
+									    block_size - block_offset;
+		size_t index = 0;
+
+		/* Write-back allocates on single block writes. A whole block write doesn't
+		 * need the existing block contents.
+		 */
+		if (lookup_block(this_instance, block_lba, is_write_back && !multi_block,
+				 len != block_size, &index)) {
+			size_t block_written = len;
+
+			if (is_write_back) {
+				status = mark_dirty(this_instance, index, block_offset, len);
+
+				if (status != PSA_SUCCESS)
+					break;
+			} else {
+				status = block_store_write(this_instance->back_store,
+							   this_instance->local_client_id,
+							   this_instance->back_store_handle,
+							   block_lba, block_offset, &data[total],
+							   len, &block_written);
+
+				if (status != PSA_SUCCESS)
+					break;
+			}
+
+			memcpy(&entry_data(this_instance, index)[block_offset], &data[total],
+			       block_written);
+			total += block_written;
+
+			if (block_written < len)
+				break;
+
+			continue;
+		}
+
+		/* Not cached so write directly to the back store */
+		size_t run_len = uncached_run_length(this_instance, block_lba, len, remaining_len);
+		size_t run_written = 0;
+
+		if (multi_block)
+			status = block_store_write_blocks(this_instance->back_store,
+							  this_instance->local_client_id,
+							  this_instance->back_store_handle,
+							  block_lba, block_offset, &data[total],
+							  run_len, &run_written);
+		else
+			status = block_store_write(this_instance->back_store,
+						   this_instance->local_client_id,
+						   this_instance->back_store_handle, block_lba,
+						   block_offset, &data[total], run_len,
+						   &run_written);
+
+		if (status != PSA_SUCCESS)
+			break;
+
+		total += run_written;
+
+		if (run_written < run_len)
+			break;
+	}
+
+	*num_written = total;
+
+	/* A short multi-block write is reported as successful */
+	return (total) ? PSA_SUCCESS : status;
+}
+
+static psa_status_t cached_block_store_read(void *context, uint32_t client_id,
+					    storage_partition_handle_t handle, uint64_t lba,
+					    size_t offset, size_t buffer_size, uint8_t *buffer,
+					    size_t *data_len)
+{
+	return read_data(context, client_id, handle, lba, offset, buffer_size, buffer, data_len,
+			 false);
+}
+
+static psa_status_t cached_block_store_write(void *context, uint32_t client_id,
+					     storage_partition_handle_t handle, uint64_t lba,
+					     size_t offset, const uint8_t *data, size_t data_len,
+					     size_t *num_written)
+{
+	return write_data(context, client_id, handle, lba, offset, data, data_len, num_written,
+			  false);
+}
+
+static psa_status_t cached_block_store_read_blocks(void *context, uint32_t client_id,
+						   storage_partition_handle_t handle,
+						   uint64_t lba, size_t offset, size_t buffer_size,
+						   uint8_t *buffer, size_t *data_len)
+{
+	return read_data(context, client_id, handle, lba, offset, buffer_size, buffer, data_len,
+			 true);
+}
+
+static psa_status_t cached_block_store_write_blocks(void *context, uint32_t client_id,
+						    storage_partition_handle_t handle,
+						    uint64_t lba, size_t offset,
+						    const uint8_t *data, size_t data_len,
+						    size_t *num_written)
+{
+	return write_data(context, client_id, handle, lba, offset, data, data_len, num_written,
+			  true);
+}
+
+static psa_status_t cached_block_store_erase(void *context, uint32_t client_id,
+					     storage_partition_handle_t handle,
+					     uint64_t begin_lba, size_t num_blocks)
+{
+	struct cached_block_store *this_instance = (struct cached_block_store *)context;
+	const struct storage_partition *storage_partition = &this_instance->storage_partition;
+
+	psa_status_t status = validate_request(this_instance, client_id, handle);
+
+	if (status != PSA_SUCCESS)
+		return status;
+
+	if (!storage_partition_is_lba_legal(storage_partition, begin_lba))
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	size_t clipped_num_blocks =
+		storage_partition_clip_num_blocks(storage_partition, begin_lba, num_blocks);
+
+	/* Discard cached copies of erased blocks, including any deferred writes */
+	for (size_t i = 0; i < this_instance->num_entries; i++) {
+		struct cached_block_store_entry *entry = &this_instance->entries[i];
+
+		if (entry->is_valid && (entry->lba >= begin_lba) &&
+		    (entry->lba - begin_lba < clipped_num_blocks))
+			invalidate_entry(this_instance, i);
+	}
+
+	return block_store_erase(this_instance->back_store, this_instance->local_client_id,
+				 this_instance->back_store_handle, begin_lba, clipped_num_blocks);
+}
+
+struct block_store *cached_block_store_init(struct cached_block_store *this_instance,
+					    uint32_t local_client_id,
+					    const struct uuid_octets *back_store_guid,
+					    struct block_store *back_store,
+					    storage_partition_authorizer authorizer,
+					    size_t num_cache_blocks,
+					    enum cached_block_store_write_policy write_policy)
+{
+	/* Define concrete block store interface */
+	static const struct block_store_interface interface = {
+		cached_block_store_get_partition_info,
+		cached_block_store_open,
+		cached_block_store_close,
+		cached_block_store_read,
+		cached_block_store_write,
+		cached_block_store_erase,
+		cached_block_store_read_blocks,
+		cached_block_store_write_blocks
+	};
+
+	if (!num_cache_blocks)
+		return NULL;
+
+	/* Initialize base block_store */
+	this_instance->base_block_store.context = this_instance;
+	this_instance->base_block_store.interface = &interface;
+
+	this_instance->local_client_id = local_client_id;
+	this_instance->authorizer = authorizer;
+	this_instance->back_store = back_store;
+	this_instance->write_policy = write_policy;
+	this_instance->entries = NULL;
+	this_instance->cache_buf = NULL;
+	memset(&this_instance->stats, 0, sizeof(this_instance->stats));
+
+	/* Get information about the underlying back store partition */
+	psa_status_t status = block_store_get_partition_info(back_store, back_store_guid,
+							     &this_instance->back_store_info);
+
+	if (status != PSA_SUCCESS)
+		return NULL;
+
+	/* The cached partition mirrors the back store partition */
+	storage_partition_init(&this_instance->storage_partition, back_store_guid,
+			       this_instance->back_store_info.num_blocks,
+			       this_instance->back_store_info.block_size);
+
+	this_instance->entries = calloc(num_cache_blocks, sizeof(struct cached_block_store_entry));
+	this_instance->cache_buf = malloc(num_cache_blocks *
+					  this_instance->back_store_info.block_size);
+
+	if (!this_instance->entries || !this_instance->cache_buf)
+		goto fail;
+
+	/* Initially all entries are invalid */
+	this_instance->num_entries = num_cache_blocks;
+	this_instance->mru_entry = NO_ENTRY;
+	this_instance->lru_entry = NO_ENTRY;
+
+	for (size_t i = 0; i < num_cache_blocks; i++)
+		link_as_lru(this_instance, i);
+
+	/* Open underlying block store */
+	status = block_store_open(back_store, local_client_id, back_store_guid,
+				  &this_instance->back_store_handle);
+
+	if (status != PSA_SUCCESS)
+		goto fail;
+
+	return &this_instance->base_block_store;
+
+fail:
+	free(this_instance->entries);
+	free(this_instance->cache_buf);
+	this_instance->entries = NULL;
+	this_instance->cache_buf = NULL;
+
+	return NULL;
+}
+
+void cached_block_store_deinit(struct cached_block_store *this_instance)
+{
+	cached_block_store_flush(this_instance);
+
+	block_store_close(this_instance->back_store, this_instance->local_client_id,
+			  this_instance->back_store_handle);
+
+	free(this_instance->entries);
+	free(this_instance->cache_buf);
+	this_instance->entries = NULL;
+	this_instance->cache_buf = NULL;
+
+	storage_partition_deinit(&this_instance->storage_partition);
+}
+
+psa_status_t cached_block_store_flush(struct cached_block_store *this_instance)
+{
+	psa_status_t status = PSA_SUCCESS;
+
+	for (size_t i = 0; i < this_instance->num_entries; i++) {
+		psa_status_t entry_status = write_back_entry(this_instance, i);
+
+		if (status == PSA_SUCCESS)
+			status = entry_status;
+	}
+
+	return status;
+}
+
+const struct cached_block_store_stats *
+cached_block_store_get_stats(const struct cached_block_store *this_instance)
+{
+	return &this_instance->stats;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef CACHED_BLOCK_STORE_H
+#define CACHED_BLOCK_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "service/block_storage/block_store/block_store.h"
+#include "service/block_storage/block_store/storage_partition.h"
+#include "service/block_storage/block_store/storage_partition_acl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Cache write policy
+ */
+enum cached_block_store_write_policy {
+	/* Writes update the back store immediately */
+	CACHED_BLOCK_STORE_WRITE_THROUGH,
+	/* Writes to cached blocks are deferred until eviction, flush or close */
+	CACHED_BLOCK_STORE_WRITE_BACK
+};
+
+/**
+ * \brief Cache usage counters
+ *
+ * Counted per block looked up in the cache.
+ */
+struct cached_block_store_stats {
+	uint64_t hits;
+	uint64_t misses;
+};
+
+/**
+ * \brief A cache entry
+ *
+ * Entries are linked in most to least recently used order. Invalid entries
+ * are kept at the least recently used end of the list. A dirty entry holds
+ * the range of bytes to write back.
+ */
+struct cached_block_store_entry {
+	uint64_t lba;
+	size_t prev;
+	size_t next;
+	size_t dirty_begin;
+	size_t dirty_end;
+	bool is_valid;
+	bool is_dirty;
+};
+
+/**
+ * \brief cached_block_store structure
+ *
+ * A cached_block_store is a stackable block_store that holds recently used blocks
+ * from a single partition of an underlying block store in an LRU cache. The cached
+ * partition is presented with the same GUID as the back store partition. Single
+ * block reads, such as GPT header or metadata reads, are served from the cache.
+ * Multi-block transfers use cached copies where present but don't allocate cache
+ * entries so bulk transfers don't evict frequently used blocks. Erased blocks are
+ * invalidated.
+ *
+ * With the write-back policy, only the bytes written to a block are written back
+ * so blocks that were partly written before they were cached may be written to.
+ * Back store write errors for deferred writes are reported by the operation that
+ * causes the write-back.
+ */
+struct cached_block_store {
+	struct block_store base_block_store;
+	uint32_t local_client_id;
+	storage_partition_authorizer authorizer;
+	struct storage_partition storage_partition;
+	storage_partition_handle_t back_store_handle;
+	struct block_store *back_store;
+	struct storage_partition_info back_store_info;
+	enum cached_block_store_write_policy write_policy;
+	size_t num_entries;
+	size_t mru_entry;
+	size_t lru_entry;
+	struct cached_block_store_entry *entries;
+	uint8_t *cache_buf;
+	struct cached_block_store_stats stats;
+};
+
+/**
+ * \brief Initialize a cached_block_store
+ *
+ * \param[in]  cached_block_store  The subject cached_block_store
+ * \param[in]  local_client_id     Client ID corresponding to the current environment
+ * \param[in]  back_store_guid     The partition GUID to use in the underlying back store
+ * \param[in]  back_store          The associated back store
+ * \param[in]  authorizer          Optional authorizer function for authorizing clients
+ * \param[in]  num_cache_blocks    Cache capacity in blocks
+ * \param[in]  write_policy        The cache write policy
+ *
+ * \return Pointer to block_store or NULL on failure
+ */
+struct block_store *cached_block_store_init(struct cached_block_store *cached_block_store,
+					    uint32_t local_client_id,
+					    const struct uuid_octets *back_store_guid,
+					    struct block_store *back_store,
+					    storage_partition_authorizer authorizer,
+					    size_t num_cache_blocks,
+					    enum cached_block_store_write_policy write_policy);
+
+/**
+ * \brief De-initialize a cached_block_store
+ *
+ *  Writes back any dirty blocks and frees resource allocated during call to
+ *  cached_block_store_init().
+ *
+ * \param[in]  cached_block_store  The subject cached_block_store
+ */
+void cached_block_store_deinit(struct cached_block_store *cached_block_store);
+
+/**
+ * \brief Write back any dirty blocks
+ *
+ * \param[in]  cached_block_store  The subject cached_block_store
+ *
+ * \return PSA_SUCCESS if all dirty blocks were written back
+ */
+psa_status_t cached_block_store_flush(struct cached_block_store *cached_block_store);
+
+/**
+ * \brief Get cache usage counters
+ *
+ * \param[in]  cached_block_store  The subject cached_block_store
+ *
+ * \return Pointer to cached_block_store_stats structure.
+ */
+const struct cached_block_store_stats *
+cached_block_store_get_stats(const struct cached_block_store *cached_block_store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHED_BLOCK_STORE_H */
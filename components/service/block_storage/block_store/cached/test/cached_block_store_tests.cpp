@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include "common/uuid/uuid.h"
+#include "service/block_storage/block_store/device/ram/ram_block_store.h"
+#include "service/block_storage/block_store/cached/cached_block_store.h"
+#include "CppUTest/TestHarness.h"
+
+TEST_GROUP(CachedBlockStoreTests)
+{
+	void setup()
+	{
+		/* Initialize a ram_block_store to use as the back store */
+		uuid_guid_octets_from_canonical(&m_back_store_guid,
+			"6ec10ff6-4252-4ef7-aeca-5036db6697df");
+
+		m_back_store = ram_block_store_init(
+			&m_ram_store,
+			&m_back_store_guid,
+			BACK_STORE_NUM_BLOCKS,
+			BACK_STORE_BLOCK_SIZE);
+
+		CHECK_TRUE(m_back_store);
+
+		m_block_store = NULL;
+	}
+
+	void teardown()
+	{
+		if (m_block_store) {
+			block_store_close(m_block_store, CLIENT_ID, m_handle);
+			cached_block_store_deinit(&m_cached_store);
+		}
+
+		ram_block_store_deinit(&m_ram_store);
+	}
+
+	void init_cache(enum cached_block_store_write_policy write_policy)
+	{
+		/* Stack a cached_block_store over the back store */
+		m_block_store = cached_block_store_init(
+			&m_cached_store,
+			LOCAL_CLIENT_ID,
+			&m_back_store_guid,
+			m_back_store,
+			NULL,
+			CACHE_NUM_BLOCKS,
+			write_policy);
+
+		CHECK_TRUE(m_block_store);
+
+		psa_status_t status = block_store_open(
+			m_block_store, CLIENT_ID, &m_back_store_guid, &m_handle);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+	}
+
+	void write_block(uint64_t lba, uint8_t val)
+	{
+		uint8_t write_buffer[BACK_STORE_BLOCK_SIZE];
+		size_t num_written = 0;
+
+		memset(write_buffer, val, sizeof(write_buffer));
+
+		psa_status_t status = block_store_write(
+			m_block_store, CLIENT_ID, m_handle, lba,
+			0, write_buffer, sizeof(write_buffer), &num_written);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		UNSIGNED_LONGS_EQUAL(sizeof(write_buffer), num_written);
+	}
+
+	void check_block(struct block_store *block_store, uint32_t client_id,
+		storage_partition_handle_t handle, uint64_t lba, uint8_t expected_val)
+	{
+		uint8_t read_buffer[BACK_STORE_BLOCK_SIZE];
+		uint8_t expected[BACK_STORE_BLOCK_SIZE];
+		size_t data_len = 0;
+
+		memset(expected, expected_val, sizeof(expected));
+
+		psa_status_t status = block_store_read(
+			block_store, client_id, handle, lba, 0,
+			sizeof(read_buffer), read_buffer, &data_len);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		UNSIGNED_LONGS_EQUAL(sizeof(read_buffer), data_len);
+		MEMCMP_EQUAL(expected, read_buffer, sizeof(read_buffer));
+	}
+
+	void check_cached_block(uint64_t lba, uint8_t expected_val)
+	{
+		check_block(m_block_store, CLIENT_ID, m_handle, lba, expected_val);
+	}
+
+	void check_back_store_block(uint64_t lba, uint8_t expected_val)
+	{
+		/* Read directly from the back store using the cache's own session */
+		check_block(m_back_store, LOCAL_CLIENT_ID, m_cached_store.back_store_handle,
+			lba, expected_val);
+	}
+
+	void check_stats(uint64_t expected_hits, uint64_t expected_misses)
+	{
+		const struct cached_block_store_stats *stats =
+			cached_block_store_get_stats(&m_cached_store);
+
+		UNSIGNED_LONGS_EQUAL(expected_hits, stats->hits);
+		UNSIGNED_LONGS_EQUAL(expected_misses, stats->misses);
+	}
+
+	/* Back store configuration */
+	static const size_t BACK_STORE_NUM_BLOCKS = 32;
+	static const size_t BACK_STORE_BLOCK_SIZE = 512;
+
+	/* Cache configuration */
+	static const size_t CACHE_NUM_BLOCKS = 4;
+
+	static const uint32_t LOCAL_CLIENT_ID = 11;
+	static const uint32_t CLIENT_ID = 27;
+
+	struct block_store *m_back_store;
+	struct block_store *m_block_store;
+	struct ram_block_store m_ram_store;
+	struct cached_block_store m_cached_store;
+	struct uuid_octets m_back_store_guid;
+	storage_partition_handle_t m_handle;
+};
+
+TEST(CachedBlockStoreTests, getPartitionInfo)
+{
+	struct storage_partition_info info;
+
+	init_cache(CACHED_BLOCK_STORE_WRITE_THROUGH);
+
+	psa_status_t status = block_store_get_partition_info(
+		m_block_store, &m_back_store_guid, &info);
+
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(BACK_STORE_NUM_BLOCKS, info.num_blocks);
+	UNSIGNED_LONGS_EQUAL(BACK_STORE_BLOCK_SIZE, info.block_size);
+	MEMCMP_EQUAL(m_back_store_guid.octets,
+		info.partition_guid.octets, sizeof(info.partition_guid.octets));
+}
+
+TEST(CachedBlockStoreTests, readHitAndLruEviction)
+{
+	init_cache(CACHED_BLOCK_STORE_WRITE_THROUGH);
+
+	/* Repeated reads of the same block should only miss once */
+	check_cached_block(0, 0xff);
+	check_cached_block(0, 0xff);
+	check_stats(1, 1);
+
+	/* Fill the cache then touch block 0 so block 1 becomes least recently used */
+	for (uint64_t lba = 1; lba < CACHE_NUM_BLOCKS; lba++)
+		check_cached_block(lba, 0xff);
+
+	check_cached_block(0, 0xff);
+	check_stats(2, CACHE_NUM_BLOCKS);
+
+	/* Reading another block should evict block 1 but not block 0 */
+	check_cached_block(CACHE_NUM_BLOCKS, 0xff);
+	check_cached_block(0, 0xff);
+	check_stats(3, CACHE_NUM_BLOCKS + 1);
+
+	check_cached_block(1, 0xff);
+	check_stats(3, CACHE_NUM_BLOCKS + 2);
+}
+
+TEST(CachedBlockStoreTests, writeThrough)
+{
+	init_cache(CACHED_BLOCK_STORE_WRITE_THROUGH);
+
+	/* Cache a block, then write to it */
+	check_cached_block(3, 0xff);
+	write_block(3, 0xa5);
+
+	/* Expect both the cached copy and back store to be updated */
+	check_cached_block(3, 0xa5);
+	check_stats(2, 1);
+	check_back_store_block(3, 0xa5);
+
+	/* Writes to uncached blocks don't allocate cache entries */
+	write_block(4, 0x5a);
+	check_back_store_block(4, 0x5a);
+	check_cached_block(4, 0x5a);
+	check_stats(2, 3);
+}
+
+TEST(CachedBlockStoreTests, writeBack)
+{
+	init_cache(CACHED_BLOCK_STORE_WRITE_BACK);
+
+	/* A write should be held in the cache until flushed */
+	write_block(5, 0x11);
+	check_cached_block(5, 0x11);
+	check_back_store_block(5, 0xff);
+
+	LONGS_EQUAL(PSA_SUCCESS, cached_block_store_flush(&m_cached_store));
+	check_back_store_block(5, 0x11);
+
+	/* Evicting a dirty block should write it back */
+	write_block(6, 0x22);
+	check_back_store_block(6, 0xff);
+
+	for (uint64_t lba = 10; lba < 10 + CACHE_NUM_BLOCKS; lba++)
+		check_cached_block(lba, 0xff);
+
+	check_back_store_block(6, 0x22);
+	check_cached_block(6, 0x22);
+}
+
+TEST(CachedBlockStoreTests, eraseInvalidates)
+{
+	init_cache(CACHED_BLOCK_STORE_WRITE_BACK);
+
+	/* A deferred write to an erased block should be discarded */
+	write_block(7, 0x33);
+	write_block(8, 0x44);
+
+	psa_status_t status = block_store_erase(m_block_store, CLIENT_ID, m_handle, 7, 1);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	check_cached_block(7, 0xff);
+	LONGS_EQUAL(PSA_SUCCESS, cached_block_store_flush(&m_cached_store));
+	check_back_store_block(7, 0xff);
+	check_back_store_block(8, 0x44);
+}
+
+TEST(CachedBlockStoreTests, multiBlockReadWrite)
+{
+	uint8_t write_buffer[BACK_STORE_BLOCK_SIZE * 3];
+	uint8_t read_buffer[BACK_STORE_BLOCK_SIZE * 3];
+	size_t offset = 100;
+	size_t data_len = 0;
+	size_t num_written = 0;
+
+	init_cache(CACHED_BLOCK_STORE_WRITE_BACK);
+
+	for (size_t i = 0; i < sizeof(write_buffer); i++)
+		write_buffer[i] = (uint8_t)i;
+
+	/* Hold a dirty copy of block 13 in the cache */
+	write_block(13, 0x55);
+
+	/* A multi-block write should update the cached block and write others directly */
+	psa_status_t status = block_store_write_blocks(
+		m_block_store, CLIENT_ID, m_handle, 12, offset,
+		write_buffer, sizeof(write_buffer), &num_written);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(write_buffer), num_written);
+
+	status = block_store_read_blocks(
+		m_block_store, CLIENT_ID, m_handle, 12, offset,
+		sizeof(read_buffer), read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(read_buffer), data_len);
+	MEMCMP_EQUAL(write_buffer, read_buffer, sizeof(read_buffer));
+
+	/* Check the back store holds the same data once flushed */
+	LONGS_EQUAL(PSA_SUCCESS, cached_block_store_flush(&m_cached_store));
+
+	status = block_store_read_blocks(
+		m_back_store, LOCAL_CLIENT_ID, m_cached_store.back_store_handle, 12, offset,
+		sizeof(read_buffer), read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(read_buffer), data_len);
+	MEMCMP_EQUAL(write_buffer, read_buffer, sizeof(read_buffer));
+
+	/* A multi-block read should be clipped at the end of the partition */
+	status = block_store_read_blocks(
+		m_block_store, CLIENT_ID, m_handle, BACK_STORE_NUM_BLOCKS - 1, 0,
+		sizeof(read_buffer), read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(BACK_STORE_BLOCK_SIZE, data_len);
+}
+
+TEST(CachedBlockStoreTests, partialWriteBack)
+{
+	uint8_t write_buffer[100];
+	uint8_t read_buffer[BACK_STORE_BLOCK_SIZE];
+	uint8_t expected[BACK_STORE_BLOCK_SIZE];
+	size_t num_written = 0;
+	size_t data_len = 0;
+
+	init_cache(CACHED_BLOCK_STORE_WRITE_BACK);
+	memset(expected, 0xff, sizeof(expected));
+
+	/* Write the start of block 2 directly to the back store */
+	memset(write_buffer, 0x11, sizeof(write_buffer));
+	LONGS_EQUAL(PSA_SUCCESS, block_store_write(
+		m_back_store, LOCAL_CLIENT_ID, m_cached_store.back_store_handle, 2, 0,
+		write_buffer, sizeof(write_buffer), &num_written));
+	memset(&expected[0], 0x11, sizeof(write_buffer));
+
+	/* Write the following bytes through the cache. The flush shouldn't rewrite the
+	 * bytes that were already written to the back store.
+	 */
+	memset(write_buffer, 0x22, sizeof(write_buffer));
+	LONGS_EQUAL(PSA_SUCCESS, block_store_write(
+		m_block_store, CLIENT_ID, m_handle, 2, 100,
+		write_buffer, sizeof(write_buffer), &num_written));
+	memset(&expected[100], 0x22, sizeof(write_buffer));
+
+	LONGS_EQUAL(PSA_SUCCESS, cached_block_store_flush(&m_cached_store));
+
+	/* Contiguous writes are merged. A disjoint write leaves the gap untouched. */
+	memset(write_buffer, 0x33, sizeof(write_buffer));
+	LONGS_EQUAL(PSA_SUCCESS, block_store_write(
+		m_block_store, CLIENT_ID, m_handle, 2, 200,
+		write_buffer, 50, &num_written));
+	LONGS_EQUAL(PSA_SUCCESS, block_store_write(
+		m_block_store, CLIENT_ID, m_handle, 2, 250,
+		write_buffer, 50, &num_written));
+	LONGS_EQUAL(PSA_SUCCESS, block_store_write(
+		m_block_store, CLIENT_ID, m_handle, 2, 400,
+		write_buffer, sizeof(write_buffer), &num_written));
+	memset(&expected[200], 0x33, 100);
+	memset(&expected[400], 0x33, sizeof(write_buffer));
+
+	/* Evict the block */
+	for (uint64_t lba = 10; lba < 10 + CACHE_NUM_BLOCKS; lba++)
+		check_cached_block(lba, 0xff);
+
+	LONGS_EQUAL(PSA_SUCCESS, block_store_read(
+		m_back_store, LOCAL_CLIENT_ID, m_cached_store.back_store_handle, 2, 0,
+		sizeof(read_buffer), read_buffer, &data_len));
+	MEMCMP_EQUAL(expected, read_buffer, sizeof(read_buffer));
+
+	/* The gap at 300 is still erased so it may be written */
+	LONGS_EQUAL(PSA_SUCCESS, block_store_write(
+		m_block_store, CLIENT_ID, m_handle, 2, 300,
+		write_buffer, sizeof(write_buffer), &num_written));
+	LONGS_EQUAL(PSA_SUCCESS, cached_block_store_flush(&m_cached_store));
+}
@@ -181,8 +181,8 @@ static psa_status_t block_storage_client_close(void *context,
 	return psa_status;
 }
 
-static psa_status_t block_storage_client_read(void *context,
-	uint32_t client_id,
+static psa_status_t read_data(void *context,
+	uint32_t opcode,
 	storage_partition_handle_t handle,
 	uint64_t lba,
 	size_t offset,
@@ -196,8 +196,6 @@ static psa_status_t block_storage_client_read(void *context,
 	size_t req_len = sizeof(req_msg);
 	uint8_t *req_buf = NULL;
 
-	(void)client_id;
-
 	*data_len = 0;
 
 	req_msg.handle = handle;
@@ -218,7 +216,7 @@ static psa_status_t block_storage_client_read(void *context,
 		memcpy(req_buf, &req_msg, req_len);
 
 		this_context->client.rpc_status = rpc_caller_session_invoke(
-			call_handle, TS_BLOCK_STORAGE_OPCODE_READ, &resp_buf, &resp_len,
+			call_handle, opcode, &resp_buf, &resp_len,
 			&service_status);
 
 		if (this_context->client.rpc_status == RPC_SUCCESS) {
@@ -247,8 +245,8 @@ static psa_status_t block_storage_client_read(void *context,
 	return psa_status;
 }
 
-static psa_status_t block_storage_client_write(void *context,
-	uint32_t client_id,
+static psa_status_t write_data(void *context,
+	uint32_t opcode,
 	storage_partition_handle_t handle,
 	uint64_t lba,
 	size_t offset,
@@ -262,8 +260,6 @@ static psa_status_t block_storage_client_write(void *context,
 	size_t req_len = sizeof(req_msg) + data_len;
 	uint8_t *req_buf = NULL;
 
-	(void)client_id;
-
 	req_msg.handle = handle;
 	req_msg.lba = lba;
 	req_msg.offset = offset;
@@ -284,7 +280,341 @@ static psa_status_t block_storage_client_write(void *context,
 		memcpy(&req_buf[sizeof(req_msg)], data, data_len);
 
 		this_context->client.rpc_status = rpc_caller_session_invoke(
-			call_handle, TS_BLOCK_STORAGE_OPCODE_WRITE,
+			call_handle, opcode,
+			&resp_buf, &resp_len, &service_status);
+
+		if (this_context->client.rpc_status == RPC_SUCCESS) {
+
+			psa_status = service_status;
+
+			if (psa_status == PSA_SUCCESS) {
+
+				if (resp_len >= sizeof(struct ts_block_storage_write_out)) {
+
+					struct ts_block_storage_write_out resp_msg;
+
+					memcpy(&resp_msg, resp_buf, sizeof(resp_msg));
+					*num_written = resp_msg.num_written;
+				} else {
+					/* Failed to decode response message */
+					psa_status = PSA_ERROR_GENERIC_ERROR;
+				}
+			}
+		}
+
+		rpc_caller_session_end(call_handle);
+	} else {
+
+		this_context->client.rpc_status = RPC_ERROR_INTERNAL;
+	}
+
+	return psa_status;
+}
+
+static psa_status_t block_storage_client_read(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	(void)client_id;
+
+	return read_data(context, TS_BLOCK_STORAGE_OPCODE_READ,
+		handle, lba, offset, buffer_size, buffer, data_len);
+}
+
+static psa_status_t block_storage_client_write(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	(void)client_id;
+
+	return write_data(context, TS_BLOCK_STORAGE_OPCODE_WRITE,
+		handle, lba, offset, data, data_len, num_written);
+}
+
+static psa_status_t block_storage_client_read_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	struct block_storage_client *this_context = (struct block_storage_client *)context;
+	size_t max_len = this_context->client.service_info.max_payload;
+	psa_status_t psa_status;
+
+	(void)client_id;
+
+	/* Limit the read to what fits in a single response. The caller continues from
+	 * wherever the read stops.
+	 */
+	if (buffer_size > max_len)
+		buffer_size = max_len;
+
+	psa_status = read_data(context, TS_BLOCK_STORAGE_OPCODE_READ_BLOCKS,
+		handle, lba, offset, buffer_size, buffer, data_len);
+
+	/* Fall back to a single block read if the provider doesn't support the opcode */
+	if (this_context->client.rpc_status == RPC_ERROR_INVALID_VALUE)
+		psa_status = read_data(context, TS_BLOCK_STORAGE_OPCODE_READ,
+			handle, lba, offset, buffer_size, buffer, data_len);
+
+	return psa_status;
+}
+
+static psa_status_t block_storage_client_write_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	struct block_storage_client *this_context = (struct block_storage_client *)context;
+	size_t max_len = this_context->client.service_info.max_payload;
+	psa_status_t psa_status;
+
+	(void)client_id;
+
+	/* Limit the write to what fits in a single request alongside the fixed size message */
+	max_len = (max_len > sizeof(struct ts_block_storage_write_in)) ?
+		max_len - sizeof(struct ts_block_storage_write_in) : 0;
+
+	if (data_len > max_len)
+		data_len = max_len;
+
+	psa_status = write_data(context, TS_BLOCK_STORAGE_OPCODE_WRITE_BLOCKS,
+		handle, lba, offset, data, data_len, num_written);
+
+	/* Fall back to a single block write if the provider doesn't support the opcode */
+	if (this_context->client.rpc_status == RPC_ERROR_INVALID_VALUE)
+		psa_status = write_data(context, TS_BLOCK_STORAGE_OPCODE_WRITE,
+			handle, lba, offset, data, data_len, num_written);
+
+	return psa_status;
+}
+
+/*
+ * Determine how many ranges of a vectored operation fit in a single call. Ranges are
+ * included while their descriptors, and their data if carried in the request, fit
+ * within max_len. Only a first range that doesn't fit is sent with its length reduced
+ * so that, where possible, a call ends on a range boundary.
+ */
+static size_t fit_vec_ranges(const struct block_store_range *ranges,
+	size_t num_ranges,
+	size_t max_len,
+	size_t data_len,
+	bool data_in_request,
+	size_t *last_range_len,
+	size_t *total_data_len)
+{
+	size_t count = 0;
+	size_t req_len = sizeof(struct ts_block_storage_vec_in);
+
+	*total_data_len = 0;
+	*last_range_len = 0;
+
+	while (count < num_ranges) {
+
+		size_t space = data_len - *total_data_len;
+		size_t range_len = 0;
+
+		req_len += sizeof(struct ts_block_storage_range);
+
+		if (data_in_request) {
+
+			if (req_len + *total_data_len > max_len)
+				break;
+
+			if (space > max_len - req_len - *total_data_len)
+				space = max_len - req_len - *total_data_len;
+
+		} else if (req_len > max_len) {
+
+			break;
+		}
+
+		range_len = (ranges[count].len < space) ? ranges[count].len : space;
+
+		if ((range_len < ranges[count].len) && (count || !range_len))
+			break;
+
+		*total_data_len += range_len;
+		*last_range_len = range_len;
+
+		if (range_len < ranges[count++].len)
+			break;
+	}
+
+	return count;
+}
+
+static void serialize_vec_ranges(uint8_t *req_buf,
+	storage_partition_handle_t handle,
+	const struct block_store_range *ranges,
+	size_t num_ranges,
+	size_t last_range_len)
+{
+	struct ts_block_storage_vec_in req_msg = {0};
+	size_t pos = sizeof(req_msg);
+
+	req_msg.handle = handle;
+	req_msg.num_ranges = num_ranges;
+
+	memcpy(req_buf, &req_msg, sizeof(req_msg));
+
+	for (size_t i = 0; i < num_ranges; ++i) {
+
+		struct ts_block_storage_range range_msg;
+
+		range_msg.lba = ranges[i].lba;
+		range_msg.offset = ranges[i].offset;
+		range_msg.len = (i + 1 < num_ranges) ? ranges[i].len : last_range_len;
+
+		memcpy(&req_buf[pos], &range_msg, sizeof(range_msg));
+		pos += sizeof(range_msg);
+	}
+}
+
+static psa_status_t block_storage_client_read_vec(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	const struct block_store_range *ranges,
+	size_t num_ranges,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	struct block_storage_client *this_context = (struct block_storage_client *)context;
+	psa_status_t psa_status = PSA_ERROR_GENERIC_ERROR;
+	size_t max_len = this_context->client.service_info.max_payload;
+	size_t last_range_len = 0;
+	size_t total_data_len = 0;
+	uint8_t *req_buf = NULL;
+
+	(void)client_id;
+
+	*data_len = 0;
+
+	/* Send as many ranges as fit in a single call */
+	if (buffer_size > max_len)
+		buffer_size = max_len;
+
+	num_ranges = fit_vec_ranges(ranges, num_ranges, max_len, buffer_size, false,
+		&last_range_len, &total_data_len);
+
+	if (!num_ranges)
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	size_t req_len = sizeof(struct ts_block_storage_vec_in) +
+		num_ranges * sizeof(struct ts_block_storage_range);
+
+	rpc_call_handle call_handle =
+		rpc_caller_session_begin(this_context->client.session, &req_buf, req_len,
+					 total_data_len);
+
+	if (call_handle) {
+
+		uint8_t *resp_buf = NULL;
+		size_t resp_len = 0;
+		service_status_t service_status = 0;
+
+		serialize_vec_ranges(req_buf, handle, ranges, num_ranges, last_range_len);
+
+		this_context->client.rpc_status = rpc_caller_session_invoke(
+			call_handle, TS_BLOCK_STORAGE_OPCODE_READ_VEC, &resp_buf, &resp_len,
+			&service_status);
+
+		if (this_context->client.rpc_status == RPC_SUCCESS) {
+
+			psa_status = service_status;
+
+			if (psa_status == PSA_SUCCESS) {
+
+				if (resp_len <= buffer_size) {
+
+					memcpy(buffer, resp_buf, resp_len);
+					*data_len = resp_len;
+				} else {
+
+					psa_status = PSA_ERROR_BUFFER_TOO_SMALL;
+				}
+			}
+		} else if (this_context->client.rpc_status == RPC_ERROR_INVALID_VALUE) {
+
+			/* Provider doesn't support vectored reads */
+			psa_status = PSA_ERROR_NOT_SUPPORTED;
+		}
+
+		rpc_caller_session_end(call_handle);
+	} else {
+
+		this_context->client.rpc_status = RPC_ERROR_INTERNAL;
+	}
+
+	return psa_status;
+}
+
+static psa_status_t block_storage_client_write_vec(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	const struct block_store_range *ranges,
+	size_t num_ranges,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	struct block_storage_client *this_context = (struct block_storage_client *)context;
+	psa_status_t psa_status = PSA_ERROR_GENERIC_ERROR;
+	size_t max_len = this_context->client.service_info.max_payload;
+	size_t last_range_len = 0;
+	size_t total_data_len = 0;
+	uint8_t *req_buf = NULL;
+
+	(void)client_id;
+
+	*num_written = 0;
+
+	/* Range descriptors and data share the request */
+	num_ranges = fit_vec_ranges(ranges, num_ranges, max_len, data_len, true,
+		&last_range_len, &total_data_len);
+
+	if (!num_ranges)
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	size_t ranges_len = sizeof(struct ts_block_storage_vec_in) +
+		num_ranges * sizeof(struct ts_block_storage_range);
+	size_t req_len = ranges_len + total_data_len;
+
+	rpc_call_handle call_handle =
+		rpc_caller_session_begin(this_context->client.session, &req_buf, req_len,
+					 sizeof(struct ts_block_storage_write_out));
+
+	if (call_handle) {
+
+		uint8_t *resp_buf = NULL;
+		size_t resp_len = 0;
+		service_status_t service_status = 0;
+
+		serialize_vec_ranges(req_buf, handle, ranges, num_ranges, last_range_len);
+
+		/* Copy variable length data */
+		memcpy(&req_buf[ranges_len], data, total_data_len);
+
+		this_context->client.rpc_status = rpc_caller_session_invoke(
+			call_handle, TS_BLOCK_STORAGE_OPCODE_WRITE_VEC,
 			&resp_buf, &resp_len, &service_status);
 
 		if (this_context->client.rpc_status == RPC_SUCCESS) {
@@ -304,6 +634,10 @@ static psa_status_t block_storage_client_write(void *context,
 					psa_status = PSA_ERROR_GENERIC_ERROR;
 				}
 			}
+		} else if (this_context->client.rpc_status == RPC_ERROR_INVALID_VALUE) {
+
+			/* Provider doesn't support vectored writes */
+			psa_status = PSA_ERROR_NOT_SUPPORTED;
 		}
 
 		rpc_caller_session_end(call_handle);
@@ -374,7 +708,11 @@ struct block_store *block_storage_client_init(
 		block_storage_client_close,
 		block_storage_client_read,
 		block_storage_client_write,
-		block_storage_client_erase
+		block_storage_client_erase,
+		block_storage_client_read_blocks,
+		block_storage_client_write_blocks,
+		block_storage_client_read_vec,
+		block_storage_client_write_vec
 	};
 
 	/* Initialize base block_store */
@@ -9,123 +9,195 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #define ERASED_DATA_VAL (0xff)
 
-ssize_t file_length(FILE *fp)
+/* Number of erase_buf references passed to each pwritev call when erasing */
+#define ERASE_IOV_COUNT (64)
+
+static void unmap_file(struct file_block_store *this_instance)
 {
-	ssize_t size = -1;
+	if (this_instance->map) {
+		munmap(this_instance->map, this_instance->map_len);
+		this_instance->map = NULL;
+		this_instance->map_len = 0;
+	}
+}
 
-	if (!fseek(fp, 0, SEEK_END))
-		size = ftell(fp);
+static void map_file(struct file_block_store *this_instance)
+{
+	/* The mapping covers the whole file so is re-established whenever the file grows.
+	 * If mapping fails, accesses fall back to pread/pwrite.
+	 */
+	unmap_file(this_instance);
+
+	if ((this_instance->mode == FILE_BLOCK_STORE_MODE_MMAP) && this_instance->file_len) {
+		void *map = mmap(NULL, this_instance->file_len, PROT_READ | PROT_WRITE, MAP_SHARED,
+				 this_instance->fd, 0);
+
+		if (map != MAP_FAILED) {
+			this_instance->map = map;
+			this_instance->map_len = this_instance->file_len;
+		}
+	}
+}
 
-	return size;
+static bool is_mapped(const struct file_block_store *this_instance, size_t pos, size_t len)
+{
+	return this_instance->map && (pos <= this_instance->map_len) &&
+	       (len <= this_instance->map_len - pos);
 }
 
-static psa_status_t seek(FILE *fp, ssize_t pos)
+static psa_status_t read_file(const struct file_block_store *this_instance, size_t pos,
+			      uint8_t *buffer, size_t len)
 {
-	if (fseek(fp, pos, SEEK_SET))
-		return PSA_ERROR_BAD_STATE;
+	if (is_mapped(this_instance, pos, len)) {
+		memcpy(buffer, &this_instance->map[pos], len);
+		return PSA_SUCCESS;
+	}
+
+	while (len > 0) {
+		ssize_t result = pread(this_instance->fd, buffer, len, (off_t)pos);
+
+		if (result < 0 && errno == EINTR)
+			continue;
+
+		if (result <= 0)
+			return PSA_ERROR_BAD_STATE;
+
+		buffer += result;
+		pos += (size_t)result;
+		len -= (size_t)result;
+	}
 
 	return PSA_SUCCESS;
 }
 
-static psa_status_t prepare_for_read(const struct file_block_store *this_instance, uint32_t lba,
-				     size_t offset, size_t requested_read_len,
-				     size_t *adjusted_read_len)
+static psa_status_t write_file(struct file_block_store *this_instance, size_t pos,
+			       const uint8_t *data, size_t len)
 {
-	assert(this_instance);
-
-	psa_status_t status = PSA_ERROR_BAD_STATE;
+	size_t end_pos = pos + len;
 
-	const struct storage_partition *storage_partition =
-		&this_instance->base_block_device.storage_partition;
+	if (is_mapped(this_instance, pos, len)) {
+		memcpy(&this_instance->map[pos], data, len);
+		return PSA_SUCCESS;
+	}
 
-	ssize_t read_pos = lba * storage_partition->block_size + offset;
-	ssize_t file_len = file_length(this_instance->file_handle);
+	while (len > 0) {
+		ssize_t result = pwrite(this_instance->fd, data, len, (off_t)pos);
 
-	if (file_len >= 0) {
-		/* File exists so attempt to seek the read position to the requested LBA + offset */
-		if (read_pos <= file_len) {
-			size_t bytes_until_end_of_file = (size_t)(file_len - read_pos);
-			size_t bytes_until_end_of_block = storage_partition->block_size - offset;
+		if (result < 0 && errno == EINTR)
+			continue;
 
-			size_t read_limit = (bytes_until_end_of_file < bytes_until_end_of_block) ?
-						    bytes_until_end_of_file :
-						    bytes_until_end_of_block;
+		if (result <= 0)
+			return PSA_ERROR_BAD_STATE;
 
-			*adjusted_read_len =
-				(requested_read_len < read_limit) ? requested_read_len : read_limit;
+		data += result;
+		pos += (size_t)result;
+		len -= (size_t)result;
+	}
 
-			status = seek(this_instance->file_handle, read_pos);
-		} else {
-			/* Requested block is beyond the end of the file */
-			status = PSA_ERROR_INVALID_ARGUMENT;
-		}
+	if (end_pos > this_instance->file_len) {
+		this_instance->file_len = end_pos;
+		map_file(this_instance);
 	}
 
-	return status;
+	return PSA_SUCCESS;
 }
 
-static psa_status_t write_erased(const struct file_block_store *this_instance, size_t pos,
-				 size_t len)
+static psa_status_t write_erased(struct file_block_store *this_instance, size_t pos, size_t len)
 {
-	psa_status_t status = PSA_ERROR_BAD_STATE;
-	size_t remaining_len = len;
+	struct iovec iov[ERASE_IOV_COUNT];
+	size_t end_pos = pos + len;
 
 	assert(this_instance);
 
-	status = seek(this_instance->file_handle, pos);
+	if (is_mapped(this_instance, pos, len)) {
+		memset(&this_instance->map[pos], ERASED_DATA_VAL, len);
+		return PSA_SUCCESS;
+	}
+
+	/* Every iovec references the same erase_buf so each call erases up to
+	 * ERASE_IOV_COUNT * sizeof(erase_buf) bytes.
+	 */
+	for (size_t i = 0; i < ERASE_IOV_COUNT; i++) {
+		iov[i].iov_base = (void *)this_instance->erase_buf;
+		iov[i].iov_len = sizeof(this_instance->erase_buf);
+	}
+
+	while (len > 0) {
+		size_t iov_count = 0;
+		size_t erase_len = 0;
 
-	while ((status == PSA_SUCCESS) && (remaining_len > 0)) {
-		size_t erase_len = (remaining_len < sizeof(this_instance->erase_buf)) ?
-					   remaining_len :
-					   sizeof(this_instance->erase_buf);
+		while ((iov_count < ERASE_IOV_COUNT) && (erase_len < len)) {
+			size_t remaining_len = len - erase_len;
 
-		size_t write_len =
-			fwrite(this_instance->erase_buf, 1, erase_len, this_instance->file_handle);
+			iov[iov_count].iov_len = (remaining_len < sizeof(this_instance->erase_buf)) ?
+							 remaining_len :
+							 sizeof(this_instance->erase_buf);
 
-		if (write_len != erase_len)
-			status = PSA_ERROR_BAD_STATE;
+			erase_len += iov[iov_count].iov_len;
+			++iov_count;
+		}
+
+		ssize_t result = pwritev(this_instance->fd, iov, (int)iov_count, (off_t)pos);
+
+		/* Restore any shortened iovec for the next pass */
+		iov[iov_count - 1].iov_len = sizeof(this_instance->erase_buf);
 
-		remaining_len -= erase_len;
+		if (result < 0 && errno == EINTR)
+			continue;
+
+		if (result <= 0)
+			return PSA_ERROR_BAD_STATE;
+
+		pos += (size_t)result;
+		len -= (size_t)result;
 	}
 
-	return status;
+	if (end_pos > this_instance->file_len) {
+		this_instance->file_len = end_pos;
+		map_file(this_instance);
+	}
+
+	return PSA_SUCCESS;
 }
 
-static psa_status_t prepare_for_write(const struct file_block_store *this_instance, uint32_t lba,
-				      size_t offset, size_t requested_write_len,
-				      size_t *adjusted_write_len)
+static psa_status_t extend_file(struct file_block_store *this_instance, size_t new_len)
 {
-	assert(this_instance);
-
-	psa_status_t status = PSA_ERROR_BAD_STATE;
+	size_t file_len = this_instance->file_len;
 
-	const struct storage_partition *storage_partition =
-		&this_instance->base_block_device.storage_partition;
+	if (new_len <= file_len)
+		return PSA_SUCCESS;
 
-	size_t bytes_until_end_of_block = storage_partition->block_size - offset;
-	*adjusted_write_len = (requested_write_len < bytes_until_end_of_block) ?
-				      requested_write_len :
-				      bytes_until_end_of_block;
+	/* Reserve the extension in one go. The erased state is not zero so the reserved
+	 * range still has to be filled. Filesystems that can't preallocate just extend
+	 * the file as the erased data is written.
+	 */
+	if (posix_fallocate(this_instance->fd, (off_t)file_len, (off_t)(new_len - file_len)) ==
+	    ENOSPC)
+		return PSA_ERROR_INSUFFICIENT_STORAGE;
 
-	ssize_t write_pos = lba * storage_partition->block_size + offset;
-	ssize_t file_len = file_length(this_instance->file_handle);
+	return write_erased(this_instance, file_len, new_len - file_len);
+}
 
-	if (file_len >= 0) {
-		if (write_pos > file_len) {
-			/* Writing beyond the current end-of-file so extend the file */
-			status = write_erased(this_instance, file_len, write_pos - file_len);
-		} else {
-			/* Writing over existing data */
-			status = seek(this_instance->file_handle, write_pos);
-		}
-	}
+static size_t transfer_limit(const struct storage_partition *storage_partition, uint64_t lba,
+			     size_t offset, bool multi_block)
+{
+	/* Single block transfers stop at the end of the block, multi-block at the partition end */
+	if (!multi_block)
+		return storage_partition->block_size - offset;
 
-	return status;
+	return storage_partition_clip_length(storage_partition, lba, offset, SIZE_MAX);
 }
 
 static psa_status_t file_block_store_get_partition_info(void *context,
@@ -145,7 +217,7 @@ static psa_status_t file_block_store_open(void *context, uint32_t client_id,
 	struct file_block_store *this_instance = (struct file_block_store *)context;
 	psa_status_t status = PSA_ERROR_BAD_STATE;
 
-	if (this_instance->file_handle > 0) {
+	if (this_instance->fd >= 0) {
 		status = block_device_open(&this_instance->base_block_device, client_id,
 					   partition_guid, handle);
 	}
@@ -161,10 +233,10 @@ static psa_status_t file_block_store_close(void *context, uint32_t client_id,
 	return block_device_close(&this_instance->base_block_device, client_id, handle);
 }
 
-static psa_status_t file_block_store_read(void *context, uint32_t client_id,
-					  storage_partition_handle_t handle, uint64_t lba,
-					  size_t offset, size_t buffer_size, uint8_t *buffer,
-					  size_t *data_len)
+static psa_status_t read_data(void *context, uint32_t client_id,
+			      storage_partition_handle_t handle, uint64_t lba, size_t offset,
+			      size_t buffer_size, uint8_t *buffer, size_t *data_len,
+			      bool multi_block)
 {
 	const struct file_block_store *this_instance = (struct file_block_store *)context;
 
@@ -179,17 +251,26 @@ static psa_status_t file_block_store_read(void *context, uint32_t client_id,
 
 		if (storage_partition_is_lba_legal(storage_partition, lba) &&
 		    (offset < storage_partition->block_size)) {
-			size_t read_len = 0;
+			size_t read_pos = lba * storage_partition->block_size + offset;
+
+			if (read_pos <= this_instance->file_len) {
+				size_t read_len = this_instance->file_len - read_pos;
+				size_t max_read_len = transfer_limit(storage_partition, lba, offset,
+								     multi_block);
+
+				if (read_len > max_read_len)
+					read_len = max_read_len;
 
-			status = prepare_for_read(this_instance, lba, offset, buffer_size,
-						  &read_len);
+				if (read_len > buffer_size)
+					read_len = buffer_size;
 
-			if (status == PSA_SUCCESS) {
-				*data_len = fread(buffer, 1, read_len, this_instance->file_handle);
+				status = read_file(this_instance, read_pos, buffer, read_len);
 
-				if (*data_len != read_len)
-					status = PSA_ERROR_BAD_STATE;
-			}
+				if (status == PSA_SUCCESS)
+					*data_len = read_len;
+			} else
+				/* Requested block is beyond the end of the file */
+				status = PSA_ERROR_INVALID_ARGUMENT;
 		} else
 			/* Block or offset outside of configured limits */
 			status = PSA_ERROR_INVALID_ARGUMENT;
@@ -198,10 +279,10 @@ static psa_status_t file_block_store_read(void *context, uint32_t client_id,
 	return status;
 }
 
-static psa_status_t file_block_store_write(void *context, uint32_t client_id,
-					   storage_partition_handle_t handle, uint64_t lba,
-					   size_t offset, const uint8_t *data, size_t data_len,
-					   size_t *num_written)
+static psa_status_t write_data(void *context, uint32_t client_id,
+			       storage_partition_handle_t handle, uint64_t lba, size_t offset,
+			       const uint8_t *data, size_t data_len, size_t *num_written,
+			       bool multi_block)
 {
 	struct file_block_store *this_instance = (struct file_block_store *)context;
 
@@ -216,18 +297,21 @@ static psa_status_t file_block_store_write(void *context, uint32_t client_id,
 
 		if (storage_partition_is_lba_legal(storage_partition, lba) &&
 		    (offset < storage_partition->block_size)) {
-			size_t adjusted_len = 0;
+			size_t write_pos = lba * storage_partition->block_size + offset;
+			size_t write_len = transfer_limit(storage_partition, lba, offset,
+							  multi_block);
+
+			if (write_len > data_len)
+				write_len = data_len;
 
-			status = prepare_for_write(this_instance, lba, offset, data_len,
-						   &adjusted_len);
+			/* Writing beyond the current end-of-file so extend the file */
+			status = extend_file(this_instance, write_pos);
 
-			if (status == PSA_SUCCESS) {
-				*num_written =
-					fwrite(data, 1, adjusted_len, this_instance->file_handle);
+			if (status == PSA_SUCCESS)
+				status = write_file(this_instance, write_pos, data, write_len);
 
-				if (*num_written != adjusted_len)
-					status = PSA_ERROR_BAD_STATE;
-			}
+			if (status == PSA_SUCCESS)
+				*num_written = write_len;
 		} else
 			/* Block or offset outside of configured limits */
 			status = PSA_ERROR_INVALID_ARGUMENT;
@@ -236,6 +320,42 @@ static psa_status_t file_block_store_write(void *context, uint32_t client_id,
 	return status;
 }
 
+static psa_status_t file_block_store_read(void *context, uint32_t client_id,
+					  storage_partition_handle_t handle, uint64_t lba,
+					  size_t offset, size_t buffer_size, uint8_t *buffer,
+					  size_t *data_len)
+{
+	return read_data(context, client_id, handle, lba, offset, buffer_size, buffer, data_len,
+			 false);
+}
+
+static psa_status_t file_block_store_write(void *context, uint32_t client_id,
+					   storage_partition_handle_t handle, uint64_t lba,
+					   size_t offset, const uint8_t *data, size_t data_len,
+					   size_t *num_written)
+{
+	return write_data(context, client_id, handle, lba, offset, data, data_len, num_written,
+			  false);
+}
+
+static psa_status_t file_block_store_read_blocks(void *context, uint32_t client_id,
+						 storage_partition_handle_t handle, uint64_t lba,
+						 size_t offset, size_t buffer_size, uint8_t *buffer,
+						 size_t *data_len)
+{
+	return read_data(context, client_id, handle, lba, offset, buffer_size, buffer, data_len,
+			 true);
+}
+
+static psa_status_t file_block_store_write_blocks(void *context, uint32_t client_id,
+						  storage_partition_handle_t handle, uint64_t lba,
+						  size_t offset, const uint8_t *data, size_t data_len,
+						  size_t *num_written)
+{
+	return write_data(context, client_id, handle, lba, offset, data, data_len, num_written,
+			  true);
+}
+
 static psa_status_t file_block_store_erase(void *context, uint32_t client_id,
 					   storage_partition_handle_t handle, uint64_t begin_lba,
 					   size_t num_blocks)
@@ -257,23 +377,15 @@ static psa_status_t file_block_store_erase(void *context, uint32_t client_id,
 		size_t blocks_to_erase = (num_blocks < blocks_remaining) ? num_blocks :
 									   blocks_remaining;
 
-		ssize_t file_len = file_length(this_instance->file_handle);
-
-		if (file_len >= 0) {
-			/* File exists. If erased block falls within the limits of the file,
-			 * explicitly set blocks to the erased state. If erased block is
-			 * beyond EOF, there's nothing to do.
-			 */
-			ssize_t block_pos = begin_lba * storage_partition->block_size;
+		/* If erased block falls within the limits of the file, explicitly set
+		 * blocks to the erased state. If erased block is beyond EOF, there's
+		 * nothing to do.
+		 */
+		size_t block_pos = begin_lba * storage_partition->block_size;
 
-			if (block_pos < file_len)
-				status = write_erased(this_instance, block_pos,
-						      blocks_to_erase *
-							      storage_partition->block_size);
-
-		} else {
-			status = PSA_ERROR_BAD_STATE;
-		}
+		if (block_pos < this_instance->file_len)
+			status = write_erased(this_instance, block_pos,
+					      blocks_to_erase * storage_partition->block_size);
 	}
 
 	return status;
@@ -281,6 +393,14 @@ static psa_status_t file_block_store_erase(void *context, uint32_t client_id,
 
 struct block_store *file_block_store_init(struct file_block_store *this_instance,
 					  const char *filename, size_t block_size)
+{
+	return file_block_store_init_with_mode(this_instance, filename, block_size,
+					       FILE_BLOCK_STORE_MODE_FILE_IO);
+}
+
+struct block_store *file_block_store_init_with_mode(struct file_block_store *this_instance,
+						    const char *filename, size_t block_size,
+						    enum file_block_store_mode mode)
 {
 	struct block_store *block_store = NULL;
 	size_t num_blocks = 0;
@@ -293,7 +413,9 @@ struct block_store *file_block_store_init(struct file_block_store *this_instance
 								file_block_store_close,
 								file_block_store_read,
 								file_block_store_write,
-								file_block_store_erase };
+								file_block_store_erase,
+								file_block_store_read_blocks,
+								file_block_store_write_blocks };
 
 	/* Initialize base block_store */
 	this_instance->base_block_device.base_block_store.context = this_instance;
@@ -302,24 +424,31 @@ struct block_store *file_block_store_init(struct file_block_store *this_instance
 	/* Initialize buffer used for erase operations */
 	memset(this_instance->erase_buf, ERASED_DATA_VAL, sizeof(this_instance->erase_buf));
 
-	/* Open the file */
-	this_instance->file_handle = fopen(filename, "r+b");
+	this_instance->mode = mode;
+	this_instance->file_len = 0;
+	this_instance->map = NULL;
+	this_instance->map_len = 0;
 
-	if (this_instance->file_handle) {
-		/* File already exists so initialise the view of the number of blocks */
-		ssize_t file_len = file_length(this_instance->file_handle);
+	/* Open the file, creating an empty one if it doesn't exist */
+	this_instance->fd = open(filename, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
 
-		if (file_len >= 0)
-			num_blocks = (size_t)file_len / block_size;
+	if (this_instance->fd >= 0) {
+		struct stat file_stat;
 
-	} else {
-		/* File doesn't exist so create an empty one */
-		this_instance->file_handle = fopen(filename, "w+b");
-	}
+		if (!fstat(this_instance->fd, &file_stat)) {
+			/* Initialise the view of the number of blocks from any existing file */
+			this_instance->file_len = (size_t)file_stat.st_size;
+			num_blocks = this_instance->file_len / block_size;
+
+			map_file(this_instance);
 
-	if (this_instance->file_handle)
-		block_store = block_device_init(&this_instance->base_block_device, NULL, num_blocks,
-						block_size);
+			block_store = block_device_init(&this_instance->base_block_device, NULL,
+							num_blocks, block_size);
+		} else {
+			close(this_instance->fd);
+			this_instance->fd = -1;
+		}
+	}
 
 	return block_store;
 }
@@ -328,9 +457,11 @@ void file_block_store_deinit(struct file_block_store *this_instance)
 {
 	assert(this_instance);
 
-	if (this_instance->file_handle) {
-		fclose(this_instance->file_handle);
-		this_instance->file_handle = NULL;
+	unmap_file(this_instance);
+
+	if (this_instance->fd >= 0) {
+		close(this_instance->fd);
+		this_instance->fd = -1;
 	}
 
 	block_device_deinit(&this_instance->base_block_device);
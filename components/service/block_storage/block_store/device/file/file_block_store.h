@@ -8,8 +8,8 @@
 #ifndef FILE_BLOCK_STORE_H
 #define FILE_BLOCK_STORE_H
 
+#include <stddef.h>
 #include <stdint.h>
-#include <stdio.h>
 
 #include "service/block_storage/block_store/device/block_device.h"
 
@@ -23,11 +23,23 @@ extern "C" {
  * A file_block_store is a block_device that uses a file for storage.
  * The file represents a real storage device organized as a series of
  * consecutive blocks. The file_block_store can be used for accessing disk
- * image files in a Posix environment.
+ * image files in a Posix environment. File data is accessed with pread/pwrite
+ * so concurrent reads don't contend for a shared file position.
  */
+enum file_block_store_mode {
+	/* Access the file with pread/pwrite */
+	FILE_BLOCK_STORE_MODE_FILE_IO,
+	/* Map the file into memory. Suits read-mostly disk images */
+	FILE_BLOCK_STORE_MODE_MMAP
+};
+
 struct file_block_store {
 	struct block_device base_block_device;
-	FILE *file_handle;
+	int fd;
+	size_t file_len;
+	enum file_block_store_mode mode;
+	uint8_t *map;
+	size_t map_len;
 	uint8_t erase_buf[256];
 };
 
@@ -43,6 +55,23 @@ struct file_block_store {
 struct block_store *file_block_store_init(struct file_block_store *file_block_store,
 					  const char *filename, size_t block_size);
 
+/**
+ * \brief Initialize a file_block_store with a specified access mode
+ *
+ * In FILE_BLOCK_STORE_MODE_MMAP mode, reads and writes within the file are
+ * served from a shared mapping that is re-established whenever the file grows.
+ *
+ * \param[in]  file_block_store  The subject file_block_store
+ * \param[in]  filename          The host filename used for storage
+ * \param[in]  block_size        The storage block size
+ * \param[in]  mode              How file data is accessed
+ *
+ * \return Pointer to block_store or NULL on failure
+ */
+struct block_store *file_block_store_init_with_mode(struct file_block_store *file_block_store,
+						    const char *filename, size_t block_size,
+						    enum file_block_store_mode mode);
+
 /**
  * \brief De-initialize a file_block_store
  *
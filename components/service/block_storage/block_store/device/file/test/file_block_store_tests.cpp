@@ -127,6 +127,55 @@ TEST(FileBlockStoreTests, wholeBlockRw)
 	erase_blocks(6, 1);
 }
 
+/*
+ * Check writes and reads that span multiple blocks.
+ */
+TEST(FileBlockStoreTests, multiBlockRw)
+{
+	struct block_store *bs = &m_file_block_store.base_block_device.base_block_store;
+	uint8_t write_buf[BLOCK_SIZE * 3];
+	uint8_t read_buf[BLOCK_SIZE * 3];
+	size_t num_written = 0;
+	size_t num_read = 0;
+	size_t offset = 17;
+
+	for (size_t i = 0; i < sizeof(write_buf); i++)
+		write_buf[i] = (uint8_t)i;
+
+	/* Write from part way into block 4, extending the file on the way */
+	psa_status_t status = block_store_write_blocks(bs, CLIENT_ID, m_partition_handle, 4,
+						       offset, write_buf, sizeof(write_buf),
+						       &num_written);
+
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(write_buf), num_written);
+
+	/* Blocks written before the write position should read as erased */
+	check_block(3, 0, BLOCK_SIZE, 0xff);
+	check_block(4, 0, offset, 0xff);
+
+	status = block_store_read_blocks(bs, CLIENT_ID, m_partition_handle, 4, offset,
+					 sizeof(read_buf), read_buf, &num_read);
+
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(read_buf), num_read);
+	MEMCMP_EQUAL(write_buf, read_buf, sizeof(read_buf));
+
+	/* A single block read should still stop at the end of the block */
+	status = block_store_read(bs, CLIENT_ID, m_partition_handle, 4, offset,
+				  sizeof(read_buf), read_buf, &num_read);
+
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(BLOCK_SIZE - offset, num_read);
+
+	/* Expect the write to be clipped at the end of the partition */
+	status = block_store_write_blocks(bs, CLIENT_ID, m_partition_handle, NUM_BLOCKS - 1, 0,
+					  write_buf, sizeof(write_buf), &num_written);
+
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(BLOCK_SIZE, num_written);
+}
+
 /*
  * Check state when initialised with existing disk image file
  */
@@ -164,3 +213,62 @@ TEST(FileBlockStoreTests, initWithExistingDiskImage)
 	UNSIGNED_LONGS_EQUAL(NUM_BLOCKS, disk_info.num_blocks);
 	UNSIGNED_LONGS_EQUAL(BLOCK_SIZE, disk_info.block_size);
 }
+
+/*
+ * Check the mmap access mode, including growth of a mapped file and persistence
+ * of data written through the mapping.
+ */
+TEST(FileBlockStoreTests, mmapModeRw)
+{
+	size_t num_written = 0;
+
+	/* Create a small disk image, then reopen it in mmap mode */
+	set_block(1, 0, BLOCK_SIZE, 'a', &num_written);
+	UNSIGNED_LONGS_EQUAL(BLOCK_SIZE, num_written);
+
+	block_store_close(&m_file_block_store.base_block_device.base_block_store, CLIENT_ID,
+			  m_partition_handle);
+	file_block_store_deinit(&m_file_block_store);
+
+	struct block_store *block_store = file_block_store_init_with_mode(
+		&m_file_block_store, m_filename.c_str(), BLOCK_SIZE, FILE_BLOCK_STORE_MODE_MMAP);
+
+	CHECK_TRUE(block_store);
+
+	psa_status_t status = file_block_store_configure(&m_file_block_store, &m_disk_guid,
+							 NUM_BLOCKS, BLOCK_SIZE);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_open(block_store, CLIENT_ID, &m_disk_guid, &m_partition_handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	/* Existing data is visible and in-place writes and erases go through the mapping */
+	check_block(0, 0, BLOCK_SIZE, 0xff);
+	check_block(1, 0, BLOCK_SIZE, 'a');
+	set_block(0, 100, 50, 'b', &num_written);
+	UNSIGNED_LONGS_EQUAL(50, num_written);
+	check_block(0, 100, 50, 'b');
+	erase_blocks(1, 1);
+	check_block(1, 0, BLOCK_SIZE, 0xff);
+
+	/* Writing beyond the end of the file grows the mapped file */
+	set_block(20, 0, BLOCK_SIZE, 'c', &num_written);
+	UNSIGNED_LONGS_EQUAL(BLOCK_SIZE, num_written);
+	check_block(10, 0, BLOCK_SIZE, 0xff);
+	check_block(20, 0, BLOCK_SIZE, 'c');
+
+	/* Reopen using file I/O and check data written through the mapping persists */
+	block_store_close(block_store, CLIENT_ID, m_partition_handle);
+	file_block_store_deinit(&m_file_block_store);
+
+	block_store = file_block_store_init(&m_file_block_store, m_filename.c_str(), BLOCK_SIZE);
+	CHECK_TRUE(block_store);
+
+	status = block_store_open(block_store, CLIENT_ID, &m_disk_guid, &m_partition_handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	check_block(0, 0, 100, 0xff);
+	check_block(0, 100, 50, 'b');
+	check_block(1, 0, BLOCK_SIZE, 0xff);
+	check_block(20, 0, BLOCK_SIZE, 'c');
+}
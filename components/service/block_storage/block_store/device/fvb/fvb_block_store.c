@@ -146,6 +146,89 @@ static psa_status_t fvb_block_store_write(void *context,
 	return status;
 }
 
+static psa_status_t fvb_block_store_read_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	struct fvb_block_store *this_instance = (struct fvb_block_store *)context;
+	const struct storage_partition *storage_partition =
+		&this_instance->base_block_device.storage_partition;
+	psa_status_t status = PSA_SUCCESS;
+	size_t total_len = 0;
+	size_t len = storage_partition_clip_length(storage_partition, lba, offset, buffer_size);
+
+	*data_len = 0;
+
+	/* FVB transfers can't cross a block boundary so read a block at a time */
+	do {
+		size_t bytes_remaining = storage_partition->block_size - offset;
+		size_t read_len = 0;
+
+		status = fvb_block_store_read(context, client_id, handle, lba, offset,
+			(len - total_len < bytes_remaining) ? len - total_len : bytes_remaining,
+			&buffer[total_len], &read_len);
+
+		if ((status != PSA_SUCCESS) || !read_len)
+			break;
+
+		total_len += read_len;
+		++lba;
+		offset = 0;
+
+	} while (total_len < len);
+
+	*data_len = total_len;
+
+	return status;
+}
+
+static psa_status_t fvb_block_store_write_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	struct fvb_block_store *this_instance = (struct fvb_block_store *)context;
+	const struct storage_partition *storage_partition =
+		&this_instance->base_block_device.storage_partition;
+	psa_status_t status = PSA_SUCCESS;
+	size_t total_len = 0;
+	size_t len = storage_partition_clip_length(storage_partition, lba, offset, data_len);
+
+	*num_written = 0;
+
+	/* FVB transfers can't cross a block boundary so write a block at a time */
+	do {
+		size_t bytes_remaining = storage_partition->block_size - offset;
+		size_t write_len = 0;
+
+		status = fvb_block_store_write(context, client_id, handle, lba, offset,
+			&data[total_len],
+			(len - total_len < bytes_remaining) ? len - total_len : bytes_remaining,
+			&write_len);
+
+		if ((status != PSA_SUCCESS) || !write_len)
+			break;
+
+		total_len += write_len;
+		++lba;
+		offset = 0;
+
+	} while (total_len < len);
+
+	*num_written = total_len;
+
+	return status;
+}
+
 static psa_status_t fvb_block_store_erase(void *context,
 	uint32_t client_id,
 	storage_partition_handle_t handle,
@@ -205,7 +288,9 @@ struct block_store *fvb_block_store_init(
 		fvb_block_store_close,
 		fvb_block_store_read,
 		fvb_block_store_write,
-		fvb_block_store_erase
+		fvb_block_store_erase,
+		fvb_block_store_read_blocks,
+		fvb_block_store_write_blocks
 	};
 
 	/* Initialize base block_store */
@@ -113,6 +113,77 @@ static psa_status_t null_block_store_write(void *context,
 	return status;
 }
 
+static psa_status_t null_block_store_read_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	const struct null_block_store *null_block_store = (struct null_block_store*)context;
+	psa_status_t status = block_device_check_access_permitted(
+		&null_block_store->base_block_device, client_id, handle);
+
+	if (status == PSA_SUCCESS) {
+
+		const struct storage_partition *storage_partition =
+			&null_block_store->base_block_device.storage_partition;
+
+		if (storage_partition_is_lba_legal(storage_partition, lba) &&
+			(offset < storage_partition->block_size)) {
+
+			/* Just real zeros, up to the end of the partition */
+			size_t bytes_to_read = storage_partition_clip_length(storage_partition,
+				lba, offset, buffer_size);
+
+			memset(buffer, 0, bytes_to_read);
+			*data_len = bytes_to_read;
+		}
+		else {
+
+			status = PSA_ERROR_INVALID_ARGUMENT;
+		}
+	}
+
+	return status;
+}
+
+static psa_status_t null_block_store_write_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	struct null_block_store *null_block_store = (struct null_block_store*)context;
+	psa_status_t status = block_device_check_access_permitted(
+		&null_block_store->base_block_device, client_id, handle);
+
+	if (status == PSA_SUCCESS) {
+
+		const struct storage_partition *storage_partition =
+			&null_block_store->base_block_device.storage_partition;
+
+		if (storage_partition_is_lba_legal(storage_partition, lba) &&
+			(offset < storage_partition->block_size)) {
+
+			/* Don't actually write anything */
+			*num_written = storage_partition_clip_length(storage_partition,
+				lba, offset, data_len);
+		}
+		else {
+
+			status = PSA_ERROR_INVALID_ARGUMENT;
+		}
+	}
+
+	return status;
+}
+
 static psa_status_t null_block_store_erase(void *context,
 	uint32_t client_id,
 	storage_partition_handle_t handle,
@@ -149,7 +220,9 @@ struct block_store *null_block_store_init(
 		null_block_store_close,
 		null_block_store_read,
 		null_block_store_write,
-		null_block_store_erase
+		null_block_store_erase,
+		null_block_store_read_blocks,
+		null_block_store_write_blocks
 	};
 
 	/* Initialize base block_store */
@@ -7,6 +7,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "ram_block_store.h"
@@ -14,34 +15,173 @@
 
 #define RAM_BLOCK_STORE_ERASED_VALUE	    (0xff)
 
+#define BITMAP_WORD_BITS		    (64)
+#define BITMAP_NUM_WORDS(num_bits)	    (((num_bits) + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS)
+
+static uint64_t bitmap_word_mask(size_t first_bit, size_t *num_bits)
+{
+	size_t shift = first_bit % BITMAP_WORD_BITS;
+	size_t bits_in_word = BITMAP_WORD_BITS - shift;
+
+	if (*num_bits < bits_in_word)
+		bits_in_word = *num_bits;
+
+	*num_bits = bits_in_word;
+
+	if (bits_in_word == BITMAP_WORD_BITS)
+		return UINT64_MAX;
+
+	return ((UINT64_C(1) << bits_in_word) - 1) << shift;
+}
+
+static void bitmap_set_range(uint64_t *bitmap, size_t first_bit, size_t num_bits)
+{
+	while (num_bits) {
+
+		size_t bits_in_word = num_bits;
+		uint64_t mask = bitmap_word_mask(first_bit, &bits_in_word);
+
+		bitmap[first_bit / BITMAP_WORD_BITS] |= mask;
+		first_bit += bits_in_word;
+		num_bits -= bits_in_word;
+	}
+}
+
+static void bitmap_clear_range(uint64_t *bitmap, size_t first_bit, size_t num_bits)
+{
+	while (num_bits) {
+
+		size_t bits_in_word = num_bits;
+		uint64_t mask = bitmap_word_mask(first_bit, &bits_in_word);
+
+		bitmap[first_bit / BITMAP_WORD_BITS] &= ~mask;
+		first_bit += bits_in_word;
+		num_bits -= bits_in_word;
+	}
+}
+
+static bool bitmap_is_set(const uint64_t *bitmap, size_t bit)
+{
+	return bitmap[bit / BITMAP_WORD_BITS] & (UINT64_C(1) << (bit % BITMAP_WORD_BITS));
+}
+
+static bool is_memory_erased(const uint8_t *mem, size_t len)
+{
+	const uint64_t *word;
+
+	/* Check a byte at a time up to a word boundary, then a word at a time */
+	while (len && ((uintptr_t)mem % sizeof(uint64_t))) {
+
+		if (*mem != RAM_BLOCK_STORE_ERASED_VALUE)
+			return false;
+
+		++mem;
+		--len;
+	}
+
+	for (word = (const uint64_t *)mem; len >= sizeof(uint64_t); ++word) {
+
+		if (*word != UINT64_MAX)
+			return false;
+
+		len -= sizeof(uint64_t);
+	}
+
+	for (mem = (const uint8_t *)word; len; ++mem, --len) {
+
+		if (*mem != RAM_BLOCK_STORE_ERASED_VALUE)
+			return false;
+	}
+
+	return true;
+}
+
+static bool is_range_erased(const struct ram_block_store *ram_block_store,
+	size_t index,
+	size_t len)
+{
+	size_t block_size = ram_block_store->base_block_device.storage_partition.block_size;
+	size_t end_index = index + len;
+
+	while (index < end_index) {
+
+		size_t lba = index / block_size;
+		size_t block_end = (lba + 1) * block_size;
+		size_t check_len = ((end_index < block_end) ? end_index : block_end) - index;
+
+		/* Blocks known to be erased don't need checking */
+		if (!bitmap_is_set(ram_block_store->erased_bitmap, lba) &&
+			!is_memory_erased(&ram_block_store->ram_back_store[index], check_len))
+			return false;
+
+		index += check_len;
+	}
+
+	return true;
+}
+
 static bool is_block_erased(const struct ram_block_store *ram_block_store,
 	uint64_t lba,
 	size_t offset,
 	size_t len)
 {
-	bool is_erased = true;
-	size_t block_start_index =
-		ram_block_store->base_block_device.storage_partition.block_size * lba;
-	size_t block_end_index =
-		block_start_index + ram_block_store->base_block_device.storage_partition.block_size;
+	size_t block_size = ram_block_store->base_block_device.storage_partition.block_size;
+	size_t bytes_remaining = block_size - offset;
 
-	size_t index = block_start_index + offset;
-	size_t end_index = (index + len < block_end_index) ?
-		index + len :
-		block_end_index;
+	return is_range_erased(ram_block_store, block_size * lba + offset,
+		(len < bytes_remaining) ? len : bytes_remaining);
+}
 
-	while (index < end_index) {
+/* Fills any blocks of the range with a pending erase with the erased value */
+static void complete_pending_erase(struct ram_block_store *ram_block_store,
+	size_t index,
+	size_t len)
+{
+	size_t block_size = ram_block_store->base_block_device.storage_partition.block_size;
+	uint64_t *pending = ram_block_store->erase_pending_bitmap;
+	size_t lba;
+	size_t end_lba;
+
+	if (!len)
+		return;
 
-		if (ram_block_store->ram_back_store[index] != RAM_BLOCK_STORE_ERASED_VALUE) {
+	lba = index / block_size;
+	end_lba = (index + len - 1) / block_size + 1;
 
-			is_erased = false;
-			break;
+	while (lba < end_lba) {
+
+		/* Skip whole words of blocks without a pending erase */
+		if (!(pending[lba / BITMAP_WORD_BITS] >> (lba % BITMAP_WORD_BITS))) {
+
+			lba = (lba / BITMAP_WORD_BITS + 1) * BITMAP_WORD_BITS;
+			continue;
+		}
+
+		if (bitmap_is_set(pending, lba)) {
+
+			memset(&ram_block_store->ram_back_store[lba * block_size],
+				RAM_BLOCK_STORE_ERASED_VALUE, block_size);
+			bitmap_clear_range(pending, lba, 1);
 		}
 
-		++index;
+		++lba;
 	}
+}
+
+/* Clears the erased state of the blocks that the range was written to */
+static void mark_range_written(struct ram_block_store *ram_block_store,
+	size_t index,
+	size_t len)
+{
+	size_t block_size = ram_block_store->base_block_device.storage_partition.block_size;
+	size_t lba;
 
-	return is_erased;
+	if (!len)
+		return;
+
+	lba = index / block_size;
+	bitmap_clear_range(ram_block_store->erased_bitmap, lba,
+		(index + len - 1) / block_size + 1 - lba);
 }
 
 static psa_status_t ram_block_store_get_partition_info(void *context,
@@ -101,6 +241,9 @@ static psa_status_t ram_block_store_read(void *context,
 			const uint8_t *block_start =
 				&ram_block_store->ram_back_store[lba * storage_partition->block_size];
 
+			complete_pending_erase(ram_block_store,
+				lba * storage_partition->block_size + offset, bytes_to_read);
+
 			memcpy(buffer, &block_start[offset], bytes_to_read);
 			*data_len = bytes_to_read;
 		}
@@ -145,6 +288,11 @@ static psa_status_t ram_block_store_write(void *context,
 				data_len :
 				bytes_remaining;
 
+			complete_pending_erase(ram_block_store,
+				lba * storage_partition->block_size + offset, bytes_to_write);
+			mark_range_written(ram_block_store,
+				lba * storage_partition->block_size + offset, bytes_to_write);
+
 			memcpy(&block_start[offset], data, bytes_to_write);
 			*num_written = bytes_to_write;
 		}
@@ -157,6 +305,88 @@ static psa_status_t ram_block_store_write(void *context,
 	return status;
 }
 
+static psa_status_t ram_block_store_read_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	struct ram_block_store *ram_block_store = (struct ram_block_store*)context;
+	psa_status_t status = block_device_check_access_permitted(
+		&ram_block_store->base_block_device, client_id, handle);
+
+	if (status == PSA_SUCCESS) {
+
+		const struct storage_partition *storage_partition =
+			&ram_block_store->base_block_device.storage_partition;
+
+		if (storage_partition_is_lba_legal(storage_partition, lba) &&
+			(offset < storage_partition->block_size)) {
+
+			size_t start_index = lba * storage_partition->block_size + offset;
+			size_t bytes_to_read = storage_partition_clip_length(storage_partition,
+				lba, offset, buffer_size);
+
+			complete_pending_erase(ram_block_store, start_index, bytes_to_read);
+
+			memcpy(buffer, &ram_block_store->ram_back_store[start_index], bytes_to_read);
+			*data_len = bytes_to_read;
+		}
+		else {
+
+			status = PSA_ERROR_INVALID_ARGUMENT;
+		}
+	}
+
+	return status;
+}
+
+static psa_status_t ram_block_store_write_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	struct ram_block_store *ram_block_store = (struct ram_block_store*)context;
+	psa_status_t status = block_device_check_access_permitted(
+		&ram_block_store->base_block_device, client_id, handle);
+
+	if (status == PSA_SUCCESS) {
+
+		const struct storage_partition *storage_partition =
+			&ram_block_store->base_block_device.storage_partition;
+
+		if (storage_partition_is_lba_legal(storage_partition, lba) &&
+			(offset < storage_partition->block_size)) {
+
+			size_t start_index = lba * storage_partition->block_size + offset;
+			size_t bytes_to_write = storage_partition_clip_length(storage_partition,
+				lba, offset, data_len);
+
+			if (!is_range_erased(ram_block_store, start_index, bytes_to_write))
+				return PSA_ERROR_STORAGE_FAILURE;
+
+			complete_pending_erase(ram_block_store, start_index, bytes_to_write);
+			mark_range_written(ram_block_store, start_index, bytes_to_write);
+
+			memcpy(&ram_block_store->ram_back_store[start_index], data, bytes_to_write);
+			*num_written = bytes_to_write;
+		}
+		else {
+
+			status = PSA_ERROR_INVALID_ARGUMENT;
+		}
+	}
+
+	return status;
+}
+
 static psa_status_t ram_block_store_erase(void *context,
 	uint32_t client_id,
 	storage_partition_handle_t handle,
@@ -181,12 +411,9 @@ static psa_status_t ram_block_store_erase(void *context,
 		size_t blocks_to_erase = storage_partition_clip_num_blocks(storage_partition,
 			begin_lba, num_blocks);
 
-		uint8_t *erase_from =
-			&ram_block_store->ram_back_store[begin_lba * storage_partition->block_size];
-		size_t erase_len =
-			blocks_to_erase * storage_partition->block_size;
-
-		memset(erase_from, RAM_BLOCK_STORE_ERASED_VALUE, erase_len);
+		/* The back store is filled with the erased value when next accessed */
+		bitmap_set_range(ram_block_store->erased_bitmap, begin_lba, blocks_to_erase);
+		bitmap_set_range(ram_block_store->erase_pending_bitmap, begin_lba, blocks_to_erase);
 	}
 
 	return status;
@@ -208,7 +435,9 @@ struct block_store *ram_block_store_init(
 		ram_block_store_close,
 		ram_block_store_read,
 		ram_block_store_write,
-		ram_block_store_erase
+		ram_block_store_erase,
+		ram_block_store_read_blocks,
+		ram_block_store_write_blocks
 	};
 
 	/* Publish the public interface */
@@ -217,16 +446,34 @@ struct block_store *ram_block_store_init(
 
 	/* Allocate storage and set all to the erased state */
 	size_t back_store_size = num_blocks * block_size;
+	size_t bitmap_size = BITMAP_NUM_WORDS(num_blocks) * sizeof(uint64_t);
+
 	ram_block_store->ram_back_store = (uint8_t*)malloc(back_store_size);
+	ram_block_store->erased_bitmap = (uint64_t*)calloc(1, bitmap_size);
+	ram_block_store->erase_pending_bitmap = (uint64_t*)calloc(1, bitmap_size);
 
-	if (ram_block_store->ram_back_store) {
+	if (ram_block_store->ram_back_store &&
+		ram_block_store->erased_bitmap &&
+		ram_block_store->erase_pending_bitmap) {
 
-		memset(ram_block_store->ram_back_store, RAM_BLOCK_STORE_ERASED_VALUE, back_store_size);
+		bitmap_set_range(ram_block_store->erased_bitmap, 0, num_blocks);
+		bitmap_set_range(ram_block_store->erase_pending_bitmap, 0, num_blocks);
 
 		retval = block_device_init(
 			&ram_block_store->base_block_device, disk_guid, num_blocks, block_size);
 	}
 
+	if (!retval) {
+
+		free(ram_block_store->ram_back_store);
+		free(ram_block_store->erased_bitmap);
+		free(ram_block_store->erase_pending_bitmap);
+
+		ram_block_store->ram_back_store = NULL;
+		ram_block_store->erased_bitmap = NULL;
+		ram_block_store->erase_pending_bitmap = NULL;
+	}
+
 	return retval;
 }
 
@@ -234,6 +481,8 @@ void ram_block_store_deinit(
 	struct ram_block_store *ram_block_store)
 {
 	free(ram_block_store->ram_back_store);
+	free(ram_block_store->erased_bitmap);
+	free(ram_block_store->erase_pending_bitmap);
 
 	block_device_deinit(&ram_block_store->base_block_device);
 }
@@ -254,6 +503,9 @@ psa_status_t ram_block_store_modify(
 		size_t write_len = (offset + data_len < back_store_size) ?
 			data_len : back_store_size - offset;
 
+		complete_pending_erase(ram_block_store, offset, write_len);
+		mark_range_written(ram_block_store, offset, write_len);
+
 		memcpy(&ram_block_store->ram_back_store[offset], data, write_len);
 	} else
 		return PSA_ERROR_INVALID_ARGUMENT;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -21,11 +21,21 @@ extern "C" {
  * It presents a single storage partition with the capacity specified at initialization.
  * The ram_block_store is intended to be used in test integrations where a real
  * NV block_store is either not available or is not needed.
+ *
+ * The erased state of each block is tracked in a bitmap. Erasing a block only marks
+ * it as erased, the back store is filled with the erased value when the block is
+ * next accessed.
  */
 struct ram_block_store
 {
 	struct block_device base_block_device;
 	uint8_t *ram_back_store;
+
+	/* Blocks that hold only the erased value. Writes to these need no erased check. */
+	uint64_t *erased_bitmap;
+
+	/* Erased blocks whose back store hasn't been filled with the erased value yet */
+	uint64_t *erase_pending_bitmap;
 };
 
 /**
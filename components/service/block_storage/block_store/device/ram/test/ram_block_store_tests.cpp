@@ -6,6 +6,7 @@
 
 #include <cstring>
 #include <stdint.h>
+#include <vector>
 #include "common/uuid/uuid.h"
 #include "service/block_storage/block_store/device/ram/ram_block_store.h"
 #include "CppUTest/TestHarness.h"
@@ -188,4 +189,189 @@ TEST(RamBlockStoreTests, eraseOperations)
 
 	status = block_store_close(m_block_store, CLIENT_ID, handle);
 	LONGS_EQUAL(PSA_SUCCESS, status);
-}
\ No newline at end of file
+}
+
+TEST(RamBlockStoreTests, multiBlockReadWrite)
+{
+	storage_partition_handle_t handle;
+	uint8_t write_buffer[BLOCK_SIZE * 4];
+	uint8_t read_buffer[BLOCK_SIZE * 4];
+	size_t data_len = 0;
+	size_t num_written = 0;
+	uint64_t lba = 10;
+	size_t offset = 100;
+
+	psa_status_t status =
+		block_store_open(m_block_store, CLIENT_ID, &m_partition_guid, &handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	/* Write starting part way into a block and spanning following blocks */
+	for (size_t i = 0; i < sizeof(write_buffer); ++i)
+		write_buffer[i] = (uint8_t)i;
+
+	status = block_store_write_blocks(m_block_store, CLIENT_ID, handle, lba,
+		offset, write_buffer, sizeof(write_buffer), &num_written);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(write_buffer), num_written);
+
+	/* Expect to read back the same data in one operation */
+	memset(read_buffer, 0, sizeof(read_buffer));
+	status = block_store_read_blocks(m_block_store, CLIENT_ID, handle, lba,
+		offset, sizeof(read_buffer), read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(read_buffer), data_len);
+	MEMCMP_EQUAL(write_buffer, read_buffer, sizeof(read_buffer));
+
+	/* Expect the same data when read block by block */
+	status = block_store_read(m_block_store, CLIENT_ID, handle, lba + 1,
+		0, BLOCK_SIZE, read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(BLOCK_SIZE, data_len);
+	MEMCMP_EQUAL(&write_buffer[BLOCK_SIZE - offset], read_buffer, BLOCK_SIZE);
+
+	/* A write overlapping any of the written blocks should fail */
+	status = block_store_write_blocks(m_block_store, CLIENT_ID, handle, lba + 3,
+		offset + 10, write_buffer, sizeof(write_buffer), &num_written);
+	LONGS_EQUAL(PSA_ERROR_STORAGE_FAILURE, status);
+
+	/* Expect transfers to be clipped at the end of the partition */
+	status = block_store_erase(m_block_store, CLIENT_ID, handle, NUM_BLOCKS - 2, 2);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_write_blocks(m_block_store, CLIENT_ID, handle, NUM_BLOCKS - 2,
+		0, write_buffer, sizeof(write_buffer), &num_written);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(BLOCK_SIZE * 2, num_written);
+
+	status = block_store_read_blocks(m_block_store, CLIENT_ID, handle, NUM_BLOCKS - 1,
+		offset, sizeof(read_buffer), read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(BLOCK_SIZE - offset, data_len);
+	MEMCMP_EQUAL(&write_buffer[BLOCK_SIZE + offset], read_buffer, data_len);
+
+	status = block_store_close(m_block_store, CLIENT_ID, handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+}
+
+TEST(RamBlockStoreTests, eraseRestoresErasedState)
+{
+	storage_partition_handle_t handle;
+	uint8_t write_buffer[BLOCK_SIZE];
+	uint8_t read_buffer[BLOCK_SIZE];
+	uint8_t erased_block[BLOCK_SIZE];
+	size_t data_len = 0;
+	size_t num_written = 0;
+	uint64_t lba = 63;
+
+	psa_status_t status =
+		block_store_open(m_block_store, CLIENT_ID, &m_partition_guid, &handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	memset(write_buffer, 0x5a, sizeof(write_buffer));
+	memset(erased_block, 0xff, sizeof(erased_block));
+
+	/* Write to blocks either side of a bitmap word boundary */
+	for (uint64_t i = lba; i < lba + 2; ++i) {
+
+		status = block_store_write(m_block_store, CLIENT_ID, handle, i,
+			0, write_buffer, BLOCK_SIZE, &num_written);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+	}
+
+	/* Erasing one of them should leave the other one intact */
+	status = block_store_erase(m_block_store, CLIENT_ID, handle, lba + 1, 1);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_read(m_block_store, CLIENT_ID, handle, lba,
+		0, BLOCK_SIZE, read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	MEMCMP_EQUAL(write_buffer, read_buffer, BLOCK_SIZE);
+
+	status = block_store_read(m_block_store, CLIENT_ID, handle, lba + 1,
+		0, BLOCK_SIZE, read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	MEMCMP_EQUAL(erased_block, read_buffer, BLOCK_SIZE);
+
+	/* A block holding erased values after a write may be written again */
+	status = block_store_write(m_block_store, CLIENT_ID, handle, lba + 1,
+		0, erased_block, BLOCK_SIZE / 2, &num_written);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_write(m_block_store, CLIENT_ID, handle, lba + 1,
+		1, write_buffer, 7, &num_written);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_write(m_block_store, CLIENT_ID, handle, lba + 1,
+		5, write_buffer, 1, &num_written);
+	LONGS_EQUAL(PSA_ERROR_STORAGE_FAILURE, status);
+
+	/* Modifying the back store of an erased block makes it unwritable */
+	status = ram_block_store_modify(&m_ram_block_store,
+		(lba + 2) * BLOCK_SIZE + 100, write_buffer, 1);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_write_blocks(m_block_store, CLIENT_ID, handle, lba + 2,
+		0, write_buffer, BLOCK_SIZE, &num_written);
+	LONGS_EQUAL(PSA_ERROR_STORAGE_FAILURE, status);
+
+	status = block_store_close(m_block_store, CLIENT_ID, handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+}
+
+TEST(RamBlockStoreTests, repeatedWriteErase)
+{
+	/* Spans several bitmap words with a partly used last word */
+	const size_t num_blocks = 130;
+	const unsigned int num_cycles = 3;
+	const size_t store_size = num_blocks * BLOCK_SIZE;
+	struct ram_block_store ram_block_store;
+	storage_partition_handle_t handle;
+	std::vector<uint8_t> buffer(store_size);
+	std::vector<uint8_t> read_buffer(store_size);
+	std::vector<uint8_t> erased(store_size, 0xff);
+	size_t num_written = 0;
+	size_t data_len = 0;
+
+	struct block_store *block_store = ram_block_store_init(&ram_block_store,
+		&m_partition_guid, num_blocks, BLOCK_SIZE);
+	CHECK_TRUE(block_store);
+
+	psa_status_t status =
+		block_store_open(block_store, CLIENT_ID, &m_partition_guid, &handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	for (unsigned int cycle = 0; cycle < num_cycles; ++cycle) {
+
+		for (size_t i = 0; i < store_size; ++i)
+			buffer[i] = (uint8_t)(i ^ (i >> 8) ^ cycle);
+
+		/* Every block is expected to be writable after the previous erase */
+		for (size_t lba = 0; lba < num_blocks; ++lba) {
+
+			status = block_store_write(block_store, CLIENT_ID, handle, lba,
+				0, &buffer[lba * BLOCK_SIZE], BLOCK_SIZE, &num_written);
+			LONGS_EQUAL(PSA_SUCCESS, status);
+		}
+
+		status = block_store_read_blocks(block_store, CLIENT_ID, handle, 0,
+			0, store_size, read_buffer.data(), &data_len);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		UNSIGNED_LONGS_EQUAL(store_size, data_len);
+		MEMCMP_EQUAL(buffer.data(), read_buffer.data(), store_size);
+
+		status = block_store_erase(block_store, CLIENT_ID, handle, 0, num_blocks);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+
+		/* Everything should read back as erased */
+		status = block_store_read_blocks(block_store, CLIENT_ID, handle, 0,
+			0, store_size, read_buffer.data(), &data_len);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		UNSIGNED_LONGS_EQUAL(store_size, data_len);
+		MEMCMP_EQUAL(erased.data(), read_buffer.data(), store_size);
+	}
+
+	status = block_store_close(block_store, CLIENT_ID, handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	ram_block_store_deinit(&ram_block_store);
+}
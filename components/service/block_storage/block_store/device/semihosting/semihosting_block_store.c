@@ -6,6 +6,8 @@
  */
 
 #include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <stddef.h>
 #include <lib/semihosting.h>
@@ -20,10 +22,23 @@ static psa_status_t seek(long handle, ssize_t pos)
 	return PSA_SUCCESS;
 }
 
+static size_t transfer_limit(
+	const struct storage_partition *storage_partition,
+	uint64_t lba, size_t offset,
+	bool multi_block)
+{
+	/* Single block transfers stop at the end of the block, multi-block at the partition end */
+	if (!multi_block)
+		return storage_partition->block_size - offset;
+
+	return storage_partition_clip_length(storage_partition, lba, offset, SIZE_MAX);
+}
+
 static psa_status_t prepare_for_read(
 	const struct semihosting_block_store *this_instance,
 	uint64_t lba, size_t offset,
 	size_t requested_read_len,
+	size_t max_read_len,
 	size_t *adjusted_read_len)
 {
 	psa_status_t status = PSA_ERROR_BAD_STATE;
@@ -40,11 +55,10 @@ static psa_status_t prepare_for_read(
 		if (read_pos <= file_len) {
 
 			size_t bytes_until_end_of_file = (size_t)(file_len - read_pos);
-			size_t bytes_until_end_of_block = storage_partition->block_size - offset;
 
-			size_t read_limit = (bytes_until_end_of_file < bytes_until_end_of_block) ?
+			size_t read_limit = (bytes_until_end_of_file < max_read_len) ?
 				bytes_until_end_of_file :
-				bytes_until_end_of_block;
+				max_read_len;
 
 			*adjusted_read_len = (requested_read_len < read_limit) ?
 				requested_read_len :
@@ -97,6 +111,7 @@ static psa_status_t prepare_for_write(
 	const struct semihosting_block_store *this_instance,
 	uint64_t lba, size_t offset,
 	size_t requested_write_len,
+	size_t max_write_len,
 	size_t *adjusted_write_len)
 {
 	psa_status_t status = PSA_ERROR_BAD_STATE;
@@ -104,10 +119,9 @@ static psa_status_t prepare_for_write(
 	const struct storage_partition *storage_partition =
 		&this_instance->base_block_device.storage_partition;
 
-	size_t bytes_until_end_of_block = storage_partition->block_size - offset;
-	*adjusted_write_len = (requested_write_len < bytes_until_end_of_block) ?
+	*adjusted_write_len = (requested_write_len < max_write_len) ?
 		requested_write_len :
-		bytes_until_end_of_block;
+		max_write_len;
 
 	ssize_t write_pos = lba * storage_partition->block_size + offset;
 	ssize_t file_len = semihosting_file_length(this_instance->file_handle);
@@ -167,14 +181,15 @@ static psa_status_t semihosting_block_store_close(void *context,
 		&this_instance->base_block_device, client_id, handle);
 }
 
-static psa_status_t semihosting_block_store_read(void *context,
+static psa_status_t read_data(void *context,
 	uint32_t client_id,
 	storage_partition_handle_t handle,
 	uint64_t lba,
 	size_t offset,
 	size_t buffer_size,
 	uint8_t *buffer,
-	size_t *data_len)
+	size_t *data_len,
+	bool multi_block)
 {
 	const struct semihosting_block_store *this_instance =
 		(struct semihosting_block_store*)context;
@@ -198,6 +213,7 @@ static psa_status_t semihosting_block_store_read(void *context,
 				this_instance,
 				lba, offset,
 				buffer_size,
+				transfer_limit(storage_partition, lba, offset, multi_block),
 				&read_len);
 
 			if (status == PSA_SUCCESS) {
@@ -224,14 +240,15 @@ static psa_status_t semihosting_block_store_read(void *context,
 	return status;
 }
 
-static psa_status_t semihosting_block_store_write(void *context,
+static psa_status_t write_data(void *context,
 	uint32_t client_id,
 	storage_partition_handle_t handle,
 	uint64_t lba,
 	size_t offset,
 	const uint8_t *data,
 	size_t data_len,
-	size_t *num_written)
+	size_t *num_written,
+	bool multi_block)
 {
 	struct semihosting_block_store *this_instance = (struct semihosting_block_store*)context;
 	psa_status_t status = block_device_check_access_permitted(
@@ -253,6 +270,7 @@ static psa_status_t semihosting_block_store_write(void *context,
 				this_instance,
 				lba, offset,
 				data_len,
+				transfer_limit(storage_partition, lba, offset, multi_block),
 				&adjusted_len);
 
 			if (status == PSA_SUCCESS) {
@@ -281,6 +299,58 @@ static psa_status_t semihosting_block_store_write(void *context,
 	return status;
 }
 
+static psa_status_t semihosting_block_store_read(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	return read_data(context, client_id, handle, lba, offset,
+		buffer_size, buffer, data_len, false);
+}
+
+static psa_status_t semihosting_block_store_write(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	return write_data(context, client_id, handle, lba, offset,
+		data, data_len, num_written, false);
+}
+
+static psa_status_t semihosting_block_store_read_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	return read_data(context, client_id, handle, lba, offset,
+		buffer_size, buffer, data_len, true);
+}
+
+static psa_status_t semihosting_block_store_write_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	return write_data(context, client_id, handle, lba, offset,
+		data, data_len, num_written, true);
+}
+
 static psa_status_t semihosting_block_store_erase(void *context,
 	uint32_t client_id,
 	storage_partition_handle_t handle,
@@ -347,7 +417,9 @@ struct block_store *semihosting_block_store_init(
 		semihosting_block_store_close,
 		semihosting_block_store_read,
 		semihosting_block_store_write,
-		semihosting_block_store_erase
+		semihosting_block_store_erase,
+		semihosting_block_store_read_blocks,
+		semihosting_block_store_write_blocks
 	};
 
 	/* Initialize base block_store */
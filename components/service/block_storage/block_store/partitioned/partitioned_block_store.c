@@ -286,6 +286,103 @@ static psa_status_t partitioned_block_store_erase(void *context,
 	return status;
 }
 
+static psa_status_t partitioned_block_store_read_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	const struct partitioned_block_store *partitioned_block_store =
+		(struct partitioned_block_store*)context;
+
+	const struct storage_partition *partition = NULL;
+
+	psa_status_t status = validate_partition_request(
+		partitioned_block_store,
+		client_id,
+		handle,
+		&partition);
+
+	if (status == PSA_SUCCESS) {
+
+		if (storage_partition_is_lba_legal(partition, lba)) {
+
+			size_t clipped_read_len = storage_partition_clip_length(
+				partition,
+				lba, offset,
+				buffer_size);
+
+			/* Read from underlying back store */
+			status = block_store_read_blocks(
+				partitioned_block_store->back_store,
+				partitioned_block_store->local_client_id,
+				partitioned_block_store->back_store_handle,
+				partition->base_lba + lba,
+				offset,
+				clipped_read_len,
+				buffer,
+				data_len);
+		}
+		else {
+
+			status = PSA_ERROR_INVALID_ARGUMENT;
+		}
+	}
+
+	return status;
+}
+
+static psa_status_t partitioned_block_store_write_blocks(void *context,
+	uint32_t client_id,
+	storage_partition_handle_t handle,
+	uint64_t lba,
+	size_t offset,
+	const uint8_t *data,
+	size_t data_len,
+	size_t *num_written)
+{
+	const struct partitioned_block_store *partitioned_block_store =
+		(struct partitioned_block_store*)context;
+
+	const struct storage_partition *partition = NULL;
+
+	psa_status_t status = validate_partition_request(
+		partitioned_block_store,
+		client_id,
+		handle,
+		&partition);
+
+	if (status == PSA_SUCCESS) {
+
+		if (storage_partition_is_lba_legal(partition, lba)) {
+
+			size_t clipped_data_len = storage_partition_clip_length(
+				partition, lba, offset,
+				data_len);
+
+			/* Write to underlying back store */
+			status = block_store_write_blocks(
+				partitioned_block_store->back_store,
+				partitioned_block_store->local_client_id,
+				partitioned_block_store->back_store_handle,
+				partition->base_lba + lba,
+				offset,
+				data,
+				clipped_data_len,
+				num_written);
+		}
+		else {
+
+			status = PSA_ERROR_INVALID_ARGUMENT;
+		}
+	}
+
+	return status;
+}
+
 struct block_store *partitioned_block_store_init(
 	struct partitioned_block_store *partitioned_block_store,
 	uint32_t local_client_id,
@@ -301,7 +398,9 @@ struct block_store *partitioned_block_store_init(
 		partitioned_block_store_close,
 		partitioned_block_store_read,
 		partitioned_block_store_write,
-		partitioned_block_store_erase
+		partitioned_block_store_erase,
+		partitioned_block_store_read_blocks,
+		partitioned_block_store_write_blocks
 	};
 
 	/* Initialize base block_store */
@@ -4,11 +4,16 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdbool.h>
+#include <stdlib.h>
 #include "protocols/service/block_storage/packed-c/opcodes.h"
 #include "protocols/rpc/common/packed-c/status.h"
 #include "block_storage_provider.h"
 #include "block_storage_uuid.h"
 
+/* Number of ranges from a vectored write request passed to the block_store at a time */
+#define BLOCK_STORAGE_PROVIDER_VEC_BATCH	(16)
+
 /* Service request handlers */
 static rpc_status_t get_partition_info_handler(void *context, struct rpc_request *req);
 static rpc_status_t open_handler(void *context, struct rpc_request *req);
@@ -16,6 +21,10 @@ static rpc_status_t close_handler(void *context, struct rpc_request *req);
 static rpc_status_t read_handler(void *context, struct rpc_request *req);
 static rpc_status_t write_handler(void *context, struct rpc_request *req);
 static rpc_status_t erase_handler(void *context, struct rpc_request *req);
+static rpc_status_t read_blocks_handler(void *context, struct rpc_request *req);
+static rpc_status_t write_blocks_handler(void *context, struct rpc_request *req);
+static rpc_status_t read_vec_handler(void *context, struct rpc_request *req);
+static rpc_status_t write_vec_handler(void *context, struct rpc_request *req);
 
 /* Handler mapping table for service */
 static const struct service_handler handler_table[] = {
@@ -24,7 +33,11 @@ static const struct service_handler handler_table[] = {
 	{TS_BLOCK_STORAGE_OPCODE_CLOSE,              close_handler},
 	{TS_BLOCK_STORAGE_OPCODE_READ,               read_handler},
 	{TS_BLOCK_STORAGE_OPCODE_WRITE,              write_handler},
-	{TS_BLOCK_STORAGE_OPCODE_ERASE,              erase_handler}
+	{TS_BLOCK_STORAGE_OPCODE_ERASE,              erase_handler},
+	{TS_BLOCK_STORAGE_OPCODE_READ_BLOCKS,        read_blocks_handler},
+	{TS_BLOCK_STORAGE_OPCODE_WRITE_BLOCKS,       write_blocks_handler},
+	{TS_BLOCK_STORAGE_OPCODE_READ_VEC,           read_vec_handler},
+	{TS_BLOCK_STORAGE_OPCODE_WRITE_VEC,          write_vec_handler}
 };
 
 struct rpc_service_interface *block_storage_provider_init(
@@ -164,7 +177,7 @@ static rpc_status_t close_handler(void *context, struct rpc_request *req)
 	return rpc_status;
 }
 
-static rpc_status_t read_handler(void *context, struct rpc_request *req)
+static rpc_status_t handle_read(void *context, struct rpc_request *req, bool multi_block)
 {
 	struct block_storage_provider *this_instance = (struct block_storage_provider*)context;
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
@@ -186,7 +199,7 @@ static rpc_status_t read_handler(void *context, struct rpc_request *req)
 		if (len > req->response.size)
 			len = req->response.size;
 
-		psa_status_t op_status = block_store_read(
+		psa_status_t op_status = (multi_block ? block_store_read_blocks : block_store_read)(
 			this_instance->block_store,
 			req->source_id,
 			handle,
@@ -202,7 +215,7 @@ static rpc_status_t read_handler(void *context, struct rpc_request *req)
 	return rpc_status;
 }
 
-static rpc_status_t write_handler(void *context, struct rpc_request *req)
+static rpc_status_t handle_write(void *context, struct rpc_request *req, bool multi_block)
 {
 	struct block_storage_provider *this_instance = (struct block_storage_provider*)context;
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
@@ -225,7 +238,7 @@ static rpc_status_t write_handler(void *context, struct rpc_request *req)
 
 		size_t num_written = 0;
 
-		psa_status_t op_status = block_store_write(
+		psa_status_t op_status = (multi_block ? block_store_write_blocks : block_store_write)(
 			this_instance->block_store,
 			req->source_id,
 			handle,
@@ -247,6 +260,177 @@ static rpc_status_t write_handler(void *context, struct rpc_request *req)
 	return rpc_status;
 }
 
+static rpc_status_t read_handler(void *context, struct rpc_request *req)
+{
+	return handle_read(context, req, false);
+}
+
+static rpc_status_t write_handler(void *context, struct rpc_request *req)
+{
+	return handle_write(context, req, false);
+}
+
+static rpc_status_t read_blocks_handler(void *context, struct rpc_request *req)
+{
+	/* As read but the read may span contiguous blocks */
+	return handle_read(context, req, true);
+}
+
+static rpc_status_t write_blocks_handler(void *context, struct rpc_request *req)
+{
+	/* As write but the write may span contiguous blocks */
+	return handle_write(context, req, true);
+}
+
+static rpc_status_t deserialize_vec_batch(const struct block_storage_serializer *serializer,
+	const struct rpc_buffer *req_buf,
+	size_t first_range,
+	size_t num_ranges,
+	struct block_store_range *ranges,
+	size_t *batch_size,
+	size_t *batch_len)
+{
+	rpc_status_t rpc_status = RPC_SUCCESS;
+
+	*batch_size = num_ranges - first_range;
+	*batch_len = 0;
+
+	if (*batch_size > BLOCK_STORAGE_PROVIDER_VEC_BATCH)
+		*batch_size = BLOCK_STORAGE_PROVIDER_VEC_BATCH;
+
+	for (size_t i = 0; (i < *batch_size) && (rpc_status == RPC_SUCCESS); ++i) {
+
+		rpc_status = serializer->deserialize_vec_range(req_buf, first_range + i, &ranges[i]);
+		*batch_len += ranges[i].len;
+	}
+
+	return rpc_status;
+}
+
+static rpc_status_t read_vec_handler(void *context, struct rpc_request *req)
+{
+	struct block_storage_provider *this_instance = (struct block_storage_provider*)context;
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+
+	struct rpc_buffer *req_buf = &req->request;
+	const struct block_storage_serializer *serializer =
+		get_block_storage_serializer(this_instance, req);
+
+	storage_partition_handle_t handle = 0;
+	size_t num_ranges = 0;
+
+	if (serializer)
+		rpc_status = serializer->deserialize_read_vec_req(req_buf, &handle, &num_ranges);
+
+	if (rpc_status == RPC_SUCCESS) {
+
+		struct block_store_range *ranges = NULL;
+		size_t read_len = 0;
+
+		/*
+		 * The read data may be returned in the same buffer as the request so
+		 * every range is deserialized before the first read.
+		 */
+		ranges = malloc(num_ranges * sizeof(*ranges));
+
+		if (!ranges && num_ranges) {
+
+			req->service_status = PSA_ERROR_INSUFFICIENT_MEMORY;
+			return RPC_SUCCESS;
+		}
+
+		for (size_t i = 0; (i < num_ranges) && (rpc_status == RPC_SUCCESS); ++i)
+			rpc_status = serializer->deserialize_vec_range(req_buf, i, &ranges[i]);
+
+		if (rpc_status == RPC_SUCCESS) {
+
+			/* Reading stops at the first short read */
+			req->service_status = block_store_read_vec(
+				this_instance->block_store,
+				req->source_id,
+				handle,
+				ranges,
+				num_ranges,
+				req->response.size,
+				(uint8_t *)req->response.data,
+				&read_len);
+
+			req->response.data_length = read_len;
+		}
+
+		free(ranges);
+	}
+
+	return rpc_status;
+}
+
+static rpc_status_t write_vec_handler(void *context, struct rpc_request *req)
+{
+	struct block_storage_provider *this_instance = (struct block_storage_provider*)context;
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+
+	struct rpc_buffer *req_buf = &req->request;
+	const struct block_storage_serializer *serializer =
+		get_block_storage_serializer(this_instance, req);
+
+	storage_partition_handle_t handle = 0;
+	size_t num_ranges = 0;
+	const uint8_t *data = NULL;
+	size_t data_len = 0;
+
+	if (serializer)
+		rpc_status = serializer->deserialize_write_vec_req(req_buf, &handle, &num_ranges,
+			&data, &data_len);
+
+	if (rpc_status == RPC_SUCCESS) {
+
+		psa_status_t op_status = PSA_SUCCESS;
+		size_t total_len = 0;
+		size_t range_index = 0;
+
+		/* Write batches of ranges, stopping at the first short write */
+		while ((range_index < num_ranges) && (op_status == PSA_SUCCESS)) {
+
+			struct block_store_range ranges[BLOCK_STORAGE_PROVIDER_VEC_BATCH];
+			size_t batch_size = 0;
+			size_t batch_len = 0;
+			size_t num_written = 0;
+
+			rpc_status = deserialize_vec_batch(serializer, req_buf, range_index, num_ranges,
+				ranges, &batch_size, &batch_len);
+
+			if (rpc_status != RPC_SUCCESS)
+				break;
+
+			op_status = block_store_write_vec(
+				this_instance->block_store,
+				req->source_id,
+				handle,
+				ranges,
+				batch_size,
+				&data[total_len],
+				data_len - total_len,
+				&num_written);
+
+			total_len += num_written;
+			range_index += batch_size;
+
+			if (num_written != batch_len)
+				break;
+		}
+
+		req->service_status = op_status;
+
+		if ((rpc_status == RPC_SUCCESS) && (op_status == PSA_SUCCESS)) {
+
+			struct rpc_buffer *resp_buf = &req->response;
+			rpc_status = serializer->serialize_write_resp(resp_buf, total_len);
+		}
+	}
+
+	return rpc_status;
+}
+
 static rpc_status_t erase_handler(void *context, struct rpc_request *req)
 {
 	struct block_storage_provider *this_instance = (struct block_storage_provider*)context;
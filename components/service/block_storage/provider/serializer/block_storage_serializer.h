@@ -62,6 +62,23 @@ struct block_storage_serializer {
 		storage_partition_handle_t *handle,
 		uint64_t *begin_lba,
 		size_t *num_blocks);
+
+	/* Operation: read_vec */
+	rpc_status_t (*deserialize_read_vec_req)(const struct rpc_buffer *req_buf,
+		storage_partition_handle_t *handle,
+		size_t *num_ranges);
+
+	/* Operation: write_vec */
+	rpc_status_t (*deserialize_write_vec_req)(const struct rpc_buffer *req_buf,
+		storage_partition_handle_t *handle,
+		size_t *num_ranges,
+		const uint8_t **data,
+		size_t *data_len);
+
+	/* Range descriptor for read_vec and write_vec */
+	rpc_status_t (*deserialize_vec_range)(const struct rpc_buffer *req_buf,
+		size_t index,
+		struct block_store_range *range);
 };
 
 #endif /* BLOCK_STORAGE_PROVIDER_SERIALIZER_H */
@@ -206,6 +206,88 @@ rpc_status_t deserialize_erase_req(const struct rpc_buffer *req_buf,
 	return rpc_status;
 }
 
+/* Operations: read_vec, write_vec */
+static rpc_status_t deserialize_vec_req(const struct rpc_buffer *req_buf,
+	storage_partition_handle_t *handle,
+	size_t *num_ranges,
+	size_t *ranges_end)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INVALID_REQUEST_BODY;
+	struct ts_block_storage_vec_in recv_msg;
+	size_t expected_fixed_len = sizeof(struct ts_block_storage_vec_in);
+
+	if (expected_fixed_len <= req_buf->data_length) {
+
+		memcpy(&recv_msg, req_buf->data, expected_fixed_len);
+
+		/* Check that the range descriptors fit in the request */
+		size_t max_ranges = (req_buf->data_length - expected_fixed_len) /
+			sizeof(struct ts_block_storage_range);
+
+		if (recv_msg.num_ranges <= max_ranges) {
+
+			*handle = recv_msg.handle;
+			*num_ranges = recv_msg.num_ranges;
+			*ranges_end = expected_fixed_len +
+				recv_msg.num_ranges * sizeof(struct ts_block_storage_range);
+
+			rpc_status = RPC_SUCCESS;
+		}
+	}
+
+	return rpc_status;
+}
+
+rpc_status_t deserialize_read_vec_req(const struct rpc_buffer *req_buf,
+	storage_partition_handle_t *handle,
+	size_t *num_ranges)
+{
+	size_t ranges_end = 0;
+
+	return deserialize_vec_req(req_buf, handle, num_ranges, &ranges_end);
+}
+
+rpc_status_t deserialize_write_vec_req(const struct rpc_buffer *req_buf,
+	storage_partition_handle_t *handle,
+	size_t *num_ranges,
+	const uint8_t **data,
+	size_t *data_length)
+{
+	size_t ranges_end = 0;
+	rpc_status_t rpc_status = deserialize_vec_req(req_buf, handle, num_ranges, &ranges_end);
+
+	if (rpc_status == RPC_SUCCESS) {
+
+		*data = (const uint8_t*)req_buf->data + ranges_end;
+		*data_length = req_buf->data_length - ranges_end;
+	}
+
+	return rpc_status;
+}
+
+rpc_status_t deserialize_vec_range(const struct rpc_buffer *req_buf,
+	size_t index,
+	struct block_store_range *range)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INVALID_REQUEST_BODY;
+	struct ts_block_storage_range recv_range;
+	size_t range_pos = sizeof(struct ts_block_storage_vec_in) +
+		index * sizeof(struct ts_block_storage_range);
+
+	if (range_pos + sizeof(struct ts_block_storage_range) <= req_buf->data_length) {
+
+		memcpy(&recv_range, (const uint8_t*)req_buf->data + range_pos, sizeof(recv_range));
+
+		range->lba = recv_range.lba;
+		range->offset = recv_range.offset;
+		range->len = recv_range.len;
+
+		rpc_status = RPC_SUCCESS;
+	}
+
+	return rpc_status;
+}
+
 /* Singleton method to provide access to the serializer instance */
 const struct block_storage_serializer *packedc_block_storage_serializer_instance(void)
 {
@@ -219,7 +301,10 @@ const struct block_storage_serializer *packedc_block_storage_serializer_instance
 		deserialize_read_req,
 		deserialize_write_req,
 		serialize_write_resp,
-		deserialize_erase_req
+		deserialize_erase_req,
+		deserialize_read_vec_req,
+		deserialize_write_vec_req,
+		deserialize_vec_range
 	};
 
 	return &instance;
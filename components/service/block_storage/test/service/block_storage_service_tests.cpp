@@ -5,8 +5,10 @@
  */
 
 #include <cstring>
+#include <vector>
 #include "common/uuid/uuid.h"
 #include "service/block_storage/block_store/block_store.h"
+#include "service/block_storage/block_store/cached/cached_block_store.h"
 #include "service/block_storage/factory/client/block_store_factory.h"
 #include "service/block_storage/config/ref/ref_partition_configurator.h"
 #include "CppUTest/TestHarness.h"
@@ -211,3 +213,363 @@ TEST(BlockStorageServiceTests, blockAccessOperations)
 	status = block_store_close(m_block_store, LOCAL_CLIENT_ID, handle);
 	LONGS_EQUAL(PSA_SUCCESS, status);
 }
+
+TEST(BlockStorageServiceTests, multiBlockAccessOperations)
+{
+	storage_partition_handle_t handle;
+	uint8_t write_buffer[REF_PARTITION_BLOCK_SIZE * 3];
+	uint8_t read_buffer[REF_PARTITION_BLOCK_SIZE * 3];
+	struct storage_partition_info info;
+	size_t offset = REF_PARTITION_BLOCK_SIZE / 2;
+	size_t total_len = 0;
+
+	psa_status_t status = block_store_get_partition_info(
+		m_block_store, &m_partition_4_guid, &info);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_open(
+		m_block_store, LOCAL_CLIENT_ID, &m_partition_4_guid, &handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_erase(
+		m_block_store, LOCAL_CLIENT_ID, handle, 0, info.num_blocks);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	for (size_t i = 0; i < sizeof(write_buffer); ++i)
+		write_buffer[i] = (uint8_t)(i * 3);
+
+	/* Write a range spanning several blocks. Each operation may be limited
+	 * by the RPC payload size so continue until the whole range is written.
+	 */
+	while (total_len < sizeof(write_buffer)) {
+
+		size_t pos = offset + total_len;
+		size_t num_written = 0;
+
+		status = block_store_write_blocks(
+			m_block_store, LOCAL_CLIENT_ID, handle,
+			pos / REF_PARTITION_BLOCK_SIZE, pos % REF_PARTITION_BLOCK_SIZE,
+			&write_buffer[total_len], sizeof(write_buffer) - total_len, &num_written);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		CHECK_TRUE(num_written > 0);
+
+		total_len += num_written;
+	}
+
+	/* Expect to read the same data back */
+	memset(read_buffer, 0, sizeof(read_buffer));
+	total_len = 0;
+
+	while (total_len < sizeof(read_buffer)) {
+
+		size_t pos = offset + total_len;
+		size_t data_len = 0;
+
+		status = block_store_read_blocks(
+			m_block_store, LOCAL_CLIENT_ID, handle,
+			pos / REF_PARTITION_BLOCK_SIZE, pos % REF_PARTITION_BLOCK_SIZE,
+			sizeof(read_buffer) - total_len, &read_buffer[total_len], &data_len);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		CHECK_TRUE(data_len > 0);
+
+		total_len += data_len;
+	}
+
+	MEMCMP_EQUAL(write_buffer, read_buffer, sizeof(read_buffer));
+
+	status = block_store_close(m_block_store, LOCAL_CLIENT_ID, handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+}
+
+TEST(BlockStorageServiceTests, vectoredAccessOperations)
+{
+	storage_partition_handle_t handle;
+	const struct block_store_range ranges[] = {
+		{ 2, 100, 700 },
+		{ 10, 0, REF_PARTITION_BLOCK_SIZE },
+		{ 20, REF_PARTITION_BLOCK_SIZE - 1, 3 },
+		{ 5, 0, 10 }
+	};
+	const size_t num_ranges = sizeof(ranges) / sizeof(ranges[0]);
+	uint8_t write_buffer[700 + REF_PARTITION_BLOCK_SIZE + 3 + 10];
+	uint8_t read_buffer[sizeof(write_buffer)];
+	uint8_t block_buffer[REF_PARTITION_BLOCK_SIZE];
+	struct storage_partition_info info;
+	size_t num_written = 0;
+	size_t data_len = 0;
+
+	psa_status_t status = block_store_get_partition_info(
+		m_block_store, &m_partition_1_guid, &info);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_open(
+		m_block_store, LOCAL_CLIENT_ID, &m_partition_1_guid, &handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_erase(
+		m_block_store, LOCAL_CLIENT_ID, handle, 0, info.num_blocks);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	for (size_t i = 0; i < sizeof(write_buffer); ++i)
+		write_buffer[i] = (uint8_t)(i * 5 + 1);
+
+	/* Write all ranges in one operation */
+	status = block_store_write_vec(
+		m_block_store, LOCAL_CLIENT_ID, handle, ranges, num_ranges,
+		write_buffer, sizeof(write_buffer), &num_written);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(write_buffer), num_written);
+
+	/* Expect to read the same data back */
+	memset(read_buffer, 0, sizeof(read_buffer));
+	status = block_store_read_vec(
+		m_block_store, LOCAL_CLIENT_ID, handle, ranges, num_ranges,
+		sizeof(read_buffer), read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(read_buffer), data_len);
+	MEMCMP_EQUAL(write_buffer, read_buffer, sizeof(read_buffer));
+
+	/* Check the data landed where expected using a plain block read */
+	status = block_store_read(
+		m_block_store, LOCAL_CLIENT_ID, handle, 10,
+		0, sizeof(block_buffer), block_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(block_buffer), data_len);
+	MEMCMP_EQUAL(&write_buffer[700], block_buffer, sizeof(block_buffer));
+
+	/* A read with a short buffer should stop early */
+	status = block_store_read_vec(
+		m_block_store, LOCAL_CLIENT_ID, handle, ranges, num_ranges,
+		800, read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	CHECK_TRUE(data_len >= 700);
+	CHECK_TRUE(data_len <= 800);
+	MEMCMP_EQUAL(write_buffer, read_buffer, data_len);
+
+	status = block_store_close(m_block_store, LOCAL_CLIENT_ID, handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+}
+
+TEST(BlockStorageServiceTests, vectoredAccessManyRanges)
+{
+	storage_partition_handle_t handle;
+	struct block_store_range ranges[32];
+	const size_t num_ranges = sizeof(ranges) / sizeof(ranges[0]);
+	const size_t range_len = 64;
+	uint8_t write_buffer[num_ranges * range_len];
+	uint8_t read_buffer[sizeof(write_buffer)];
+	struct storage_partition_info info;
+	size_t num_written = 0;
+	size_t data_len = 0;
+
+	psa_status_t status = block_store_get_partition_info(
+		m_block_store, &m_partition_1_guid, &info);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_open(
+		m_block_store, LOCAL_CLIENT_ID, &m_partition_1_guid, &handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_erase(
+		m_block_store, LOCAL_CLIENT_ID, handle, 0, info.num_blocks);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	/* More ranges than the provider handles in one batch */
+	for (size_t i = 0; i < num_ranges; ++i) {
+
+		ranges[i].lba = i % info.num_blocks;
+		ranges[i].offset = (i / info.num_blocks) * range_len;
+		ranges[i].len = range_len;
+	}
+
+	for (size_t i = 0; i < sizeof(write_buffer); ++i)
+		write_buffer[i] = (uint8_t)(i * 3 + 7);
+
+	status = block_store_write_vec(
+		m_block_store, LOCAL_CLIENT_ID, handle, ranges, num_ranges,
+		write_buffer, sizeof(write_buffer), &num_written);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(write_buffer), num_written);
+
+	/* Expect every range to be read back in a single call */
+	memset(read_buffer, 0, sizeof(read_buffer));
+	status = block_store_read_vec(
+		m_block_store, LOCAL_CLIENT_ID, handle, ranges, num_ranges,
+		sizeof(read_buffer), read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(read_buffer), data_len);
+	MEMCMP_EQUAL(write_buffer, read_buffer, sizeof(read_buffer));
+
+	status = block_store_close(m_block_store, LOCAL_CLIENT_ID, handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+}
+
+/*
+ * Checks that repeated reads through a cached_block_store stacked over the
+ * client are served from the cache and that writes go through to the service.
+ */
+TEST(BlockStorageServiceTests, cachedAccessOperations)
+{
+	struct cached_block_store cached_store;
+	storage_partition_handle_t handle;
+	uint8_t write_buffer[REF_PARTITION_BLOCK_SIZE];
+	uint8_t read_buffer[REF_PARTITION_BLOCK_SIZE];
+	struct storage_partition_info info;
+	size_t num_written = 0;
+	size_t data_len = 0;
+	uint64_t lba = 2;
+	unsigned int num_reads = 10;
+
+	/* Stack a cached_block_store over the client to cache partition 3 */
+	struct block_store *cached_block_store = cached_block_store_init(
+		&cached_store, LOCAL_CLIENT_ID, &m_partition_3_guid, m_block_store, NULL,
+		2, CACHED_BLOCK_STORE_WRITE_THROUGH);
+	CHECK_TRUE(cached_block_store);
+
+	psa_status_t status = block_store_get_partition_info(
+		cached_block_store, &m_partition_3_guid, &info);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	LONGS_EQUAL(REF_PARTITION_3_ENDING_LBA - REF_PARTITION_3_STARTING_LBA + 1, info.num_blocks);
+
+	status = block_store_open(
+		cached_block_store, LOCAL_CLIENT_ID, &m_partition_3_guid, &handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_erase(
+		cached_block_store, LOCAL_CLIENT_ID, handle, 0, info.num_blocks);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	memset(write_buffer, 0x3c, sizeof(write_buffer));
+	status = block_store_write(
+		cached_block_store, LOCAL_CLIENT_ID, handle, lba, 0,
+		write_buffer, sizeof(write_buffer), &num_written);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(write_buffer), num_written);
+
+	/* Only the first read of the block should reach the service */
+	for (unsigned int i = 0; i < num_reads; ++i) {
+
+		memset(read_buffer, 0, sizeof(read_buffer));
+		status = block_store_read(
+			cached_block_store, LOCAL_CLIENT_ID, handle, lba, 0,
+			sizeof(read_buffer), read_buffer, &data_len);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		UNSIGNED_LONGS_EQUAL(sizeof(read_buffer), data_len);
+		MEMCMP_EQUAL(write_buffer, read_buffer, sizeof(read_buffer));
+	}
+
+	const struct cached_block_store_stats *stats = cached_block_store_get_stats(&cached_store);
+
+	UNSIGNED_LONGS_EQUAL(num_reads - 1, stats->hits);
+
+	/* Expect the write to have gone through to the service */
+	memset(read_buffer, 0, sizeof(read_buffer));
+	status = block_store_read(
+		m_block_store, LOCAL_CLIENT_ID, cached_store.back_store_handle, lba, 0,
+		sizeof(read_buffer), read_buffer, &data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(read_buffer), data_len);
+	MEMCMP_EQUAL(write_buffer, read_buffer, sizeof(read_buffer));
+
+	status = block_store_close(cached_block_store, LOCAL_CLIENT_ID, handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	cached_block_store_deinit(&cached_store);
+}
+
+TEST(BlockStorageServiceTests, wholePartitionTransfers)
+{
+	storage_partition_handle_t handle;
+	struct storage_partition_info info;
+	psa_status_t status = block_store_get_partition_info(
+		m_block_store, &m_partition_1_guid, &info);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = block_store_open(
+		m_block_store, LOCAL_CLIENT_ID, &m_partition_1_guid, &handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	size_t partition_size = info.num_blocks * info.block_size;
+	std::vector<uint8_t> write_buffer(partition_size);
+	std::vector<uint8_t> read_buffer(partition_size);
+	std::vector<struct block_store_range> ranges(info.num_blocks);
+
+	for (size_t i = 0; i < partition_size; ++i)
+		write_buffer[i] = (uint8_t)(i ^ (i >> 8));
+
+	/* One range per block so that vectored transfers do the same work as block transfers */
+	for (size_t i = 0; i < info.num_blocks; ++i) {
+
+		ranges[i].lba = i;
+		ranges[i].offset = 0;
+		ranges[i].len = info.block_size;
+	}
+
+	for (int method = 0; method < 3; ++method) {
+
+		size_t write_calls = 0;
+		size_t read_calls = 0;
+		size_t total = 0;
+
+		status = block_store_erase(
+			m_block_store, LOCAL_CLIENT_ID, handle, 0, info.num_blocks);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+
+		while (total < partition_size) {
+
+			size_t lba = total / info.block_size;
+			size_t offset = total % info.block_size;
+			size_t len = 0;
+
+			if (method == 0)
+				status = block_store_write(m_block_store, LOCAL_CLIENT_ID, handle,
+					lba, 0, &write_buffer[total], info.block_size, &len);
+			else if (method == 1)
+				status = block_store_write_blocks(m_block_store, LOCAL_CLIENT_ID, handle,
+					lba, offset, &write_buffer[total], partition_size - total, &len);
+			else
+				status = block_store_write_vec(m_block_store, LOCAL_CLIENT_ID, handle,
+					&ranges[lba], info.num_blocks - lba,
+					&write_buffer[total], partition_size - total, &len);
+
+			LONGS_EQUAL(PSA_SUCCESS, status);
+			CHECK_TRUE(len > 0);
+			total += len;
+			++write_calls;
+		}
+
+		total = 0;
+
+		while (total < partition_size) {
+
+			size_t lba = total / info.block_size;
+			size_t offset = total % info.block_size;
+			size_t len = 0;
+
+			if (method == 0)
+				status = block_store_read(m_block_store, LOCAL_CLIENT_ID, handle,
+					lba, 0, info.block_size, &read_buffer[total], &len);
+			else if (method == 1)
+				status = block_store_read_blocks(m_block_store, LOCAL_CLIENT_ID, handle,
+					lba, offset, partition_size - total, &read_buffer[total], &len);
+			else
+				status = block_store_read_vec(m_block_store, LOCAL_CLIENT_ID, handle,
+					&ranges[lba], info.num_blocks - lba,
+					partition_size - total, &read_buffer[total], &len);
+
+			LONGS_EQUAL(PSA_SUCCESS, status);
+			CHECK_TRUE(len > 0);
+			total += len;
+			++read_calls;
+		}
+
+		MEMCMP_EQUAL(write_buffer.data(), read_buffer.data(), partition_size);
+
+		/* Multi-block and vectored transfers need no more calls than block transfers */
+		CHECK_TRUE(write_calls <= info.num_blocks);
+		CHECK_TRUE(read_calls <= info.num_blocks);
+	}
+
+	status = block_store_close(m_block_store, LOCAL_CLIENT_ID, handle);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+}
@@ -7,8 +7,29 @@
 #include "service_provider.h"
 #include <protocols/rpc/common/packed-c/status.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
+/* Limits for building a dispatch table, chains exceeding these are walked instead */
+#define DISPATCH_TABLE_MAX_HANDLERS	(UINT8_MAX)
+#define DISPATCH_TABLE_MAX_SPAN		(4096)
+
+struct service_dispatch_entry {
+	const struct service_handler *handler;
+	void *context;
+};
+
+/* The index maps (opcode - opcode_base) to an entry number plus one, zero means not handled */
+struct service_dispatch_table {
+	const struct service_dispatch_entry *entries;
+	const uint8_t *index;
+	uint32_t opcode_base;
+	size_t index_len;
+	struct rpc_service_interface *successor;
+};
+
+static rpc_status_t receive(void *context, struct rpc_request *req);
+
 static const struct service_handler *find_handler(const struct service_provider *sp,
 						  uint32_t opcode)
 {
@@ -50,6 +71,94 @@ static void set_opcode_range(struct service_provider *sp)
 	sp->opcode_range_hi = hi;
 }
 
+static struct service_provider *chained_provider(struct rpc_service_interface *rpc_iface)
+{
+	/* Only successors that are service providers can be included in a dispatch table */
+	if (!rpc_iface || rpc_iface->receive != receive)
+		return NULL;
+
+	return (struct service_provider*)((char*)rpc_iface - offsetof(struct service_provider, iface));
+}
+
+static void build_dispatch_table(struct service_provider *sp)
+{
+	struct service_dispatch_table *table = NULL;
+	struct service_dispatch_entry *entries = NULL;
+	uint8_t *index = NULL;
+	const struct service_provider *link = NULL;
+	struct rpc_service_interface *successor = NULL;
+	uint32_t lo = UINT32_MAX;
+	uint32_t hi = 0;
+	size_t num_handlers = 0;
+	size_t num_entries = 0;
+
+	free(sp->dispatch_table);
+	sp->dispatch_table = NULL;
+
+	/* Determine the opcode span and handler count of the whole chain */
+	for (link = sp; link; link = chained_provider(link->successor)) {
+		if (!link->num_handlers)
+			continue;
+
+		if (link->opcode_range_lo < lo) lo = link->opcode_range_lo;
+		if (link->opcode_range_hi > hi) hi = link->opcode_range_hi;
+
+		num_handlers += link->num_handlers;
+	}
+
+	if (!num_handlers || num_handlers > DISPATCH_TABLE_MAX_HANDLERS ||
+	    hi - lo >= DISPATCH_TABLE_MAX_SPAN)
+		return;
+
+	table = calloc(1, sizeof(*table) + num_handlers * sizeof(*entries) + (hi - lo + 1));
+	if (!table)
+		return;
+
+	entries = (struct service_dispatch_entry *)&table[1];
+	index = (uint8_t *)&entries[num_handlers];
+
+	/* Fill in chain order so that a handler takes precedence over any later one */
+	for (link = sp; link; link = chained_provider(link->successor)) {
+		for (size_t i = 0; i < link->num_handlers; i++) {
+			uint32_t offset = service_handler_get_opcode(&link->handlers[i]) - lo;
+
+			if (index[offset])
+				continue;
+
+			entries[num_entries].handler = &link->handlers[i];
+			entries[num_entries].context = link->iface.context;
+			index[offset] = (uint8_t)++num_entries;
+		}
+
+		successor = link->successor;
+	}
+
+	table->entries = entries;
+	table->index = index;
+	table->opcode_base = lo;
+	table->index_len = hi - lo + 1;
+	table->successor = successor;
+
+	sp->dispatch_table = table;
+}
+
+static rpc_status_t dispatch(const struct service_dispatch_table *table,
+			     struct rpc_request *req)
+{
+	uint32_t offset = (uint32_t)req->opcode - table->opcode_base;
+
+	if (offset < table->index_len && table->index[offset]) {
+		const struct service_dispatch_entry *entry = &table->entries[table->index[offset] - 1];
+
+		return service_handler_invoke(entry->handler, entry->context, req);
+	}
+
+	if (table->successor)
+		return rpc_service_receive(table->successor, req);
+
+	return RPC_ERROR_INVALID_VALUE;
+}
+
 static rpc_status_t receive(void *context, struct rpc_request *req)
 {
 	struct rpc_service_interface *rpc_iface = (struct rpc_service_interface *)context;
@@ -58,6 +167,10 @@ static rpc_status_t receive(void *context, struct rpc_request *req)
 	const struct service_handler *handler = NULL;
 
 	sp = (struct service_provider*)((char*)rpc_iface - offsetof(struct service_provider, iface));
+
+	if (sp->dispatch_table)
+		return dispatch(sp->dispatch_table, req);
+
 	handler = find_handler(sp, req->opcode);
 
 	if (handler) {
@@ -84,13 +197,32 @@ void service_provider_init(struct service_provider *sp, void *context,
 	sp->num_handlers = num_handlers;
 
 	sp->successor = NULL;
+	sp->dispatch_table = NULL;
 
 	set_opcode_range(sp);
 }
 
+void service_provider_deinit(struct service_provider *sp)
+{
+	free(sp->dispatch_table);
+	sp->dispatch_table = NULL;
+}
+
 void service_provider_extend(struct service_provider *context,
 			     struct service_provider *sub_provider)
 {
 	sub_provider->successor = context->successor;
 	context->successor = &sub_provider->iface;
+
+	build_dispatch_table(context);
+}
+
+void service_provider_link_successor(struct service_provider *sp,
+				     struct rpc_service_interface *successor)
+{
+	sp->successor = successor;
+
+	/* Only an extended provider has a dispatch table that needs to cover the new chain */
+	if (sp->dispatch_table)
+		build_dispatch_table(sp);
 }
@@ -36,12 +36,17 @@ static inline uint32_t service_handler_get_opcode(const struct service_handler *
 	return handler->opcode;
 }
 
+/* Opcode indexed handler table of a chain of service providers */
+struct service_dispatch_table;
+
 /** \brief Service provider
  *
  * A generalised service provider that acts as an rpc call endpoint.  It receives call
  * requests and delegates them to the appropriate handle provided by a concrete service
  * provider.  To support service specialization and proxying, unhandled requests may
  * optionally be passed to a delegate rpc_interface to form a chain of responsibility.
+ * When a service provider is extended, a dispatch table covering the whole chain is
+ * built so finding the handler of a request doesn't depend on the length of the chain.
  */
 struct service_provider {
 	struct rpc_service_interface iface;
@@ -50,6 +55,7 @@ struct service_provider {
 	uint32_t opcode_range_lo;
 	uint32_t opcode_range_hi;
 	struct rpc_service_interface *successor;
+	struct service_dispatch_table *dispatch_table;
 };
 
 static inline struct rpc_service_interface *service_provider_get_rpc_interface(struct service_provider *sp)
@@ -61,12 +67,20 @@ void service_provider_init(struct service_provider *sp, void *context,
 			   const struct rpc_uuid *service_uuid,
 			   const struct service_handler *handlers, size_t num_handlers);
 
+/*
+ * Free the dispatch table built for a chain of service providers.  Only needs
+ * to be called for service providers that have been extended.
+ */
+void service_provider_deinit(struct service_provider *sp);
+
 /*
  * Extend the core set of operations provided by a service provider by
  * adding a sub provider that will add a capability.  This facility
  * allows a deployment to customize the set of operations
  * supported to meet requirements by only extending the core service
- * provider if needed.
+ * provider if needed.  Sub providers should be initialized and linked
+ * before being added as the dispatch table of the chain is rebuilt on
+ * each call.
  */
 void service_provider_extend(struct service_provider *context,
 			     struct service_provider *sub_provider);
@@ -76,11 +90,8 @@ void service_provider_extend(struct service_provider *context,
  * to allow call handling to be delegated to different components.  Used to support
  * modular configuration of service capabilities.
  */
-static inline void service_provider_link_successor(struct service_provider *sp,
-						   struct rpc_service_interface *successor)
-{
-	sp->successor = successor;
-}
+void service_provider_link_successor(struct service_provider *sp,
+				     struct rpc_service_interface *successor);
 
 #ifdef __cplusplus
 }
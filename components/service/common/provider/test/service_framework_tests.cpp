@@ -4,8 +4,12 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
-#include <string>
+#include <atomic>
 #include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include <service/common/provider/service_provider.h>
 #include <protocols/rpc/common/packed-c/status.h>
 #include <rpc/direct/direct_caller.h>
@@ -43,6 +47,119 @@ TEST_GROUP(ServiceFrameworkTests)
 		return RPC_SUCCESS;
 	}
 
+	static rpc_status_t handlerThatEchoes(void *context, struct rpc_request* req)
+	{
+		(void)context;
+
+		size_t len = req->request.data_length;
+
+		if (len > req->response.size)
+			return RPC_ERROR_INVALID_RESPONSE_BODY;
+
+		memmove(req->response.data, req->request.data, len);
+		req->response.data_length = len;
+
+		req->service_status = SERVICE_SPECIFIC_SUCCESS_CODE;
+
+		return RPC_SUCCESS;
+	}
+
+	/* The service provider needs to be the first member of its context */
+	struct test_provider {
+		struct service_provider provider;
+		int id;
+	};
+
+	static rpc_status_t handlerThatReturnsId(void *context, struct rpc_request* req)
+	{
+		req->service_status = ((struct test_provider *)context)->id;
+
+		return RPC_SUCCESS;
+	}
+
+	static rpc_status_t callAndGetRpcStatus(struct rpc_service_interface *iface,
+						uint16_t opcode)
+	{
+		struct rpc_request req;
+
+		memset(&req, 0, sizeof(req));
+		req.opcode = opcode;
+
+		return rpc_service_receive(iface, &req);
+	}
+
+	static service_status_t callAndGetServiceStatus(struct rpc_service_interface *iface,
+							uint16_t opcode)
+	{
+		struct rpc_request req;
+
+		memset(&req, 0, sizeof(req));
+		req.opcode = opcode;
+
+		LONGS_EQUAL(RPC_SUCCESS, rpc_service_receive(iface, &req));
+
+		return req.service_status;
+	}
+
+	/* Makes echo calls and returns the number that failed */
+	static unsigned int makeEchoCalls(struct rpc_caller_session *session, std::mutex *lock,
+					  unsigned int thread_id, unsigned int num_calls)
+	{
+		unsigned int num_failed = 0;
+
+		for (unsigned int i = 0; i < num_calls; ++i) {
+			std::unique_lock<std::mutex> session_lock;
+			uint8_t *req_buf;
+			uint8_t *resp_buf;
+			size_t resp_len;
+			service_status_t service_status;
+			uint8_t pattern = (uint8_t)(thread_id * 31 + i);
+
+			/* Single slot sessions need calls to be serialised */
+			if (lock)
+				session_lock = std::unique_lock<std::mutex>(*lock);
+
+			rpc_call_handle handle = rpc_caller_session_begin(session, &req_buf,
+									  ECHO_REQ_LEN, ECHO_REQ_LEN);
+
+			if (!handle) {
+				++num_failed;
+				continue;
+			}
+
+			memset(req_buf, pattern, ECHO_REQ_LEN);
+
+			rpc_status_t rpc_status = rpc_caller_session_invoke(
+				handle, SOME_ARBITRARY_OPCODE, &resp_buf, &resp_len, &service_status);
+
+			if (rpc_status != RPC_SUCCESS || resp_len != ECHO_REQ_LEN ||
+			    resp_buf[0] != pattern || resp_buf[ECHO_REQ_LEN - 1] != pattern)
+				++num_failed;
+
+			rpc_caller_session_end(handle);
+		}
+
+		return num_failed;
+	}
+
+	/* Makes echo calls from concurrent threads and returns the number that failed */
+	static unsigned int makeConcurrentEchoCalls(struct rpc_caller_session *session,
+						    std::mutex *lock)
+	{
+		std::vector<std::thread> threads;
+		std::atomic<unsigned int> failed(0);
+
+		for (unsigned int t = 0; t < NUM_THREADS; ++t)
+			threads.emplace_back([=, &failed]() {
+				failed += makeEchoCalls(session, lock, t, NUM_CALLS_PER_THREAD);
+			});
+
+		for (auto &thread : threads)
+			thread.join();
+
+		return failed;
+	}
+
 	void setup()
 	{
 		memset(&m_direct_caller, 0, sizeof(m_direct_caller));
@@ -60,6 +177,9 @@ TEST_GROUP(ServiceFrameworkTests)
 	static const uint32_t YET_ANOTHER_ARBITRARY_OPCODE = 7;
 	static const int SERVICE_SPECIFIC_ERROR_CODE = 101;
 	static const int SERVICE_SPECIFIC_SUCCESS_CODE = 100;
+	static const size_t ECHO_REQ_LEN = 64;
+	static const unsigned int NUM_THREADS = 4;
+	static const unsigned int NUM_CALLS_PER_THREAD = 1000;
 
 	struct rpc_caller_interface m_direct_caller;
 	struct rpc_caller_session m_session;
@@ -277,4 +397,179 @@ TEST(ServiceFrameworkTests, serviceProviderChain)
 	rpc_caller_session_end(handle);
 
 	LONGS_EQUAL(RPC_ERROR_INVALID_VALUE, rpc_status);
+
+	service_provider_deinit(&base_provider);
+}
+
+TEST(ServiceFrameworkTests, serviceProviderDispatchTable)
+{
+	struct rpc_uuid service_uuid = { .uuid = {
+		0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+		0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef } };
+	struct service_handler base_handlers[2];
+	struct service_handler sub0_handlers[2];
+	struct service_handler sub1_handlers[1];
+	struct service_handler tail_handlers[1];
+	struct test_provider base = { .id = 1 };
+	struct test_provider sub0 = { .id = 2 };
+	struct test_provider sub1 = { .id = 3 };
+	struct test_provider tail = { .id = 4 };
+	struct rpc_service_interface *iface = NULL;
+
+	base_handlers[0].opcode = 100;
+	base_handlers[0].invoke = handlerThatReturnsId;
+	base_handlers[1].opcode = 150;
+	base_handlers[1].invoke = handlerThatReturnsId;
+
+	/* Opcode 150 is also handled by the base which takes precedence */
+	sub0_handlers[0].opcode = 150;
+	sub0_handlers[0].invoke = handlerThatReturnsId;
+	sub0_handlers[1].opcode = 2000;
+	sub0_handlers[1].invoke = handlerThatReturnsId;
+
+	sub1_handlers[0].opcode = 90;
+	sub1_handlers[0].invoke = handlerThatReturnsId;
+
+	tail_handlers[0].opcode = 3000;
+	tail_handlers[0].invoke = handlerThatReturnsId;
+
+	service_provider_init(&base.provider, &base, &service_uuid, base_handlers, 2);
+	service_provider_init(&sub0.provider, &sub0, &service_uuid, sub0_handlers, 2);
+	service_provider_init(&sub1.provider, &sub1, &service_uuid, sub1_handlers, 1);
+	service_provider_init(&tail.provider, &tail, &service_uuid, tail_handlers, 1);
+
+	/* Chain base -> sub1 -> sub0 -> tail */
+	service_provider_link_successor(&base.provider,
+					service_provider_get_rpc_interface(&tail.provider));
+	service_provider_extend(&base.provider, &sub0.provider);
+	service_provider_extend(&base.provider, &sub1.provider);
+
+	iface = service_provider_get_rpc_interface(&base.provider);
+
+	/* Each handler should be invoked with the context of its own provider */
+	LONGS_EQUAL(base.id, callAndGetServiceStatus(iface, 100));
+	LONGS_EQUAL(base.id, callAndGetServiceStatus(iface, 150));
+	LONGS_EQUAL(sub0.id, callAndGetServiceStatus(iface, 2000));
+	LONGS_EQUAL(sub1.id, callAndGetServiceStatus(iface, 90));
+
+	/* Unhandled requests should be passed to the successor at the end of the chain */
+	LONGS_EQUAL(tail.id, callAndGetServiceStatus(iface, 3000));
+	LONGS_EQUAL(RPC_ERROR_INVALID_VALUE, callAndGetRpcStatus(iface, 91));
+
+	/* Replacing the chain should rebuild the dispatch table */
+	service_provider_link_successor(&base.provider,
+					service_provider_get_rpc_interface(&tail.provider));
+
+	LONGS_EQUAL(tail.id, callAndGetServiceStatus(iface, 3000));
+	LONGS_EQUAL(RPC_ERROR_INVALID_VALUE, callAndGetRpcStatus(iface, 2000));
+	LONGS_EQUAL(RPC_ERROR_INVALID_VALUE, callAndGetRpcStatus(iface, 90));
+
+	/* Without a dispatch table the chain should be walked with the same result */
+	service_provider_deinit(&base.provider);
+
+	LONGS_EQUAL(base.id, callAndGetServiceStatus(iface, 150));
+	LONGS_EQUAL(tail.id, callAndGetServiceStatus(iface, 3000));
+	LONGS_EQUAL(RPC_ERROR_INVALID_VALUE, callAndGetRpcStatus(iface, 2000));
+}
+
+TEST(ServiceFrameworkTests, sessionWithSlots)
+{
+	struct rpc_uuid service_uuid = { .uuid = {
+		0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+		0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef } };
+	struct service_handler handlers[1];
+	handlers[0].opcode = SOME_ARBITRARY_OPCODE;
+	handlers[0].invoke = handlerThatEchoes;
+
+	struct service_provider service_provider;
+	rpc_status_t rpc_status;
+
+	service_provider_init(&service_provider, &service_provider, &service_uuid, handlers, 1);
+	rpc_status = direct_caller_init(&m_direct_caller,
+					service_provider_get_rpc_interface(&service_provider));
+	LONGS_EQUAL(RPC_SUCCESS, rpc_status);
+
+	/* Slots need shared memory allocated for the session */
+	rpc_status = rpc_caller_session_find_and_open_with_slots(&m_session, &m_direct_caller,
+								 &service_uuid, 0, NUM_THREADS);
+	LONGS_EQUAL(RPC_ERROR_INVALID_VALUE, rpc_status);
+
+	rpc_status = rpc_caller_session_find_and_open_with_slots(&m_session, &m_direct_caller,
+								 &service_uuid, 4096, NUM_THREADS);
+	LONGS_EQUAL(RPC_SUCCESS, rpc_status);
+
+	/* Expect a call to be able to begin in each slot but no more */
+	rpc_call_handle handles[NUM_THREADS];
+	uint8_t *req_buf[NUM_THREADS];
+	uint8_t *extra_req_buf;
+
+	for (unsigned int i = 0; i < NUM_THREADS; ++i) {
+		handles[i] = rpc_caller_session_begin(&m_session, &req_buf[i], ECHO_REQ_LEN, 0);
+		CHECK_TRUE(handles[i]);
+
+		for (unsigned int j = 0; j < i; ++j)
+			CHECK_TRUE(req_buf[i] != req_buf[j]);
+	}
+
+	POINTERS_EQUAL(NULL, rpc_caller_session_begin(&m_session, &extra_req_buf,
+						      ECHO_REQ_LEN, 0));
+
+	/* Closing the session is refused while calls are in progress */
+	LONGS_EQUAL(RPC_ERROR_INVALID_STATE, rpc_caller_session_close(&m_session));
+
+	/* Complete calls out of order. A freed slot can be reused. */
+	for (unsigned int i = NUM_THREADS; i > 0; --i) {
+		uint8_t *resp_buf;
+		size_t resp_len;
+		service_status_t service_status;
+
+		memset(req_buf[i - 1], i, ECHO_REQ_LEN);
+
+		rpc_status = rpc_caller_session_invoke(handles[i - 1], SOME_ARBITRARY_OPCODE,
+						       &resp_buf, &resp_len, &service_status);
+		LONGS_EQUAL(RPC_SUCCESS, rpc_status);
+		UNSIGNED_LONGS_EQUAL(ECHO_REQ_LEN, resp_len);
+		BYTES_EQUAL(i, resp_buf[0]);
+
+		LONGS_EQUAL(RPC_SUCCESS, rpc_caller_session_end(handles[i - 1]));
+	}
+
+	handles[0] = rpc_caller_session_begin(&m_session, &extra_req_buf, ECHO_REQ_LEN, 0);
+	CHECK_TRUE(handles[0]);
+	LONGS_EQUAL(RPC_SUCCESS, rpc_caller_session_end(handles[0]));
+}
+
+TEST(ServiceFrameworkTests, concurrentCalls)
+{
+	struct rpc_uuid service_uuid = { .uuid = {
+		0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+		0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef } };
+	struct service_handler handlers[1];
+	handlers[0].opcode = SOME_ARBITRARY_OPCODE;
+	handlers[0].invoke = handlerThatEchoes;
+
+	struct service_provider service_provider;
+	rpc_status_t rpc_status;
+	std::mutex session_lock;
+
+	service_provider_init(&service_provider, &service_provider, &service_uuid, handlers, 1);
+	rpc_status = direct_caller_init(&m_direct_caller,
+					service_provider_get_rpc_interface(&service_provider));
+	LONGS_EQUAL(RPC_SUCCESS, rpc_status);
+
+	/* Threads share a single slot session behind a mutex */
+	rpc_status = rpc_caller_session_find_and_open(&m_session, &m_direct_caller, &service_uuid,
+						      4096);
+	LONGS_EQUAL(RPC_SUCCESS, rpc_status);
+
+	UNSIGNED_LONGS_EQUAL(0, makeConcurrentEchoCalls(&m_session, &session_lock));
+
+	LONGS_EQUAL(RPC_SUCCESS, rpc_caller_session_close(&m_session));
+
+	/* Each thread can hold an in-flight call in its own slot */
+	rpc_status = rpc_caller_session_find_and_open_with_slots(&m_session, &m_direct_caller,
+								 &service_uuid, 4096, NUM_THREADS);
+	LONGS_EQUAL(RPC_SUCCESS, rpc_status);
+
+	UNSIGNED_LONGS_EQUAL(0, makeConcurrentEchoCalls(&m_session, NULL));
 }
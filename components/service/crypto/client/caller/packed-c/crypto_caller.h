@@ -13,6 +13,7 @@
  * provided by a crypto service instance using the packed-c serialization.
  */
 #include "crypto_caller_aead.h"
+#include "crypto_caller_batch.h"
 #include "crypto_caller_copy_key.h"
 #include "crypto_caller_generate_key.h"
 #include "crypto_caller_hash.h"
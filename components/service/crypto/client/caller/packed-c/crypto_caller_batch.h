@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PACKEDC_CRYPTO_CALLER_BATCH_H
+#define PACKEDC_CRYPTO_CALLER_BATCH_H
+
+#include <stdbool.h>
+#include <string.h>
+#include <psa/crypto.h>
+#include <service/common/client/service_client.h>
+#include <service/crypto/client/psa/psa_crypto_batch.h>
+#include <protocols/rpc/common/packed-c/status.h>
+#include <protocols/service/crypto/packed-c/batch.h>
+#include <protocols/service/crypto/packed-c/hash.h>
+#include <protocols/service/crypto/packed-c/opcodes.h>
+#include <protocols/service/crypto/packed-c/sign_hash.h>
+#include <protocols/service/crypto/packed-c/verify_hash.h>
+#include <common/tlv/tlv.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns the opcode of a batch operation or zero if the operation is unknown */
+static inline uint32_t crypto_caller_batch_opcode(const struct psa_crypto_batch_op *op)
+{
+	switch (op->type) {
+	case PSA_CRYPTO_BATCH_OP_HASH_COMPUTE:
+		return TS_CRYPTO_OPCODE_HASH_COMPUTE;
+	case PSA_CRYPTO_BATCH_OP_SIGN_HASH:
+		return TS_CRYPTO_OPCODE_SIGN_HASH;
+	case PSA_CRYPTO_BATCH_OP_VERIFY_HASH:
+		return TS_CRYPTO_OPCODE_VERIFY_HASH;
+	case PSA_CRYPTO_BATCH_OP_SIGN_MESSAGE:
+		return TS_CRYPTO_OPCODE_SIGN_MESSAGE;
+	case PSA_CRYPTO_BATCH_OP_VERIFY_MESSAGE:
+		return TS_CRYPTO_OPCODE_VERIFY_MESSAGE;
+	default:
+		return 0;
+	}
+}
+
+static inline bool crypto_caller_batch_op_is_verify(const struct psa_crypto_batch_op *op)
+{
+	return op->type == PSA_CRYPTO_BATCH_OP_VERIFY_HASH ||
+	       op->type == PSA_CRYPTO_BATCH_OP_VERIFY_MESSAGE;
+}
+
+/* Returns the length of the packed-c request parameters of an operation */
+static inline size_t crypto_caller_batch_req_len(const struct psa_crypto_batch_op *op)
+{
+	if (op->type == PSA_CRYPTO_BATCH_OP_HASH_COMPUTE)
+		return sizeof(struct ts_crypto_hash_compute_in) +
+		       tlv_required_space(op->input_length);
+
+	if (crypto_caller_batch_op_is_verify(op))
+		return sizeof(struct ts_crypto_verify_hash_in) +
+		       tlv_required_space(op->input_length) +
+		       tlv_required_space(op->signature_length);
+
+	return sizeof(struct ts_crypto_sign_hash_in) + tlv_required_space(op->input_length);
+}
+
+/* Returns the maximum length of the packed-c response parameters of an operation */
+static inline size_t crypto_caller_batch_resp_len_max(const struct psa_crypto_batch_op *op)
+{
+	if (op->type == PSA_CRYPTO_BATCH_OP_HASH_COMPUTE)
+		return tlv_required_space(
+			(op->output_size < PSA_HASH_MAX_SIZE) ? op->output_size : PSA_HASH_MAX_SIZE);
+
+	if (crypto_caller_batch_op_is_verify(op))
+		return 0;
+
+	return tlv_required_space(
+		(op->output_size < PSA_SIGNATURE_MAX_SIZE) ? op->output_size : PSA_SIGNATURE_MAX_SIZE);
+}
+
+static inline void crypto_caller_batch_encode_op(const struct psa_crypto_batch_op *op,
+	uint8_t *buf, size_t len)
+{
+	struct tlv_iterator req_iter;
+	struct tlv_record record;
+	size_t fixed_len = 0;
+
+	if (op->type == PSA_CRYPTO_BATCH_OP_HASH_COMPUTE) {
+
+		struct ts_crypto_hash_compute_in req_msg;
+
+		req_msg.alg = op->alg;
+		fixed_len = sizeof(req_msg);
+		memcpy(buf, &req_msg, fixed_len);
+
+		record.tag = TS_CRYPTO_HASH_COMPUTE_IN_TAG_DATA;
+	}
+	else {
+
+		/* Sign and verify requests share the same fixed parameters */
+		struct ts_crypto_sign_hash_in req_msg;
+
+		req_msg.id = op->key;
+		req_msg.alg = op->alg;
+		fixed_len = sizeof(req_msg);
+		memcpy(buf, &req_msg, fixed_len);
+
+		if (crypto_caller_batch_op_is_verify(op))
+			record.tag = TS_CRYPTO_VERIFY_HASH_IN_TAG_HASH;
+		else
+			record.tag = TS_CRYPTO_SIGN_HASH_IN_TAG_HASH;
+	}
+
+	record.length = op->input_length;
+	record.value = op->input;
+
+	tlv_iterator_begin(&req_iter, &buf[fixed_len], len - fixed_len);
+	tlv_encode(&req_iter, &record);
+
+	if (crypto_caller_batch_op_is_verify(op)) {
+
+		record.tag = TS_CRYPTO_VERIFY_HASH_IN_TAG_SIGNATURE;
+		record.length = op->signature_length;
+		record.value = op->signature;
+		tlv_encode(&req_iter, &record);
+	}
+}
+
+static inline psa_status_t crypto_caller_batch_decode_op(struct psa_crypto_batch_op *op,
+	const uint8_t *buf, size_t len)
+{
+	struct tlv_const_iterator resp_iter;
+	struct tlv_record decoded_record;
+	uint16_t tag = TS_CRYPTO_SIGN_HASH_OUT_TAG_SIGNATURE;
+
+	if (crypto_caller_batch_op_is_verify(op))
+		return PSA_SUCCESS;
+
+	if (op->type == PSA_CRYPTO_BATCH_OP_HASH_COMPUTE)
+		tag = TS_CRYPTO_HASH_COMPUTE_OUT_TAG_HASH;
+
+	tlv_const_iterator_begin(&resp_iter, buf, len);
+
+	if (!tlv_find_decode(&resp_iter, tag, &decoded_record)) {
+		/* Mandatory response parameter missing */
+		return PSA_ERROR_GENERIC_ERROR;
+	}
+
+	if (decoded_record.length > op->output_size) {
+		/* Provided buffer is too small */
+		return PSA_ERROR_BUFFER_TOO_SMALL;
+	}
+
+	memcpy(op->output, decoded_record.value, decoded_record.length);
+	op->output_length = decoded_record.length;
+
+	return PSA_SUCCESS;
+}
+
+static inline void crypto_caller_batch_decode_resp(struct psa_crypto_batch_op *ops,
+	size_t num_ops, const uint8_t *resp_buf, size_t resp_len)
+{
+	size_t offset = 0;
+
+	for (size_t i = 0; i < num_ops; i++) {
+
+		struct ts_crypto_batch_item_out item;
+		size_t fixed_len = sizeof(struct ts_crypto_batch_item_out);
+
+		if (!crypto_caller_batch_opcode(&ops[i]))
+			continue;
+
+		if (resp_len - offset < fixed_len)
+			break; /* The remaining operations were not executed */
+
+		memcpy(&item, &resp_buf[offset], fixed_len);
+		offset += fixed_len;
+
+		if (item.length > resp_len - offset)
+			break;
+
+		if (item.rpc_status == RPC_SUCCESS) {
+
+			ops[i].status = item.service_status;
+
+			if (ops[i].status == PSA_SUCCESS)
+				ops[i].status = crypto_caller_batch_decode_op(&ops[i],
+					&resp_buf[offset], item.length);
+		}
+		else if (item.rpc_status == RPC_ERROR_INVALID_VALUE) {
+
+			/* The service doesn't implement the operation */
+			ops[i].status = PSA_ERROR_NOT_SUPPORTED;
+		}
+
+		offset += item.length;
+	}
+}
+
+static inline psa_status_t crypto_caller_batch(struct service_client *context,
+	struct psa_crypto_batch_op *ops,
+	size_t num_ops)
+{
+	psa_status_t psa_status = PSA_ERROR_GENERIC_ERROR;
+	size_t req_len = 0;
+	size_t resp_len_max = 0;
+
+	for (size_t i = 0; i < num_ops; i++) {
+
+		ops[i].output_length = 0;
+
+		if (!crypto_caller_batch_opcode(&ops[i])) {
+			ops[i].status = PSA_ERROR_NOT_SUPPORTED;
+			continue;
+		}
+
+		/* For operations that the service didn't return a result for */
+		ops[i].status = PSA_ERROR_GENERIC_ERROR;
+
+		req_len += sizeof(struct ts_crypto_batch_item_in) +
+			crypto_caller_batch_req_len(&ops[i]);
+		resp_len_max += sizeof(struct ts_crypto_batch_item_out) +
+			crypto_caller_batch_resp_len_max(&ops[i]);
+	}
+
+	if (!req_len)
+		return PSA_SUCCESS;
+
+	/* The caller falls back to individual calls if the batch doesn't fit */
+	if (context->service_info.max_payload &&
+	    (req_len > context->service_info.max_payload ||
+	     resp_len_max > context->service_info.max_payload))
+		return PSA_ERROR_NOT_SUPPORTED;
+
+	rpc_call_handle call_handle;
+	uint8_t *req_buf;
+
+	call_handle = rpc_caller_session_begin(context->session, &req_buf, req_len, resp_len_max);
+
+	if (call_handle) {
+
+		uint8_t *resp_buf;
+		size_t resp_len;
+		service_status_t service_status;
+		size_t offset = 0;
+
+		for (size_t i = 0; i < num_ops; i++) {
+
+			struct ts_crypto_batch_item_in item;
+			size_t fixed_len = sizeof(struct ts_crypto_batch_item_in);
+
+			item.opcode = crypto_caller_batch_opcode(&ops[i]);
+
+			if (!item.opcode)
+				continue;
+
+			item.length = crypto_caller_batch_req_len(&ops[i]);
+			memcpy(&req_buf[offset], &item, fixed_len);
+			offset += fixed_len;
+
+			crypto_caller_batch_encode_op(&ops[i], &req_buf[offset], item.length);
+			offset += item.length;
+		}
+
+		context->rpc_status =
+			rpc_caller_session_invoke(call_handle, TS_CRYPTO_OPCODE_BATCH,
+						  &resp_buf, &resp_len, &service_status);
+
+		if (context->rpc_status == RPC_SUCCESS) {
+
+			psa_status = service_status;
+
+			if (psa_status == PSA_SUCCESS)
+				crypto_caller_batch_decode_resp(ops, num_ops, resp_buf, resp_len);
+		}
+		else if (context->rpc_status == RPC_ERROR_INVALID_VALUE) {
+
+			/* The service doesn't implement batches */
+			psa_status = PSA_ERROR_NOT_SUPPORTED;
+		}
+
+		rpc_caller_session_end(call_handle);
+	}
+
+	return psa_status;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PACKEDC_CRYPTO_CALLER_BATCH_H */
@@ -293,6 +293,99 @@ static inline psa_status_t crypto_caller_mac_abort(struct service_client *contex
 	return psa_status;
 }
 
+static inline psa_status_t crypto_caller_mac_compute(struct service_client *context,
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input,
+	size_t input_length,
+	uint8_t *mac,
+	size_t mac_size,
+	size_t *mac_length)
+{
+	psa_status_t psa_status = PSA_ERROR_GENERIC_ERROR;
+	struct ts_crypto_mac_compute_in req_msg;
+	size_t req_fixed_len = sizeof(struct ts_crypto_mac_compute_in);
+	size_t req_len = req_fixed_len;
+	size_t resp_len_max = tlv_required_space(
+		(mac_size < PSA_MAC_MAX_SIZE) ? mac_size : PSA_MAC_MAX_SIZE);
+
+	*mac_length = 0;
+	req_msg.key_id = key;
+	req_msg.alg = alg;
+
+	/* Mandatory input data parameter */
+	struct tlv_record data_record;
+	data_record.tag = TS_CRYPTO_MAC_COMPUTE_IN_TAG_DATA;
+	data_record.length = input_length;
+	data_record.value = input;
+	req_len += tlv_required_space(data_record.length);
+
+	/* The caller falls back to a multi-part operation if the input doesn't fit */
+	if (context->service_info.max_payload && req_len > context->service_info.max_payload)
+		return PSA_ERROR_NOT_SUPPORTED;
+
+	rpc_call_handle call_handle;
+	uint8_t *req_buf;
+
+	call_handle = rpc_caller_session_begin(context->session, &req_buf, req_len, resp_len_max);
+
+	if (call_handle) {
+
+		uint8_t *resp_buf;
+		size_t resp_len;
+		service_status_t service_status;
+		struct tlv_iterator req_iter;
+
+		memcpy(req_buf, &req_msg, req_fixed_len);
+
+		tlv_iterator_begin(&req_iter, &req_buf[req_fixed_len], req_len - req_fixed_len);
+		tlv_encode(&req_iter, &data_record);
+
+		context->rpc_status =
+			rpc_caller_session_invoke(call_handle, TS_CRYPTO_OPCODE_MAC_COMPUTE,
+						  &resp_buf, &resp_len, &service_status);
+
+		if (context->rpc_status == RPC_SUCCESS) {
+
+			psa_status = service_status;
+
+			if (psa_status == PSA_SUCCESS) {
+
+				struct tlv_const_iterator resp_iter;
+				struct tlv_record decoded_record;
+				tlv_const_iterator_begin(&resp_iter, resp_buf, resp_len);
+
+				if (tlv_find_decode(&resp_iter,
+					TS_CRYPTO_MAC_COMPUTE_OUT_TAG_MAC, &decoded_record)) {
+
+					if (decoded_record.length <= mac_size) {
+
+						memcpy(mac, decoded_record.value, decoded_record.length);
+						*mac_length = decoded_record.length;
+					}
+					else {
+						/* Provided buffer is too small */
+						psa_status = PSA_ERROR_BUFFER_TOO_SMALL;
+					}
+				}
+				else {
+					/* Mandatory response parameter missing */
+					psa_status = PSA_ERROR_GENERIC_ERROR;
+				}
+			}
+		}
+		else if (context->rpc_status == RPC_ERROR_INVALID_VALUE) {
+
+			/* The service doesn't implement the one-shot operation */
+			psa_status = PSA_ERROR_NOT_SUPPORTED;
+		}
+
+		rpc_caller_session_end(call_handle);
+	}
+
+	return psa_status;
+}
+
 static inline size_t crypto_caller_mac_max_update_size(const struct service_client *context)
 {
 	/* Returns the maximum number of bytes that may be
@@ -14,6 +14,7 @@
  */
 #include "crypto_caller_aead.h"
 #include "crypto_caller_asymmetric_decrypt.h"
+#include "crypto_caller_batch.h"
 #include "crypto_caller_asymmetric_encrypt.h"
 #include "crypto_caller_cipher.h"
 #include "crypto_caller_copy_key.h"
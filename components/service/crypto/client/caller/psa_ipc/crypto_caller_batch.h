@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSA_IPC_CRYPTO_CALLER_BATCH_H
+#define PSA_IPC_CRYPTO_CALLER_BATCH_H
+
+#include <psa/crypto.h>
+#include <service/common/client/service_client.h>
+#include <service/crypto/client/psa/psa_crypto_batch.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* TF-M has no batch operation so operations are called one by one */
+static inline psa_status_t crypto_caller_batch(struct service_client *context,
+	struct psa_crypto_batch_op *ops,
+	size_t num_ops)
+{
+	(void)context;
+	(void)ops;
+	(void)num_ops;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PSA_IPC_CRYPTO_CALLER_BATCH_H */
@@ -222,6 +222,84 @@ static inline psa_status_t crypto_caller_cipher_abort(
 	return status;
 }
 
+static inline psa_status_t crypto_caller_cipher_encrypt(
+						struct service_client *context,
+						psa_key_id_t key,
+						psa_algorithm_t alg,
+						const uint8_t *input,
+						size_t input_length,
+						uint8_t *output,
+						size_t output_size,
+						size_t *output_length)
+{
+	struct service_client *ipc = context;
+	struct rpc_caller_interface *caller = ipc->session->caller;
+	psa_status_t status;
+	size_t max_payload = ipc->service_info.max_payload;
+	struct psa_ipc_crypto_pack_iovec iov = {
+		.function_id = TFM_CRYPTO_CIPHER_ENCRYPT_SID,
+		.key_id = key,
+		.alg = alg,
+	};
+	struct psa_invec in_vec[] = {
+		{ .base = psa_ptr_to_u32(&iov), .len = iov_size },
+		{ .base = psa_ptr_const_to_u32(input), .len = input_length },
+	};
+	struct psa_outvec out_vec[] = {
+		{ .base = psa_ptr_to_u32(output), .len = output_size },
+	};
+
+	/* The caller falls back to a multi-part operation if the input doesn't fit */
+	if (max_payload && iov_size + input_length > max_payload)
+		return PSA_ERROR_NOT_SUPPORTED;
+
+	status = psa_call(caller, TFM_CRYPTO_HANDLE, PSA_IPC_CALL, in_vec,
+			  IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
+
+	*output_length = out_vec[0].len;
+
+	return status;
+}
+
+static inline psa_status_t crypto_caller_cipher_decrypt(
+						struct service_client *context,
+						psa_key_id_t key,
+						psa_algorithm_t alg,
+						const uint8_t *input,
+						size_t input_length,
+						uint8_t *output,
+						size_t output_size,
+						size_t *output_length)
+{
+	struct service_client *ipc = context;
+	struct rpc_caller_interface *caller = ipc->session->caller;
+	psa_status_t status;
+	size_t max_payload = ipc->service_info.max_payload;
+	struct psa_ipc_crypto_pack_iovec iov = {
+		.function_id = TFM_CRYPTO_CIPHER_DECRYPT_SID,
+		.key_id = key,
+		.alg = alg,
+	};
+	struct psa_invec in_vec[] = {
+		{ .base = psa_ptr_to_u32(&iov), .len = iov_size },
+		{ .base = psa_ptr_const_to_u32(input), .len = input_length },
+	};
+	struct psa_outvec out_vec[] = {
+		{ .base = psa_ptr_to_u32(output), .len = output_size },
+	};
+
+	/* The caller falls back to a multi-part operation if the input doesn't fit */
+	if (max_payload && iov_size + input_length > max_payload)
+		return PSA_ERROR_NOT_SUPPORTED;
+
+	status = psa_call(caller, TFM_CRYPTO_HANDLE, PSA_IPC_CALL, in_vec,
+			  IOVEC_LEN(in_vec), out_vec, IOVEC_LEN(out_vec));
+
+	*output_length = out_vec[0].len;
+
+	return status;
+}
+
 static inline size_t crypto_caller_cipher_max_update_size(const struct service_client *context)
 {
 	/* Returns the maximum number of bytes that may be
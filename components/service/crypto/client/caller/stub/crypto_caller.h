@@ -14,6 +14,7 @@
  * real crypto caller implementations.
  */
 #include "crypto_caller_aead.h"
+#include "crypto_caller_batch.h"
 #include "crypto_caller_copy_key.h"
 #include "crypto_caller_generate_key.h"
 #include "crypto_caller_hash.h"
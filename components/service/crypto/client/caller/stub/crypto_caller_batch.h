@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STUB_CRYPTO_CALLER_BATCH_H
+#define STUB_CRYPTO_CALLER_BATCH_H
+
+#include <psa/crypto.h>
+#include <service/common/client/service_client.h>
+#include <service/crypto/client/psa/psa_crypto_batch.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline psa_status_t crypto_caller_batch(struct service_client *context,
+	struct psa_crypto_batch_op *ops,
+	size_t num_ops)
+{
+	(void)context;
+	(void)ops;
+	(void)num_ops;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STUB_CRYPTO_CALLER_BATCH_H */
@@ -111,6 +111,48 @@ static inline psa_status_t crypto_caller_cipher_abort(struct service_client *con
 	return PSA_ERROR_NOT_SUPPORTED;
 }
 
+static inline psa_status_t crypto_caller_cipher_encrypt(struct service_client *context,
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input,
+	size_t input_length,
+	uint8_t *output,
+	size_t output_size,
+	size_t *output_length)
+{
+	(void)context;
+	(void)key;
+	(void)alg;
+	(void)input;
+	(void)input_length;
+	(void)output;
+	(void)output_size;
+	(void)output_length;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
+static inline psa_status_t crypto_caller_cipher_decrypt(struct service_client *context,
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input,
+	size_t input_length,
+	uint8_t *output,
+	size_t output_size,
+	size_t *output_length)
+{
+	(void)context;
+	(void)key;
+	(void)alg;
+	(void)input;
+	(void)input_length;
+	(void)output;
+	(void)output_size;
+	(void)output_length;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
 static inline size_t crypto_caller_cipher_max_update_size(struct service_client *context)
 {
 	(void)context;
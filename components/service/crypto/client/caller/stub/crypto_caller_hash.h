@@ -86,6 +86,25 @@ static inline psa_status_t crypto_caller_hash_clone(struct service_client *conte
 	return PSA_ERROR_NOT_SUPPORTED;
 }
 
+static inline psa_status_t crypto_caller_hash_compute(struct service_client *context,
+	psa_algorithm_t alg,
+	const uint8_t *input,
+	size_t input_length,
+	uint8_t *hash,
+	size_t hash_size,
+	size_t *hash_length)
+{
+	(void)context;
+	(void)alg;
+	(void)input;
+	(void)input_length;
+	(void)hash;
+	(void)hash_size;
+	(void)hash_length;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
 static inline size_t crypto_caller_hash_max_update_size(struct service_client *context)
 {
 	(void)context;
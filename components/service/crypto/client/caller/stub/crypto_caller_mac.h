@@ -91,6 +91,27 @@ static inline psa_status_t crypto_caller_mac_abort(struct service_client *contex
 	return PSA_ERROR_NOT_SUPPORTED;
 }
 
+static inline psa_status_t crypto_caller_mac_compute(struct service_client *context,
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input,
+	size_t input_length,
+	uint8_t *mac,
+	size_t mac_size,
+	size_t *mac_length)
+{
+	(void)context;
+	(void)key;
+	(void)alg;
+	(void)input;
+	(void)input_length;
+	(void)mac;
+	(void)mac_size;
+	(void)mac_length;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
 static inline size_t crypto_caller_mac_max_update_size(struct service_client *context)
 {
 	(void)context;
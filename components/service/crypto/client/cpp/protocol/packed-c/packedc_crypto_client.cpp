@@ -211,6 +211,15 @@ psa_status_t packedc_crypto_client::hash_clone(
 		source_op_handle, target_op_handle);
 }
 
+psa_status_t packedc_crypto_client::hash_compute(
+	psa_algorithm_t alg,
+	const uint8_t *input, size_t input_length,
+	uint8_t *hash, size_t hash_size, size_t *hash_length)
+{
+	return crypto_caller_hash_compute(&m_client,
+		alg, input, input_length, hash, hash_size, hash_length);
+}
+
 /* Cipher methods */
 size_t packedc_crypto_client::cipher_max_update_size() const
 {
@@ -276,6 +285,26 @@ psa_status_t packedc_crypto_client::cipher_abort(
 		op_handle);
 }
 
+psa_status_t packedc_crypto_client::cipher_encrypt(
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input, size_t input_length,
+	uint8_t *output, size_t output_size, size_t *output_length)
+{
+	return crypto_caller_cipher_encrypt(&m_client,
+		key, alg, input, input_length, output, output_size, output_length);
+}
+
+psa_status_t packedc_crypto_client::cipher_decrypt(
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input, size_t input_length,
+	uint8_t *output, size_t output_size, size_t *output_length)
+{
+	return crypto_caller_cipher_decrypt(&m_client,
+		key, alg, input, input_length, output, output_size, output_length);
+}
+
 /* MAC methods */
 size_t packedc_crypto_client::mac_max_update_size() const
 {
@@ -331,6 +360,16 @@ psa_status_t packedc_crypto_client::mac_abort(
 		op_handle);
 }
 
+psa_status_t packedc_crypto_client::mac_compute(
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input, size_t input_length,
+	uint8_t *mac, size_t mac_size, size_t *mac_length)
+{
+	return crypto_caller_mac_compute(&m_client,
+		key, alg, input, input_length, mac, mac_size, mac_length);
+}
+
 /* Key derivation methods */
 psa_status_t packedc_crypto_client::key_derivation_setup(
 	uint32_t *op_handle,
@@ -418,3 +457,9 @@ psa_status_t packedc_crypto_client::raw_key_agreement(psa_algorithm_t alg,
 		alg, private_key, peer_key, peer_key_length,
 		output, output_size, output_length);
 }
+
+psa_status_t packedc_crypto_client::batch(
+	struct psa_crypto_batch_op *ops, size_t num_ops)
+{
+	return crypto_caller_batch(&m_client, ops, num_ops);
+}
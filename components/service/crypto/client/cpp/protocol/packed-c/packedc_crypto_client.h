@@ -10,6 +10,7 @@
 #include "rpc_caller_session.h"
 #include <service/crypto/client/cpp/crypto_client.h>
 #include <protocols/service/crypto/packed-c/key_attributes.h>
+#include <service/crypto/client/psa/psa_crypto_batch.h>
 
 /*
  * A concrete crypto_client that uses the packed-c based crypto access protocol
@@ -126,6 +127,11 @@ public:
 		uint32_t source_op_handle,
 		uint32_t *target_op_handle);
 
+	psa_status_t hash_compute(
+		psa_algorithm_t alg,
+		const uint8_t *input, size_t input_length,
+		uint8_t *hash, size_t hash_size, size_t *hash_length);
+
 	/* Cipher methods */
 	size_t cipher_max_update_size() const;
 
@@ -159,6 +165,18 @@ public:
 	psa_status_t cipher_abort(
 		uint32_t op_handle);
 
+	psa_status_t cipher_encrypt(
+		psa_key_id_t key,
+		psa_algorithm_t alg,
+		const uint8_t *input, size_t input_length,
+		uint8_t *output, size_t output_size, size_t *output_length);
+
+	psa_status_t cipher_decrypt(
+		psa_key_id_t key,
+		psa_algorithm_t alg,
+		const uint8_t *input, size_t input_length,
+		uint8_t *output, size_t output_size, size_t *output_length);
+
 	/* MAC methods */
 	size_t mac_max_update_size() const;
 
@@ -187,6 +205,12 @@ public:
 	psa_status_t mac_abort(
 		uint32_t op_handle);
 
+	psa_status_t mac_compute(
+		psa_key_id_t key,
+		psa_algorithm_t alg,
+		const uint8_t *input, size_t input_length,
+		uint8_t *mac, size_t mac_size, size_t *mac_length);
+
 	/* Key derivation methods */
 	psa_status_t key_derivation_setup(
 		uint32_t *op_handle,
@@ -233,6 +257,10 @@ public:
 		const uint8_t *peer_key, size_t peer_key_length,
 		uint8_t *output, size_t output_size, size_t *output_length);
 
+	/* Executes independent operations with a single call to the service */
+	psa_status_t batch(
+		struct psa_crypto_batch_op *ops, size_t num_ops);
+
 };
 
 #endif /* PACKEDC_CRYPTO_CLIENT_H */
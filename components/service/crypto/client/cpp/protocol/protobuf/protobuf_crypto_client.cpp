@@ -881,6 +881,21 @@ psa_status_t protobuf_crypto_client::hash_clone(
 	return PSA_ERROR_NOT_SUPPORTED;
 }
 
+psa_status_t protobuf_crypto_client::hash_compute(
+	psa_algorithm_t alg,
+	const uint8_t *input, size_t input_length,
+	uint8_t *hash, size_t hash_size, size_t *hash_length)
+{
+	(void)alg;
+	(void)input;
+	(void)input_length;
+	(void)hash;
+	(void)hash_size;
+	(void)hash_length;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
 /* Cipher methods */
 size_t protobuf_crypto_client::cipher_max_update_size() const
 {
@@ -969,6 +984,40 @@ psa_status_t protobuf_crypto_client::cipher_abort(
 	return PSA_ERROR_NOT_SUPPORTED;
 }
 
+psa_status_t protobuf_crypto_client::cipher_encrypt(
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input, size_t input_length,
+	uint8_t *output, size_t output_size, size_t *output_length)
+{
+	(void)key;
+	(void)alg;
+	(void)input;
+	(void)input_length;
+	(void)output;
+	(void)output_size;
+	(void)output_length;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
+psa_status_t protobuf_crypto_client::cipher_decrypt(
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input, size_t input_length,
+	uint8_t *output, size_t output_size, size_t *output_length)
+{
+	(void)key;
+	(void)alg;
+	(void)input;
+	(void)input_length;
+	(void)output;
+	(void)output_size;
+	(void)output_length;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
 /* MAC methods */
 size_t protobuf_crypto_client::mac_max_update_size() const
 {
@@ -1041,6 +1090,23 @@ psa_status_t protobuf_crypto_client::mac_abort(
 	return PSA_ERROR_NOT_SUPPORTED;
 }
 
+psa_status_t protobuf_crypto_client::mac_compute(
+	psa_key_id_t key,
+	psa_algorithm_t alg,
+	const uint8_t *input, size_t input_length,
+	uint8_t *mac, size_t mac_size, size_t *mac_length)
+{
+	(void)key;
+	(void)alg;
+	(void)input;
+	(void)input_length;
+	(void)mac;
+	(void)mac_size;
+	(void)mac_length;
+
+	return PSA_ERROR_NOT_SUPPORTED;
+}
+
 /* Key derivation methods */
 psa_status_t protobuf_crypto_client::key_derivation_setup(
 	uint32_t *op_handle,
@@ -126,6 +126,11 @@ public:
 		uint32_t source_op_handle,
 		uint32_t *target_op_handle);
 
+	psa_status_t hash_compute(
+		psa_algorithm_t alg,
+		const uint8_t *input, size_t input_length,
+		uint8_t *hash, size_t hash_size, size_t *hash_length);
+
 	/* Cipher methods */
 	size_t cipher_max_update_size() const;
 
@@ -159,6 +164,18 @@ public:
 	psa_status_t cipher_abort(
 		uint32_t op_handle);
 
+	psa_status_t cipher_encrypt(
+		psa_key_id_t key,
+		psa_algorithm_t alg,
+		const uint8_t *input, size_t input_length,
+		uint8_t *output, size_t output_size, size_t *output_length);
+
+	psa_status_t cipher_decrypt(
+		psa_key_id_t key,
+		psa_algorithm_t alg,
+		const uint8_t *input, size_t input_length,
+		uint8_t *output, size_t output_size, size_t *output_length);
+
 	/* MAC methods */
 	size_t mac_max_update_size() const;
 
@@ -187,6 +204,12 @@ public:
 	psa_status_t mac_abort(
 		uint32_t op_handle);
 
+	psa_status_t mac_compute(
+		psa_key_id_t key,
+		psa_algorithm_t alg,
+		const uint8_t *input, size_t input_length,
+		uint8_t *mac, size_t mac_size, size_t *mac_length);
+
 	/* Key derivation methods */
 	psa_status_t key_derivation_setup(
 		uint32_t *op_handle,
@@ -11,6 +11,7 @@ endif()
 target_sources(${TGT} PRIVATE
 	"${CMAKE_CURRENT_LIST_DIR}/psa_crypto_client.c"
 	"${CMAKE_CURRENT_LIST_DIR}/psa_crypto_client_key_attributes.c"
+	"${CMAKE_CURRENT_LIST_DIR}/psa_crypto_batch.c"
 	"${CMAKE_CURRENT_LIST_DIR}/psa_get_key_attributes.c"
 	"${CMAKE_CURRENT_LIST_DIR}/psa_asymmetric_decrypt.c"
 	"${CMAKE_CURRENT_LIST_DIR}/psa_asymmetric_encrypt.c"
@@ -225,11 +225,22 @@ psa_status_t psa_aead_encrypt(psa_key_id_t key,
 	size_t aeadtext_size,
 	size_t *aeadtext_length)
 {
+	if (psa_crypto_client_instance.init_status != PSA_SUCCESS)
+		return psa_crypto_client_instance.init_status;
+
+	/* Use a single request unless the input is too large or unsupported by the service */
+	psa_status_t psa_status = crypto_caller_aead_encrypt(&psa_crypto_client_instance.base,
+		key, alg, nonce, nonce_length, additional_data, additional_data_length,
+		plaintext, plaintext_length, aeadtext, aeadtext_size, aeadtext_length);
+
+	if (psa_status != PSA_ERROR_NOT_SUPPORTED)
+		return psa_status;
+
 	psa_aead_operation_t operation = psa_aead_operation_init();
 	size_t bytes_output = 0;
 	*aeadtext_length = 0;
 
-	psa_status_t psa_status = psa_aead_encrypt_setup(&operation, key, alg);
+	psa_status = psa_aead_encrypt_setup(&operation, key, alg);
 	if (psa_status != PSA_SUCCESS) return psa_status;
 
 	if ((psa_status = psa_aead_set_lengths(&operation, additional_data_length, plaintext_length),
@@ -278,11 +289,21 @@ psa_status_t psa_aead_decrypt(psa_key_id_t key,
 	size_t plaintext_size,
 	size_t *plaintext_length)
 {
+	if (psa_crypto_client_instance.init_status != PSA_SUCCESS)
+		return psa_crypto_client_instance.init_status;
+
+	psa_status_t psa_status = crypto_caller_aead_decrypt(&psa_crypto_client_instance.base,
+		key, alg, nonce, nonce_length, additional_data, additional_data_length,
+		aeadtext, aeadtext_length, plaintext, plaintext_size, plaintext_length);
+
+	if (psa_status != PSA_ERROR_NOT_SUPPORTED)
+		return psa_status;
+
 	psa_aead_operation_t operation = psa_aead_operation_init();
 	size_t bytes_output = 0;
 	*plaintext_length = 0;
 
-	psa_status_t psa_status = psa_aead_decrypt_setup(&operation, key, alg);
+	psa_status = psa_aead_decrypt_setup(&operation, key, alg);
 	if (psa_status != PSA_SUCCESS) return psa_status;
 
 	size_t tag_len = PSA_ALG_AEAD_GET_TAG_LENGTH(alg);
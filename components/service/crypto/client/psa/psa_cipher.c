@@ -171,8 +171,18 @@ psa_status_t psa_cipher_encrypt(psa_key_id_t key,
 	size_t output_size,
 	size_t *output_length)
 {
+	if (psa_crypto_client_instance.init_status != PSA_SUCCESS)
+		return psa_crypto_client_instance.init_status;
+
+	/* Use a single request unless the input is too large or unsupported by the service */
+	psa_status_t psa_status = crypto_caller_cipher_encrypt(&psa_crypto_client_instance.base,
+		key, alg, input, input_length, output, output_size, output_length);
+
+	if (psa_status != PSA_ERROR_NOT_SUPPORTED)
+		return psa_status;
+
 	psa_cipher_operation_t operation = psa_cipher_operation_init();
-	psa_status_t psa_status = psa_cipher_encrypt_setup(&operation, key, alg);
+	psa_status = psa_cipher_encrypt_setup(&operation, key, alg);
 
 	if (psa_status == PSA_SUCCESS) {
 
@@ -214,8 +224,17 @@ psa_status_t psa_cipher_decrypt(psa_key_id_t key,
 	size_t output_size,
 	size_t *output_length)
 {
+	if (psa_crypto_client_instance.init_status != PSA_SUCCESS)
+		return psa_crypto_client_instance.init_status;
+
+	psa_status_t psa_status = crypto_caller_cipher_decrypt(&psa_crypto_client_instance.base,
+		key, alg, input, input_length, output, output_size, output_length);
+
+	if (psa_status != PSA_ERROR_NOT_SUPPORTED)
+		return psa_status;
+
 	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
-	psa_status_t psa_status = psa_get_key_attributes(key, &attributes);
+	psa_status = psa_get_key_attributes(key, &attributes);
 
 	if (psa_status == PSA_SUCCESS) {
 
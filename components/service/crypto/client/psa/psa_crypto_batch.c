@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <psa/crypto.h>
+#include "psa_crypto_batch.h"
+#include "psa_crypto_client.h"
+#include "crypto_caller_selector.h"
+
+static psa_status_t execute_op(struct psa_crypto_batch_op *op)
+{
+	switch (op->type) {
+	case PSA_CRYPTO_BATCH_OP_HASH_COMPUTE:
+		return psa_hash_compute(op->alg, op->input, op->input_length,
+			op->output, op->output_size, &op->output_length);
+	case PSA_CRYPTO_BATCH_OP_SIGN_HASH:
+		return psa_sign_hash(op->key, op->alg, op->input, op->input_length,
+			op->output, op->output_size, &op->output_length);
+	case PSA_CRYPTO_BATCH_OP_VERIFY_HASH:
+		return psa_verify_hash(op->key, op->alg, op->input, op->input_length,
+			op->signature, op->signature_length);
+	case PSA_CRYPTO_BATCH_OP_SIGN_MESSAGE:
+		return psa_sign_message(op->key, op->alg, op->input, op->input_length,
+			op->output, op->output_size, &op->output_length);
+	case PSA_CRYPTO_BATCH_OP_VERIFY_MESSAGE:
+		return psa_verify_message(op->key, op->alg, op->input, op->input_length,
+			op->signature, op->signature_length);
+	default:
+		return PSA_ERROR_NOT_SUPPORTED;
+	}
+}
+
+psa_status_t psa_crypto_batch_execute(struct psa_crypto_batch_op *ops, size_t num_ops)
+{
+	if (psa_crypto_client_instance.init_status != PSA_SUCCESS)
+		return psa_crypto_client_instance.init_status;
+
+	/* The caller returns PSA_ERROR_NOT_SUPPORTED if the batch doesn't fit in
+	 * a single request or the service doesn't support batches.
+	 */
+	psa_status_t psa_status = crypto_caller_batch(&psa_crypto_client_instance.base,
+		ops, num_ops);
+
+	if (psa_status != PSA_ERROR_NOT_SUPPORTED)
+		return psa_status;
+
+	for (size_t i = 0; i < num_ops; i++) {
+
+		ops[i].output_length = 0;
+		ops[i].status = execute_op(&ops[i]);
+	}
+
+	return PSA_SUCCESS;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSA_CRYPTO_BATCH_H
+#define PSA_CRYPTO_BATCH_H
+
+#include <psa/crypto.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief      Operations that may be part of a batch
+ */
+enum psa_crypto_batch_op_type {
+	PSA_CRYPTO_BATCH_OP_HASH_COMPUTE,
+	PSA_CRYPTO_BATCH_OP_SIGN_HASH,
+	PSA_CRYPTO_BATCH_OP_VERIFY_HASH,
+	PSA_CRYPTO_BATCH_OP_SIGN_MESSAGE,
+	PSA_CRYPTO_BATCH_OP_VERIFY_MESSAGE
+};
+
+/**
+ * @brief      A single operation of a batch
+ *
+ * The input is the data to hash, the hash to sign or verify or the message
+ * to sign or verify. The output receives the hash or the signature. Signature
+ * verification takes the signature as an input and has no output.
+ */
+struct psa_crypto_batch_op {
+	enum psa_crypto_batch_op_type type;
+	psa_key_id_t key;
+	psa_algorithm_t alg;
+	const uint8_t *input;
+	size_t input_length;
+	const uint8_t *signature;
+	size_t signature_length;
+	uint8_t *output;
+	size_t output_size;
+	size_t output_length;
+	psa_status_t status;
+};
+
+/**
+ * @brief      Executes independent crypto operations
+ *
+ * Operations are executed in order and the status of each is returned in its
+ * status member. When the crypto service supports batches, all operations
+ * are carried by a single service call. Otherwise they are called one by one.
+ *
+ * @param[inout]  ops      The operations to execute
+ * @param[in]     num_ops  The number of operations
+ *
+ * @return     PSA_SUCCESS if the operations were executed, the status of each
+ *             operation is in its status member.
+ */
+psa_status_t psa_crypto_batch_execute(struct psa_crypto_batch_op *ops, size_t num_ops);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PSA_CRYPTO_BATCH_H */
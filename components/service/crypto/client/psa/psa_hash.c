@@ -163,8 +163,22 @@ psa_status_t psa_hash_compute(psa_algorithm_t alg,
 	size_t hash_size,
 	size_t *hash_length)
 {
+	if (psa_crypto_client_instance.init_status != PSA_SUCCESS)
+		return psa_crypto_client_instance.init_status;
+
+	/* Hash the input with a single request if possible. The caller returns
+	 * PSA_ERROR_NOT_SUPPORTED if the input doesn't fit in the request or the
+	 * service doesn't support one-shot operations, in which case fall back to
+	 * a multi-part operation.
+	 */
+	psa_status_t psa_status = crypto_caller_hash_compute(&psa_crypto_client_instance.base,
+		alg, input, input_length, hash, hash_size, hash_length);
+
+	if (psa_status != PSA_ERROR_NOT_SUPPORTED)
+		return psa_status;
+
 	psa_hash_operation_t operation;
-	psa_status_t psa_status = multi_hash_update(&operation, alg, input, input_length);
+	psa_status = multi_hash_update(&operation, alg, input, input_length);
 
 	if (psa_status == PSA_SUCCESS) {
 
@@ -147,8 +147,18 @@ psa_status_t psa_mac_compute(psa_key_id_t key,
 	size_t mac_size,
 	size_t *mac_length)
 {
+	if (psa_crypto_client_instance.init_status != PSA_SUCCESS)
+		return psa_crypto_client_instance.init_status;
+
+	/* Use a single request unless the input is too large or unsupported by the service */
+	psa_status_t psa_status = crypto_caller_mac_compute(&psa_crypto_client_instance.base,
+		key, alg, input, input_length, mac, mac_size, mac_length);
+
+	if (psa_status != PSA_ERROR_NOT_SUPPORTED)
+		return psa_status;
+
 	psa_mac_operation_t operation = psa_mac_operation_init();
-	psa_status_t psa_status = psa_mac_sign_setup(&operation, key, alg);
+	psa_status = psa_mac_sign_setup(&operation, key, alg);
 
 	if (psa_status == PSA_SUCCESS) {
 
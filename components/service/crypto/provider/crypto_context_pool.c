@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,23 +7,72 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include "crypto_context_pool.h"
 
+static size_t default_num_contexts = CRYPTO_CONTEXT_POOL_SIZE;
+static size_t default_client_quota = CRYPTO_CONTEXT_POOL_CLIENT_QUOTA;
+
 static void add_to_free_list(struct crypto_context_pool *pool,
 	struct crypto_context *context);
 
-static uint32_t alloc_op_handle(struct crypto_context_pool *pool);
-static bool op_handle_in_use(struct crypto_context_pool *pool, uint32_t candidate);
+static struct crypto_context **find_bucket(struct crypto_context_pool *pool,
+	uint32_t client_id, uint32_t op_handle);
+static void remove_from_bucket(struct crypto_context_pool *pool,
+	struct crypto_context *context);
+
+static struct crypto_context *find_client_lru(struct crypto_context_pool *pool,
+	uint32_t client_id);
+
+static uint32_t alloc_op_handle(struct crypto_context_pool *pool, uint32_t client_id);
+static bool op_handle_in_use(struct crypto_context_pool *pool, uint32_t client_id,
+	uint32_t candidate);
 
 
+void crypto_context_pool_set_defaults(size_t num_contexts, size_t client_quota)
+{
+	default_num_contexts = num_contexts;
+	default_client_quota = client_quota;
+}
+
 void crypto_context_pool_init(struct crypto_context_pool *pool)
+{
+	crypto_context_pool_init_with_config(pool, default_num_contexts, default_client_quota);
+}
+
+void crypto_context_pool_init_with_config(struct crypto_context_pool *pool,
+	size_t num_contexts,
+	size_t client_quota)
 {
 	pool->free = NULL;
 	pool->active_head = NULL;
 	pool->active_tail = NULL;
 	pool->most_recent_op_handle = 0;
+	pool->client_quota = client_quota;
+
+	/* The number of buckets is a power of two for cheap indexing */
+	pool->num_buckets = 1;
+	while (pool->num_buckets < num_contexts) pool->num_buckets <<= 1;
+
+	pool->contexts = calloc(num_contexts, sizeof(struct crypto_context));
+	pool->buckets = calloc(pool->num_buckets, sizeof(struct crypto_context *));
+
+	if (!pool->contexts || !pool->buckets) {
+
+		free(pool->contexts);
+		free(pool->buckets);
+
+		pool->contexts = NULL;
+		pool->buckets = NULL;
+		pool->num_contexts = 0;
+		pool->num_buckets = 0;
+
+		return;
+	}
+
+	pool->num_contexts = num_contexts;
 
-	for (size_t i = 0; i < CRYPTO_CONTEXT_POOL_SIZE; i++) {
+	for (size_t i = 0; i < num_contexts; i++) {
 
 		add_to_free_list(pool, &pool->contexts[i]);
 	}
@@ -31,7 +80,16 @@ void crypto_context_pool_init(struct crypto_context_pool *pool)
 
 void crypto_context_pool_deinit(struct crypto_context_pool *pool)
 {
-	(void)pool;
+	free(pool->contexts);
+	free(pool->buckets);
+
+	pool->contexts = NULL;
+	pool->buckets = NULL;
+	pool->num_contexts = 0;
+	pool->num_buckets = 0;
+	pool->free = NULL;
+	pool->active_head = NULL;
+	pool->active_tail = NULL;
 }
 
 struct crypto_context *crypto_context_pool_alloc(struct crypto_context_pool *pool,
@@ -41,12 +99,24 @@ struct crypto_context *crypto_context_pool_alloc(struct crypto_context_pool *poo
 {
 	struct crypto_context *context = NULL;
 
-	/* Re-cycle least-recently used context if there are no free contexts */
-	if (!pool->free && pool->active_tail) crypto_context_pool_free(pool, pool->active_tail);
+	if (pool->client_quota) {
+
+		/* A client at its quota re-cycles its own least-recently used context */
+		struct crypto_context *client_lru = find_client_lru(pool, client_id);
+
+		if (client_lru) crypto_context_pool_free(pool, client_lru);
+	}
+	else if (!pool->free && pool->active_tail) {
+
+		/* Re-cycle least-recently used context if there are no free contexts */
+		crypto_context_pool_free(pool, pool->active_tail);
+	}
 
 	/* Active context are held in a linked list in most recently allocated order */
 	if (pool->free) {
 
+		struct crypto_context **bucket = NULL;
+
 		context = pool->free;
 		pool->free = context->next;
 
@@ -60,8 +130,12 @@ struct crypto_context *crypto_context_pool_alloc(struct crypto_context_pool *poo
 		context->usage = usage;
 		context->client_id = client_id;
 
-		context->op_handle = alloc_op_handle(pool);
+		context->op_handle = alloc_op_handle(pool, client_id);
 		*op_handle = context->op_handle;
+
+		bucket = find_bucket(pool, client_id, context->op_handle);
+		context->hash_next = *bucket;
+		*bucket = context;
 	}
 
 	return context;
@@ -70,6 +144,8 @@ struct crypto_context *crypto_context_pool_alloc(struct crypto_context_pool *poo
 void crypto_context_pool_free(struct crypto_context_pool *pool,
 	struct crypto_context *context)
 {
+	remove_from_bucket(pool, context);
+
 	/* Remove from active list */
 	if (context->prev) {
 		context->prev->next = context->next;
@@ -99,23 +175,26 @@ struct crypto_context *crypto_context_pool_find(struct crypto_context_pool *pool
 	 * as misusing a context for a different operation from the one that was
 	 * setup.
 	 */
-	struct crypto_context *found = NULL;
-	struct crypto_context *context = pool->active_head;
+	struct crypto_context *context = NULL;
+
+	if (!pool->num_buckets)
+		return NULL;
+
+	context = *find_bucket(pool, client_id, op_handle);
 
 	while (context) {
 
 		if ((context->op_handle == op_handle) &&
-			(context->usage == usage) &&
 			(context->client_id == client_id)) {
 
-			found = context;
-			break;
+			/* The op handle is unique for the client so there's no other candidate */
+			return (context->usage == usage) ? context : NULL;
 		}
 
-		context = context->next;
+		context = context->hash_next;
 	}
 
-	return found;
+	return NULL;
 }
 
 static void add_to_free_list(struct crypto_context_pool *pool,
@@ -125,34 +204,90 @@ static void add_to_free_list(struct crypto_context_pool *pool,
 	context->op_handle = 0;
 	context->next = pool->free;
 	context->prev = NULL;
+	context->hash_next = NULL;
 	pool->free = context;
 }
 
-static uint32_t alloc_op_handle(struct crypto_context_pool *pool)
+static struct crypto_context **find_bucket(struct crypto_context_pool *pool,
+	uint32_t client_id, uint32_t op_handle)
+{
+	/* Multiplicative hashing of both keys, the upper bits are the best mixed */
+	uint64_t key = ((uint64_t)client_id << 32) | op_handle;
+	uint64_t hash = key * UINT64_C(0x9e3779b97f4a7c15);
+
+	return &pool->buckets[(hash >> 32) & (pool->num_buckets - 1)];
+}
+
+static void remove_from_bucket(struct crypto_context_pool *pool,
+	struct crypto_context *context)
+{
+	struct crypto_context **link = find_bucket(pool, context->client_id, context->op_handle);
+
+	while (*link) {
+
+		if (*link == context) {
+
+			*link = context->hash_next;
+			break;
+		}
+
+		link = &(*link)->hash_next;
+	}
+
+	context->hash_next = NULL;
+}
+
+static struct crypto_context *find_client_lru(struct crypto_context_pool *pool,
+	uint32_t client_id)
+{
+	/* Returns the least-recently used context of a client that has reached its quota */
+	struct crypto_context *lru = NULL;
+	struct crypto_context *context = pool->active_tail;
+	size_t count = 0;
+
+	while (context) {
+
+		if (context->client_id == client_id) {
+
+			if (!lru) lru = context;
+			if (++count >= pool->client_quota) return lru;
+		}
+
+		context = context->prev;
+	}
+
+	return NULL;
+}
+
+static uint32_t alloc_op_handle(struct crypto_context_pool *pool, uint32_t client_id)
 {
 	/* op handles need to be unique and to minimize the probability
 	 * of a client using a stale handle that collides with a legitmately
-	 * active one, use a rolling 32-bit integer.
+	 * active one, use a rolling 32-bit integer.  As contexts are always
+	 * found by client_id and op_handle, the handle only needs to be unique
+	 * for the client.
 	 */
 	uint32_t candidate = pool->most_recent_op_handle + 1;
 
-	while (op_handle_in_use(pool, candidate)) ++candidate;
+	while (op_handle_in_use(pool, client_id, candidate)) ++candidate;
 
 	pool->most_recent_op_handle = candidate;
 
 	return candidate;
 }
 
-static bool op_handle_in_use(struct crypto_context_pool *pool, uint32_t candidate)
+static bool op_handle_in_use(struct crypto_context_pool *pool, uint32_t client_id,
+	uint32_t candidate)
 {
-	bool in_use = false;
-	struct crypto_context *context = pool->active_head;
+	struct crypto_context *context = *find_bucket(pool, client_id, candidate);
+
+	while (context) {
 
-	while (context && !in_use) {
+		if ((context->op_handle == candidate) && (context->client_id == client_id))
+			return true;
 
-		in_use = (candidate == context->op_handle);
-		context = context->next;
+		context = context->hash_next;
 	}
 
-	return in_use;
+	return false;
 }
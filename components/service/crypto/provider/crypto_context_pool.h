@@ -7,6 +7,7 @@
 #ifndef CRYPTO_CONTEXT_POOL_H
 #define CRYPTO_CONTEXT_POOL_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <psa/crypto.h>
 
@@ -19,7 +20,13 @@
  * on a setup and freed on the finish.  To cope with badly behaved clients
  * that may never finish a transaction, if no free contexts are available
  * for a new transaction, the least recently used active context is
- * recycled.
+ * recycled.  If a per-client quota is set, a client that reaches its quota
+ * recycles its own least recently used context instead and contexts of other
+ * clients are never recycled.
+ *
+ * Active contexts are indexed by client_id and op_handle in a hash table so
+ * the cost of finding a context doesn't depend on the number of active
+ * contexts.
  */
 
 #ifdef __cplusplus
@@ -49,6 +56,7 @@ struct crypto_context
 	uint32_t op_handle;
 	struct crypto_context *next;
 	struct crypto_context *prev;
+	struct crypto_context *hash_next;
 
 	union context_variant
 	{
@@ -62,18 +70,31 @@ struct crypto_context
 
 /**
  * The default pool size.  This may be overridden to meet the needs
- * of a particular deployment.
+ * of a particular deployment, either at build-time or at run-time
+ * using crypto_context_pool_set_defaults().
  */
 #ifndef CRYPTO_CONTEXT_POOL_SIZE
 #define CRYPTO_CONTEXT_POOL_SIZE            (10)
 #endif
 
+/**
+ * The default maximum number of contexts that a single client may hold.
+ * Zero means that there's no per-client quota.
+ */
+#ifndef CRYPTO_CONTEXT_POOL_CLIENT_QUOTA
+#define CRYPTO_CONTEXT_POOL_CLIENT_QUOTA    (0)
+#endif
+
 /**
  * The crypto context pool structure.
  */
 struct crypto_context_pool
 {
-	struct crypto_context contexts[CRYPTO_CONTEXT_POOL_SIZE];
+	struct crypto_context *contexts;
+	size_t num_contexts;
+	size_t client_quota;
+	struct crypto_context **buckets;
+	size_t num_buckets;
 	struct crypto_context *free;
 	struct crypto_context *active_head;
 	struct crypto_context *active_tail;
@@ -81,10 +102,28 @@ struct crypto_context_pool
 };
 
 /*
- * Initializes a crypto_context_pool, called once during setup.
+ * Sets the pool size and the per-client quota of pools that are initialized
+ * by crypto_context_pool_init() afterwards.  Allows a deployment to configure
+ * the pools of the crypto providers at run-time, before creating them.
+ */
+void crypto_context_pool_set_defaults(size_t num_contexts, size_t client_quota);
+
+/*
+ * Initializes a crypto_context_pool with the default configuration, called
+ * once during setup.
  */
 void crypto_context_pool_init(struct crypto_context_pool *pool);
 
+/*
+ * Initializes a crypto_context_pool with the given number of contexts and
+ * per-client quota.  A zero quota means that there's no per-client quota.
+ * If the contexts can't be allocated, the pool is left empty and all
+ * allocations fail.
+ */
+void crypto_context_pool_init_with_config(struct crypto_context_pool *pool,
+	size_t num_contexts,
+	size_t client_quota);
+
 /*
  * De-initializes a crypto_context_pool, called once during tear-down.
  */
@@ -93,7 +132,8 @@ void crypto_context_pool_deinit(struct crypto_context_pool *pool);
 /*
  * Allocate a fresh context.  On success, a pointer to a crypto_context object
  * is returned and an op handle is provided for reacqiring the context during
- * sunsequent operations.
+ * sunsequent operations.  If a per-client quota is set, NULL is returned when
+ * the pool is full and the client is within its quota.
  */
 struct crypto_context *crypto_context_pool_alloc(struct crypto_context_pool *pool,
 	enum crypto_context_op_id usage,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,7 +8,7 @@
 #include <psa/crypto.h>
 #include <service/crypto/provider/crypto_provider.h>
 #include <stdint.h>
-#include <stdlib.h>
+#include <string.h>
 
 #include "crypto_uuid.h"
 
@@ -26,6 +26,7 @@ static rpc_status_t generate_random_handler(void *context, struct rpc_request *r
 static rpc_status_t copy_key_handler(void *context, struct rpc_request *req);
 static rpc_status_t purge_key_handler(void *context, struct rpc_request *req);
 static rpc_status_t get_key_attributes_handler(void *context, struct rpc_request *req);
+static rpc_status_t batch_handler(void *context, struct rpc_request *req);
 
 /* Handler mapping table for service */
 static const struct service_handler handler_table[] = {
@@ -44,6 +45,7 @@ static const struct service_handler handler_table[] = {
 	{ TS_CRYPTO_OPCODE_GET_KEY_ATTRIBUTES, get_key_attributes_handler },
 	{ TS_CRYPTO_OPCODE_SIGN_MESSAGE, asymmetric_sign_handler },
 	{ TS_CRYPTO_OPCODE_VERIFY_MESSAGE, asymmetric_verify_handler },
+	{ TS_CRYPTO_OPCODE_BATCH, batch_handler },
 };
 
 struct rpc_service_interface *
@@ -59,6 +61,7 @@ crypto_provider_init(struct crypto_provider *context, unsigned int encoding,
 		return NULL;
 
 	context->serializer = serializer;
+	crypto_scratch_init(&context->scratch);
 
 	service_provider_init(&context->base_provider, context, &crypto_service_uuid[encoding],
 			      handler_table,
@@ -69,7 +72,7 @@ crypto_provider_init(struct crypto_provider *context, unsigned int encoding,
 
 void crypto_provider_deinit(struct crypto_provider *context)
 {
-	(void)context;
+	service_provider_deinit(&context->base_provider);
 }
 
 void crypto_provider_register_serializer(struct crypto_provider *context,
@@ -91,6 +94,13 @@ static const struct crypto_provider_serializer *get_crypto_serializer(void *cont
 	return this_instance->serializer;
 }
 
+static struct crypto_scratch *get_crypto_scratch(void *context)
+{
+	struct crypto_provider *this_instance = (struct crypto_provider *)context;
+
+	return &this_instance->scratch;
+}
+
 static rpc_status_t generate_key_handler(void *context, struct rpc_request *req)
 {
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
@@ -147,6 +157,7 @@ static rpc_status_t export_key_handler(void *context, struct rpc_request *req)
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
 	struct rpc_buffer *req_buf = &req->request;
 	const struct crypto_provider_serializer *serializer = get_crypto_serializer(context, req);
+	struct crypto_scratch *scratch = get_crypto_scratch(context);
 
 	psa_key_id_t id;
 
@@ -155,7 +166,7 @@ static rpc_status_t export_key_handler(void *context, struct rpc_request *req)
 
 	if (rpc_status == RPC_SUCCESS) {
 		size_t max_export_size = PSA_EXPORT_KEY_PAIR_MAX_SIZE;
-		uint8_t *key_buffer = malloc(max_export_size);
+		uint8_t *key_buffer = crypto_scratch_alloc(scratch, max_export_size);
 
 		if (key_buffer) {
 			size_t export_size;
@@ -169,7 +180,7 @@ static rpc_status_t export_key_handler(void *context, struct rpc_request *req)
 					resp_buf, key_buffer, export_size);
 			}
 
-			free(key_buffer);
+			crypto_scratch_free(scratch, key_buffer);
 			req->service_status = psa_status;
 		} else {
 			/* Failed to allocate key buffer */
@@ -185,6 +196,7 @@ static rpc_status_t export_public_key_handler(void *context, struct rpc_request
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
 	struct rpc_buffer *req_buf = &req->request;
 	const struct crypto_provider_serializer *serializer = get_crypto_serializer(context, req);
+	struct crypto_scratch *scratch = get_crypto_scratch(context);
 
 	psa_key_id_t id;
 
@@ -193,7 +205,7 @@ static rpc_status_t export_public_key_handler(void *context, struct rpc_request
 
 	if (rpc_status == RPC_SUCCESS) {
 		size_t max_export_size = PSA_EXPORT_PUBLIC_KEY_MAX_SIZE;
-		uint8_t *key_buffer = malloc(max_export_size);
+		uint8_t *key_buffer = crypto_scratch_alloc(scratch, max_export_size);
 
 		if (key_buffer) {
 			size_t export_size;
@@ -207,7 +219,7 @@ static rpc_status_t export_public_key_handler(void *context, struct rpc_request
 					resp_buf, key_buffer, export_size);
 			}
 
-			free(key_buffer);
+			crypto_scratch_free(scratch, key_buffer);
 			req->service_status = psa_status;
 		} else {
 			/* Failed to allocate key buffer */
@@ -223,10 +235,11 @@ static rpc_status_t import_key_handler(void *context, struct rpc_request *req)
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
 	struct rpc_buffer *req_buf = &req->request;
 	const struct crypto_provider_serializer *serializer = get_crypto_serializer(context, req);
+	struct crypto_scratch *scratch = get_crypto_scratch(context);
 
 	if (serializer) {
 		size_t key_data_len = serializer->max_deserialised_parameter_size(req_buf);
-		uint8_t *key_buffer = malloc(key_data_len);
+		uint8_t *key_buffer = crypto_scratch_alloc(scratch, key_data_len);
 
 		if (key_buffer) {
 			psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
@@ -251,7 +264,7 @@ static rpc_status_t import_key_handler(void *context, struct rpc_request *req)
 			}
 
 			psa_reset_key_attributes(&attributes);
-			free(key_buffer);
+			crypto_scratch_free(scratch, key_buffer);
 		} else {
 			rpc_status = RPC_ERROR_RESOURCE_FAILURE;
 		}
@@ -336,6 +349,7 @@ static rpc_status_t asymmetric_decrypt_handler(void *context, struct rpc_request
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
 	struct rpc_buffer *req_buf = &req->request;
 	const struct crypto_provider_serializer *serializer = get_crypto_serializer(context, req);
+	struct crypto_scratch *scratch = get_crypto_scratch(context);
 
 	if (serializer) {
 		size_t max_param_size = serializer->max_deserialised_parameter_size(req_buf);
@@ -343,9 +357,9 @@ static rpc_status_t asymmetric_decrypt_handler(void *context, struct rpc_request
 		psa_key_id_t id;
 		psa_algorithm_t alg;
 		size_t ciphertext_len = max_param_size;
-		uint8_t *ciphertext_buffer = malloc(ciphertext_len);
+		uint8_t *ciphertext_buffer = crypto_scratch_alloc(scratch, ciphertext_len);
 		size_t salt_len = max_param_size;
-		uint8_t *salt_buffer = malloc(salt_len);
+		uint8_t *salt_buffer = crypto_scratch_alloc(scratch, salt_len);
 
 		if (ciphertext_buffer && salt_buffer) {
 			rpc_status = serializer->deserialize_asymmetric_decrypt_req(
@@ -365,7 +379,8 @@ static rpc_status_t asymmetric_decrypt_handler(void *context, struct rpc_request
 							psa_get_key_bits(&attributes), alg);
 
 					size_t plaintext_len;
-					uint8_t *plaintext_buffer = malloc(max_decrypt_size);
+					uint8_t *plaintext_buffer =
+						crypto_scratch_alloc(scratch, max_decrypt_size);
 
 					if (plaintext_buffer) {
 						/* Salt is an optional parameter */
@@ -383,7 +398,7 @@ static rpc_status_t asymmetric_decrypt_handler(void *context, struct rpc_request
 								resp_buf, plaintext_buffer, plaintext_len);
 						}
 
-						free(plaintext_buffer);
+						crypto_scratch_free(scratch, plaintext_buffer);
 					} else {
 						/* Failed to allocate ouptput buffer */
 						rpc_status = RPC_ERROR_RESOURCE_FAILURE;
@@ -398,8 +413,8 @@ static rpc_status_t asymmetric_decrypt_handler(void *context, struct rpc_request
 			rpc_status = RPC_ERROR_RESOURCE_FAILURE;
 		}
 
-		free(ciphertext_buffer);
-		free(salt_buffer);
+		crypto_scratch_free(scratch, salt_buffer);
+		crypto_scratch_free(scratch, ciphertext_buffer);
 	}
 
 	return rpc_status;
@@ -410,6 +425,7 @@ static rpc_status_t asymmetric_encrypt_handler(void *context, struct rpc_request
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
 	struct rpc_buffer *req_buf = &req->request;
 	const struct crypto_provider_serializer *serializer = get_crypto_serializer(context, req);
+	struct crypto_scratch *scratch = get_crypto_scratch(context);
 
 	if (serializer) {
 		size_t max_param_size = serializer->max_deserialised_parameter_size(req_buf);
@@ -417,9 +433,9 @@ static rpc_status_t asymmetric_encrypt_handler(void *context, struct rpc_request
 		psa_key_id_t id;
 		psa_algorithm_t alg;
 		size_t plaintext_len = max_param_size;
-		uint8_t *plaintext_buffer = malloc(plaintext_len);
+		uint8_t *plaintext_buffer = crypto_scratch_alloc(scratch, plaintext_len);
 		size_t salt_len = max_param_size;
-		uint8_t *salt_buffer = malloc(salt_len);
+		uint8_t *salt_buffer = crypto_scratch_alloc(scratch, salt_len);
 
 		if (plaintext_buffer && salt_buffer) {
 			rpc_status = serializer->deserialize_asymmetric_encrypt_req(
@@ -439,7 +455,8 @@ static rpc_status_t asymmetric_encrypt_handler(void *context, struct rpc_request
 							psa_get_key_bits(&attributes), alg);
 
 					size_t ciphertext_len;
-					uint8_t *ciphertext_buffer = malloc(max_encrypt_size);
+					uint8_t *ciphertext_buffer =
+						crypto_scratch_alloc(scratch, max_encrypt_size);
 
 					if (ciphertext_buffer) {
 						/* Salt is an optional parameter */
@@ -458,7 +475,7 @@ static rpc_status_t asymmetric_encrypt_handler(void *context, struct rpc_request
 								resp_buf, ciphertext_buffer, ciphertext_len);
 						}
 
-						free(ciphertext_buffer);
+						crypto_scratch_free(scratch, ciphertext_buffer);
 					} else {
 						/* Failed to allocate ouptput buffer */
 						rpc_status = RPC_ERROR_RESOURCE_FAILURE;
@@ -473,8 +490,8 @@ static rpc_status_t asymmetric_encrypt_handler(void *context, struct rpc_request
 			rpc_status = RPC_ERROR_RESOURCE_FAILURE;
 		}
 
-		free(plaintext_buffer);
-		free(salt_buffer);
+		crypto_scratch_free(scratch, salt_buffer);
+		crypto_scratch_free(scratch, plaintext_buffer);
 	}
 
 	return rpc_status;
@@ -485,6 +502,7 @@ static rpc_status_t generate_random_handler(void *context, struct rpc_request *r
 	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
 	struct rpc_buffer *req_buf = &req->request;
 	const struct crypto_provider_serializer *serializer = get_crypto_serializer(context, req);
+	struct crypto_scratch *scratch = get_crypto_scratch(context);
 
 	size_t output_size;
 
@@ -493,7 +511,7 @@ static rpc_status_t generate_random_handler(void *context, struct rpc_request *r
 
 	if (rpc_status == RPC_SUCCESS) {
 		psa_status_t psa_status;
-		uint8_t *output_buffer = malloc(output_size);
+		uint8_t *output_buffer = crypto_scratch_alloc(scratch, output_size);
 
 		if (output_buffer) {
 			psa_status = psa_generate_random(output_buffer, output_size);
@@ -506,7 +524,7 @@ static rpc_status_t generate_random_handler(void *context, struct rpc_request *r
 			}
 
 			req->service_status = psa_status;
-			free(output_buffer);
+			crypto_scratch_free(scratch, output_buffer);
 		} else {
 			/* Failed to allocate output buffer */
 			rpc_status = RPC_ERROR_RESOURCE_FAILURE;
@@ -595,3 +613,102 @@ static rpc_status_t get_key_attributes_handler(void *context, struct rpc_request
 
 	return rpc_status;
 }
+
+static rpc_status_t validate_batch_req(const struct crypto_provider_serializer *serializer,
+				       const struct rpc_buffer *req_buf)
+{
+	size_t offset = 0;
+
+	/* Check the whole batch before executing any of its items */
+	while (offset < req_buf->data_length) {
+		uint32_t opcode = 0;
+		struct rpc_buffer item_req_buf;
+		rpc_status_t rpc_status = serializer->deserialize_batch_item_req(req_buf, &offset,
+										 &opcode,
+										 &item_req_buf);
+
+		if (rpc_status != RPC_SUCCESS)
+			return rpc_status;
+
+		/* Batches can't be nested */
+		if (opcode == TS_CRYPTO_OPCODE_BATCH)
+			return RPC_ERROR_INVALID_REQUEST_BODY;
+	}
+
+	return RPC_SUCCESS;
+}
+
+static rpc_status_t batch_handler(void *context, struct rpc_request *req)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	struct crypto_provider *this_instance = (struct crypto_provider *)context;
+	const struct crypto_provider_serializer *serializer = get_crypto_serializer(context, req);
+	struct crypto_scratch *scratch = get_crypto_scratch(context);
+	struct rpc_service_interface *service =
+		service_provider_get_rpc_interface(&this_instance->base_provider);
+
+	/* Batches are only supported by serializers that implement the envelope */
+	if (!serializer || !serializer->deserialize_batch_item_req)
+		return RPC_ERROR_INVALID_VALUE;
+
+	rpc_status = validate_batch_req(serializer, &req->request);
+	if (rpc_status != RPC_SUCCESS)
+		return rpc_status;
+
+	/*
+	 * The request and the response may share the same buffer so the request is copied
+	 * before the response items overwrite it. Item outputs are written to a scratch
+	 * buffer and then appended to the response.
+	 */
+	struct rpc_buffer req_buf = req->request;
+
+	req_buf.data = crypto_scratch_alloc(scratch, req->request.data_length);
+
+	uint8_t *item_resp_data = crypto_scratch_alloc(scratch, req->response.size);
+
+	if (req_buf.data && item_resp_data) {
+		size_t offset = 0;
+
+		memcpy(req_buf.data, req->request.data, req->request.data_length);
+		req->response.data_length = 0;
+
+		while (offset < req_buf.data_length) {
+			struct rpc_request item_req = *req;
+			uint32_t opcode = 0;
+			size_t space = 0;
+
+			/* Items that don't fit into the response are not executed */
+			if (serializer->batch_item_resp_space(&req->response, &space) != RPC_SUCCESS)
+				break;
+
+			serializer->deserialize_batch_item_req(&req_buf, &offset, &opcode,
+							       &item_req.request);
+
+			item_req.opcode = opcode;
+			item_req.service_status = 0;
+			item_req.response.data = item_resp_data;
+			item_req.response.data_length = 0;
+			item_req.response.size = space;
+
+			rpc_status = rpc_service_receive(service, &item_req);
+
+			if (rpc_status != RPC_SUCCESS)
+				item_req.response.data_length = 0;
+
+			serializer->serialize_batch_item_resp(&req->response, rpc_status,
+							      item_req.service_status,
+							      &item_req.response);
+		}
+
+		req->service_status = PSA_SUCCESS;
+		rpc_status = RPC_SUCCESS;
+	} else {
+		/* Failed to allocate buffers */
+		rpc_status = RPC_ERROR_RESOURCE_FAILURE;
+	}
+
+	crypto_scratch_free(scratch, item_resp_data);
+	crypto_scratch_free(scratch, req_buf.data);
+
+	return rpc_status;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdlib.h>
+#include "crypto_scratch.h"
+
+/* Buffers are aligned for any of the parameter types */
+#define CRYPTO_SCRATCH_ALIGNMENT	(sizeof(uint64_t))
+
+void crypto_scratch_init(struct crypto_scratch *scratch)
+{
+	scratch->used = 0;
+	scratch->scratch_alloc_count = 0;
+	scratch->heap_alloc_count = 0;
+}
+
+void *crypto_scratch_alloc(struct crypto_scratch *scratch, size_t size)
+{
+	size_t aligned_size = (size + CRYPTO_SCRATCH_ALIGNMENT - 1) &
+		~(CRYPTO_SCRATCH_ALIGNMENT - 1);
+
+	/* Zero sized buffers still get a unique address */
+	if (!aligned_size)
+		aligned_size = CRYPTO_SCRATCH_ALIGNMENT;
+
+	if (aligned_size >= size && aligned_size <= sizeof(scratch->buffer) - scratch->used) {
+
+		void *buf = &scratch->buffer[scratch->used];
+
+		scratch->used += aligned_size;
+		scratch->scratch_alloc_count++;
+
+		return buf;
+	}
+
+	scratch->heap_alloc_count++;
+
+	return malloc(size ? size : 1);
+}
+
+void crypto_scratch_free(struct crypto_scratch *scratch, void *buf)
+{
+	uint8_t *start = scratch->buffer;
+	uint8_t *end = &scratch->buffer[sizeof(scratch->buffer)];
+
+	if ((uint8_t *)buf >= start && (uint8_t *)buf < end) {
+
+		/* Releases the buffer and anything allocated after it */
+		scratch->used = (uint8_t *)buf - start;
+	}
+	else {
+
+		free(buf);
+	}
+}
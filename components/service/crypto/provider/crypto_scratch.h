@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CRYPTO_SCRATCH_H
+#define CRYPTO_SCRATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Request handlers need temporary buffers for deserialized parameters and
+ * for outputs that are serialized into the response.  A crypto_scratch is a
+ * bump allocator that provides these buffers without using the heap.  As
+ * requests are handled one at a time, buffers are released in the reverse
+ * order of allocation, once the handler has finished with them.  This also
+ * holds for requests that are handled within a batch.  If a buffer doesn't
+ * fit in the remaining space, it is allocated from the heap instead.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The scratch size.  This covers the common requests that fit into a 4K
+ * shared buffer and may be overridden to meet the needs of a particular
+ * deployment.
+ */
+#ifndef CRYPTO_SCRATCH_SIZE
+#define CRYPTO_SCRATCH_SIZE		(4096)
+#endif
+
+/**
+ * A crypto_scratch, with counters of the allocations that it served
+ */
+struct crypto_scratch
+{
+	size_t used;
+	size_t scratch_alloc_count;
+	size_t heap_alloc_count;
+	uint8_t buffer[CRYPTO_SCRATCH_SIZE] __attribute__((aligned(sizeof(uint64_t))));
+};
+
+/*
+ * Initializes a crypto_scratch, called once during setup.
+ */
+void crypto_scratch_init(struct crypto_scratch *scratch);
+
+/*
+ * Allocates a buffer of the given size.  Returns NULL if the buffer couldn't
+ * be allocated from the scratch or from the heap.
+ */
+void *crypto_scratch_alloc(struct crypto_scratch *scratch, size_t size);
+
+/*
+ * Frees a buffer returned by crypto_scratch_alloc().  Buffers must be freed in
+ * the reverse order of allocation.  Freeing a NULL buffer has no effect.
+ */
+void crypto_scratch_free(struct crypto_scratch *scratch, void *buf);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* CRYPTO_SCRATCH_H */
@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <protocols/service/crypto/packed-c/opcodes.h>
@@ -20,6 +21,7 @@ static rpc_status_t aead_update_handler(void *context, struct rpc_request *req);
 static rpc_status_t aead_finish_handler(void *context, struct rpc_request *req);
 static rpc_status_t aead_verify_handler(void *context, struct rpc_request *req);
 static rpc_status_t aead_abort_handler(void *context, struct rpc_request *req);
+static rpc_status_t aead_crypt_handler(void *context, struct rpc_request *req);
 
 /* Handler mapping table for service */
 static const struct service_handler handler_table[] = {
@@ -32,7 +34,9 @@ static const struct service_handler handler_table[] = {
 	{TS_CRYPTO_OPCODE_AEAD_UPDATE,				aead_update_handler},
 	{TS_CRYPTO_OPCODE_AEAD_FINISH,				aead_finish_handler},
 	{TS_CRYPTO_OPCODE_AEAD_VERIFY,				aead_verify_handler},
-	{TS_CRYPTO_OPCODE_AEAD_ABORT,				aead_abort_handler}
+	{TS_CRYPTO_OPCODE_AEAD_ABORT,				aead_abort_handler},
+	{TS_CRYPTO_OPCODE_AEAD_ENCRYPT,				aead_crypt_handler},
+	{TS_CRYPTO_OPCODE_AEAD_DECRYPT,				aead_crypt_handler}
 };
 
 void aead_provider_init(struct aead_provider *context)
@@ -461,3 +465,63 @@ static rpc_status_t aead_abort_handler(void *context, struct rpc_request *req)
 
 	return rpc_status;
 }
+
+static rpc_status_t aead_crypt_handler(void *context, struct rpc_request *req)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	struct rpc_buffer *req_buf = &req->request;
+	const struct aead_provider_serializer *serializer = get_serializer(context, req);
+
+	psa_key_id_t key_id;
+	psa_algorithm_t alg;
+	const uint8_t *nonce;
+	size_t nonce_len;
+	const uint8_t *additional_data;
+	size_t additional_data_len;
+	const uint8_t *input;
+	size_t input_len;
+
+	if (serializer)
+		rpc_status = serializer->deserialize_aead_crypt_req(req_buf, &key_id, &alg,
+			&nonce, &nonce_len,
+			&additional_data, &additional_data_len,
+			&input, &input_len);
+
+	if (rpc_status == RPC_SUCCESS) {
+
+		/* The whole input is carried by the request so no crypto context is needed */
+		psa_status_t psa_status = PSA_ERROR_INSUFFICIENT_MEMORY;
+		bool is_encrypt = (req->opcode == TS_CRYPTO_OPCODE_AEAD_ENCRYPT);
+		size_t output_len = 0;
+		size_t output_size = is_encrypt ?
+			PSA_AEAD_ENCRYPT_OUTPUT_MAX_SIZE(input_len) :
+			PSA_AEAD_DECRYPT_OUTPUT_MAX_SIZE(input_len);
+		uint8_t *output = malloc(output_size ? output_size : 1); /* Empty output is valid */
+
+		if (output) {
+
+			psa_status = is_encrypt ?
+				psa_aead_encrypt(key_id, alg, nonce, nonce_len,
+					additional_data, additional_data_len,
+					input, input_len,
+					output, output_size, &output_len) :
+				psa_aead_decrypt(key_id, alg, nonce, nonce_len,
+					additional_data, additional_data_len,
+					input, input_len,
+					output, output_size, &output_len);
+
+			if (psa_status == PSA_SUCCESS) {
+
+				struct rpc_buffer *resp_buf = &req->response;
+				rpc_status = serializer->serialize_aead_crypt_resp(resp_buf,
+					output, output_len);
+			}
+
+			free(output);
+		}
+
+		req->service_status = psa_status;
+	}
+
+	return rpc_status;
+}
@@ -75,6 +75,17 @@ struct aead_provider_serializer {
 	/* Operation: aead_abort */
 	rpc_status_t (*deserialize_aead_abort_req)(const struct rpc_buffer *req_buf,
 		uint32_t *op_handle);
+
+	/* Operation: aead_encrypt/aead_decrypt */
+	rpc_status_t (*deserialize_aead_crypt_req)(const struct rpc_buffer *req_buf,
+		psa_key_id_t *id,
+		psa_algorithm_t *alg,
+		const uint8_t **nonce, size_t *nonce_len,
+		const uint8_t **additional_data, size_t *additional_data_len,
+		const uint8_t **input, size_t *input_len);
+
+	rpc_status_t (*serialize_aead_crypt_resp)(struct rpc_buffer *resp_buf,
+		const uint8_t *output, size_t output_len);
 };
 
 #endif /* AEAD_PROVIDER_SERIALIZER_H */
@@ -385,6 +385,87 @@ static rpc_status_t deserialize_aead_abort_req(const struct rpc_buffer *req_buf,
 	return rpc_status;
 }
 
+/* Operation: aead_encrypt/aead_decrypt */
+static rpc_status_t deserialize_aead_crypt_req(const struct rpc_buffer *req_buf,
+	psa_key_id_t *id,
+	psa_algorithm_t *alg,
+	const uint8_t **nonce, size_t *nonce_len,
+	const uint8_t **additional_data, size_t *additional_data_len,
+	const uint8_t **input, size_t *input_len)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INVALID_REQUEST_BODY;
+	struct ts_crypto_aead_crypt_in recv_msg;
+	size_t expected_fixed_len = sizeof(struct ts_crypto_aead_crypt_in);
+
+	if (expected_fixed_len <= req_buf->data_length) {
+
+		struct tlv_const_iterator req_iter;
+		struct tlv_record decoded_record;
+
+		rpc_status = RPC_SUCCESS;
+
+		memcpy(&recv_msg, req_buf->data, expected_fixed_len);
+
+		*id = recv_msg.key_id;
+		*alg = recv_msg.alg;
+
+		tlv_const_iterator_begin(&req_iter,
+			(uint8_t*)req_buf->data + expected_fixed_len,
+			req_buf->data_length - expected_fixed_len);
+
+		/* Parameters are decoded in tag order. Missing parameters default to zero length. */
+		*nonce = NULL;
+		*nonce_len = 0;
+		*additional_data = NULL;
+		*additional_data_len = 0;
+		*input = NULL;
+		*input_len = 0;
+
+		if (tlv_find_decode(&req_iter, TS_CRYPTO_AEAD_CRYPT_IN_TAG_NONCE, &decoded_record)) {
+
+			*nonce = decoded_record.value;
+			*nonce_len = decoded_record.length;
+		}
+
+		if (tlv_find_decode(&req_iter, TS_CRYPTO_AEAD_CRYPT_IN_TAG_ADDITIONAL_DATA,
+			&decoded_record)) {
+
+			*additional_data = decoded_record.value;
+			*additional_data_len = decoded_record.length;
+		}
+
+		if (tlv_find_decode(&req_iter, TS_CRYPTO_AEAD_CRYPT_IN_TAG_DATA, &decoded_record)) {
+
+			*input = decoded_record.value;
+			*input_len = decoded_record.length;
+		}
+	}
+
+	return rpc_status;
+}
+
+static rpc_status_t serialize_aead_crypt_resp(struct rpc_buffer *resp_buf,
+	const uint8_t *output, size_t output_len)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	struct tlv_iterator resp_iter;
+
+	struct tlv_record out_record;
+	out_record.tag = TS_CRYPTO_AEAD_CRYPT_OUT_TAG_DATA;
+	out_record.length = output_len;
+	out_record.value = output;
+
+	tlv_iterator_begin(&resp_iter, resp_buf->data, resp_buf->size);
+
+	if (tlv_encode(&resp_iter, &out_record)) {
+
+		resp_buf->data_length = tlv_required_space(output_len);
+		rpc_status = RPC_SUCCESS;
+	}
+
+	return rpc_status;
+}
+
 /* Singleton method to provide access to the serializer instance */
 const struct aead_provider_serializer *packedc_aead_provider_serializer_instance(void)
 {
@@ -402,7 +483,9 @@ const struct aead_provider_serializer *packedc_aead_provider_serializer_instance
 		serialize_aead_finish_resp,
 		deserialize_aead_verify_req,
 		serialize_aead_verify_resp,
-		deserialize_aead_abort_req
+		deserialize_aead_abort_req,
+		deserialize_aead_crypt_req,
+		serialize_aead_crypt_resp
 	};
 
 	return &instance;
@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <protocols/service/crypto/packed-c/opcodes.h>
@@ -17,6 +18,7 @@ static rpc_status_t cipher_set_iv_handler(void *context, struct rpc_request *req
 static rpc_status_t cipher_update_handler(void *context, struct rpc_request *req);
 static rpc_status_t cipher_finish_handler(void *context, struct rpc_request *req);
 static rpc_status_t cipher_abort_handler(void *context, struct rpc_request *req);
+static rpc_status_t cipher_crypt_handler(void *context, struct rpc_request *req);
 
 /* Handler mapping table for service */
 static const struct service_handler handler_table[] = {
@@ -26,7 +28,9 @@ static const struct service_handler handler_table[] = {
 	{TS_CRYPTO_OPCODE_CIPHER_SET_IV,   			cipher_set_iv_handler},
 	{TS_CRYPTO_OPCODE_CIPHER_UPDATE,          	cipher_update_handler},
 	{TS_CRYPTO_OPCODE_CIPHER_FINISH,          	cipher_finish_handler},
-	{TS_CRYPTO_OPCODE_CIPHER_ABORT,          	cipher_abort_handler}
+	{TS_CRYPTO_OPCODE_CIPHER_ABORT,          	cipher_abort_handler},
+	{TS_CRYPTO_OPCODE_CIPHER_ENCRYPT,          	cipher_crypt_handler},
+	{TS_CRYPTO_OPCODE_CIPHER_DECRYPT,          	cipher_crypt_handler}
 };
 
 void cipher_provider_init(struct cipher_provider *context)
@@ -326,3 +330,53 @@ static rpc_status_t cipher_abort_handler(void *context, struct rpc_request *req)
 
 	return rpc_status;
 }
+
+static rpc_status_t cipher_crypt_handler(void *context, struct rpc_request *req)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	struct rpc_buffer *req_buf = &req->request;
+	const struct cipher_provider_serializer *serializer = get_serializer(context, req);
+
+	psa_key_id_t key_id;
+	psa_algorithm_t alg;
+	const uint8_t *input;
+	size_t input_len;
+
+	if (serializer)
+		rpc_status = serializer->deserialize_cipher_crypt_req(req_buf, &key_id, &alg,
+			&input, &input_len);
+
+	if (rpc_status == RPC_SUCCESS) {
+
+		/* The whole input is carried by the request so no crypto context is needed */
+		psa_status_t psa_status = PSA_ERROR_INSUFFICIENT_MEMORY;
+		bool is_encrypt = (req->opcode == TS_CRYPTO_OPCODE_CIPHER_ENCRYPT);
+		size_t output_len = 0;
+		size_t output_size = is_encrypt ?
+			PSA_CIPHER_ENCRYPT_OUTPUT_MAX_SIZE(input_len) :
+			PSA_CIPHER_DECRYPT_OUTPUT_MAX_SIZE(input_len);
+		uint8_t *output = malloc(output_size ? output_size : 1); /* Empty output is valid */
+
+		if (output) {
+
+			psa_status = is_encrypt ?
+				psa_cipher_encrypt(key_id, alg, input, input_len,
+					output, output_size, &output_len) :
+				psa_cipher_decrypt(key_id, alg, input, input_len,
+					output, output_size, &output_len);
+
+			if (psa_status == PSA_SUCCESS) {
+
+				struct rpc_buffer *resp_buf = &req->response;
+				rpc_status = serializer->serialize_cipher_crypt_resp(resp_buf,
+					output, output_len);
+			}
+
+			free(output);
+		}
+
+		req->service_status = psa_status;
+	}
+
+	return rpc_status;
+}
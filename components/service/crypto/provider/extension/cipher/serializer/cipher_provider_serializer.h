@@ -55,6 +55,15 @@ struct cipher_provider_serializer {
 	/* Operation: cipher_abort */
 	rpc_status_t (*deserialize_cipher_abort_req)(const struct rpc_buffer *req_buf,
 		uint32_t *op_handle);
+
+	/* Operation: cipher_encrypt/cipher_decrypt */
+	rpc_status_t (*deserialize_cipher_crypt_req)(const struct rpc_buffer *req_buf,
+		psa_key_id_t *id,
+		psa_algorithm_t *alg,
+		const uint8_t **data, size_t *data_len);
+
+	rpc_status_t (*serialize_cipher_crypt_resp)(struct rpc_buffer *resp_buf,
+		const uint8_t *data, size_t data_len);
 };
 
 #endif /* CIPHER_PROVIDER_SERIALIZER_H */
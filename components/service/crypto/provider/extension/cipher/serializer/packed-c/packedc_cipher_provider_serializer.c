@@ -245,6 +245,69 @@ static rpc_status_t deserialize_cipher_abort_req(const struct rpc_buffer *req_bu
 	return rpc_status;
 }
 
+/* Operation: cipher_encrypt/cipher_decrypt */
+static rpc_status_t deserialize_cipher_crypt_req(const struct rpc_buffer *req_buf,
+	psa_key_id_t *id,
+	psa_algorithm_t *alg,
+	const uint8_t **data, size_t *data_length)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INVALID_REQUEST_BODY;
+	struct ts_crypto_cipher_crypt_in recv_msg;
+	size_t expected_fixed_len = sizeof(struct ts_crypto_cipher_crypt_in);
+
+	if (expected_fixed_len <= req_buf->data_length) {
+
+		struct tlv_const_iterator req_iter;
+		struct tlv_record decoded_record;
+
+		rpc_status = RPC_SUCCESS;
+
+		memcpy(&recv_msg, req_buf->data, expected_fixed_len);
+
+		*id = recv_msg.key_id;
+		*alg = recv_msg.alg;
+
+		tlv_const_iterator_begin(&req_iter,
+			(uint8_t*)req_buf->data + expected_fixed_len,
+			req_buf->data_length - expected_fixed_len);
+
+		if (tlv_find_decode(&req_iter, TS_CRYPTO_CIPHER_CRYPT_IN_TAG_DATA, &decoded_record)) {
+
+			*data = decoded_record.value;
+			*data_length = decoded_record.length;
+		}
+		else {
+			/* Default to a zero length data */
+			*data = NULL;
+			*data_length = 0;
+		}
+	}
+
+	return rpc_status;
+}
+
+static rpc_status_t serialize_cipher_crypt_resp(struct rpc_buffer *resp_buf,
+		const uint8_t *data, size_t data_length)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	struct tlv_iterator resp_iter;
+
+	struct tlv_record out_record;
+	out_record.tag = TS_CRYPTO_CIPHER_CRYPT_OUT_TAG_DATA;
+	out_record.length = data_length;
+	out_record.value = data;
+
+	tlv_iterator_begin(&resp_iter, resp_buf->data, resp_buf->size);
+
+	if (tlv_encode(&resp_iter, &out_record)) {
+
+		resp_buf->data_length = tlv_required_space(data_length);
+		rpc_status = RPC_SUCCESS;
+	}
+
+	return rpc_status;
+}
+
 /* Singleton method to provide access to the serializer instance */
 const struct cipher_provider_serializer *packedc_cipher_provider_serializer_instance(void)
 {
@@ -258,7 +321,9 @@ const struct cipher_provider_serializer *packedc_cipher_provider_serializer_inst
 		serialize_cipher_update_resp,
 		deserialize_cipher_finish_req,
 		serialize_cipher_finish_resp,
-		deserialize_cipher_abort_req
+		deserialize_cipher_abort_req,
+		deserialize_cipher_crypt_req,
+		serialize_cipher_crypt_resp
 	};
 
 	return &instance;
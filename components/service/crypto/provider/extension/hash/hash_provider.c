@@ -17,6 +17,7 @@ static rpc_status_t hash_finish_handler(void *context, struct rpc_request *req);
 static rpc_status_t hash_abort_handler(void *context, struct rpc_request *req);
 static rpc_status_t hash_verify_handler(void *context, struct rpc_request *req);
 static rpc_status_t hash_clone_handler(void *context, struct rpc_request *req);
+static rpc_status_t hash_compute_handler(void *context, struct rpc_request *req);
 
 /* Handler mapping table for service */
 static const struct service_handler handler_table[] = {
@@ -25,7 +26,8 @@ static const struct service_handler handler_table[] = {
 	{TS_CRYPTO_OPCODE_HASH_FINISH,          hash_finish_handler},
 	{TS_CRYPTO_OPCODE_HASH_ABORT,          	hash_abort_handler},
 	{TS_CRYPTO_OPCODE_HASH_VERIFY,          hash_verify_handler},
-	{TS_CRYPTO_OPCODE_HASH_CLONE,          	hash_clone_handler}
+	{TS_CRYPTO_OPCODE_HASH_CLONE,          	hash_clone_handler},
+	{TS_CRYPTO_OPCODE_HASH_COMPUTE,         hash_compute_handler}
 };
 
 void hash_provider_init(struct hash_provider *context)
@@ -310,3 +312,37 @@ static rpc_status_t hash_clone_handler(void *context, struct rpc_request *req)
 
 	return rpc_status;
 }
+
+static rpc_status_t hash_compute_handler(void *context, struct rpc_request *req)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	struct rpc_buffer *req_buf = &req->request;
+	const struct hash_provider_serializer *serializer = get_serializer(context, req);
+
+	psa_algorithm_t alg;
+	const uint8_t *data;
+	size_t data_len;
+
+	if (serializer)
+		rpc_status = serializer->deserialize_hash_compute_req(req_buf, &alg, &data, &data_len);
+
+	if (rpc_status == RPC_SUCCESS) {
+
+		/* The whole input is carried by the request so no crypto context is needed */
+		size_t hash_len;
+		uint8_t hash[PSA_HASH_MAX_SIZE];
+
+		psa_status_t psa_status = psa_hash_compute(alg, data, data_len,
+			hash, sizeof(hash), &hash_len);
+
+		if (psa_status == PSA_SUCCESS) {
+
+			struct rpc_buffer *resp_buf = &req->response;
+			rpc_status = serializer->serialize_hash_compute_resp(resp_buf, hash, hash_len);
+		}
+
+		req->service_status = psa_status;
+	}
+
+	return rpc_status;
+}
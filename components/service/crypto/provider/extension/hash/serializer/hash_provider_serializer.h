@@ -51,6 +51,14 @@ struct hash_provider_serializer {
 
 	rpc_status_t (*serialize_hash_clone_resp)(struct rpc_buffer *resp_buf,
 		uint32_t target_op_handle);
+
+	/* Operation: hash_compute */
+	rpc_status_t (*deserialize_hash_compute_req)(const struct rpc_buffer *req_buf,
+		psa_algorithm_t *alg,
+		const uint8_t **data, size_t *data_len);
+
+	rpc_status_t (*serialize_hash_compute_resp)(struct rpc_buffer *resp_buf,
+		const uint8_t *hash, size_t hash_len);
 };
 
 #endif /* HASH_PROVIDER_SERIALIZER_H */
@@ -218,6 +218,67 @@ static rpc_status_t serialize_hash_clone_resp(struct rpc_buffer *resp_buf,
 	return rpc_status;
 }
 
+/* Operation: hash_compute */
+static rpc_status_t deserialize_hash_compute_req(const struct rpc_buffer *req_buf,
+	psa_algorithm_t *alg,
+	const uint8_t **data, size_t *data_length)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INVALID_REQUEST_BODY;
+	struct ts_crypto_hash_compute_in recv_msg;
+	size_t expected_fixed_len = sizeof(struct ts_crypto_hash_compute_in);
+
+	if (expected_fixed_len <= req_buf->data_length) {
+
+		struct tlv_const_iterator req_iter;
+		struct tlv_record decoded_record;
+
+		rpc_status = RPC_SUCCESS;
+
+		memcpy(&recv_msg, req_buf->data, expected_fixed_len);
+
+		*alg = recv_msg.alg;
+
+		tlv_const_iterator_begin(&req_iter,
+			(uint8_t*)req_buf->data + expected_fixed_len,
+			req_buf->data_length - expected_fixed_len);
+
+		if (tlv_find_decode(&req_iter, TS_CRYPTO_HASH_COMPUTE_IN_TAG_DATA, &decoded_record)) {
+
+			*data = decoded_record.value;
+			*data_length = decoded_record.length;
+		}
+		else {
+			/* Default to a zero length data */
+			*data = NULL;
+			*data_length = 0;
+		}
+	}
+
+	return rpc_status;
+}
+
+static rpc_status_t serialize_hash_compute_resp(struct rpc_buffer *resp_buf,
+	const uint8_t *hash, size_t hash_len)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	struct tlv_iterator resp_iter;
+
+	struct tlv_record out_record;
+	out_record.tag = TS_CRYPTO_HASH_COMPUTE_OUT_TAG_HASH;
+	out_record.length = hash_len;
+	out_record.value = hash;
+
+	tlv_iterator_begin(&resp_iter, resp_buf->data, resp_buf->size);
+
+	if (tlv_encode(&resp_iter, &out_record)) {
+
+		resp_buf->data_length = tlv_required_space(hash_len);
+		rpc_status = RPC_SUCCESS;
+	}
+
+	return rpc_status;
+}
+
 /* Singleton method to provide access to the serializer instance */
 const struct hash_provider_serializer *packedc_hash_provider_serializer_instance(void)
 {
@@ -230,7 +291,9 @@ const struct hash_provider_serializer *packedc_hash_provider_serializer_instance
 		deserialize_hash_abort_req,
 		deserialize_hash_verify_req,
 		deserialize_hash_clone_req,
-		serialize_hash_clone_resp
+		serialize_hash_clone_resp,
+		deserialize_hash_compute_req,
+		serialize_hash_compute_resp
 	};
 
 	return &instance;
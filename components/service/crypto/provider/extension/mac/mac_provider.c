@@ -16,6 +16,7 @@ static rpc_status_t mac_update_handler(void *context, struct rpc_request *req);
 static rpc_status_t mac_sign_finish_handler(void *context, struct rpc_request *req);
 static rpc_status_t mac_verify_finish_handler(void *context, struct rpc_request *req);
 static rpc_status_t mac_abort_handler(void *context, struct rpc_request *req);
+static rpc_status_t mac_compute_handler(void *context, struct rpc_request *req);
 
 /* Handler mapping table for service */
 static const struct service_handler handler_table[] = {
@@ -24,7 +25,8 @@ static const struct service_handler handler_table[] = {
 	{TS_CRYPTO_OPCODE_MAC_UPDATE,          	mac_update_handler},
 	{TS_CRYPTO_OPCODE_MAC_SIGN_FINISH,      mac_sign_finish_handler},
 	{TS_CRYPTO_OPCODE_MAC_VERIFY_FINISH,    mac_verify_finish_handler},
-	{TS_CRYPTO_OPCODE_MAC_ABORT,          	mac_abort_handler}
+	{TS_CRYPTO_OPCODE_MAC_ABORT,          	mac_abort_handler},
+	{TS_CRYPTO_OPCODE_MAC_COMPUTE,          mac_compute_handler}
 };
 
 void mac_provider_init(struct mac_provider *context)
@@ -264,3 +266,39 @@ static rpc_status_t mac_abort_handler(void *context, struct rpc_request *req)
 
 	return rpc_status;
 }
+
+static rpc_status_t mac_compute_handler(void *context, struct rpc_request *req)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	struct rpc_buffer *req_buf = &req->request;
+	const struct mac_provider_serializer *serializer = get_serializer(context, req);
+
+	psa_key_id_t key_id;
+	psa_algorithm_t alg;
+	const uint8_t *data;
+	size_t data_len;
+
+	if (serializer)
+		rpc_status = serializer->deserialize_mac_compute_req(req_buf, &key_id, &alg,
+			&data, &data_len);
+
+	if (rpc_status == RPC_SUCCESS) {
+
+		/* The whole input is carried by the request so no crypto context is needed */
+		size_t mac_len;
+		uint8_t mac[PSA_MAC_MAX_SIZE];
+
+		psa_status_t psa_status = psa_mac_compute(key_id, alg, data, data_len,
+			mac, sizeof(mac), &mac_len);
+
+		if (psa_status == PSA_SUCCESS) {
+
+			struct rpc_buffer *resp_buf = &req->response;
+			rpc_status = serializer->serialize_mac_compute_resp(resp_buf, mac, mac_len);
+		}
+
+		req->service_status = psa_status;
+	}
+
+	return rpc_status;
+}
@@ -45,6 +45,15 @@ struct mac_provider_serializer {
 	/* Operation: mac_abort */
 	rpc_status_t (*deserialize_mac_abort_req)(const struct rpc_buffer *req_buf,
 		uint32_t *op_handle);
+
+	/* Operation: mac_compute */
+	rpc_status_t (*deserialize_mac_compute_req)(const struct rpc_buffer *req_buf,
+		psa_key_id_t *key_id,
+		psa_algorithm_t *alg,
+		const uint8_t **data, size_t *data_len);
+
+	rpc_status_t (*serialize_mac_compute_resp)(struct rpc_buffer *resp_buf,
+		const uint8_t *mac, size_t mac_len);
 };
 
 #endif /* MAC_PROVIDER_SERIALIZER_H */
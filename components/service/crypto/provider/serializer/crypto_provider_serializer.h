@@ -118,6 +118,22 @@ struct crypto_provider_serializer {
 
 	rpc_status_t (*serialize_generate_random_resp)(struct rpc_buffer *resp_buf,
 						       const uint8_t *output, size_t output_len);
+
+	/* Operation: batch
+	 * Items are read from the request starting at the offset, which is advanced
+	 * past the item. Response items are appended to the response buffer.
+	 */
+	rpc_status_t (*deserialize_batch_item_req)(const struct rpc_buffer *req_buf,
+						   size_t *offset, uint32_t *opcode,
+						   struct rpc_buffer *item_req_buf);
+
+	rpc_status_t (*batch_item_resp_space)(const struct rpc_buffer *resp_buf,
+					      size_t *space);
+
+	rpc_status_t (*serialize_batch_item_resp)(struct rpc_buffer *resp_buf,
+						  rpc_status_t item_rpc_status,
+						  service_status_t item_service_status,
+						  const struct rpc_buffer *item_resp_buf);
 };
 
 #endif /* CRYPTO_PROVIDER_SERIALIZER_H */
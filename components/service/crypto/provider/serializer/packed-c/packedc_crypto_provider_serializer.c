@@ -9,6 +9,7 @@
 #include <protocols/rpc/common/packed-c/status.h>
 #include <protocols/service/crypto/packed-c/asymmetric_decrypt.h>
 #include <protocols/service/crypto/packed-c/asymmetric_encrypt.h>
+#include <protocols/service/crypto/packed-c/batch.h>
 #include <protocols/service/crypto/packed-c/copy_key.h>
 #include <protocols/service/crypto/packed-c/destroy_key.h>
 #include <protocols/service/crypto/packed-c/export_key.h>
@@ -620,6 +621,75 @@ static rpc_status_t serialize_generate_random_resp(struct rpc_buffer *resp_buf,
 	return rpc_status;
 }
 
+/* Operation: batch */
+static rpc_status_t deserialize_batch_item_req(const struct rpc_buffer *req_buf, size_t *offset,
+					       uint32_t *opcode, struct rpc_buffer *item_req_buf)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INVALID_REQUEST_BODY;
+	struct ts_crypto_batch_item_in recv_msg;
+	size_t expected_fixed_len = sizeof(struct ts_crypto_batch_item_in);
+
+	if (*offset <= req_buf->data_length &&
+	    expected_fixed_len <= req_buf->data_length - *offset) {
+		size_t item_offset = *offset + expected_fixed_len;
+
+		memcpy(&recv_msg, &req_buf->data[*offset], expected_fixed_len);
+
+		if (recv_msg.length <= req_buf->data_length - item_offset) {
+			*opcode = recv_msg.opcode;
+			item_req_buf->data = &req_buf->data[item_offset];
+			item_req_buf->data_length = recv_msg.length;
+			item_req_buf->size = recv_msg.length;
+			*offset = item_offset + recv_msg.length;
+			rpc_status = RPC_SUCCESS;
+		}
+	}
+
+	return rpc_status;
+}
+
+static rpc_status_t batch_item_resp_space(const struct rpc_buffer *resp_buf, size_t *space)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INVALID_RESPONSE_BODY;
+	size_t fixed_len = sizeof(struct ts_crypto_batch_item_out);
+
+	if (resp_buf->data_length <= resp_buf->size &&
+	    fixed_len <= resp_buf->size - resp_buf->data_length) {
+		*space = resp_buf->size - resp_buf->data_length - fixed_len;
+		rpc_status = RPC_SUCCESS;
+	}
+
+	return rpc_status;
+}
+
+static rpc_status_t serialize_batch_item_resp(struct rpc_buffer *resp_buf,
+					      rpc_status_t item_rpc_status,
+					      service_status_t item_service_status,
+					      const struct rpc_buffer *item_resp_buf)
+{
+	rpc_status_t rpc_status = RPC_ERROR_INVALID_RESPONSE_BODY;
+	struct ts_crypto_batch_item_out resp_msg;
+	size_t fixed_len = sizeof(struct ts_crypto_batch_item_out);
+	size_t space = 0;
+
+	if (batch_item_resp_space(resp_buf, &space) == RPC_SUCCESS &&
+	    item_resp_buf->data_length <= space) {
+		uint8_t *item = &resp_buf->data[resp_buf->data_length];
+
+		resp_msg.rpc_status = item_rpc_status;
+		resp_msg.service_status = item_service_status;
+		resp_msg.length = item_resp_buf->data_length;
+
+		memcpy(item, &resp_msg, fixed_len);
+		memcpy(&item[fixed_len], item_resp_buf->data, item_resp_buf->data_length);
+
+		resp_buf->data_length += fixed_len + item_resp_buf->data_length;
+		rpc_status = RPC_SUCCESS;
+	}
+
+	return rpc_status;
+}
+
 /* Singleton method to provide access to the serializer instance */
 const struct crypto_provider_serializer *packedc_crypto_provider_serializer_instance(void)
 {
@@ -635,7 +705,9 @@ const struct crypto_provider_serializer *packedc_crypto_provider_serializer_inst
 		serialize_asymmetric_sign_resp,	    deserialize_asymmetric_verify_req,
 		deserialize_asymmetric_decrypt_req, serialize_asymmetric_decrypt_resp,
 		deserialize_asymmetric_encrypt_req, serialize_asymmetric_encrypt_resp,
-		deserialize_generate_random_req,    serialize_generate_random_resp
+		deserialize_generate_random_req,    serialize_generate_random_resp,
+		deserialize_batch_item_req,	    batch_item_resp_space,
+		serialize_batch_item_resp
 	};
 
 	return &instance;
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include <protocols/service/crypto/packed-c/opcodes.h>
+#include <rpc/direct/direct_caller.h>
+#include <service/crypto/client/caller/packed-c/crypto_caller.h>
+#include <service/crypto/provider/crypto_provider.h>
+#include <service/crypto/provider/crypto_uuid.h>
+#include <service/crypto/provider/serializer/packed-c/packedc_crypto_provider_serializer.h>
+#include <service/crypto/provider/extension/aead/aead_provider.h>
+#include <service/crypto/provider/extension/aead/serializer/packed-c/packedc_aead_provider_serializer.h>
+#include <CppUTest/TestHarness.h>
+
+/*
+ * Checks the one-shot AEAD operations against the equivalent multi-part
+ * sequence. A filter in front of the provider can reject the one-shot opcodes,
+ * as a service that predates them does, to check the NOT_SUPPORTED status that
+ * the psa client falls back to the multi-part sequence on.
+ */
+static rpc_status_t one_shot_filter_receive(void *context, struct rpc_request *request)
+{
+	struct rpc_service_interface *provider_iface = (struct rpc_service_interface *)context;
+
+	if ((request->opcode == TS_CRYPTO_OPCODE_AEAD_ENCRYPT) ||
+	    (request->opcode == TS_CRYPTO_OPCODE_AEAD_DECRYPT))
+		return RPC_ERROR_INVALID_VALUE;
+
+	return rpc_service_receive(provider_iface, request);
+}
+
+TEST_GROUP(AeadOneShotTests)
+{
+	void setup()
+	{
+		struct rpc_service_interface *crypto_iface = NULL;
+
+		LONGS_EQUAL(PSA_SUCCESS, psa_crypto_init());
+
+		crypto_iface = crypto_provider_init(&m_crypto_provider, TS_RPC_ENCODING_PACKED_C,
+						    packedc_crypto_provider_serializer_instance());
+		CHECK_TRUE(crypto_iface);
+
+		aead_provider_init(&m_aead_provider);
+		aead_provider_register_serializer(&m_aead_provider, TS_RPC_ENCODING_PACKED_C,
+						  packedc_aead_provider_serializer_instance());
+		crypto_provider_extend(&m_crypto_provider, &m_aead_provider.base_provider);
+
+		m_filter_iface.context = crypto_iface;
+		m_filter_iface.uuid = crypto_iface->uuid;
+		m_filter_iface.receive = one_shot_filter_receive;
+
+		m_crypto_iface = crypto_iface;
+		m_is_open = false;
+	}
+
+	void teardown()
+	{
+		if (m_is_open) {
+			crypto_caller_destroy_key(&m_client, m_key_id);
+			rpc_caller_session_close(&m_session);
+			direct_caller_deinit(&m_caller);
+		}
+
+		crypto_provider_deinit(&m_crypto_provider);
+		aead_provider_deinit(&m_aead_provider);
+	}
+
+	void open(struct rpc_service_interface *service_iface)
+	{
+		const struct rpc_uuid crypto_uuid = { .uuid = TS_PSA_CRYPTO_SERVICE_UUID };
+		psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+		uint8_t key_data[16];
+
+		memset(&m_caller, 0, sizeof(m_caller));
+		LONGS_EQUAL(RPC_SUCCESS, direct_caller_init(&m_caller, service_iface));
+		LONGS_EQUAL(RPC_SUCCESS, rpc_caller_session_find_and_open(&m_session, &m_caller,
+									  &crypto_uuid, 4096));
+
+		memset(&m_client, 0, sizeof(m_client));
+		m_client.session = &m_session;
+		m_client.service_info.max_payload = 4096;
+		m_is_open = true;
+
+		memset(key_data, 0x3c, sizeof(key_data));
+
+		psa_set_key_lifetime(&attributes, PSA_KEY_LIFETIME_VOLATILE);
+		psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT);
+		psa_set_key_algorithm(&attributes, PSA_ALG_GCM);
+		psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
+
+		LONGS_EQUAL(PSA_SUCCESS, crypto_caller_import_key(&m_client, &attributes,
+			key_data, sizeof(key_data), &m_key_id));
+
+		psa_reset_key_attributes(&attributes);
+	}
+
+	/* Encrypts with the multi-part sequence, giving the ciphertext followed by the tag */
+	void multipart_encrypt(const uint8_t *input, size_t input_length,
+			       uint8_t *output, size_t output_size, size_t *output_length)
+	{
+		uint32_t op_handle = 0;
+		size_t update_len = 0;
+		size_t finish_len = 0;
+		size_t tag_len = 0;
+
+		LONGS_EQUAL(PSA_SUCCESS, crypto_caller_aead_encrypt_setup(&m_client, &op_handle,
+			m_key_id, PSA_ALG_GCM));
+		LONGS_EQUAL(PSA_SUCCESS, crypto_caller_aead_set_nonce(&m_client, op_handle,
+			m_nonce, sizeof(m_nonce)));
+		LONGS_EQUAL(PSA_SUCCESS, crypto_caller_aead_update_ad(&m_client, op_handle,
+			m_additional_data, sizeof(m_additional_data)));
+		LONGS_EQUAL(PSA_SUCCESS, crypto_caller_aead_update(&m_client, op_handle,
+			input, input_length, output, output_size, &update_len));
+		LONGS_EQUAL(PSA_SUCCESS, crypto_caller_aead_finish(&m_client, op_handle,
+			&output[update_len], output_size - update_len, &finish_len,
+			&output[update_len + finish_len], output_size - update_len - finish_len,
+			&tag_len));
+
+		*output_length = update_len + finish_len + tag_len;
+	}
+
+	psa_status_t one_shot_encrypt(const uint8_t *input, size_t input_length,
+				      uint8_t *output, size_t output_size, size_t *output_length)
+	{
+		return crypto_caller_aead_encrypt(&m_client, m_key_id, PSA_ALG_GCM,
+			m_nonce, sizeof(m_nonce), m_additional_data, sizeof(m_additional_data),
+			input, input_length, output, output_size, output_length);
+	}
+
+	psa_status_t one_shot_decrypt(const uint8_t *input, size_t input_length,
+				      uint8_t *output, size_t output_size, size_t *output_length)
+	{
+		return crypto_caller_aead_decrypt(&m_client, m_key_id, PSA_ALG_GCM,
+			m_nonce, sizeof(m_nonce), m_additional_data, sizeof(m_additional_data),
+			input, input_length, output, output_size, output_length);
+	}
+
+	const uint8_t m_nonce[12] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
+	const uint8_t m_additional_data[20] = { 0xad };
+
+	struct crypto_provider m_crypto_provider;
+	struct aead_provider m_aead_provider;
+	struct rpc_service_interface *m_crypto_iface;
+	struct rpc_service_interface m_filter_iface;
+	struct rpc_caller_interface m_caller;
+	struct rpc_caller_session m_session;
+	struct service_client m_client;
+	psa_key_id_t m_key_id;
+	bool m_is_open;
+};
+
+TEST(AeadOneShotTests, oneShotMatchesMultipart)
+{
+	uint8_t input[100];
+	uint8_t one_shot_output[sizeof(input) + PSA_AEAD_TAG_MAX_SIZE];
+	uint8_t multipart_output[sizeof(input) + PSA_AEAD_TAG_MAX_SIZE];
+	uint8_t plaintext[sizeof(input)];
+	size_t one_shot_len = 0;
+	size_t multipart_len = 0;
+	size_t plaintext_len = 0;
+
+	open(m_crypto_iface);
+
+	for (size_t i = 0; i < sizeof(input); i++)
+		input[i] = (uint8_t)i;
+
+	LONGS_EQUAL(PSA_SUCCESS, one_shot_encrypt(input, sizeof(input),
+		one_shot_output, sizeof(one_shot_output), &one_shot_len));
+	multipart_encrypt(input, sizeof(input),
+		multipart_output, sizeof(multipart_output), &multipart_len);
+
+	UNSIGNED_LONGS_EQUAL(sizeof(input) + PSA_AEAD_TAG_LENGTH(PSA_ALG_GCM), one_shot_len);
+	UNSIGNED_LONGS_EQUAL(multipart_len, one_shot_len);
+	MEMCMP_EQUAL(multipart_output, one_shot_output, one_shot_len);
+
+	LONGS_EQUAL(PSA_SUCCESS, one_shot_decrypt(one_shot_output, one_shot_len,
+		plaintext, sizeof(plaintext), &plaintext_len));
+	UNSIGNED_LONGS_EQUAL(sizeof(input), plaintext_len);
+	MEMCMP_EQUAL(input, plaintext, plaintext_len);
+
+	/* A corrupted tag should fail authentication */
+	one_shot_output[one_shot_len - 1] ^= 1;
+
+	LONGS_EQUAL(PSA_ERROR_INVALID_SIGNATURE, one_shot_decrypt(one_shot_output, one_shot_len,
+		plaintext, sizeof(plaintext), &plaintext_len));
+	UNSIGNED_LONGS_EQUAL(0, plaintext_len);
+}
+
+TEST(AeadOneShotTests, notSupportedByService)
+{
+	uint8_t input[100];
+	uint8_t output[sizeof(input) + PSA_AEAD_TAG_MAX_SIZE];
+	uint8_t plaintext[sizeof(input)];
+	size_t output_len = 0;
+	size_t plaintext_len = 0;
+
+	/* A service without the one-shot opcodes should result in NOT_SUPPORTED */
+	open(&m_filter_iface);
+
+	memset(input, 0x5a, sizeof(input));
+
+	LONGS_EQUAL(PSA_ERROR_NOT_SUPPORTED, one_shot_encrypt(input, sizeof(input),
+		output, sizeof(output), &output_len));
+	UNSIGNED_LONGS_EQUAL(0, output_len);
+
+	/* The multi-part sequence that the client falls back to should still work */
+	multipart_encrypt(input, sizeof(input), output, sizeof(output), &output_len);
+
+	LONGS_EQUAL(PSA_ERROR_NOT_SUPPORTED, one_shot_decrypt(output, output_len,
+		plaintext, sizeof(plaintext), &plaintext_len));
+	UNSIGNED_LONGS_EQUAL(0, plaintext_len);
+}
+
+TEST(AeadOneShotTests, notSupportedForLargeInput)
+{
+	static uint8_t input[4096];
+	static uint8_t output[sizeof(input) + PSA_AEAD_TAG_MAX_SIZE];
+	size_t output_len = 0;
+
+	open(m_crypto_iface);
+
+	/* An input that doesn't fit in a single request should result in NOT_SUPPORTED */
+	LONGS_EQUAL(PSA_ERROR_NOT_SUPPORTED, one_shot_encrypt(input, sizeof(input),
+		output, sizeof(output), &output_len));
+
+	/* A smaller input should be accepted */
+	LONGS_EQUAL(PSA_SUCCESS, one_shot_encrypt(input, 1024,
+		output, sizeof(output), &output_len));
+}
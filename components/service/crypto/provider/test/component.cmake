@@ -1,5 +1,5 @@
 #-------------------------------------------------------------------------------
-# Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+# Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -9,5 +9,7 @@ if (NOT DEFINED TGT)
 endif()
 
 target_sources(${TGT} PRIVATE
+	"${CMAKE_CURRENT_LIST_DIR}/aead_one_shot_tests.cpp"
 	"${CMAKE_CURRENT_LIST_DIR}/crypto_context_pool_tests.cpp"
+	"${CMAKE_CURRENT_LIST_DIR}/crypto_provider_alloc_tests.cpp"
 	)
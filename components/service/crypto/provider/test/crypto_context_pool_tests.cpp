@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <service/crypto/provider/crypto_context_pool.h>
 #include <CppUTest/TestHarness.h>
 
@@ -128,3 +129,141 @@ TEST(CryptoContextPoolTests, multipleContexts)
 				zombie_handle_2);
 	CHECK_FALSE(context);
 }
+
+TEST(CryptoContextPoolTests, interleavedHashOperations)
+{
+	/* Stress test with many concurrent hash operations from a set of clients,
+	 * each updated in turn with a slice of the message.
+	 */
+	const unsigned int num_operations = 1000;
+	const unsigned int num_clients = 8;
+	const unsigned int num_rounds = 4;
+	uint32_t op_handles[num_operations];
+	uint8_t message[num_rounds * 16];
+	struct crypto_context *context;
+
+	crypto_context_pool_deinit(&pool_under_test);
+	crypto_context_pool_init_with_config(&pool_under_test, num_operations, 0);
+
+	LONGS_EQUAL(PSA_SUCCESS, psa_crypto_init());
+
+	for (unsigned int i = 0; i < sizeof(message); ++i)
+		message[i] = (uint8_t)i;
+
+	for (unsigned int i = 0; i < num_operations; ++i) {
+
+		context = crypto_context_pool_alloc(&pool_under_test,
+			CRYPTO_CONTEXT_OP_ID_HASH, i % num_clients,
+			&op_handles[i]);
+		CHECK_TRUE(context);
+
+		context->op.hash = psa_hash_operation_init();
+		LONGS_EQUAL(PSA_SUCCESS, psa_hash_setup(&context->op.hash, PSA_ALG_SHA_256));
+	}
+
+	for (unsigned int round = 0; round < num_rounds; ++round) {
+
+		for (unsigned int i = 0; i < num_operations; ++i) {
+
+			/* Each operation hashes a message prefix of a different length */
+			size_t slice_len = (i + round) % 16 + 1;
+
+			context = crypto_context_pool_find(&pool_under_test,
+				CRYPTO_CONTEXT_OP_ID_HASH, i % num_clients,
+				op_handles[i]);
+			CHECK_TRUE(context);
+
+			LONGS_EQUAL(PSA_SUCCESS, psa_hash_update(&context->op.hash,
+				&message[round * 16], slice_len));
+		}
+	}
+
+	for (unsigned int i = 0; i < num_operations; ++i) {
+
+		uint8_t hash[PSA_HASH_MAX_SIZE];
+		uint8_t expected_hash[PSA_HASH_MAX_SIZE];
+		uint8_t expected_input[sizeof(message)];
+		size_t hash_len = 0;
+		size_t expected_hash_len = 0;
+		size_t expected_input_len = 0;
+
+		for (unsigned int round = 0; round < num_rounds; ++round) {
+
+			size_t slice_len = (i + round) % 16 + 1;
+
+			memcpy(&expected_input[expected_input_len], &message[round * 16], slice_len);
+			expected_input_len += slice_len;
+		}
+
+		context = crypto_context_pool_find(&pool_under_test,
+			CRYPTO_CONTEXT_OP_ID_HASH, i % num_clients,
+			op_handles[i]);
+		CHECK_TRUE(context);
+
+		LONGS_EQUAL(PSA_SUCCESS, psa_hash_finish(&context->op.hash,
+			hash, sizeof(hash), &hash_len));
+		crypto_context_pool_free(&pool_under_test, context);
+
+		LONGS_EQUAL(PSA_SUCCESS, psa_hash_compute(PSA_ALG_SHA_256,
+			expected_input, expected_input_len,
+			expected_hash, sizeof(expected_hash), &expected_hash_len));
+
+		UNSIGNED_LONGS_EQUAL(expected_hash_len, hash_len);
+		MEMCMP_EQUAL(expected_hash, hash, hash_len);
+
+		/* A finished operation can't be found again */
+		CHECK_FALSE(crypto_context_pool_find(&pool_under_test,
+			CRYPTO_CONTEXT_OP_ID_HASH, i % num_clients,
+			op_handles[i]));
+	}
+}
+
+TEST(CryptoContextPoolTests, clientQuota)
+{
+	const unsigned int pool_size = 6;
+	const unsigned int client_quota = 2;
+	uint32_t op_handles[pool_size];
+	uint32_t op_handle;
+	struct crypto_context *context;
+
+	crypto_context_pool_deinit(&pool_under_test);
+	crypto_context_pool_init_with_config(&pool_under_test, pool_size, client_quota);
+
+	/* Clients 0 and 1 use their full quota */
+	for (unsigned int i = 0; i < 4; ++i) {
+
+		context = crypto_context_pool_alloc(&pool_under_test,
+			CRYPTO_CONTEXT_OP_ID_HASH, i % 2, &op_handles[i]);
+		CHECK_TRUE(context);
+	}
+
+	/* A client over its quota re-cycles its own least recently used context */
+	context = crypto_context_pool_alloc(&pool_under_test,
+		CRYPTO_CONTEXT_OP_ID_HASH, 0, &op_handle);
+	CHECK_TRUE(context);
+
+	CHECK_FALSE(crypto_context_pool_find(&pool_under_test,
+		CRYPTO_CONTEXT_OP_ID_HASH, 0, op_handles[0]));
+	CHECK_TRUE(crypto_context_pool_find(&pool_under_test,
+		CRYPTO_CONTEXT_OP_ID_HASH, 0, op_handles[2]));
+	CHECK_TRUE(crypto_context_pool_find(&pool_under_test,
+		CRYPTO_CONTEXT_OP_ID_HASH, 1, op_handles[1]));
+	CHECK_TRUE(crypto_context_pool_find(&pool_under_test,
+		CRYPTO_CONTEXT_OP_ID_HASH, 1, op_handles[3]));
+
+	/* Fill the rest of the pool */
+	CHECK_TRUE(crypto_context_pool_alloc(&pool_under_test,
+		CRYPTO_CONTEXT_OP_ID_HASH, 2, &op_handles[4]));
+	CHECK_TRUE(crypto_context_pool_alloc(&pool_under_test,
+		CRYPTO_CONTEXT_OP_ID_HASH, 3, &op_handles[5]));
+
+	/* A client below its quota can't take the context of another client */
+	CHECK_FALSE(crypto_context_pool_alloc(&pool_under_test,
+		CRYPTO_CONTEXT_OP_ID_HASH, 4, &op_handle));
+
+	for (unsigned int i = 1; i < pool_size; ++i) {
+
+		CHECK_TRUE(crypto_context_pool_find(&pool_under_test,
+			CRYPTO_CONTEXT_OP_ID_HASH, (i < 4) ? i % 2 : i - 2, op_handles[i]));
+	}
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include <rpc/direct/direct_caller.h>
+#include <service/crypto/client/caller/packed-c/crypto_caller.h>
+#include <service/crypto/provider/crypto_provider.h>
+#include <service/crypto/provider/crypto_uuid.h>
+#include <service/crypto/provider/serializer/packed-c/packedc_crypto_provider_serializer.h>
+#include <CppUTest/TestHarness.h>
+
+/*
+ * Checks that the crypto provider serves the common requests without
+ * heap allocations, using the allocation counters of its scratch.
+ */
+TEST_GROUP(CryptoProviderAllocTests)
+{
+	void setup()
+	{
+		const struct rpc_uuid crypto_uuid = { .uuid = TS_PSA_CRYPTO_SERVICE_UUID };
+		struct rpc_service_interface *crypto_iface = NULL;
+
+		LONGS_EQUAL(PSA_SUCCESS, psa_crypto_init());
+
+		crypto_iface = crypto_provider_init(&m_crypto_provider, TS_RPC_ENCODING_PACKED_C,
+						    packedc_crypto_provider_serializer_instance());
+		CHECK_TRUE(crypto_iface);
+
+		memset(&m_caller, 0, sizeof(m_caller));
+		LONGS_EQUAL(RPC_SUCCESS, direct_caller_init(&m_caller, crypto_iface));
+		LONGS_EQUAL(RPC_SUCCESS, rpc_caller_session_find_and_open(&m_session, &m_caller,
+									  &crypto_uuid, 2 * CRYPTO_SCRATCH_SIZE));
+
+		memset(&m_client, 0, sizeof(m_client));
+		m_client.session = &m_session;
+		m_client.service_info.max_payload = 4096;
+	}
+
+	void teardown()
+	{
+		rpc_caller_session_close(&m_session);
+		direct_caller_deinit(&m_caller);
+		crypto_provider_deinit(&m_crypto_provider);
+	}
+
+	void check_no_heap_allocations()
+	{
+		/* Every request needed scratch space and all of it was released */
+		CHECK_TRUE(m_crypto_provider.scratch.scratch_alloc_count > m_scratch_alloc_count);
+		UNSIGNED_LONGS_EQUAL(0, m_crypto_provider.scratch.heap_alloc_count);
+		UNSIGNED_LONGS_EQUAL(0, m_crypto_provider.scratch.used);
+
+		m_scratch_alloc_count = m_crypto_provider.scratch.scratch_alloc_count;
+	}
+
+	struct crypto_provider m_crypto_provider;
+	struct rpc_caller_interface m_caller;
+	struct rpc_caller_session m_session;
+	struct service_client m_client;
+	size_t m_scratch_alloc_count = 0;
+};
+
+TEST(CryptoProviderAllocTests, commonRequests)
+{
+	psa_status_t status;
+	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+	psa_key_id_t key_id;
+	psa_key_id_t imported_key_id;
+
+	uint8_t random[64];
+
+	status = crypto_caller_generate_random(&m_client, random, sizeof(random));
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	check_no_heap_allocations();
+
+	psa_set_key_usage_flags(&attributes,
+		PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT | PSA_KEY_USAGE_EXPORT);
+	psa_set_key_algorithm(&attributes, PSA_ALG_RSA_PKCS1V15_CRYPT);
+	psa_set_key_type(&attributes, PSA_KEY_TYPE_RSA_KEY_PAIR);
+	psa_set_key_bits(&attributes, 1024);
+
+	status = crypto_caller_generate_key(&m_client, &attributes, &key_id);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	/* Export the key pair and import it again */
+	uint8_t key_data[PSA_EXPORT_KEY_OUTPUT_SIZE(PSA_KEY_TYPE_RSA_KEY_PAIR, 1024)];
+	size_t key_data_len = 0;
+
+	status = crypto_caller_export_key(&m_client, key_id,
+		key_data, sizeof(key_data), &key_data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	check_no_heap_allocations();
+
+	status = crypto_caller_import_key(&m_client, &attributes,
+		key_data, key_data_len, &imported_key_id);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	check_no_heap_allocations();
+
+	status = crypto_caller_export_public_key(&m_client, imported_key_id,
+		key_data, sizeof(key_data), &key_data_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	check_no_heap_allocations();
+
+	/* Encrypt with the generated key and decrypt with the imported one */
+	uint8_t message[] = {'q','u','i','c','k','b','r','o','w','n','f','o','x'};
+	uint8_t ciphertext[128];
+	size_t ciphertext_len = 0;
+
+	status = crypto_caller_asymmetric_encrypt(&m_client, key_id, PSA_ALG_RSA_PKCS1V15_CRYPT,
+		message, sizeof(message), NULL, 0,
+		ciphertext, sizeof(ciphertext), &ciphertext_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	check_no_heap_allocations();
+
+	uint8_t plaintext[128];
+	size_t plaintext_len = 0;
+
+	status = crypto_caller_asymmetric_decrypt(&m_client, imported_key_id,
+		PSA_ALG_RSA_PKCS1V15_CRYPT, ciphertext, ciphertext_len, NULL, 0,
+		plaintext, sizeof(plaintext), &plaintext_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	check_no_heap_allocations();
+
+	UNSIGNED_LONGS_EQUAL(sizeof(message), plaintext_len);
+	MEMCMP_EQUAL(message, plaintext, plaintext_len);
+
+	LONGS_EQUAL(PSA_SUCCESS, crypto_caller_destroy_key(&m_client, imported_key_id));
+	LONGS_EQUAL(PSA_SUCCESS, crypto_caller_destroy_key(&m_client, key_id));
+
+	psa_reset_key_attributes(&attributes);
+}
+
+TEST(CryptoProviderAllocTests, largeRequestFallsBackToHeap)
+{
+	/* An output that doesn't fit in the scratch is allocated from the heap */
+	static uint8_t random[CRYPTO_SCRATCH_SIZE + 1];
+
+	m_client.service_info.max_payload = 0;
+
+	LONGS_EQUAL(PSA_SUCCESS, crypto_caller_generate_random(&m_client, random,
+							      sizeof(random)));
+	UNSIGNED_LONGS_EQUAL(1, m_crypto_provider.scratch.heap_alloc_count);
+	UNSIGNED_LONGS_EQUAL(0, m_crypto_provider.scratch.used);
+}
@@ -551,3 +551,129 @@ void crypto_service_scenarios::generateRandomNumbers()
 	CHECK(memcmp(num9_64bit, num10_64bit, sizeof(num9_64bit)) != 0);
 	CHECK(memcmp(num11_128bit, num12_128bit, sizeof(num11_128bit)) != 0);
 }
+
+void crypto_service_scenarios::oneShotMatchesMultipart()
+{
+	/* Compares a single request one-shot operation with the equivalent multi-part
+	 * sequence for an input that fits in a single request.
+	 */
+	psa_status_t status;
+	uint8_t input[512];
+	uint8_t one_shot_output[sizeof(input) + PSA_CIPHER_IV_MAX_SIZE];
+	uint8_t multipart_output[sizeof(input) + PSA_CIPHER_IV_MAX_SIZE];
+	size_t one_shot_len = 0;
+	size_t multipart_len = 0;
+
+	memset(input, 0x5a, sizeof(input));
+
+	/* Hash */
+	uint32_t op_handle = 0;
+
+	status = m_crypto_client->hash_compute(PSA_ALG_SHA_256, input, sizeof(input),
+		one_shot_output, sizeof(one_shot_output), &one_shot_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+
+	status = m_crypto_client->hash_setup(&op_handle, PSA_ALG_SHA_256);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	status = m_crypto_client->hash_update(op_handle, input, sizeof(input));
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	status = m_crypto_client->hash_finish(op_handle,
+		multipart_output, sizeof(multipart_output), &multipart_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+
+	UNSIGNED_LONGS_EQUAL(PSA_HASH_LENGTH(PSA_ALG_SHA_256), one_shot_len);
+	UNSIGNED_LONGS_EQUAL(one_shot_len, multipart_len);
+	MEMCMP_EQUAL(multipart_output, one_shot_output, one_shot_len);
+
+	/* MAC */
+	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+	psa_key_id_t key_id = 0;
+	uint8_t key_data[32];
+
+	memset(key_data, 0x3c, sizeof(key_data));
+
+	psa_set_key_lifetime(&attributes, PSA_KEY_LIFETIME_VOLATILE);
+	psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_SIGN_MESSAGE);
+	psa_set_key_algorithm(&attributes, PSA_ALG_HMAC(PSA_ALG_SHA_256));
+	psa_set_key_type(&attributes, PSA_KEY_TYPE_HMAC);
+
+	status = m_crypto_client->import_key(&attributes, key_data, sizeof(key_data), &key_id);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+
+	status = m_crypto_client->mac_compute(key_id, PSA_ALG_HMAC(PSA_ALG_SHA_256),
+		input, sizeof(input),
+		one_shot_output, sizeof(one_shot_output), &one_shot_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+
+	status = m_crypto_client->mac_sign_setup(&op_handle, key_id,
+		PSA_ALG_HMAC(PSA_ALG_SHA_256));
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	status = m_crypto_client->mac_update(op_handle, input, sizeof(input));
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	status = m_crypto_client->mac_sign_finish(op_handle,
+		multipart_output, sizeof(multipart_output), &multipart_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+
+	UNSIGNED_LONGS_EQUAL(one_shot_len, multipart_len);
+	MEMCMP_EQUAL(multipart_output, one_shot_output, one_shot_len);
+
+	status = m_crypto_client->destroy_key(key_id);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	psa_reset_key_attributes(&attributes);
+
+	/* Cipher */
+	psa_set_key_lifetime(&attributes, PSA_KEY_LIFETIME_VOLATILE);
+	psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT);
+	psa_set_key_algorithm(&attributes, PSA_ALG_CBC_NO_PADDING);
+	psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
+
+	status = m_crypto_client->import_key(&attributes, key_data, 16, &key_id);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+
+	status = m_crypto_client->cipher_encrypt(key_id, PSA_ALG_CBC_NO_PADDING,
+		input, sizeof(input),
+		one_shot_output, sizeof(one_shot_output), &one_shot_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+
+	size_t iv_len = 0;
+	size_t update_len = 0;
+	size_t finish_len = 0;
+
+	status = m_crypto_client->cipher_encrypt_setup(&op_handle, key_id,
+		PSA_ALG_CBC_NO_PADDING);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	status = m_crypto_client->cipher_generate_iv(op_handle,
+		multipart_output, PSA_CIPHER_IV_MAX_SIZE, &iv_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	status = m_crypto_client->cipher_update(op_handle, input, sizeof(input),
+		&multipart_output[iv_len], sizeof(multipart_output) - iv_len, &update_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	status = m_crypto_client->cipher_finish(op_handle,
+		&multipart_output[iv_len + update_len],
+		sizeof(multipart_output) - iv_len - update_len, &finish_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+
+	multipart_len = iv_len + update_len + finish_len;
+
+	/* The IVs differ so check that both ciphertexts decrypt to the input */
+	uint8_t plaintext[sizeof(input)];
+	size_t plaintext_len = 0;
+
+	UNSIGNED_LONGS_EQUAL(one_shot_len, multipart_len);
+
+	status = m_crypto_client->cipher_decrypt(key_id, PSA_ALG_CBC_NO_PADDING,
+		one_shot_output, one_shot_len, plaintext, sizeof(plaintext), &plaintext_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(input), plaintext_len);
+	MEMCMP_EQUAL(input, plaintext, plaintext_len);
+
+	status = m_crypto_client->cipher_decrypt(key_id, PSA_ALG_CBC_NO_PADDING,
+		multipart_output, multipart_len, plaintext, sizeof(plaintext), &plaintext_len);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(sizeof(input), plaintext_len);
+	MEMCMP_EQUAL(input, plaintext, plaintext_len);
+
+	status = m_crypto_client->destroy_key(key_id);
+	CHECK_EQUAL(PSA_SUCCESS, status);
+	psa_reset_key_attributes(&attributes);
+}
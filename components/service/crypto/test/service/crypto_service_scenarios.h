@@ -32,6 +32,7 @@ public:
 	void generateVolatileKeys();
 	void copyKey();
 	void purgeKey();
+	void oneShotMatchesMultipart();
 
 private:
 	crypto_client *m_crypto_client;
@@ -8,6 +8,7 @@
 #include <service/crypto/test/service/crypto_service_scenarios.h>
 #include <protocols/rpc/common/packed-c/encoding.h>
 #include <service_locator.h>
+#include <cstring>
 #include <CppUTest/TestHarness.h>
 
 /*
@@ -112,3 +113,107 @@ TEST(CryptoServicePackedcTests, generateRandomNumbers)
 {
 	m_scenarios->generateRandomNumbers();
 }
+
+TEST(CryptoServicePackedcTests, oneShotMatchesMultipart)
+{
+	m_scenarios->oneShotMatchesMultipart();
+}
+
+TEST(CryptoServicePackedcTests, batchedSignAndVerify)
+{
+	static const unsigned int num_ops = 16;
+	packedc_crypto_client crypto_client(m_rpc_session);
+	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+	psa_algorithm_t alg = PSA_ALG_DETERMINISTIC_ECDSA(PSA_ALG_SHA_256);
+	psa_key_id_t key_id;
+	uint8_t message[num_ops][64];
+	uint8_t hash[num_ops][PSA_HASH_LENGTH(PSA_ALG_SHA_256)];
+	uint8_t signature[num_ops][PSA_SIGNATURE_MAX_SIZE];
+	struct psa_crypto_batch_op ops[2 * num_ops];
+
+	psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_SIGN_HASH | PSA_KEY_USAGE_VERIFY_HASH);
+	psa_set_key_algorithm(&attributes, alg);
+	psa_set_key_type(&attributes, PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1));
+	psa_set_key_bits(&attributes, 256);
+
+	LONGS_EQUAL(PSA_SUCCESS, crypto_client.generate_key(&attributes, &key_id));
+	psa_reset_key_attributes(&attributes);
+
+	/* Hash the messages in one batch */
+	memset(ops, 0, sizeof(ops));
+
+	for (unsigned int i = 0; i < num_ops; ++i) {
+		memset(message[i], i, sizeof(message[i]));
+
+		ops[i].type = PSA_CRYPTO_BATCH_OP_HASH_COMPUTE;
+		ops[i].alg = PSA_ALG_SHA_256;
+		ops[i].input = message[i];
+		ops[i].input_length = sizeof(message[i]);
+		ops[i].output = hash[i];
+		ops[i].output_size = sizeof(hash[i]);
+	}
+
+	LONGS_EQUAL(PSA_SUCCESS, crypto_client.batch(ops, num_ops));
+
+	for (unsigned int i = 0; i < num_ops; ++i) {
+		uint8_t expected_hash[PSA_HASH_LENGTH(PSA_ALG_SHA_256)];
+		size_t expected_hash_length = 0;
+
+		LONGS_EQUAL(PSA_SUCCESS, ops[i].status);
+		LONGS_EQUAL(sizeof(hash[i]), ops[i].output_length);
+
+		LONGS_EQUAL(PSA_SUCCESS, crypto_client.hash_compute(PSA_ALG_SHA_256,
+			message[i], sizeof(message[i]),
+			expected_hash, sizeof(expected_hash), &expected_hash_length));
+		MEMCMP_EQUAL(expected_hash, hash[i], sizeof(expected_hash));
+	}
+
+	/* Sign the hashes and verify the signatures in one batch */
+	for (unsigned int i = 0; i < num_ops; ++i) {
+		ops[i].type = PSA_CRYPTO_BATCH_OP_SIGN_HASH;
+		ops[i].key = key_id;
+		ops[i].alg = alg;
+		ops[i].input = hash[i];
+		ops[i].input_length = sizeof(hash[i]);
+		ops[i].output = signature[i];
+		ops[i].output_size = sizeof(signature[i]);
+	}
+
+	LONGS_EQUAL(PSA_SUCCESS, crypto_client.batch(ops, num_ops));
+
+	for (unsigned int i = 0; i < num_ops; ++i) {
+		LONGS_EQUAL(PSA_SUCCESS, ops[i].status);
+		CHECK(ops[i].output_length > 0);
+
+		ops[num_ops + i].type = PSA_CRYPTO_BATCH_OP_VERIFY_HASH;
+		ops[num_ops + i].key = key_id;
+		ops[num_ops + i].alg = alg;
+		ops[num_ops + i].input = hash[i];
+		ops[num_ops + i].input_length = sizeof(hash[i]);
+		ops[num_ops + i].signature = signature[i];
+		ops[num_ops + i].signature_length = ops[i].output_length;
+	}
+
+	/* The failure of an operation doesn't affect the others */
+	ops[num_ops + 1].input = hash[0];
+
+	LONGS_EQUAL(PSA_SUCCESS, crypto_client.batch(&ops[num_ops], num_ops));
+
+	for (unsigned int i = 0; i < num_ops; ++i)
+		LONGS_EQUAL((i == 1) ? PSA_ERROR_INVALID_SIGNATURE : PSA_SUCCESS,
+			    ops[num_ops + i].status);
+
+	/* Deterministic signatures should match signing by separate calls */
+	for (unsigned int i = 0; i < num_ops; ++i) {
+		uint8_t expected_signature[PSA_SIGNATURE_MAX_SIZE];
+		size_t expected_signature_length = 0;
+
+		LONGS_EQUAL(PSA_SUCCESS, crypto_client.sign_hash(key_id, alg,
+			hash[i], sizeof(hash[i]),
+			expected_signature, sizeof(expected_signature), &expected_signature_length));
+		UNSIGNED_LONGS_EQUAL(expected_signature_length, ops[i].output_length);
+		MEMCMP_EQUAL(expected_signature, signature[i], expected_signature_length);
+	}
+
+	LONGS_EQUAL(PSA_SUCCESS, crypto_client.destroy_key(key_id));
+}
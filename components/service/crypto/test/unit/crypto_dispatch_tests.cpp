@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include <protocols/service/crypto/packed-c/opcodes.h>
+#include <service/crypto/provider/crypto_provider.h>
+#include <service/crypto/provider/serializer/packed-c/packedc_crypto_provider_serializer.h>
+#include <service/crypto/provider/extension/hash/hash_provider.h>
+#include <service/crypto/provider/extension/hash/serializer/packed-c/packedc_hash_provider_serializer.h>
+#include <service/crypto/provider/extension/cipher/cipher_provider.h>
+#include <service/crypto/provider/extension/cipher/serializer/packed-c/packedc_cipher_provider_serializer.h>
+#include <service/crypto/provider/extension/key_derivation/key_derivation_provider.h>
+#include <service/crypto/provider/extension/key_derivation/serializer/packed-c/packedc_key_derivation_provider_serializer.h>
+#include <service/crypto/provider/extension/mac/mac_provider.h>
+#include <service/crypto/provider/extension/mac/serializer/packed-c/packedc_mac_provider_serializer.h>
+#include <service/crypto/provider/extension/aead/aead_provider.h>
+#include <service/crypto/provider/extension/aead/serializer/packed-c/packedc_aead_provider_serializer.h>
+#include <CppUTest/TestHarness.h>
+
+/*
+ * Checks that requests are dispatched to the right provider of the full crypto
+ * provider chain. Requests have an empty body so they are rejected by the
+ * handler's deserializer without reaching the crypto backend.
+ */
+TEST_GROUP(CryptoDispatchTests)
+{
+	void setup()
+	{
+		crypto_provider_init(&m_crypto_provider, TS_RPC_ENCODING_PACKED_C,
+				     packedc_crypto_provider_serializer_instance());
+
+		hash_provider_init(&m_hash_provider);
+		hash_provider_register_serializer(&m_hash_provider, TS_RPC_ENCODING_PACKED_C,
+						  packedc_hash_provider_serializer_instance());
+		crypto_provider_extend(&m_crypto_provider, &m_hash_provider.base_provider);
+
+		cipher_provider_init(&m_cipher_provider);
+		cipher_provider_register_serializer(&m_cipher_provider, TS_RPC_ENCODING_PACKED_C,
+						    packedc_cipher_provider_serializer_instance());
+		crypto_provider_extend(&m_crypto_provider, &m_cipher_provider.base_provider);
+
+		key_derivation_provider_init(&m_key_derivation_provider);
+		key_derivation_provider_register_serializer(&m_key_derivation_provider,
+			TS_RPC_ENCODING_PACKED_C,
+			packedc_key_derivation_provider_serializer_instance());
+		crypto_provider_extend(&m_crypto_provider,
+				       &m_key_derivation_provider.base_provider);
+
+		mac_provider_init(&m_mac_provider);
+		mac_provider_register_serializer(&m_mac_provider, TS_RPC_ENCODING_PACKED_C,
+						 packedc_mac_provider_serializer_instance());
+		crypto_provider_extend(&m_crypto_provider, &m_mac_provider.base_provider);
+
+		aead_provider_init(&m_aead_provider);
+		aead_provider_register_serializer(&m_aead_provider, TS_RPC_ENCODING_PACKED_C,
+						  packedc_aead_provider_serializer_instance());
+		crypto_provider_extend(&m_crypto_provider, &m_aead_provider.base_provider);
+
+		m_iface = service_provider_get_rpc_interface(&m_crypto_provider.base_provider);
+	}
+
+	void teardown()
+	{
+		crypto_provider_deinit(&m_crypto_provider);
+		hash_provider_deinit(&m_hash_provider);
+		cipher_provider_deinit(&m_cipher_provider);
+		key_derivation_provider_deinit(&m_key_derivation_provider);
+		mac_provider_deinit(&m_mac_provider);
+		aead_provider_deinit(&m_aead_provider);
+	}
+
+	rpc_status_t call(uint16_t opcode)
+	{
+		struct rpc_request req;
+
+		memset(&req, 0, sizeof(req));
+		req.opcode = opcode;
+		req.response.data = m_resp_buf;
+		req.response.size = sizeof(m_resp_buf);
+
+		return rpc_service_receive(m_iface, &req);
+	}
+
+	void check_chain()
+	{
+		/* The core provider is at the head of the chain and hash at the end */
+		LONGS_EQUAL(RPC_ERROR_INVALID_REQUEST_BODY, call(TS_CRYPTO_OPCODE_GENERATE_RANDOM));
+		LONGS_EQUAL(RPC_ERROR_INVALID_REQUEST_BODY, call(TS_CRYPTO_OPCODE_AEAD_ABORT));
+		LONGS_EQUAL(RPC_ERROR_INVALID_REQUEST_BODY, call(TS_CRYPTO_OPCODE_MAC_ABORT));
+		LONGS_EQUAL(RPC_ERROR_INVALID_REQUEST_BODY,
+			    call(TS_CRYPTO_OPCODE_KEY_DERIVATION_ABORT));
+		LONGS_EQUAL(RPC_ERROR_INVALID_REQUEST_BODY, call(TS_CRYPTO_OPCODE_CIPHER_ABORT));
+		LONGS_EQUAL(RPC_ERROR_INVALID_REQUEST_BODY, call(TS_CRYPTO_OPCODE_HASH_ABORT));
+
+		/* An opcode that no provider handles */
+		LONGS_EQUAL(RPC_ERROR_INVALID_VALUE, call(UNSUPPORTED_OPCODE));
+	}
+
+	static const uint16_t UNSUPPORTED_OPCODE = 0x0700;
+
+	struct crypto_provider m_crypto_provider;
+	struct hash_provider m_hash_provider;
+	struct cipher_provider m_cipher_provider;
+	struct key_derivation_provider m_key_derivation_provider;
+	struct mac_provider m_mac_provider;
+	struct aead_provider m_aead_provider;
+	struct rpc_service_interface *m_iface;
+	uint8_t m_resp_buf[64];
+};
+
+TEST(CryptoDispatchTests, dispatchTableAndChainWalk)
+{
+	check_chain();
+
+	/* Dropping the dispatch table makes requests walk the provider chain */
+	service_provider_deinit(&m_crypto_provider.base_provider);
+
+	check_chain();
+}
@@ -15,7 +15,10 @@
 #include "protocols/service/fwu/packed-c/status.h"
 #include "util.h"
 
-#define COPY_CHUNK_SIZE (4096)
+/* Size of the heap buffer used to copy between volumes */
+#ifndef COPY_INSTALLER_CHUNK_SIZE
+#define COPY_INSTALLER_CHUNK_SIZE (4096)
+#endif
 
 static int close_volumes_on_error(struct copy_installer *subject)
 {
@@ -29,7 +32,7 @@ static int copy_volume_contents(struct copy_installer *subject, size_t target_co
 {
 	int status = FWU_STATUS_SUCCESS;
 	size_t copy_len = 0;
-	uint8_t *copy_buf = malloc(COPY_CHUNK_SIZE);
+	uint8_t *copy_buf = malloc(COPY_INSTALLER_CHUNK_SIZE);
 
 	if (!copy_buf)
 		return FWU_STATUS_UNKNOWN;
@@ -38,8 +41,8 @@ static int copy_volume_contents(struct copy_installer *subject, size_t target_co
 		size_t actual_read_len = 0;
 		size_t actual_write_len = 0;
 		size_t remaining_len = target_copy_len - copy_len;
-		size_t requested_read_len = (remaining_len < COPY_CHUNK_SIZE) ? remaining_len :
-										COPY_CHUNK_SIZE;
+		size_t requested_read_len = (remaining_len < COPY_INSTALLER_CHUNK_SIZE) ? remaining_len :
+										COPY_INSTALLER_CHUNK_SIZE;
 
 		status = volume_read(subject->source_volume, (uintptr_t)copy_buf,
 				     requested_read_len, &actual_read_len);
@@ -120,7 +123,7 @@ static int copy_installer_finalize(void *context)
 	if (source_status)
 		return close_volumes_on_error(subject);
 
-	destination_status = volume_size(subject->source_volume, &destination_size);
+	destination_status = volume_size(subject->destination_volume, &destination_size);
 
 	if (destination_status)
 		return close_volumes_on_error(subject);
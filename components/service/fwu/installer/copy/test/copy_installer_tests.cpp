@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -224,3 +224,45 @@ TEST(FwuCopyInstallerTests, installAndCopy)
 	/* Expect volume B to contain a copy of what's in volume A */
 	check_update_installed(m_fw_volume_b);
 }
+
+TEST(FwuCopyInstallerTests, copyToSmallerVolume)
+{
+	struct block_volume block_volume_c;
+	struct volume *fw_volume_c = NULL;
+	struct uuid_octets partition_guid;
+	unsigned int volume_c_id = banked_volume_id(FW_STORE_LOCATION_ID + 1,
+						   BANKED_USAGE_ID_FW_BANK_B);
+
+	/* Install an image into bank A that is larger than the destination volume */
+	install_initial_image(13011);
+
+	/* Construct a destination volume from the small partition 3 */
+	uuid_guid_octets_from_canonical(&partition_guid, REF_PARTITION_3_GUID);
+
+	int status = block_volume_init(&block_volume_c, m_block_store, &partition_guid,
+				       &fw_volume_c);
+	LONGS_EQUAL(0, status);
+	CHECK_TRUE(fw_volume_c);
+
+	volume_index_add(volume_c_id, fw_volume_c);
+
+	struct installer *installer =
+		installer_index_find(INSTALL_TYPE_WHOLE_VOLUME_COPY, FW_STORE_LOCATION_ID);
+	CHECK_TRUE(installer);
+
+	status = installer_begin(installer,
+				 banked_volume_id(FW_STORE_LOCATION_ID,
+						  BANKED_USAGE_ID_FW_BANK_A), /* Current volume */
+				 volume_c_id); /* Update volume */
+	LONGS_EQUAL(0, status);
+
+	/* Expect the copy to be limited to the size of the destination volume */
+	status = installer_finalize(installer);
+	LONGS_EQUAL(0, status);
+
+	m_image_len = (REF_PARTITION_3_ENDING_LBA - REF_PARTITION_3_STARTING_LBA + 1) *
+		      REF_PARTITION_BLOCK_SIZE;
+	check_update_installed(fw_volume_c);
+
+	block_volume_deinit(&block_volume_c);
+}
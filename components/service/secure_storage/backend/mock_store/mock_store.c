@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -27,6 +27,8 @@ static psa_status_t mock_store_set(void *context,
     psa_status_t psa_status = PSA_ERROR_INSUFFICIENT_STORAGE;
     struct mock_store *this_context = (struct mock_store*)context;
 
+    ++this_context->call_counts.set;
+
     /* Check length limit */
     if (data_length > MOCK_STORE_ITEM_SIZE_LIMIT) return psa_status;
 
@@ -70,6 +72,8 @@ static psa_status_t mock_store_get(void *context,
 {
     struct mock_store *this_context = (struct mock_store*)context;
 
+    ++this_context->call_counts.get;
+
     (void)client_id;
 
     if (!uid)
@@ -100,6 +104,8 @@ static psa_status_t mock_store_get_info(void *context,
     psa_status_t psa_status = PSA_ERROR_DOES_NOT_EXIST;
     struct mock_store *this_context = (struct mock_store*)context;
 
+    ++this_context->call_counts.get_info;
+
     if (!uid)
         return PSA_ERROR_INVALID_ARGUMENT;
 
@@ -107,7 +113,7 @@ static psa_status_t mock_store_get_info(void *context,
     struct mock_store_slot *slot = find_slot(this_context, uid);
 
     if (slot) {
-        p_info->capacity = slot->len;
+        p_info->capacity = slot->capacity;
         p_info->size = slot->len;
         p_info->flags = slot->flags;
         psa_status = PSA_SUCCESS;
@@ -130,6 +136,8 @@ static psa_status_t mock_store_remove(void *context,
     psa_status_t psa_status = PSA_ERROR_DOES_NOT_EXIST;
     struct mock_store *this_context = (struct mock_store*)context;
 
+    ++this_context->call_counts.remove;
+
     if (!uid)
         return PSA_ERROR_INVALID_ARGUMENT;
 
@@ -160,6 +168,8 @@ static psa_status_t mock_store_create(void *context,
     struct mock_store *this_context = (struct mock_store*)context;
     struct mock_store_slot *slot;
 
+    ++this_context->call_counts.create;
+
     slot = find_slot(this_context, uid);
 
     if (!slot) {
@@ -203,6 +213,8 @@ static psa_status_t mock_store_set_extended(void *context,
     struct mock_store *this_context = (struct mock_store*)context;
     struct mock_store_slot *slot;
 
+    ++this_context->call_counts.set_extended;
+
     slot = find_slot(this_context, uid);
 
     if (slot && slot->item) {
@@ -224,6 +236,40 @@ static psa_status_t mock_store_set_extended(void *context,
     return psa_status;
 }
 
+static psa_status_t mock_store_get_info_multi(void *context,
+                            uint32_t client_id,
+                            size_t num_uids,
+                            const uint64_t *uids,
+                            struct psa_storage_info_t *p_info,
+                            psa_status_t *p_status)
+{
+    (void)client_id;
+
+    struct mock_store *this_context = (struct mock_store*)context;
+
+    ++this_context->call_counts.get_info_multi;
+
+    for (size_t i = 0; i < num_uids; ++i) {
+
+        struct mock_store_slot *slot = (uids[i]) ? find_slot(this_context, uids[i]) : NULL;
+
+        if (slot) {
+            p_info[i].capacity = slot->capacity;
+            p_info[i].size = slot->len;
+            p_info[i].flags = slot->flags;
+            p_status[i] = PSA_SUCCESS;
+        }
+        else {
+            p_info[i].capacity = 0;
+            p_info[i].size = 0;
+            p_info[i].flags = 0;
+            p_status[i] = (uids[i]) ? PSA_ERROR_DOES_NOT_EXIST : PSA_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
 static uint32_t mock_store_get_support(void *context,
                             uint32_t client_id)
 {
@@ -253,12 +299,15 @@ struct storage_backend *mock_store_init(struct mock_store *context)
         mock_store_remove,
         mock_store_create,
         mock_store_set_extended,
+        mock_store_get_info_multi,
         mock_store_get_support
     };
 
     context->backend.context = context;
     context->backend.interface = &interface;
 
+    mock_store_clear_call_counts(context);
+
     return &context->backend;
 }
 
@@ -295,6 +344,11 @@ size_t mock_store_num_items(const struct mock_store *context)
     return count;
 }
 
+void mock_store_clear_call_counts(struct mock_store *context)
+{
+    memset(&context->call_counts, 0, sizeof(context->call_counts));
+}
+
 static struct mock_store_slot *find_slot(struct mock_store *context, uint64_t uid)
 {
     struct mock_store_slot *slot = NULL;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -28,10 +28,23 @@ struct mock_store_slot
     uint8_t *item;
 };
 
+/* Number of calls made to each backend operation */
+struct mock_store_call_counts
+{
+    size_t set;
+    size_t get;
+    size_t get_info;
+    size_t remove;
+    size_t create;
+    size_t set_extended;
+    size_t get_info_multi;
+};
+
 struct mock_store
 {
     struct storage_backend backend;
     struct mock_store_slot slots[MOCK_STORE_NUM_SLOTS];
+    struct mock_store_call_counts call_counts;
 };
 
 struct storage_backend *mock_store_init(struct mock_store *context);
@@ -41,6 +54,7 @@ void mock_store_deinit(struct mock_store *context);
 void mock_store_reset(struct mock_store *context);
 bool mock_store_exists(const struct mock_store *context, uint64_t uid);
 size_t mock_store_num_items(const struct mock_store *context);
+void mock_store_clear_call_counts(struct mock_store *context);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -100,6 +100,23 @@ static psa_status_t null_store_set_extended(void *context,
     return PSA_ERROR_STORAGE_FAILURE;
 }
 
+static psa_status_t null_store_get_info_multi(void *context,
+                            uint32_t client_id,
+                            size_t num_uids,
+                            const uint64_t *uids,
+                            struct psa_storage_info_t *p_info,
+                            psa_status_t *p_status)
+{
+    (void)context;
+    (void)client_id;
+    (void)num_uids;
+    (void)uids;
+    (void)p_info;
+    (void)p_status;
+
+    return PSA_ERROR_STORAGE_FAILURE;
+}
+
 static uint32_t null_store_get_support(void *context,
                             uint32_t client_id)
 {
@@ -120,6 +137,7 @@ struct storage_backend *null_store_init(struct null_store *context)
         null_store_remove,
         null_store_create,
         null_store_set_extended,
+        null_store_get_info_multi,
         null_store_get_support
     };
 
@@ -53,34 +53,32 @@ static psa_status_t sfs_flash_read(
 	psa_status_t status = PSA_SUCCESS;
 	struct sfs_flash_block_store_adapter *context = get_context(info);
 	size_t total_bytes_read = 0;
-	uint64_t sub_block_lba;
-	size_t sub_block_offset;
-
-	calc_sub_block_pos(context, block_id, offset, &sub_block_lba, &sub_block_offset);
 
+	/* The block_store may stop short of the requested size so continue from wherever
+	 * each read stops.
+	 */
 	while (total_bytes_read < size) {
 
 		size_t bytes_read = 0;
-		size_t bytes_to_read = size - total_bytes_read;
+		uint64_t sub_block_lba;
+		size_t sub_block_offset;
 
-		if (bytes_to_read > context->flash_info.sector_size)
-			bytes_to_read = context->flash_info.sector_size;
+		calc_sub_block_pos(context, block_id, offset + total_bytes_read,
+			&sub_block_lba, &sub_block_offset);
 
-		status = block_store_read(context->block_store,
+		status = block_store_read_blocks(context->block_store,
 			context->client_id,
 			context->partition_handle,
 			sub_block_lba,
 			sub_block_offset,
-			bytes_to_read,
+			size - total_bytes_read,
 			&buff[total_bytes_read],
 			&bytes_read);
 
-		if (status != PSA_SUCCESS)
+		if ((status != PSA_SUCCESS) || !bytes_read)
 			break;
 
 		total_bytes_read += bytes_read;
-		++sub_block_lba;
-		sub_block_offset = 0;
 	}
 
 	if ((status == PSA_SUCCESS) && (total_bytes_read != size))
@@ -100,34 +98,29 @@ static psa_status_t sfs_flash_write(
 	psa_status_t status = PSA_SUCCESS;
 	struct sfs_flash_block_store_adapter *context = get_context(info);
 	size_t total_bytes_written = 0;
-	uint64_t sub_block_lba;
-	size_t sub_block_offset;
-
-	calc_sub_block_pos(context, block_id, offset, &sub_block_lba, &sub_block_offset);
 
 	while (total_bytes_written < size) {
 
 		size_t bytes_written = 0;
-		size_t bytes_to_write = size - total_bytes_written;
+		uint64_t sub_block_lba;
+		size_t sub_block_offset;
 
-		if (bytes_to_write > context->flash_info.sector_size)
-			bytes_to_write = context->flash_info.sector_size;
+		calc_sub_block_pos(context, block_id, offset + total_bytes_written,
+			&sub_block_lba, &sub_block_offset);
 
-		status = block_store_write(context->block_store,
+		status = block_store_write_blocks(context->block_store,
 			context->client_id,
 			context->partition_handle,
 			sub_block_lba,
 			sub_block_offset,
 			&buff[total_bytes_written],
-			bytes_to_write,
+			size - total_bytes_written,
 			&bytes_written);
 
-		if (status != PSA_SUCCESS)
+		if ((status != PSA_SUCCESS) || !bytes_written)
 			break;
 
 		total_bytes_written += bytes_written;
-		++sub_block_lba;
-		sub_block_offset = 0;
 	}
 
 	if ((status == PSA_SUCCESS) && (total_bytes_written != size))
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -21,14 +21,18 @@ static psa_status_t sfs_flash_fs_file_write_aligned_data(
                                       size_t size,
                                       const uint8_t *data)
 {
+    size_t program_size = size;
+
 #if (SFS_FLASH_MAX_ALIGNMENT != 1)
     /* Check that the offset is aligned with the flash program unit */
     if (!SFS_UTILS_IS_ALIGNED(offset, fs_ctx->flash_info->program_unit)) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
-    /* Set the size to be aligned with the flash program unit */
-    size = SFS_UTILS_ALIGN(size, fs_ctx->flash_info->program_unit);
+    /* The programmed size is aligned with the flash program unit. The data
+     * block layer pads the unaligned tail, so only size bytes of data are read.
+     */
+    program_size = SFS_UTILS_ALIGN(size, fs_ctx->flash_info->program_unit);
 #endif
 
     /* It is not permitted to create gaps in the file */
@@ -37,7 +41,7 @@ static psa_status_t sfs_flash_fs_file_write_aligned_data(
     }
 
     /* Check that the new data is contained within the file's max size */
-    if (sfs_utils_check_contained_in(file_meta->max_size, offset, size)
+    if (sfs_utils_check_contained_in(file_meta->max_size, offset, program_size)
         != PSA_SUCCESS) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
@@ -56,6 +60,11 @@ psa_status_t sfs_flash_fs_prepare(struct sfs_flash_fs_ctx_t *fs_ctx,
     return sfs_flash_fs_mblock_init(fs_ctx);
 }
 
+void sfs_flash_fs_deinit(struct sfs_flash_fs_ctx_t *fs_ctx)
+{
+    sfs_flash_fs_mblock_deinit(fs_ctx);
+}
+
 psa_status_t sfs_flash_fs_wipe_all(struct sfs_flash_fs_ctx_t *fs_ctx)
 {
     /* Clean and initialize the metadata block */
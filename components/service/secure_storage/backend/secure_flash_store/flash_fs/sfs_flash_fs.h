@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -62,6 +62,14 @@ struct sfs_file_info_t {
 psa_status_t sfs_flash_fs_prepare(sfs_flash_fs_ctx_t *fs_ctx,
                                   const struct sfs_flash_info_t *flash_info);
 
+/**
+ * \brief Releases the resources held by a prepared filesystem context.
+ *
+ * \param[in,out] fs_ctx  Filesystem context. Must be prepared again before
+ *                        further use.
+ */
+void sfs_flash_fs_deinit(sfs_flash_fs_ctx_t *fs_ctx);
+
 /**
  * \brief Wipes all files from the filesystem.
  *
@@ -95,8 +103,9 @@ psa_status_t sfs_flash_fs_file_exist(sfs_flash_fs_ctx_t *fs_ctx,
  *                           to 0 when the file is empty after the creation.
  * \param[in]     flags      Flags of the file
  * \param[in]     data       Pointer to buffer containing the initial data.
- *                           This parameter is set to NULL when the file is
- *                           empty after the creation.
+ *                           Only data_size bytes are read from it. This
+ *                           parameter is set to NULL when the file is empty
+ *                           after the creation.
  *
  * \return Returns PSA_SUCCESS if the file has been created correctly. If the
  *         fid is in use, it returns PSA_ERROR_INVALID_ARGUMENT. Otherwise, it
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -8,6 +8,7 @@
 #include "sfs_flash_fs_dblock.h"
 
 #include "../flash/sfs_flash.h"
+#include <string.h>
 
 /**
  * \brief Converts logical data block number to physical number.
@@ -144,6 +145,10 @@ psa_status_t sfs_flash_fs_dblock_write_file(
     uint32_t scratch_id;
     size_t pos;
     size_t num_bytes;
+#if (SFS_FLASH_MAX_ALIGNMENT != 1)
+    uint8_t tail_buf[SFS_FLASH_MAX_ALIGNMENT];
+    size_t tail_size;
+#endif
 
     scratch_id = sfs_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
                                                          file_meta->lblock);
@@ -162,6 +167,14 @@ psa_status_t sfs_flash_fs_dblock_write_file(
         return err;
     }
 
+#if (SFS_FLASH_MAX_ALIGNMENT != 1)
+    /* Program the data up to the last whole program unit directly from the
+     * caller's buffer, the remainder is padded in a program unit sized buffer.
+     */
+    tail_size = size % fs_ctx->flash_info->program_unit;
+    size -= tail_size;
+#endif
+
     /* Write the new file data */
     err = fs_ctx->flash_info->write(fs_ctx->flash_info, scratch_id, data, pos,
                                     size);
@@ -169,6 +182,21 @@ psa_status_t sfs_flash_fs_dblock_write_file(
         return err;
     }
 
+#if (SFS_FLASH_MAX_ALIGNMENT != 1)
+    if (tail_size != 0) {
+        (void)memset(tail_buf, fs_ctx->flash_info->erase_val,
+                     fs_ctx->flash_info->program_unit);
+        (void)memcpy(tail_buf, data + size, tail_size);
+
+        err = fs_ctx->flash_info->write(fs_ctx->flash_info, scratch_id,
+                                        tail_buf, pos + size,
+                                        fs_ctx->flash_info->program_unit);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+#endif
+
     /* Calculate the position of the end of the file */
     pos = file_meta->data_idx + file_meta->max_size;
 
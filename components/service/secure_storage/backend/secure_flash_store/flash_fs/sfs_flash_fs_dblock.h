@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -67,7 +67,9 @@ psa_status_t sfs_flash_fs_dblock_read_file(
  * \param[in]     file_meta   File metadata
  * \param[in]     offset      Offset in the scratch data block where to start
  *                            the copy of the incoming data
- * \param[in]     size        Size of the incoming data
+ * \param[in]     size        Size of the incoming data. If it is not a
+ *                            multiple of the program unit, the last program
+ *                            unit is padded with the erase value.
  * \param[in]     data        Pointer to data buffer to copy in the scratch data
  *                            block
  *
@@ -1,11 +1,13 @@
 /*
- * Copyright (c) 2018-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
 #include "sfs_flash_fs_mblock.h"
+#include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* Physical ID of the two metadata blocks */
@@ -128,6 +130,231 @@ static size_t sfs_mblock_file_meta_offset(struct sfs_flash_fs_ctx_t *fs_ctx,
            + (idx * SFS_FILE_METADATA_SIZE);
 }
 
+/**
+ * \brief Checks whether the metadata RAM cache is in use.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ *
+ * \return true if metadata is served from the RAM cache
+ */
+__attribute__((always_inline))
+static inline bool sfs_mblock_cache_enabled(
+                                        const struct sfs_flash_fs_ctx_t *fs_ctx)
+{
+    return fs_ctx->fid_table != NULL;
+}
+
+/**
+ * \brief Releases the metadata RAM cache.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+static void sfs_mblock_cache_free(struct sfs_flash_fs_ctx_t *fs_ctx)
+{
+    uint32_t i;
+
+    for (i = 0; i < 2; i++) {
+        free(fs_ctx->block_meta_cache[i]);
+        free(fs_ctx->file_meta_cache[i]);
+        fs_ctx->block_meta_cache[i] = NULL;
+        fs_ctx->file_meta_cache[i] = NULL;
+    }
+
+    free(fs_ctx->fid_table);
+    fs_ctx->fid_table = NULL;
+    fs_ctx->fid_table_size = 0;
+    fs_ctx->cache_num_dblocks = 0;
+    fs_ctx->cache_num_files = 0;
+}
+
+/**
+ * \brief Allocates the metadata RAM cache for the geometry of the current
+ *        flash device. An existing cache of the same geometry is reused.
+ *
+ * \note A failed allocation leaves the cache disabled, in which case metadata
+ *       is read from flash.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+static void sfs_mblock_cache_alloc(struct sfs_flash_fs_ctx_t *fs_ctx)
+{
+    uint32_t i;
+    uint32_t num_dblocks = sfs_num_active_dblocks(fs_ctx);
+    uint32_t num_files = fs_ctx->flash_info->max_num_files;
+    size_t table_size = 1;
+
+    if (sfs_mblock_cache_enabled(fs_ctx) &&
+        (fs_ctx->cache_num_dblocks == num_dblocks) &&
+        (fs_ctx->cache_num_files == num_files)) {
+        return;
+    }
+
+    sfs_mblock_cache_free(fs_ctx);
+
+    /* Keep the load factor of the fid table at or below one half */
+    while (table_size < (2 * (size_t)num_files)) {
+        table_size <<= 1;
+    }
+
+    for (i = 0; i < 2; i++) {
+        fs_ctx->block_meta_cache[i] = calloc(num_dblocks,
+                                             SFS_BLOCK_METADATA_SIZE);
+        fs_ctx->file_meta_cache[i] = calloc(num_files, SFS_FILE_METADATA_SIZE);
+        if (!fs_ctx->block_meta_cache[i] || !fs_ctx->file_meta_cache[i]) {
+            sfs_mblock_cache_free(fs_ctx);
+            return;
+        }
+    }
+
+    fs_ctx->fid_table = calloc(table_size, sizeof(uint32_t));
+    if (!fs_ctx->fid_table) {
+        sfs_mblock_cache_free(fs_ctx);
+        return;
+    }
+
+    fs_ctx->fid_table_size = table_size;
+    fs_ctx->cache_num_dblocks = num_dblocks;
+    fs_ctx->cache_num_files = num_files;
+}
+
+/**
+ * \brief Gets the first fid table slot to probe for a file ID.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ * \param[in] fid     File ID
+ *
+ * \return Slot index
+ */
+static size_t sfs_mblock_fid_slot(const struct sfs_flash_fs_ctx_t *fs_ctx,
+                                  const uint8_t *fid)
+{
+    /* FNV-1a */
+    uint32_t hash = 2166136261u;
+    uint32_t i;
+
+    for (i = 0; i < SFS_FILE_ID_SIZE; i++) {
+        hash = (hash ^ fid[i]) * 16777619u;
+    }
+
+    return hash & (fs_ctx->fid_table_size - 1);
+}
+
+/**
+ * \brief Rebuilds the fid table from the cached file metadata of the active
+ *        metablock.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+static void sfs_mblock_cache_rebuild_fid_table(
+                                              struct sfs_flash_fs_ctx_t *fs_ctx)
+{
+    const struct sfs_file_meta_t *file_meta =
+                                fs_ctx->file_meta_cache[fs_ctx->active_metablock];
+    size_t mask = fs_ctx->fid_table_size - 1;
+    size_t slot;
+    uint32_t idx;
+    uint32_t entry;
+
+    memset(fs_ctx->fid_table, 0, fs_ctx->fid_table_size * sizeof(uint32_t));
+
+    for (idx = 0; idx < fs_ctx->cache_num_files; idx++) {
+        if (sfs_utils_validate_fid(file_meta[idx].id) != PSA_SUCCESS) {
+            continue;
+        }
+
+        /* Only the lowest index is kept for a duplicated ID, matching the
+         * result of a linear scan of the table.
+         */
+        for (slot = sfs_mblock_fid_slot(fs_ctx, file_meta[idx].id);
+             (entry = fs_ctx->fid_table[slot]) != 0;
+             slot = (slot + 1) & mask) {
+            if (!memcmp(file_meta[entry - 1].id, file_meta[idx].id,
+                        SFS_FILE_ID_SIZE)) {
+                break;
+            }
+        }
+
+        if (entry == 0) {
+            fs_ctx->fid_table[slot] = idx + 1;
+        }
+    }
+}
+
+/**
+ * \brief Loads the metadata of the active metablock into the RAM cache.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t sfs_mblock_cache_load(struct sfs_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+
+    if (!sfs_mblock_cache_enabled(fs_ctx)) {
+        return PSA_SUCCESS;
+    }
+
+    /* Block and file metadata tables are contiguous on flash, so each is
+     * loaded with a single read.
+     */
+    err = fs_ctx->flash_info->read(fs_ctx->flash_info, fs_ctx->active_metablock,
+                    (uint8_t *)fs_ctx->block_meta_cache[fs_ctx->active_metablock],
+                    sfs_mblock_block_meta_offset(SFS_LOGICAL_DBLOCK0),
+                    fs_ctx->cache_num_dblocks * SFS_BLOCK_METADATA_SIZE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = fs_ctx->flash_info->read(fs_ctx->flash_info, fs_ctx->active_metablock,
+                    (uint8_t *)fs_ctx->file_meta_cache[fs_ctx->active_metablock],
+                    sfs_mblock_file_meta_offset(fs_ctx, 0),
+                    fs_ctx->cache_num_files * SFS_FILE_METADATA_SIZE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    sfs_mblock_cache_rebuild_fid_table(fs_ctx);
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Mirrors a range of block metadata copied from the active to the
+ *        scratch metablock in the RAM cache.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     lblock  First logical block copied
+ * \param[in]     count   Number of block metadata entries copied
+ */
+static void sfs_mblock_cache_copy_block_meta(struct sfs_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t lblock, uint32_t count)
+{
+    if (sfs_mblock_cache_enabled(fs_ctx) && (count != 0)) {
+        memcpy(&fs_ctx->block_meta_cache[fs_ctx->scratch_metablock][lblock],
+               &fs_ctx->block_meta_cache[fs_ctx->active_metablock][lblock],
+               count * SFS_BLOCK_METADATA_SIZE);
+    }
+}
+
+/**
+ * \brief Mirrors a range of file metadata copied from the active to the
+ *        scratch metablock in the RAM cache.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     idx     First file metadata entry index copied
+ * \param[in]     count   Number of file metadata entries copied
+ */
+static void sfs_mblock_cache_copy_file_meta(struct sfs_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t idx, uint32_t count)
+{
+    if (sfs_mblock_cache_enabled(fs_ctx) && (count != 0)) {
+        memcpy(&fs_ctx->file_meta_cache[fs_ctx->scratch_metablock][idx],
+               &fs_ctx->file_meta_cache[fs_ctx->active_metablock][idx],
+               count * SFS_FILE_METADATA_SIZE);
+    }
+}
+
 /**
  * \brief Swaps metablocks. Scratch becomes active and active becomes scratch.
  *
@@ -140,6 +367,11 @@ static void sfs_mblock_swap_metablocks(struct sfs_flash_fs_ctx_t *fs_ctx)
     tmp_block = fs_ctx->scratch_metablock;
     fs_ctx->scratch_metablock = fs_ctx->active_metablock;
     fs_ctx->active_metablock = tmp_block;
+
+    /* The cached copy of the scratch metablock is now the active one */
+    if (sfs_mblock_cache_enabled(fs_ctx)) {
+        sfs_mblock_cache_rebuild_fid_table(fs_ctx);
+    }
 }
 
 /**
@@ -388,14 +620,22 @@ static psa_status_t sfs_mblock_update_scratch_block_meta(
                                       uint32_t lblock,
                                       const struct sfs_block_meta_t *block_meta)
 {
+    psa_status_t err;
     size_t pos;
 
     /* Calculate the position */
     pos = sfs_mblock_block_meta_offset(lblock);
-    return fs_ctx->flash_info->write(fs_ctx->flash_info,
-                                     fs_ctx->scratch_metablock,
-                                     (const uint8_t *)block_meta, pos,
-                                     SFS_BLOCK_METADATA_SIZE);
+    err = fs_ctx->flash_info->write(fs_ctx->flash_info,
+                                    fs_ctx->scratch_metablock,
+                                    (const uint8_t *)block_meta, pos,
+                                    SFS_BLOCK_METADATA_SIZE);
+
+    if ((err == PSA_SUCCESS) && sfs_mblock_cache_enabled(fs_ctx)) {
+        fs_ctx->block_meta_cache[fs_ctx->scratch_metablock][lblock] =
+                                                                    *block_meta;
+    }
+
+    return err;
 }
 
 /**
@@ -462,6 +702,9 @@ static psa_status_t sfs_mblock_copy_remaining_block_meta(
             if (err != PSA_SUCCESS) {
                 return err;
             }
+
+            sfs_mblock_cache_copy_block_meta(fs_ctx, SFS_LOGICAL_DBLOCK0 + 1,
+                                             lblock - 1);
         }
     }
 
@@ -470,8 +713,16 @@ static psa_status_t sfs_mblock_copy_remaining_block_meta(
 
     size = sfs_mblock_file_meta_offset(fs_ctx, 0) - pos;
 
-    return sfs_flash_block_to_block_move(fs_ctx->flash_info, scratch_block, pos,
-                                         meta_block, pos, size);
+    err = sfs_flash_block_to_block_move(fs_ctx->flash_info, scratch_block, pos,
+                                        meta_block, pos, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    sfs_mblock_cache_copy_block_meta(fs_ctx, lblock + 1,
+                                     sfs_num_active_dblocks(fs_ctx) - lblock - 1);
+
+    return PSA_SUCCESS;
 }
 
 /**
@@ -724,6 +975,8 @@ psa_status_t sfs_flash_fs_mblock_cp_remaining_file_meta(
         return err;
     }
 
+    sfs_mblock_cache_copy_file_meta(fs_ctx, 0, idx);
+
     /* Data after updated content */
     pos = sfs_mblock_file_meta_offset(fs_ctx, idx + 1);
 
@@ -735,6 +988,12 @@ psa_status_t sfs_flash_fs_mblock_cp_remaining_file_meta(
     if (end > pos) {
         err = sfs_flash_block_to_block_move(fs_ctx->flash_info, scratch_block,
                                             pos, meta_block, pos, (end - pos));
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        sfs_mblock_cache_copy_file_meta(fs_ctx, idx + 1,
+                              fs_ctx->flash_info->max_num_files - idx - 1);
     }
 
     return err;
@@ -759,6 +1018,25 @@ psa_status_t sfs_flash_fs_mblock_get_file_idx(struct sfs_flash_fs_ctx_t *fs_ctx,
     psa_status_t err;
     uint32_t i;
     struct sfs_file_meta_t tmp_metadata;
+    const struct sfs_file_meta_t *file_meta;
+    size_t slot;
+
+    if (sfs_mblock_cache_enabled(fs_ctx)) {
+        /* Look up the file in the fid table of the active metablock */
+        file_meta = fs_ctx->file_meta_cache[fs_ctx->active_metablock];
+
+        for (slot = sfs_mblock_fid_slot(fs_ctx, fid);
+             (i = fs_ctx->fid_table[slot]) != 0;
+             slot = (slot + 1) & (fs_ctx->fid_table_size - 1)) {
+            if (!memcmp(file_meta[i - 1].id, fid, SFS_FILE_ID_SIZE)) {
+                /* Found */
+                *idx = i - 1;
+                return PSA_SUCCESS;
+            }
+        }
+
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
 
     for (i = 0; i < fs_ctx->flash_info->max_num_files; i++) {
         err = sfs_flash_fs_mblock_read_file_meta(fs_ctx, i, &tmp_metadata);
@@ -787,6 +1065,8 @@ psa_status_t sfs_flash_fs_mblock_init(struct sfs_flash_fs_ctx_t *fs_ctx)
         return err;
     }
 
+    sfs_mblock_cache_alloc(fs_ctx);
+
     err = sfs_init_get_active_metablock(fs_ctx);
     if (err != PSA_SUCCESS) {
         return PSA_ERROR_GENERIC_ERROR;
@@ -797,10 +1077,21 @@ psa_status_t sfs_flash_fs_mblock_init(struct sfs_flash_fs_ctx_t *fs_ctx)
         return PSA_ERROR_GENERIC_ERROR;
     }
 
+    /* Cache the metadata of the active metablock */
+    err = sfs_mblock_cache_load(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
     /* Erase the other scratch metadata block */
     return sfs_mblock_erase_scratch_blocks(fs_ctx);
 }
 
+void sfs_flash_fs_mblock_deinit(struct sfs_flash_fs_ctx_t *fs_ctx)
+{
+    sfs_mblock_cache_free(fs_ctx);
+}
+
 psa_status_t sfs_flash_fs_mblock_meta_update_finalize(
                                               struct sfs_flash_fs_ctx_t *fs_ctx)
 {
@@ -855,13 +1146,18 @@ psa_status_t sfs_flash_fs_mblock_read_file_meta(
                                               uint32_t idx,
                                               struct sfs_file_meta_t *file_meta)
 {
-    psa_status_t err;
+    psa_status_t err = PSA_SUCCESS;
     size_t offset;
 
-    offset = sfs_mblock_file_meta_offset(fs_ctx, idx);
-    err = fs_ctx->flash_info->read(fs_ctx->flash_info, fs_ctx->active_metablock,
-                                   (uint8_t *)file_meta, offset,
-                                   SFS_FILE_METADATA_SIZE);
+    if (sfs_mblock_cache_enabled(fs_ctx)) {
+        *file_meta = fs_ctx->file_meta_cache[fs_ctx->active_metablock][idx];
+    } else {
+        offset = sfs_mblock_file_meta_offset(fs_ctx, idx);
+        err = fs_ctx->flash_info->read(fs_ctx->flash_info,
+                                       fs_ctx->active_metablock,
+                                       (uint8_t *)file_meta, offset,
+                                       SFS_FILE_METADATA_SIZE);
+    }
 
 #ifdef SFS_VALIDATE_METADATA_FROM_FLASH
     if (err == PSA_SUCCESS) {
@@ -877,13 +1173,18 @@ psa_status_t sfs_flash_fs_mblock_read_block_metadata(
                                             uint32_t lblock,
                                             struct sfs_block_meta_t *block_meta)
 {
-    psa_status_t err;
+    psa_status_t err = PSA_SUCCESS;
     size_t pos;
 
-    pos = sfs_mblock_block_meta_offset(lblock);
-    err = fs_ctx->flash_info->read(fs_ctx->flash_info, fs_ctx->active_metablock,
-                                   (uint8_t *)block_meta, pos,
-                                   SFS_BLOCK_METADATA_SIZE);
+    if (sfs_mblock_cache_enabled(fs_ctx)) {
+        *block_meta = fs_ctx->block_meta_cache[fs_ctx->active_metablock][lblock];
+    } else {
+        pos = sfs_mblock_block_meta_offset(lblock);
+        err = fs_ctx->flash_info->read(fs_ctx->flash_info,
+                                       fs_ctx->active_metablock,
+                                       (uint8_t *)block_meta, pos,
+                                       SFS_BLOCK_METADATA_SIZE);
+    }
 
 #ifdef SFS_VALIDATE_METADATA_FROM_FLASH
     if (err == PSA_SUCCESS) {
@@ -926,6 +1227,9 @@ psa_status_t sfs_flash_fs_mblock_reset_metablock(
     uint32_t metablock_to_erase_first = SFS_METADATA_BLOCK0;
     struct sfs_file_meta_t file_metadata;
 
+    /* The cache is rebuilt from the metadata written below */
+    sfs_mblock_cache_alloc(fs_ctx);
+
     /* Erase both metadata blocks. If at least one metadata block is valid,
      * ensure that the active metadata block is erased last to prevent rollback
      * in the case of a power failure between the two erases.
@@ -1063,12 +1367,19 @@ psa_status_t sfs_flash_fs_mblock_update_scratch_file_meta(
                                         uint32_t idx,
                                         const struct sfs_file_meta_t *file_meta)
 {
+    psa_status_t err;
     size_t pos;
 
     /* Calculate the position */
     pos = sfs_mblock_file_meta_offset(fs_ctx, idx);
-    return fs_ctx->flash_info->write(fs_ctx->flash_info,
-                                     fs_ctx->scratch_metablock,
-                                     (const uint8_t *)file_meta, pos,
-                                     SFS_FILE_METADATA_SIZE);
+    err = fs_ctx->flash_info->write(fs_ctx->flash_info,
+                                    fs_ctx->scratch_metablock,
+                                    (const uint8_t *)file_meta, pos,
+                                    SFS_FILE_METADATA_SIZE);
+
+    if ((err == PSA_SUCCESS) && sfs_mblock_cache_enabled(fs_ctx)) {
+        fs_ctx->file_meta_cache[fs_ctx->scratch_metablock][idx] = *file_meta;
+    }
+
+    return err;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -113,17 +113,44 @@ struct sfs_flash_fs_ctx_t {
                                                            */
     uint32_t active_metablock;  /**< Active metadata block */
     uint32_t scratch_metablock; /**< Scratch metadata block */
+    struct sfs_block_meta_t *block_meta_cache[2]; /**< RAM copies of the
+                                                   *   block metadata of each
+                                                   *   metadata block
+                                                   */
+    struct sfs_file_meta_t *file_meta_cache[2];   /**< RAM copies of the file
+                                                   *   metadata of each
+                                                   *   metadata block
+                                                   */
+    uint32_t *fid_table;        /**< File ID to file metadata index map for
+                                 *   the active metadata block. Slots hold
+                                 *   index + 1, 0 marks an empty slot.
+                                 */
+    size_t fid_table_size;      /**< Number of slots in fid_table */
+    uint32_t cache_num_dblocks; /**< Block metadata entries cached */
+    uint32_t cache_num_files;   /**< File metadata entries cached */
 };
 
 /**
  * \brief Initializes metadata block with the valid/active metablock.
  *
+ * \details The file and block metadata of the active metablock are loaded
+ *          into a RAM cache, so that later metadata reads and file lookups do
+ *          not need to access the flash. If the cache cannot be allocated,
+ *          metadata is read from flash instead.
+ *
  * \param[in,out] fs_ctx  Filesystem context
  *
  * \return Returns value as specified in \ref psa_status_t
  */
 psa_status_t sfs_flash_fs_mblock_init(struct sfs_flash_fs_ctx_t *fs_ctx);
 
+/**
+ * \brief Releases the metadata RAM cache.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+void sfs_flash_fs_mblock_deinit(struct sfs_flash_fs_ctx_t *fs_ctx);
+
 /**
  * \brief Copies rest of the file metadata, except for the one pointed by
  *        index.
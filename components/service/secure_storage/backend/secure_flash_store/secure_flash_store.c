@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -12,30 +12,10 @@
 #include <string.h>
 #include <stddef.h>
 
-#define SFS_MAX_ASSET_SIZE (4096) /* TODO: comes from flash layout */
 #define SFS_CREATE_FLASH_LAYOUT /* TODO: move this to a proper place */
 
-#ifndef SFS_BUF_SIZE
-/* By default, set the SFS buffer size to the max asset size so that all
- * requests can be handled in one iteration.
- */
-#define SFS_BUF_SIZE SFS_MAX_ASSET_SIZE
-#endif
-
 #define SFS_INVALID_UID 0 /* TODO: are there any invalid UID-s? */
 
-/* Buffer to store asset data from the caller.
- * Note: size must be aligned to the max flash program unit to meet the
- * alignment requirement of the filesystem.
- */
-static uint8_t asset_data[SFS_UTILS_ALIGN(SFS_BUF_SIZE,
-                                          SFS_FLASH_MAX_ALIGNMENT)];
-
-static uint8_t g_fid[SFS_FILE_ID_SIZE];
-static struct sfs_file_info_t g_file_info;
-
-static sfs_flash_fs_ctx_t fs_ctx_sfs;
-
 /**
  * \brief Maps a pair of client id and uid to a file id.
  *
@@ -58,12 +38,10 @@ static psa_status_t sfs_set(void *context,
                          const void *p_data,
                          uint32_t create_flags)
 {
-    (void)context;
-
+    struct secure_flash_store *this_context = (struct secure_flash_store *)context;
     psa_status_t status;
-    size_t write_size;
-    size_t offset;
-    const uint8_t *data = (const uint8_t *)p_data;
+    uint8_t fid[SFS_FILE_ID_SIZE];
+    struct sfs_file_info_t file_info;
 
     /* Check that the UID is valid */
     if (uid == SFS_INVALID_UID) {
@@ -78,18 +56,18 @@ static psa_status_t sfs_set(void *context,
     }
 
     /* Set file id */
-    sfs_get_fid(client_id, uid, g_fid);
+    sfs_get_fid(client_id, uid, fid);
 
     /* Read file info */
-    status = sfs_flash_fs_file_get_info(&fs_ctx_sfs, g_fid, &g_file_info);
+    status = sfs_flash_fs_file_get_info(&this_context->fs_ctx, fid, &file_info);
     if (status == PSA_SUCCESS) {
         /* If the object exists and has the write once flag set, then it
          * cannot be modified. Otherwise it needs to be removed.
          */
-        if (g_file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+        if (file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
             return PSA_ERROR_NOT_PERMITTED;
         } else {
-            status = sfs_flash_fs_file_delete(&fs_ctx_sfs, g_fid);
+            status = sfs_flash_fs_file_delete(&this_context->fs_ctx, fid);
             if (status != PSA_SUCCESS) {
                 return status;
             }
@@ -101,48 +79,12 @@ static psa_status_t sfs_set(void *context,
         return status;
     }
 
-    /* Write as much of the data as will fit in the asset_data buffer */
-    write_size = SFS_UTILS_MIN(data_length, sizeof(asset_data));
-
-    /* Read asset data from the caller */
-    memcpy(asset_data, data, write_size);
-    data += write_size;
-
-    /* Create the file in the file system */
-    status = sfs_flash_fs_file_create(&fs_ctx_sfs, g_fid, data_length,
-                                      write_size, (uint32_t)create_flags,
-                                      asset_data);
-    if (status != PSA_SUCCESS) {
-        return status;
-    }
-
-    offset = write_size;
-    data_length -= write_size;
-
-    /* Iteratively read data from the caller and write it to the filesystem, in
-     * chunks no larger than the size of the asset_data buffer.
+    /* Create the file in the file system. A file always fits in a single
+     * data block, so the caller's buffer is programmed directly in one update.
      */
-    while (data_length > 0) {
-        write_size = SFS_UTILS_MIN(data_length, sizeof(asset_data));
-
-        /* Read asset data from the caller */
-        memcpy(asset_data, data, write_size);
-        data += write_size;
-
-        /* Write to the file in the file system */
-        status = sfs_flash_fs_file_write(&fs_ctx_sfs, g_fid,
-                                         write_size, offset, asset_data);
-        if (status != PSA_SUCCESS) {
-            /* Delete the file to avoid leaving partial data */
-            (void)sfs_flash_fs_file_delete(&fs_ctx_sfs, g_fid);
-            return status;
-        }
-
-        offset += write_size;
-        data_length -= write_size;
-    }
-
-    return PSA_SUCCESS;
+    return sfs_flash_fs_file_create(&this_context->fs_ctx, fid, data_length,
+                                    data_length, (uint32_t)create_flags,
+                                    (const uint8_t *)p_data);
 }
 
 static psa_status_t sfs_get(void *context,
@@ -153,11 +95,10 @@ static psa_status_t sfs_get(void *context,
                          void *p_data,
                          size_t *p_data_length)
 {
-    (void)context;
-
+    struct secure_flash_store *this_context = (struct secure_flash_store *)context;
     psa_status_t status;
-    size_t read_size;
-    uint8_t *data = (uint8_t *)p_data;
+    uint8_t fid[SFS_FILE_ID_SIZE];
+    struct sfs_file_info_t file_info;
 
     /* Check that the UID is valid */
     if (uid == SFS_INVALID_UID) {
@@ -165,58 +106,44 @@ static psa_status_t sfs_get(void *context,
     }
 
     /* Set file id */
-    sfs_get_fid(client_id, uid, g_fid);
+    sfs_get_fid(client_id, uid, fid);
 
     /* Read file info */
-    status = sfs_flash_fs_file_get_info(&fs_ctx_sfs, g_fid, &g_file_info);
+    status = sfs_flash_fs_file_get_info(&this_context->fs_ctx, fid, &file_info);
     if (status != PSA_SUCCESS) {
         return status;
     }
 
     /* Boundary check the incoming request */
-    if (data_offset > g_file_info.size_current) {
+    if (data_offset > file_info.size_current) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
     /* Copy the object data only from within the file boundary */
     data_size = SFS_UTILS_MIN(data_size,
-                              g_file_info.size_current - data_offset);
+                              file_info.size_current - data_offset);
+
+    /* Read file data from the filesystem straight into the caller's buffer */
+    status = sfs_flash_fs_file_read(&this_context->fs_ctx, fid, data_size,
+                                    data_offset, (uint8_t *)p_data);
+    if (status != PSA_SUCCESS) {
+        *p_data_length = 0;
+        return status;
+    }
 
     /* Update the size of the output data */
     *p_data_length = data_size;
 
-    /* Iteratively read data from the filesystem and write it to the caller, in
-     * chunks no larger than the size of the asset_data buffer.
-     */
-    do {
-        /* Read as much of the data as will fit in the asset_data buffer */
-        read_size = SFS_UTILS_MIN(data_size, sizeof(asset_data));
-
-        /* Read file data from the filesystem */
-        status = sfs_flash_fs_file_read(&fs_ctx_sfs, g_fid, read_size,
-                                        data_offset, asset_data);
-        if (status != PSA_SUCCESS) {
-            *p_data_length = 0;
-            return status;
-        }
-
-        /* Write asset data to the caller */
-        memcpy(data, asset_data, read_size);
-        data += read_size;
-
-        data_offset += read_size;
-        data_size -= read_size;
-    } while (data_size > 0);
-
     return PSA_SUCCESS;
 }
 
 static psa_status_t sfs_get_info(void *context, uint32_t client_id, uint64_t uid,
                               struct psa_storage_info_t *p_info)
 {
-    (void)context;
-
+    struct secure_flash_store *this_context = (struct secure_flash_store *)context;
     psa_status_t status;
+    uint8_t fid[SFS_FILE_ID_SIZE];
+    struct sfs_file_info_t file_info;
 
     /* Check that the UID is valid */
     if (uid == SFS_INVALID_UID) {
@@ -224,27 +151,28 @@ static psa_status_t sfs_get_info(void *context, uint32_t client_id, uint64_t uid
     }
 
     /* Set file id */
-    sfs_get_fid(client_id, uid, g_fid);
+    sfs_get_fid(client_id, uid, fid);
 
     /* Read file info */
-    status = sfs_flash_fs_file_get_info(&fs_ctx_sfs, g_fid, &g_file_info);
+    status = sfs_flash_fs_file_get_info(&this_context->fs_ctx, fid, &file_info);
     if (status != PSA_SUCCESS) {
         return status;
     }
 
     /* Copy file info to the PSA info struct */
-    p_info->capacity = g_file_info.size_current;
-    p_info->size = g_file_info.size_current;
-    p_info->flags = g_file_info.flags;
+    p_info->capacity = file_info.size_current;
+    p_info->size = file_info.size_current;
+    p_info->flags = file_info.flags;
 
     return PSA_SUCCESS;
 }
 
 static psa_status_t sfs_remove(void *context, uint32_t client_id, uint64_t uid)
 {
-    (void)context;
-
+    struct secure_flash_store *this_context = (struct secure_flash_store *)context;
     psa_status_t status;
+    uint8_t fid[SFS_FILE_ID_SIZE];
+    struct sfs_file_info_t file_info;
 
     /* Check that the UID is valid */
     if (uid == SFS_INVALID_UID) {
@@ -252,9 +180,9 @@ static psa_status_t sfs_remove(void *context, uint32_t client_id, uint64_t uid)
     }
 
     /* Set file id */
-    sfs_get_fid(client_id, uid, g_fid);
+    sfs_get_fid(client_id, uid, fid);
 
-    status = sfs_flash_fs_file_get_info(&fs_ctx_sfs, g_fid, &g_file_info);
+    status = sfs_flash_fs_file_get_info(&this_context->fs_ctx, fid, &file_info);
     if (status != PSA_SUCCESS) {
         return status;
     }
@@ -262,12 +190,12 @@ static psa_status_t sfs_remove(void *context, uint32_t client_id, uint64_t uid)
     /* If the object exists and has the write once flag set, then it
      * cannot be deleted.
      */
-    if (g_file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+    if (file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
         return PSA_ERROR_NOT_PERMITTED;
     }
 
     /* Delete old file from the persistent area */
-    return sfs_flash_fs_file_delete(&fs_ctx_sfs, g_fid);
+    return sfs_flash_fs_file_delete(&this_context->fs_ctx, fid);
 }
 
 static psa_status_t sfs_create(void *context,
@@ -276,9 +204,10 @@ static psa_status_t sfs_create(void *context,
                             size_t capacity,
                             uint32_t create_flags)
 {
-    (void)context;
-
+    struct secure_flash_store *this_context = (struct secure_flash_store *)context;
     psa_status_t status;
+    uint8_t fid[SFS_FILE_ID_SIZE];
+    struct sfs_file_info_t file_info;
 
     /* Check that the UID is valid */
     if (uid == SFS_INVALID_UID) {
@@ -293,16 +222,16 @@ static psa_status_t sfs_create(void *context,
     }
 
     /* Set file id */
-    sfs_get_fid(client_id, uid, g_fid);
+    sfs_get_fid(client_id, uid, fid);
 
     /* Read file info */
-    status = sfs_flash_fs_file_get_info(&fs_ctx_sfs, g_fid, &g_file_info);
+    status = sfs_flash_fs_file_get_info(&this_context->fs_ctx, fid, &file_info);
     if (status == PSA_SUCCESS) {
         return PSA_ERROR_ALREADY_EXISTS;
     }
 
     /* Create the file in the file system */
-    status = sfs_flash_fs_file_create(&fs_ctx_sfs, g_fid, capacity,
+    status = sfs_flash_fs_file_create(&this_context->fs_ctx, fid, capacity,
                                       0, (uint32_t)create_flags,
                                       NULL);
 
@@ -327,6 +256,32 @@ static psa_status_t sfs_set_extended(void *context,
     return PSA_ERROR_NOT_SUPPORTED;
 }
 
+static psa_status_t sfs_get_info_multi(void *context,
+                                    uint32_t client_id,
+                                    size_t num_uids,
+                                    const uint64_t *uids,
+                                    struct psa_storage_info_t *p_info,
+                                    psa_status_t *p_status)
+{
+    size_t i;
+
+    for (i = 0; i < num_uids; i++) {
+        p_status[i] = sfs_get_info(context, client_id, uids[i], &p_info[i]);
+
+        if (p_status[i] != PSA_SUCCESS) {
+            memset(&p_info[i], 0, sizeof(p_info[i]));
+
+            /* Fail the whole operation if the flash can't be read */
+            if (p_status[i] != PSA_ERROR_DOES_NOT_EXIST &&
+                p_status[i] != PSA_ERROR_INVALID_ARGUMENT) {
+                return p_status[i];
+            }
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
 static uint32_t sfs_get_support(void *context, uint32_t client_id)
 {
     (void)context;
@@ -336,12 +291,15 @@ static uint32_t sfs_get_support(void *context, uint32_t client_id)
     return 0;
 }
 
-struct storage_backend *sfs_init(const struct sfs_flash_info_t *flash_binding)
+struct storage_backend *secure_flash_store_init(
+                                    struct secure_flash_store *context,
+                                    const struct sfs_flash_info_t *flash_binding)
 {
     psa_status_t status;
 
     /* Initialise the SFS context */
-    status = sfs_flash_fs_prepare(&fs_ctx_sfs, flash_binding);
+    memset(context, 0, sizeof(*context));
+    status = sfs_flash_fs_prepare(&context->fs_ctx, flash_binding);
 
 #ifdef SFS_CREATE_FLASH_LAYOUT
     /* If SFS_CREATE_FLASH_LAYOUT is set, it indicates that it is required to
@@ -359,13 +317,13 @@ struct storage_backend *sfs_init(const struct sfs_flash_info_t *flash_binding)
         /* Remove all data in the SFS memory area and create a valid SFS flash
          * layout in that area.
          */
-        status = sfs_flash_fs_wipe_all(&fs_ctx_sfs);
+        status = sfs_flash_fs_wipe_all(&context->fs_ctx);
         if (status != PSA_SUCCESS) {
             return NULL;
         }
 
         /* Attempt to initialise again */
-        status = sfs_flash_fs_prepare(&fs_ctx_sfs, flash_binding);
+        status = sfs_flash_fs_prepare(&context->fs_ctx, flash_binding);
 
         if (status != PSA_SUCCESS) {
             return NULL;
@@ -381,13 +339,30 @@ struct storage_backend *sfs_init(const struct sfs_flash_info_t *flash_binding)
         sfs_remove,
         sfs_create,
         sfs_set_extended,
+        sfs_get_info_multi,
         sfs_get_support
     };
 
-    static struct storage_backend backend;
+    context->backend.context = context;
+    context->backend.interface = &interface;
+
+    return &context->backend;
+}
+
+void secure_flash_store_deinit(struct secure_flash_store *context)
+{
+    sfs_flash_fs_deinit(&context->fs_ctx);
+
+    context->backend.context = NULL;
+    context->backend.interface = NULL;
+}
+
+struct storage_backend *sfs_init(const struct sfs_flash_info_t *flash_binding)
+{
+    static struct secure_flash_store default_instance;
 
-    backend.context = NULL;
-    backend.interface = &interface;
+    /* Re-initialising the default instance replaces the previous binding */
+    secure_flash_store_deinit(&default_instance);
 
-    return &backend;
+    return secure_flash_store_init(&default_instance, flash_binding);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -9,6 +9,7 @@
 #define __SECURE_FLASH_STORE_H__
 
 #include <service/secure_storage/backend/storage_backend.h>
+#include "flash_fs/sfs_flash_fs.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,7 +18,37 @@ extern "C" {
 struct sfs_flash_info_t;
 
 /**
- * \brief Initializes the secure flash store backend
+ * \brief Secure flash store instance
+ *
+ * Holds all state for one secure flash store so that independent instances,
+ * each bound to its own flash driver, can coexist.
+ */
+struct secure_flash_store
+{
+    struct storage_backend backend;
+    sfs_flash_fs_ctx_t fs_ctx;
+};
+
+/**
+ * \brief Initializes a secure flash store instance
+ *
+ * \param[in] context       The instance to initialize
+ * \param[in] flash_binding Binding to the flash driver
+ * \return Pointer to storage backend or NULL on failure
+ */
+struct storage_backend *secure_flash_store_init(
+                                    struct secure_flash_store *context,
+                                    const struct sfs_flash_info_t *flash_binding);
+
+/**
+ * \brief Deinitializes a secure flash store instance
+ *
+ * \param[in] context       The instance to deinitialize
+ */
+void secure_flash_store_deinit(struct secure_flash_store *context);
+
+/**
+ * \brief Initializes the default secure flash store backend
  *
  * \param[in] flash_binding Binding to the flash driver
  * \return Pointer to storage backend or NULL on failure
@@ -1,5 +1,5 @@
 #-------------------------------------------------------------------------------
-# Copyright (c) 2021-2022, Arm Limited and Contributors. All rights reserved.
+# Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -11,4 +11,5 @@ endif()
 target_sources(${TGT} PRIVATE
 	"${CMAKE_CURRENT_LIST_DIR}/sfs_ram_tests.cpp"
 	"${CMAKE_CURRENT_LIST_DIR}/sfs_block_store_tests.cpp"
+	"${CMAKE_CURRENT_LIST_DIR}/sfs_metadata_tests.cpp"
 	)
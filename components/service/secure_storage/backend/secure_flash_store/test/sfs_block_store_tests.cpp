@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <CppUTest/TestHarness.h>
+#include <cstdio>
 #include <service/secure_storage/frontend/psa/its/its_frontend.h>
 #include <service/secure_storage/frontend/psa/its/test/its_api_tests.h>
 #include <service/secure_storage/frontend/psa/ps/ps_frontend.h>
@@ -13,6 +14,8 @@
 #include <service/secure_storage/backend/secure_flash_store/flash/block_store_adapter/sfs_flash_block_store_adapter.h>
 #include <service/block_storage/factory/ref_ram/block_store_factory.h>
 #include <service/block_storage/config/ref/ref_partition_configurator.h>
+#include <service/block_storage/block_store/device/file/file_block_store.h>
+#include "sfs_metadata_tests.h"
 
 /**
  * Tests the secure flash store with a block_store flash driver.
@@ -41,7 +44,7 @@ TEST_GROUP(SfsBlockStoreTests)
 		LONGS_EQUAL(PSA_SUCCESS, status);
 		CHECK_TRUE(flash_info);
 
-		struct storage_backend *storage_backend = sfs_init(flash_info);
+		storage_backend = sfs_init(flash_info);
 		CHECK_TRUE(storage_backend);
 
 		psa_its_frontend_init(storage_backend);
@@ -62,6 +65,7 @@ TEST_GROUP(SfsBlockStoreTests)
 
 	struct block_store *block_store;
 	struct sfs_flash_block_store_adapter sfs_flash_adapter;
+	struct storage_backend *storage_backend;
 };
 
 TEST(SfsBlockStoreTests, itsStoreNewItem)
@@ -83,3 +87,135 @@ TEST(SfsBlockStoreTests, psCreateAndSetExtended)
 {
 	ps_api_tests::createAndSetExtended();
 }
+
+TEST(SfsBlockStoreTests, independentInstances)
+{
+	struct uuid_octets guid;
+	const struct sfs_flash_info_t *flash_info = NULL;
+	struct sfs_flash_block_store_adapter other_adapter;
+	struct secure_flash_store other_sfs;
+	static const uint64_t UID = 77;
+	static const size_t ITEM_SIZE = 3001;
+	uint8_t item[ITEM_SIZE];
+	uint8_t read_item[ITEM_SIZE];
+	size_t read_len = 0;
+	psa_status_t status;
+
+	/* A second instance on its own block store */
+	uuid_guid_octets_from_canonical(&guid, REF_PARTITION_2_GUID);
+
+	struct block_store *other_block_store = ref_ram_block_store_factory_create();
+	CHECK_TRUE(other_block_store);
+
+	status = sfs_flash_block_store_adapter_init(&other_adapter, CLIENT_ID, other_block_store,
+						    &guid, MIN_FLASH_BLOCK_SIZE, MAX_NUM_FILES,
+						    &flash_info);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	struct storage_backend *other_backend = secure_flash_store_init(&other_sfs, flash_info);
+	CHECK_TRUE(other_backend);
+
+	/* Store a multi-KB object with the same UID in each instance */
+	for (size_t i = 0; i < ITEM_SIZE; ++i)
+		item[i] = (uint8_t)i;
+
+	status = storage_backend->interface->set(storage_backend->context, CLIENT_ID, UID,
+						 ITEM_SIZE, item, PSA_STORAGE_FLAG_NONE);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = other_backend->interface->set(other_backend->context, CLIENT_ID, UID,
+					       ITEM_SIZE - 1, &item[1], PSA_STORAGE_FLAG_NONE);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	/* Each instance reads back its own object, including from an offset */
+	status = storage_backend->interface->get(storage_backend->context, CLIENT_ID, UID, 0,
+						 sizeof(read_item), read_item, &read_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(ITEM_SIZE, read_len);
+	MEMCMP_EQUAL(item, read_item, ITEM_SIZE);
+
+	status = other_backend->interface->get(other_backend->context, CLIENT_ID, UID, 1000,
+					       sizeof(read_item), read_item, &read_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(ITEM_SIZE - 1 - 1000, read_len);
+	MEMCMP_EQUAL(&item[1001], read_item, read_len);
+
+	/* Removing from one instance leaves the other untouched */
+	status = other_backend->interface->remove(other_backend->context, CLIENT_ID, UID);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	status = storage_backend->interface->get(storage_backend->context, CLIENT_ID, UID, 0,
+						 sizeof(read_item), read_item, &read_len);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(ITEM_SIZE, read_len);
+
+	status = storage_backend->interface->remove(storage_backend->context, CLIENT_ID, UID);
+	LONGS_EQUAL(PSA_SUCCESS, status);
+
+	secure_flash_store_deinit(&other_sfs);
+	sfs_flash_block_store_adapter_deinit(&other_adapter);
+	ref_ram_block_store_factory_destroy(other_block_store);
+}
+
+/**
+ * Tests the secure flash store with a file backed block_store, where every
+ * flash access is a host file operation.
+ */
+TEST_GROUP(SfsFileBlockStoreTests)
+{
+	void setup()
+	{
+		struct uuid_octets guid;
+		const struct sfs_flash_info_t *flash_info = NULL;
+
+		uuid_guid_octets_from_canonical(&guid, REF_PARTITION_2_GUID);
+
+		block_store = file_block_store_init(&file_block_store, FILENAME, BLOCK_SIZE);
+		CHECK_TRUE(block_store);
+
+		psa_status_t status = file_block_store_configure(&file_block_store, &guid,
+								 NUM_BLOCKS, BLOCK_SIZE);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+
+		status = sfs_flash_block_store_adapter_init(
+			&sfs_flash_adapter,
+			CLIENT_ID,
+			block_store,
+			&guid,
+			MIN_FLASH_BLOCK_SIZE,
+			MAX_NUM_FILES,
+			&flash_info);
+
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		CHECK_TRUE(flash_info);
+
+		storage_backend = sfs_init(flash_info);
+		CHECK_TRUE(storage_backend);
+	}
+
+	void teardown()
+	{
+		sfs_flash_block_store_adapter_deinit(&sfs_flash_adapter);
+		file_block_store_deinit(&file_block_store);
+		remove(FILENAME);
+
+		block_store = NULL;
+	}
+
+	static constexpr const char *FILENAME = "sfs_file_block_store.tmp";
+	static const uint32_t CLIENT_ID = 10;
+	static const size_t MAX_NUM_FILES = 10;
+	static const size_t MIN_FLASH_BLOCK_SIZE = 4096;
+	static const size_t BLOCK_SIZE = 512;
+	static const size_t NUM_BLOCKS = 64;
+
+	struct file_block_store file_block_store;
+	struct block_store *block_store;
+	struct sfs_flash_block_store_adapter sfs_flash_adapter;
+	struct storage_backend *storage_backend;
+};
+
+TEST(SfsFileBlockStoreTests, metadataFullFileTable)
+{
+	sfs_metadata_tests::fullFileTable(storage_backend, MAX_NUM_FILES);
+}
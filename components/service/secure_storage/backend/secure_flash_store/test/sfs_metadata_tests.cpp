@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <cstring>
+#include <CppUTest/TestHarness.h>
+#include "sfs_metadata_tests.h"
+
+void sfs_metadata_tests::fullFileTable(struct storage_backend *backend, size_t num_files)
+{
+	static const uint32_t CLIENT_ID = 0x1234;
+	static const uint64_t BASE_UID = 0x100;
+	static const size_t ITEM_SIZE = 32;
+	uint8_t item[ITEM_SIZE];
+	uint8_t read_item[ITEM_SIZE];
+	struct psa_storage_info_t info;
+	size_t read_len;
+	psa_status_t status;
+
+	CHECK_TRUE(backend);
+
+	/* Fill the file table so that lookups have to cover every slot */
+	for (size_t i = 0; i < num_files; ++i) {
+		memset(item, (int)i, sizeof(item));
+		status = backend->interface->set(backend->context, CLIENT_ID, BASE_UID + i,
+						 sizeof(item), item, PSA_STORAGE_FLAG_NONE);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+	}
+
+	for (size_t i = 0; i < num_files; ++i) {
+		status = backend->interface->get_info(backend->context, CLIENT_ID,
+						      BASE_UID + i, &info);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		UNSIGNED_LONGS_EQUAL(ITEM_SIZE, info.size);
+
+		status = backend->interface->get(backend->context, CLIENT_ID,
+						 BASE_UID + i, 0, sizeof(read_item),
+						 read_item, &read_len);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		UNSIGNED_LONGS_EQUAL(ITEM_SIZE, read_len);
+		BYTES_EQUAL(i, read_item[0]);
+	}
+
+	/* Lookups that miss have to prove that no slot matches */
+	status = backend->interface->get_info(backend->context, CLIENT_ID,
+					      BASE_UID + num_files, &info);
+	LONGS_EQUAL(PSA_ERROR_DOES_NOT_EXIST, status);
+
+	/* Each overwrite goes through a metadata block swap */
+	for (size_t i = 0; i < num_files; ++i) {
+		memset(item, (int)(i + 1), sizeof(item));
+		status = backend->interface->set(backend->context, CLIENT_ID, BASE_UID + i,
+						 sizeof(item), item, PSA_STORAGE_FLAG_NONE);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+	}
+
+	for (size_t i = 0; i < num_files; ++i) {
+		status = backend->interface->get(backend->context, CLIENT_ID, BASE_UID + i, 0,
+						 sizeof(read_item), read_item, &read_len);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+		BYTES_EQUAL(i + 1, read_item[0]);
+
+		status = backend->interface->remove(backend->context, CLIENT_ID, BASE_UID + i);
+		LONGS_EQUAL(PSA_SUCCESS, status);
+	}
+
+	/* Expect the removed files to no longer be found */
+	for (size_t i = 0; i < num_files; ++i) {
+		status = backend->interface->get_info(backend->context, CLIENT_ID,
+						      BASE_UID + i, &info);
+		LONGS_EQUAL(PSA_ERROR_DOES_NOT_EXIST, status);
+	}
+}
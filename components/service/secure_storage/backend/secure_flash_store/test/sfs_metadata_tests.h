@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SFS_METADATA_TESTS_H
+#define SFS_METADATA_TESTS_H
+
+#include <cstddef>
+#include <service/secure_storage/backend/storage_backend.h>
+
+/*
+ * Metadata scenarios for the secure flash store that may be run against
+ * any flash binding.
+ */
+class sfs_metadata_tests
+{
+public:
+
+	static void fullFileTable(struct storage_backend *backend, size_t num_files);
+};
+
+#endif /* SFS_METADATA_TESTS_H */
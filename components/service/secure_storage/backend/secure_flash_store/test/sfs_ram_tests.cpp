@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,6 +11,7 @@
 #include <service/secure_storage/frontend/psa/ps/test/ps_api_tests.h>
 #include <service/secure_storage/backend/secure_flash_store/secure_flash_store.h>
 #include <service/secure_storage/backend/secure_flash_store/flash/ram/sfs_flash_ram.h>
+#include "sfs_metadata_tests.h"
 
 /**
  * Tests the secure flash store with a ram flash driver.
@@ -19,11 +20,13 @@ TEST_GROUP(SfsRamTests)
 {
     void setup()
     {
-        struct storage_backend *storage_backend = sfs_init(sfs_flash_ram_instance());
+        storage_backend = sfs_init(sfs_flash_ram_instance());
 
         psa_its_frontend_init(storage_backend);
         psa_ps_frontend_init(storage_backend);
     }
+
+    struct storage_backend *storage_backend;
 };
 
 TEST(SfsRamTests, itsStoreNewItem)
@@ -45,3 +48,8 @@ TEST(SfsRamTests, psCreateAndSetExtended)
 {
     ps_api_tests::createAndSetExtended();
 }
+
+TEST(SfsRamTests, metadataFullFileTable)
+{
+    sfs_metadata_tests::fullFileTable(storage_backend, 10);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -315,6 +315,120 @@ out:
 	return psa_status;
 }
 
+static psa_status_t get_info_multi_call(struct secure_storage_client *this_context,
+				       size_t num_uids,
+				       const uint64_t *uids,
+				       struct psa_storage_info_t *p_info,
+				       psa_status_t *p_status)
+{
+	uint8_t *request = NULL;
+	uint8_t *response = NULL;
+	size_t request_length = 0;
+	size_t response_length = 0;
+	size_t expected_response_length = 0;
+	struct secure_storage_request_get_info_multi *request_desc = NULL;
+	struct secure_storage_response_get_info_multi *response_desc = NULL;
+	rpc_call_handle handle = 0;
+	rpc_status_t rpc_status = RPC_ERROR_INTERNAL;
+	service_status_t service_status = 0;
+	psa_status_t psa_status = PSA_ERROR_GENERIC_ERROR;
+
+	request_length = sizeof(*request_desc) + num_uids * sizeof(request_desc->uids[0]);
+	expected_response_length = num_uids * sizeof(*response_desc);
+
+	handle = rpc_caller_session_begin(this_context->client.session, &request,
+					  request_length, expected_response_length);
+	if (!handle)
+		goto out;
+
+	/* Populating request descriptor */
+	request_desc = (struct secure_storage_request_get_info_multi *)request;
+	request_desc->num_uids = num_uids;
+	memcpy(request_desc->uids, uids, num_uids * sizeof(request_desc->uids[0]));
+
+	rpc_status = rpc_caller_session_invoke(handle, TS_SECURE_STORAGE_OPCODE_GET_INFO_MULTI,
+					       &response, &response_length, &service_status);
+	if (rpc_status == RPC_ERROR_INVALID_VALUE) {
+		/* The provider doesn't implement the operation */
+		psa_status = PSA_ERROR_NOT_SUPPORTED;
+		goto session_end;
+	}
+
+	if (rpc_status != RPC_SUCCESS ||
+	   (service_status == PSA_SUCCESS && response_length != expected_response_length))
+		goto session_end;
+
+	psa_status = service_status;
+
+	if (psa_status != PSA_SUCCESS)
+		goto session_end;
+
+	response_desc = (struct secure_storage_response_get_info_multi *)response;
+
+	for (size_t i = 0; i < num_uids; i++) {
+		p_status[i] = response_desc[i].status;
+		p_info[i].capacity = response_desc[i].capacity;
+		p_info[i].size = response_desc[i].size;
+		p_info[i].flags = response_desc[i].flags;
+	}
+
+session_end:
+	rpc_status = rpc_caller_session_end(handle);
+	if (psa_status == PSA_SUCCESS && rpc_status != RPC_SUCCESS)
+		psa_status = PSA_ERROR_GENERIC_ERROR;
+
+out:
+	return psa_status;
+}
+
+static psa_status_t secure_storage_client_get_info_multi(void *context,
+							 uint32_t client_id,
+							 size_t num_uids,
+							 const uint64_t *uids,
+							 struct psa_storage_info_t *p_info,
+							 psa_status_t *p_status)
+{
+	struct secure_storage_client *this_context = (struct secure_storage_client*)context;
+	size_t max_payload = this_context->client.service_info.max_payload;
+	size_t max_uids = num_uids;
+	psa_status_t psa_status = PSA_SUCCESS;
+	size_t i = 0;
+
+	/* Validating input parameters */
+	if ((uids == NULL || p_info == NULL || p_status == NULL) && num_uids != 0)
+		return PSA_ERROR_INVALID_ARGUMENT;
+
+	/* Split the list into calls that fit the maximum payload */
+	if (max_payload) {
+		max_uids = MIN(max_payload / sizeof(struct secure_storage_response_get_info_multi),
+			       max_payload / sizeof(uint64_t) - 1);
+	}
+
+	while (i < num_uids) {
+		size_t chunk_size = MIN(num_uids - i, max_uids);
+
+		psa_status = (chunk_size) ?
+			get_info_multi_call(this_context, chunk_size, &uids[i], &p_info[i],
+					    &p_status[i]) :
+			PSA_ERROR_NOT_SUPPORTED;
+
+		if (psa_status != PSA_SUCCESS)
+			break;
+
+		i += chunk_size;
+	}
+
+	if (psa_status != PSA_ERROR_NOT_SUPPORTED)
+		return psa_status;
+
+	/* Fall back to looking up the remaining uids one at a time */
+	for (; i < num_uids; i++)
+		p_status[i] = secure_storage_client_get_info(context, client_id, uids[i],
+							     &p_info[i]);
+
+	return PSA_SUCCESS;
+}
+
 static uint32_t secure_storage_get_support(void *context, uint32_t client_id)
 {
 	struct secure_storage_client *this_context = (struct secure_storage_client*)context;
@@ -368,6 +482,7 @@ struct storage_backend *secure_storage_client_init(struct secure_storage_client
 		secure_storage_client_remove,
 		secure_storage_client_create,
 		secure_storage_set_extended,
+		secure_storage_client_get_info_multi,
 		secure_storage_get_support
 	};
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -14,6 +14,7 @@
 #include <service/secure_storage/frontend/secure_storage_provider/secure_storage_provider.h>
 #include <service/secure_storage/backend/secure_storage_client/secure_storage_client.h>
 #include <service/secure_storage/backend/mock_store/mock_store.h>
+#include <protocols/service/secure_storage/packed-c/secure_storage_proto.h>
 
 
 TEST_GROUP(SecureStorageClientTests)
@@ -81,3 +82,93 @@ TEST(SecureStorageClientTests, psCreateAndSetExtended)
 {
     ps_api_tests::createAndSetExtended();
 }
+
+TEST(SecureStorageClientTests, getInfoMulti)
+{
+    struct storage_backend *backend = &m_storage_client.backend;
+    const uint64_t uids[] = { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 };
+    const size_t num_uids = sizeof(uids) / sizeof(uids[0]);
+    struct psa_storage_info_t info[num_uids];
+    psa_status_t status[num_uids];
+    uint8_t data[num_uids] = { 0 };
+
+    /* Store objects for every other uid with the size of each depending on the uid */
+    for (size_t i = 0; i < num_uids; i += 2) {
+        LONGS_EQUAL(PSA_SUCCESS, backend->interface->set(backend->context, 0, uids[i],
+                                                         i + 1, data, PSA_STORAGE_FLAG_NONE));
+    }
+
+    /* Expect all uids to be looked up with a single call to the backend */
+    mock_store_clear_call_counts(&m_mock_store);
+
+    LONGS_EQUAL(PSA_SUCCESS, backend->interface->get_info_multi(backend->context, 0,
+                                                                num_uids, uids, info, status));
+
+    for (size_t i = 0; i < num_uids; ++i) {
+        LONGS_EQUAL((i % 2) ? PSA_ERROR_DOES_NOT_EXIST : PSA_SUCCESS, status[i]);
+        UNSIGNED_LONGS_EQUAL((i % 2) ? 0 : i + 1, info[i].size);
+    }
+
+    UNSIGNED_LONGS_EQUAL(1, m_mock_store.call_counts.get_info_multi);
+    UNSIGNED_LONGS_EQUAL(0, m_mock_store.call_counts.get_info);
+
+    /* Expect the lookup to be split into calls that fit the maximum payload */
+    mock_store_clear_call_counts(&m_mock_store);
+    m_storage_client.client.service_info.max_payload =
+        4 * sizeof(struct secure_storage_response_get_info_multi);
+
+    LONGS_EQUAL(PSA_SUCCESS, backend->interface->get_info_multi(backend->context, 0,
+                                                                num_uids, uids, info, status));
+
+    UNSIGNED_LONGS_EQUAL(3, m_mock_store.call_counts.get_info_multi);
+    LONGS_EQUAL(PSA_ERROR_DOES_NOT_EXIST, status[num_uids - 1]);
+    UNSIGNED_LONGS_EQUAL(num_uids - 1, info[num_uids - 2].size);
+
+    /* Expect a fallback to individual lookups if not even one uid fits */
+    mock_store_clear_call_counts(&m_mock_store);
+    m_storage_client.client.service_info.max_payload = 16;
+
+    LONGS_EQUAL(PSA_SUCCESS, backend->interface->get_info_multi(backend->context, 0,
+                                                                num_uids, uids, info, status));
+
+    UNSIGNED_LONGS_EQUAL(0, m_mock_store.call_counts.get_info_multi);
+    UNSIGNED_LONGS_EQUAL(num_uids, m_mock_store.call_counts.get_info);
+    LONGS_EQUAL(PSA_SUCCESS, status[0]);
+    LONGS_EQUAL(PSA_ERROR_DOES_NOT_EXIST, status[1]);
+}
+
+TEST(SecureStorageClientTests, getInfoMultiManyUids)
+{
+    struct storage_backend *backend = &m_storage_client.backend;
+    static const size_t num_uids = 40;
+    uint64_t uids[num_uids];
+    struct psa_storage_info_t info[num_uids];
+    psa_status_t status[num_uids];
+    uint8_t data[num_uids] = { 0 };
+
+    /* Store objects for every other uid with the size of each depending on the uid */
+    for (size_t i = 0; i < num_uids; ++i) {
+        uids[i] = 100 + i;
+
+        if (!(i % 2))
+            LONGS_EQUAL(PSA_SUCCESS, backend->interface->set(backend->context, 0, uids[i],
+                                                             i + 1, data, PSA_STORAGE_FLAG_NONE));
+    }
+
+    /*
+     * Expect a single call to the service, which looks up the uids in several
+     * chunks, to give the right result for every uid.
+     */
+    mock_store_clear_call_counts(&m_mock_store);
+
+    LONGS_EQUAL(PSA_SUCCESS, backend->interface->get_info_multi(backend->context, 0,
+                                                                num_uids, uids, info, status));
+
+    for (size_t i = 0; i < num_uids; ++i) {
+        LONGS_EQUAL((i % 2) ? PSA_ERROR_DOES_NOT_EXIST : PSA_SUCCESS, status[i]);
+        UNSIGNED_LONGS_EQUAL((i % 2) ? 0 : i + 1, info[i].size);
+    }
+
+    UNSIGNED_LONGS_EQUAL(3, m_mock_store.call_counts.get_info_multi);
+    UNSIGNED_LONGS_EQUAL(0, m_mock_store.call_counts.get_info);
+}
@@ -149,6 +149,25 @@ static psa_status_t secure_storage_set_extended(void *context,
 	return PSA_ERROR_NOT_SUPPORTED;
 }
 
+static psa_status_t secure_storage_ipc_get_info_multi(void *context,
+						      uint32_t client_id,
+						      size_t num_uids,
+						      const uint64_t *uids,
+						      struct psa_storage_info_t *p_info,
+						      psa_status_t *p_status)
+{
+	/* The PSA storage API has no bulk operation so look up one uid at a time */
+	for (size_t i = 0; i < num_uids; i++) {
+
+		p_status[i] = secure_storage_ipc_get_info(context, client_id, uids[i], &p_info[i]);
+
+		if (p_status[i] != PSA_SUCCESS)
+			memset(&p_info[i], 0, sizeof(p_info[i]));
+	}
+
+	return PSA_SUCCESS;
+}
+
 static uint32_t secure_storage_get_support(void *context, uint32_t client_id)
 {
 	struct secure_storage_ipc *ipc = context;
@@ -181,6 +200,7 @@ struct storage_backend *secure_storage_ipc_init(struct secure_storage_ipc *conte
 		.remove = secure_storage_ipc_remove,
 		.create = secure_storage_ipc_create,
 		.set_extended = secure_storage_set_extended,
+		.get_info_multi = secure_storage_ipc_get_info_multi,
 		.get_support = secure_storage_get_support,
 	};
 
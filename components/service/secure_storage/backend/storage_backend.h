@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -243,6 +243,39 @@ struct storage_backend_interface
                             size_t data_length,
                             const void *p_data);
 
+    /**
+     * \brief Retrieve the metadata about a list of uids
+     *
+     * Equivalent to calling get_info for each uid in `uids` but allows a
+     * backend to serve the whole list with a single operation. The status of
+     * the lookup of each uid is written to the corresponding `p_status` entry.
+     * On failure of the lookup, the `p_info` entry is zeroed.
+     *
+     * \param[in]  context    The concrete backend context
+     * \param[in]  client_id  Identifier of the asset's owner (client)
+     * \param[in]  num_uids   The number of entries in `uids`
+     * \param[in]  uids       The `uid` values
+     * \param[out] p_info     Array of `num_uids` `psa_storage_info_t` structs
+     *                        that will be populated with the metadata
+     * \param[out] p_status   Array of `num_uids` lookup statuses
+     *
+     * \return A status indicating the success/failure of the operation as a
+     *         whole. When not PSA_SUCCESS, the contents of `p_info` and
+     *         `p_status` are undefined.
+     *
+     * \retval PSA_SUCCESS                 The operation completed successfully
+     * \retval PSA_ERROR_STORAGE_FAILURE   The operation failed because the physical
+     *                                     storage has failed (Fatal error)
+     * \retval PSA_ERROR_INVALID_ARGUMENT  The operation failed because one of the
+     *                                     provided pointers is invalid
+     */
+    psa_status_t (*get_info_multi)(void *context,
+                                uint32_t client_id,
+                                size_t num_uids,
+                                const uint64_t *uids,
+                                struct psa_storage_info_t *p_info,
+                                psa_status_t *p_status);
+
     /**
      * \brief Get supported features
      *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,6 +8,11 @@
 #include "components/common/utils/include/util.h"
 #include "components/rpc/common/endpoint/rpc_service_interface.h"
 #include "protocols/service/secure_storage/packed-c/secure_storage_proto.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Number of uids passed to the backend per get_info_multi call */
+#define GET_INFO_MULTI_CHUNK_SIZE	(16)
 
 static rpc_status_t set_handler(void *context, struct rpc_request *req)
 {
@@ -153,6 +158,82 @@ static rpc_status_t set_extended_handler(void *context, struct rpc_request *req)
 	return RPC_SUCCESS;
 }
 
+static rpc_status_t get_info_multi_handler(void *context, struct rpc_request *req)
+{
+	struct secure_storage_provider *this_context = (struct secure_storage_provider*)context;
+	struct secure_storage_request_get_info_multi *request_desc = NULL;
+	struct secure_storage_response_get_info_multi *response_desc = NULL;
+	uint64_t *uids = NULL;
+	struct psa_storage_info_t storage_info[GET_INFO_MULTI_CHUNK_SIZE];
+	psa_status_t status[GET_INFO_MULTI_CHUNK_SIZE];
+	size_t request_length = 0;
+	size_t response_length = 0;
+	size_t num_uids = 0;
+
+	/* Checking if the descriptor fits into the request buffer */
+	if (req->request.data_length < sizeof(*request_desc))
+		return RPC_ERROR_INVALID_REQUEST_BODY;
+
+	request_desc = (struct secure_storage_request_get_info_multi *)(req->request.data);
+	num_uids = request_desc->num_uids;
+
+	/* Checking for overflow */
+	if (MUL_OVERFLOW(num_uids, sizeof(request_desc->uids[0]), &request_length) ||
+	    ADD_OVERFLOW(sizeof(*request_desc), request_length, &request_length))
+		return RPC_ERROR_INVALID_REQUEST_BODY;
+
+	/* Checking if the request descriptor and the uids fit into the request buffer */
+	if (req->request.data_length < request_length)
+		return RPC_ERROR_INVALID_REQUEST_BODY;
+
+	/* Checking if the response entries would fit the response buffer */
+	if (MUL_OVERFLOW(num_uids, sizeof(*response_desc), &response_length) ||
+	    req->response.size < response_length)
+		return RPC_ERROR_INVALID_RESPONSE_BODY;
+
+	/*
+	 * The response may be written to the same buffer as the request so all
+	 * uids are copied out before the first response entry is written. This
+	 * also aligns the packed uids for the backend.
+	 */
+	uids = malloc(num_uids * sizeof(uids[0]));
+	if (!uids && num_uids) {
+		req->service_status = PSA_ERROR_INSUFFICIENT_MEMORY;
+		return RPC_SUCCESS;
+	}
+
+	memcpy(uids, request_desc->uids, num_uids * sizeof(uids[0]));
+
+	response_desc = (struct secure_storage_response_get_info_multi *)(req->response.data);
+	req->service_status = PSA_SUCCESS;
+
+	for (size_t i = 0; i < num_uids; i += GET_INFO_MULTI_CHUNK_SIZE) {
+
+		size_t chunk_size = MIN(num_uids - i, (size_t)GET_INFO_MULTI_CHUNK_SIZE);
+
+		req->service_status = this_context->backend->interface->get_info_multi(
+			this_context->backend->context, req->source_id, chunk_size, &uids[i],
+			storage_info, status);
+
+		if (req->service_status != PSA_SUCCESS) {
+			free(uids);
+			return RPC_SUCCESS;
+		}
+
+		for (size_t j = 0; j < chunk_size; j++) {
+			response_desc[i + j].status = status[j];
+			response_desc[i + j].capacity = storage_info[j].capacity;
+			response_desc[i + j].size = storage_info[j].size;
+			response_desc[i + j].flags = storage_info[j].flags;
+		}
+	}
+
+	free(uids);
+	req->response.data_length = response_length;
+
+	return RPC_SUCCESS;
+}
+
 static rpc_status_t get_support_handler(void *context, struct rpc_request *req)
 {
 	struct secure_storage_provider *this_context = (struct secure_storage_provider*)context;
@@ -183,7 +264,8 @@ static const struct service_handler handler_table[] = {
 	{TS_SECURE_STORAGE_OPCODE_REMOVE,	remove_handler},
 	{TS_SECURE_STORAGE_OPCODE_CREATE,	create_handler},
 	{TS_SECURE_STORAGE_OPCODE_SET_EXTENDED,	set_extended_handler},
-	{TS_SECURE_STORAGE_OPCODE_GET_SUPPORT,	get_support_handler}
+	{TS_SECURE_STORAGE_OPCODE_GET_SUPPORT,	get_support_handler},
+	{TS_SECURE_STORAGE_OPCODE_GET_INFO_MULTI,	get_info_multi_handler}
 };
 
 struct rpc_service_interface *secure_storage_provider_init(struct secure_storage_provider *context,
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -341,6 +341,101 @@ TEST(UefiVariableIndexTests, dumpBufferTooSmall)
 }
 
 
+TEST(UefiVariableIndexTests, dumpDirtyReplay)
+{
+	uint8_t dump_buffer[MAX_VARIABLES * sizeof(struct variable_metadata)];
+	uint8_t journal_buffer[MAX_VARIABLES * sizeof(struct variable_index_record)];
+	struct variable_info *info = NULL;
+
+	create_variables();
+
+	/* Take a full dump to act as the base and to clear all dirty flags */
+	size_t dump_len = 0;
+	variable_index_dump(&m_variable_index, sizeof(dump_buffer), dump_buffer, &dump_len);
+
+	size_t journal_len = 0;
+	CHECK_FALSE(variable_index_dump_dirty(&m_variable_index,
+		sizeof(journal_buffer), journal_buffer, &journal_len));
+	UNSIGNED_LONGS_EQUAL(0, journal_len);
+
+	/* Remove one NV variable and add another */
+	info = variable_index_find(
+		&m_variable_index,
+		&guid_2,
+		name_2.size() * sizeof(int16_t),
+		name_2.data());
+	CHECK_TRUE(info);
+	variable_index_clear_variable(&m_variable_index, info);
+
+	info = variable_index_add_entry(
+		&m_variable_index,
+		&guid_2,
+		name_1.size() * sizeof(int16_t),
+		name_1.data());
+	CHECK_TRUE(info);
+	variable_index_set_variable(info, EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS);
+	uint64_t added_uid = info->metadata.uid;
+
+	/* Expect nothing to be dumped and dirty state to be retained if the
+	 * buffer is too small to hold all records.
+	 */
+	CHECK_TRUE(variable_index_dump_dirty(&m_variable_index,
+		sizeof(struct variable_index_record), journal_buffer, &journal_len));
+	UNSIGNED_LONGS_EQUAL(0, journal_len);
+
+	/* Expect only records for the two changed entries */
+	CHECK_TRUE(variable_index_dump_dirty(&m_variable_index,
+		sizeof(journal_buffer), journal_buffer, &journal_len));
+	UNSIGNED_LONGS_EQUAL(sizeof(struct variable_index_record) * 2, journal_len);
+
+	CHECK_FALSE(variable_index_dump_dirty(&m_variable_index,
+		sizeof(journal_buffer), journal_buffer + journal_len, &dump_len));
+
+	/* Reboot, restore the base and replay the journal */
+	variable_index_deinit(&m_variable_index);
+	efi_status_t status = variable_index_init(&m_variable_index, MAX_VARIABLES);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	variable_index_dump(&m_variable_index, 0, NULL, &dump_len);
+	UNSIGNED_LONGS_EQUAL(0, dump_len);
+
+	size_t base_len = sizeof(struct variable_metadata) * 2;
+	UNSIGNED_LONGS_EQUAL(base_len, variable_index_restore(&m_variable_index, base_len, dump_buffer));
+	UNSIGNED_LONGS_EQUAL(journal_len,
+		variable_index_replay(&m_variable_index, journal_len, journal_buffer));
+
+	POINTERS_EQUAL(NULL, variable_index_find(
+		&m_variable_index,
+		&guid_2,
+		name_2.size() * sizeof(int16_t),
+		name_2.data()));
+
+	info = variable_index_find(
+		&m_variable_index,
+		&guid_2,
+		name_1.size() * sizeof(int16_t),
+		name_1.data());
+	CHECK_TRUE(info);
+	CHECK_TRUE(info->is_variable_set);
+	UNSIGNED_LONGLONGS_EQUAL(added_uid, info->metadata.uid);
+
+	info = variable_index_find(
+		&m_variable_index,
+		&guid_1,
+		name_3.size() * sizeof(int16_t),
+		name_3.data());
+	CHECK_TRUE(info);
+	CHECK_TRUE(info->is_variable_set);
+
+	/* Expect replaying the journal a second time to have no effect */
+	UNSIGNED_LONGS_EQUAL(journal_len,
+		variable_index_replay(&m_variable_index, journal_len, journal_buffer));
+
+	dump_len = 0;
+	variable_index_dump(&m_variable_index, sizeof(dump_buffer), dump_buffer, &dump_len);
+	UNSIGNED_LONGS_EQUAL(sizeof(struct variable_metadata) * 2, dump_len);
+}
+
 TEST(UefiVariableIndexTests, removeVariable)
 {
 	uint8_t buffer[MAX_VARIABLES * sizeof(struct variable_metadata)];
@@ -655,3 +750,274 @@ TEST(UefiVariableIndexTests, setCheckConstraintsNonExistingVar)
 	UNSIGNED_LONGS_EQUAL(constraints.min_size, info->check_constraints.min_size);
 	UNSIGNED_LONGS_EQUAL(constraints.max_size, info->check_constraints.max_size);
 }
+
+TEST(UefiVariableIndexTests, uidCollision)
+{
+	/* The names "Ba" and "C@" produce the same djb2 hash. Expect both
+	 * variables to be indexed independently with different uids.
+	 */
+	std::vector<int16_t> name_a = to_variable_name(L"Ba");
+	std::vector<int16_t> name_b = to_variable_name(L"C@");
+
+	struct variable_info *info_a = variable_index_add_entry(
+		&m_variable_index,
+		&guid_1,
+		name_a.size() * sizeof(int16_t),
+		name_a.data());
+	CHECK_TRUE(info_a);
+	variable_index_set_variable(info_a, EFI_VARIABLE_NON_VOLATILE);
+
+	struct variable_info *info_b = variable_index_add_entry(
+		&m_variable_index,
+		&guid_1,
+		name_b.size() * sizeof(int16_t),
+		name_b.data());
+	CHECK_TRUE(info_b);
+	variable_index_set_variable(info_b, EFI_VARIABLE_NON_VOLATILE);
+
+	CHECK_TRUE(info_a != info_b);
+	CHECK_TRUE(info_a->metadata.uid != info_b->metadata.uid);
+
+	POINTERS_EQUAL(info_a, variable_index_find(
+		&m_variable_index,
+		&guid_1,
+		name_a.size() * sizeof(int16_t),
+		name_a.data()));
+
+	POINTERS_EQUAL(info_b, variable_index_find(
+		&m_variable_index,
+		&guid_1,
+		name_b.size() * sizeof(int16_t),
+		name_b.data()));
+
+	/* Expect uids to be preserved over a dump and restore */
+	uint64_t uid_a = info_a->metadata.uid;
+	uint64_t uid_b = info_b->metadata.uid;
+	uint8_t buffer[MAX_VARIABLES * sizeof(struct variable_metadata)];
+	size_t dump_len = 0;
+
+	variable_index_dump(&m_variable_index, sizeof(buffer), buffer, &dump_len);
+	UNSIGNED_LONGS_EQUAL((sizeof(struct variable_metadata) * 2), dump_len);
+
+	variable_index_deinit(&m_variable_index);
+	efi_status_t status = variable_index_init(&m_variable_index, MAX_VARIABLES);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	UNSIGNED_LONGS_EQUAL(dump_len, variable_index_restore(&m_variable_index, dump_len, buffer));
+
+	info_a = variable_index_find(
+		&m_variable_index,
+		&guid_1,
+		name_a.size() * sizeof(int16_t),
+		name_a.data());
+	CHECK_TRUE(info_a);
+	UNSIGNED_LONGLONGS_EQUAL(uid_a, info_a->metadata.uid);
+
+	info_b = variable_index_find(
+		&m_variable_index,
+		&guid_1,
+		name_b.size() * sizeof(int16_t),
+		name_b.data());
+	CHECK_TRUE(info_b);
+	UNSIGNED_LONGLONGS_EQUAL(uid_b, info_b->metadata.uid);
+
+	/* Removing one of the pair must not affect lookup of the other */
+	variable_index_clear_variable(&m_variable_index, info_a);
+	variable_index_remove_unused_entry(&m_variable_index, info_a);
+
+	POINTERS_EQUAL(NULL, variable_index_find(
+		&m_variable_index,
+		&guid_1,
+		name_a.size() * sizeof(int16_t),
+		name_a.data()));
+
+	POINTERS_EQUAL(info_b, variable_index_find(
+		&m_variable_index,
+		&guid_1,
+		name_b.size() * sizeof(int16_t),
+		name_b.data()));
+}
+
+TEST(UefiVariableIndexTests, reservedUids)
+{
+	/* "Ba" and "C@" have the same hash so the second is given a probed uid */
+	std::vector<int16_t> name_a = to_variable_name(L"Ba");
+	std::vector<int16_t> name_b = to_variable_name(L"C@");
+
+	struct variable_info *info_a = variable_index_add_entry(
+		&m_variable_index,
+		&guid_1,
+		name_a.size() * sizeof(int16_t),
+		name_a.data());
+	CHECK_TRUE(info_a);
+
+	uint64_t hashed_uid = info_a->metadata.uid;
+
+	/* Expect the probe to skip the reserved uids that follow the hashed uid */
+	variable_index_deinit(&m_variable_index);
+	efi_status_t status = variable_index_init(&m_variable_index, MAX_VARIABLES);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = variable_index_reserve_uid(&m_variable_index, hashed_uid + 1);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	status = variable_index_reserve_uid(&m_variable_index, hashed_uid + 2);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	info_a = variable_index_add_entry(
+		&m_variable_index,
+		&guid_1,
+		name_a.size() * sizeof(int16_t),
+		name_a.data());
+	CHECK_TRUE(info_a);
+	UNSIGNED_LONGLONGS_EQUAL(hashed_uid, info_a->metadata.uid);
+
+	struct variable_info *info_b = variable_index_add_entry(
+		&m_variable_index,
+		&guid_1,
+		name_b.size() * sizeof(int16_t),
+		name_b.data());
+	CHECK_TRUE(info_b);
+	UNSIGNED_LONGLONGS_EQUAL(hashed_uid + 3, info_b->metadata.uid);
+
+	/* Expect a reserved hashed uid to be skipped too */
+	variable_index_deinit(&m_variable_index);
+	status = variable_index_init(&m_variable_index, MAX_VARIABLES);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = variable_index_reserve_uid(&m_variable_index, hashed_uid);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	info_a = variable_index_add_entry(
+		&m_variable_index,
+		&guid_1,
+		name_a.size() * sizeof(int16_t),
+		name_a.data());
+	CHECK_TRUE(info_a);
+	UNSIGNED_LONGLONGS_EQUAL(hashed_uid + 1, info_a->metadata.uid);
+
+	/* Expect the number of reserved uids to be limited */
+	for (size_t i = 1; i < VARIABLE_INDEX_MAX_RESERVED_UIDS; ++i) {
+
+		status = variable_index_reserve_uid(&m_variable_index, i);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	}
+
+	status = variable_index_reserve_uid(&m_variable_index, 100);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_OUT_OF_RESOURCES, status);
+}
+
+TEST(UefiVariableIndexTests, lookupManyVariables)
+{
+	static const size_t index_sizes[] = {64, 512, 4096};
+
+	for (size_t size_idx = 0; size_idx < sizeof(index_sizes) / sizeof(size_t); ++size_idx) {
+
+		size_t num_vars = index_sizes[size_idx];
+		struct variable_index index;
+		std::vector<std::vector<int16_t>> names;
+
+		efi_status_t status = variable_index_init(&index, num_vars);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+		for (size_t i = 0; i < num_vars; ++i)
+			names.push_back(to_variable_name(L"lookup_var_" + std::to_wstring(i)));
+
+		for (size_t i = 0; i < num_vars; ++i) {
+
+			struct variable_info *info = variable_index_add_entry(
+				&index,
+				&guid_1,
+				names[i].size() * sizeof(int16_t),
+				names[i].data());
+			CHECK_TRUE(info);
+
+			variable_index_set_variable(info, EFI_VARIABLE_NON_VOLATILE);
+		}
+
+		/* Expect every variable to be found as its own entry */
+		for (size_t i = 0; i < num_vars; ++i) {
+
+			struct variable_info *info = variable_index_find(
+				&index,
+				&guid_1,
+				names[i].size() * sizeof(int16_t),
+				names[i].data());
+			CHECK_TRUE(info);
+			UNSIGNED_LONGS_EQUAL(names[i].size() * sizeof(int16_t), info->metadata.name_size);
+			MEMCMP_EQUAL(names[i].data(), info->metadata.name, info->metadata.name_size);
+		}
+
+		/* Expect a variable that wasn't added not to be found */
+		std::vector<int16_t> missing_name = to_variable_name(L"missing_var");
+
+		POINTERS_EQUAL(NULL, variable_index_find(
+			&index,
+			&guid_1,
+			missing_name.size() * sizeof(int16_t),
+			missing_name.data()));
+
+		variable_index_deinit(&index);
+	}
+}
+
+TEST(UefiVariableIndexTests, fullEnumeration)
+{
+	static const size_t index_sizes[] = {64, 512, 4096};
+	const std::vector<int16_t> null_name = to_variable_name(L"");
+
+	for (size_t size_idx = 0; size_idx < sizeof(index_sizes) / sizeof(size_t); ++size_idx) {
+
+		size_t num_vars = index_sizes[size_idx];
+		struct variable_index index;
+		std::vector<std::vector<int16_t>> names;
+
+		efi_status_t status = variable_index_init(&index, num_vars);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+		for (size_t i = 0; i < num_vars; ++i) {
+
+			names.push_back(to_variable_name(L"enum_var_" + std::to_wstring(i)));
+
+			struct variable_info *info = variable_index_add_entry(
+				&index,
+				&guid_1,
+				names[i].size() * sizeof(int16_t),
+				names[i].data());
+			CHECK_TRUE(info);
+
+			variable_index_set_variable(info, EFI_VARIABLE_NON_VOLATILE);
+		}
+
+		/* Enumerate the whole index in the way GetNextVariableName would.
+		 * Expect variables to be returned in the order they were added.
+		 */
+		size_t count = 0;
+		const struct variable_info *info = NULL;
+
+		info = variable_index_find_next(
+			&index,
+			&guid_1,
+			null_name.size() * sizeof(int16_t),
+			null_name.data(),
+			&status);
+
+		while (info) {
+
+			UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+			MEMCMP_EQUAL(names[count].data(), info->metadata.name, info->metadata.name_size);
+			++count;
+
+			info = variable_index_find_next(
+				&index,
+				&info->metadata.guid,
+				info->metadata.name_size,
+				info->metadata.name,
+				&status);
+		}
+
+		UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+		UNSIGNED_LONGS_EQUAL(num_vars, count);
+
+		variable_index_deinit(&index);
+	}
+}
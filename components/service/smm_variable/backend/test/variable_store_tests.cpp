@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -237,6 +237,28 @@ TEST_GROUP(UefiVariableStoreTests)
 		return status;
 	}
 
+	psa_status_t get_stored_info(
+		const std::wstring &name,
+		struct psa_storage_info_t *storage_info)
+	{
+		std::vector<int16_t> var_name = to_variable_name(name);
+		size_t name_size = var_name.size() * sizeof(int16_t);
+
+		const struct variable_info *info = variable_index_find(
+			&m_uefi_variable_store.variable_index,
+			&m_common_guid,
+			name_size,
+			var_name.data());
+
+		if (!info) return PSA_ERROR_DOES_NOT_EXIST;
+
+		return m_persistent_backend->interface->get_info(
+			m_persistent_backend->context,
+			OWNER_ID,
+			info->metadata.uid,
+			storage_info);
+	}
+
 	void zap_stored_variable(
 		const std::wstring &name)
 	{
@@ -422,6 +444,548 @@ TEST(UefiVariableStoreTests, persistentSetGet)
 	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY - expected_output.size(), remaining_variable_storage_size);
 }
 
+TEST(UefiVariableStoreTests, cachedSpaceAccounting)
+{
+	efi_status_t status = EFI_SUCCESS;
+	std::string input_data = "quick brown fox";
+	std::string output_data;
+	size_t max_variable_storage_size = 0;
+	size_t remaining_variable_storage_size = 0;
+	size_t max_variable_size = 0;
+	size_t nv_used = 0;
+	size_t volatile_used = 0;
+
+	/* Add a mixture of NV and volatile variables of different sizes */
+	for (int i = 0; i < 6; ++i) {
+
+		std::wstring var_name = L"var_" + std::to_wstring(i);
+		std::string data = input_data.substr(0, 5 + i);
+		uint32_t attributes = (i % 2) ? 0 : EFI_VARIABLE_NON_VOLATILE;
+
+		status = set_variable(var_name, data, attributes);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+		if (attributes) nv_used += data.size();
+		else volatile_used += data.size();
+	}
+
+	/* Expect QueryVariableInfo not to make any backend calls */
+	mock_store_clear_call_counts(&m_persistent_store);
+	mock_store_clear_call_counts(&m_volatile_store);
+
+	status = query_variable_info(EFI_VARIABLE_NON_VOLATILE, &max_variable_storage_size,
+		&remaining_variable_storage_size, &max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY - nv_used, remaining_variable_storage_size);
+
+	status = query_variable_info(0, &max_variable_storage_size,
+		&remaining_variable_storage_size, &max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY - volatile_used, remaining_variable_storage_size);
+
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.get_info);
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.get);
+	UNSIGNED_LONGS_EQUAL(0, m_volatile_store.call_counts.get_info);
+	UNSIGNED_LONGS_EQUAL(0, m_volatile_store.call_counts.get);
+
+	/* Expect GetVariable to make a single get call */
+	status = get_variable(L"var_2", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, input_data.substr(0, 7).compare(output_data));
+
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.get_info);
+	UNSIGNED_LONGS_EQUAL(1, m_persistent_store.call_counts.get);
+
+	/* Expect totals to follow appends and removals */
+	status = set_variable(L"var_1", input_data,
+		EFI_VARIABLE_APPEND_WRITE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	volatile_used += input_data.size();
+
+	status = set_variable(L"var_0", std::string(), EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	nv_used -= 5;
+
+	status = query_variable_info(EFI_VARIABLE_NON_VOLATILE, &max_variable_storage_size,
+		&remaining_variable_storage_size, &max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY - nv_used, remaining_variable_storage_size);
+
+	status = query_variable_info(0, &max_variable_storage_size,
+		&remaining_variable_storage_size, &max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY - volatile_used, remaining_variable_storage_size);
+
+	/* Expect NV sizes to be recovered after a power cycle and volatile space freed */
+	power_cycle();
+
+	status = query_variable_info(EFI_VARIABLE_NON_VOLATILE, &max_variable_storage_size,
+		&remaining_variable_storage_size, &max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY - nv_used, remaining_variable_storage_size);
+
+	status = query_variable_info(0, &max_variable_storage_size,
+		&remaining_variable_storage_size, &max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY, remaining_variable_storage_size);
+}
+
+TEST(UefiVariableStoreTests, appendInPlace)
+{
+	efi_status_t status = EFI_SUCCESS;
+	std::string input_data = "quick brown fox";
+	std::string appended_data = " jumps over the lazy dog";
+	std::string output_data;
+	struct psa_storage_info_t storage_info;
+	uint64_t max_variable_storage_size = 0;
+	uint64_t remaining_variable_storage_size = 0;
+	uint64_t max_variable_size = 0;
+
+	/* By default, no capacity is reserved for appends */
+	status = set_variable(L"nv_var", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	LONGS_EQUAL(PSA_SUCCESS, get_stored_info(L"nv_var", &storage_info));
+	UNSIGNED_LONGS_EQUAL(input_data.size(), storage_info.capacity);
+
+	status = set_variable(L"nv_var", std::string(), EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	/* When enabled, a new NV variable should be created with room to grow */
+	m_uefi_variable_store.persistent_store.reserve_append_capacity = true;
+
+	status = set_variable(L"nv_var", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	LONGS_EQUAL(PSA_SUCCESS, get_stored_info(L"nv_var", &storage_info));
+	UNSIGNED_LONGS_EQUAL(input_data.size(), storage_info.size);
+	UNSIGNED_LONGS_EQUAL(MAX_VARIABLE_SIZE, storage_info.capacity);
+
+	/* Expect the reserved capacity to count as used space */
+	status = query_variable_info(EFI_VARIABLE_NON_VOLATILE, &max_variable_storage_size,
+		&remaining_variable_storage_size, &max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY - MAX_VARIABLE_SIZE,
+		remaining_variable_storage_size);
+
+	/* Expect the append to be written without reading back the variable */
+	mock_store_clear_call_counts(&m_persistent_store);
+
+	status = set_variable(L"nv_var", appended_data,
+		EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_APPEND_WRITE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.get);
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.get_info);
+	UNSIGNED_LONGS_EQUAL(1, m_persistent_store.call_counts.set_extended);
+
+	/* A second append should be placed after the first using the cached size */
+	status = set_variable(L"nv_var", appended_data,
+		EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_APPEND_WRITE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.get_info);
+	UNSIGNED_LONGS_EQUAL(2, m_persistent_store.call_counts.set_extended);
+
+	status = get_variable(L"nv_var", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, (input_data + appended_data + appended_data).compare(output_data));
+
+	/* Overwriting an existing variable should replace it with set */
+	status = set_variable(L"nv_var", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	LONGS_EQUAL(PSA_SUCCESS, get_stored_info(L"nv_var", &storage_info));
+	UNSIGNED_LONGS_EQUAL(input_data.size(), storage_info.capacity);
+
+	status = query_variable_info(EFI_VARIABLE_NON_VOLATILE, &max_variable_storage_size,
+		&remaining_variable_storage_size, &max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(STORE_CAPACITY - input_data.size(),
+		remaining_variable_storage_size);
+
+	/* Without spare capacity, the append falls back to read-modify-write */
+	mock_store_clear_call_counts(&m_persistent_store);
+
+	status = set_variable(L"nv_var", appended_data,
+		EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_APPEND_WRITE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	UNSIGNED_LONGS_EQUAL(1, m_persistent_store.call_counts.get);
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.get_info);
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.set_extended);
+
+	/* Check the data survives a power cycle */
+	power_cycle();
+
+	status = get_variable(L"nv_var", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, (input_data + appended_data).compare(output_data));
+
+	/* An empty object left by a failure between create and write should be removed */
+	std::vector<int16_t> var_name = to_variable_name(L"nv_var");
+	const struct variable_info *info = variable_index_find(
+		&m_uefi_variable_store.variable_index,
+		&m_common_guid,
+		var_name.size() * sizeof(int16_t),
+		var_name.data());
+	CHECK_TRUE(info);
+
+	zap_stored_variable(L"nv_var");
+	m_persistent_backend->interface->create(m_persistent_backend->context, OWNER_ID,
+		info->metadata.uid, MAX_VARIABLE_SIZE, PSA_STORAGE_FLAG_NONE);
+
+	LONGS_EQUAL(PSA_SUCCESS, get_stored_info(L"nv_var", &storage_info));
+	UNSIGNED_LONGS_EQUAL(0, storage_info.size);
+
+	power_cycle();
+
+	status = get_variable(L"nv_var", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+}
+
+TEST(UefiVariableStoreTests, repeatedAppends)
+{
+	/* Models repeated appends of signature list entries to a dbx-like variable */
+	const unsigned int num_appends = 100;
+	const std::string entry(76, 'x');
+	const size_t max_size = entry.size() * (num_appends + 1);
+
+	uefi_variable_store_set_storage_limits(
+		&m_uefi_variable_store,
+		EFI_VARIABLE_NON_VOLATILE,
+		2 * max_size,
+		max_size);
+
+	for (unsigned int i = 0; i < 2; ++i) {
+
+		std::wstring var_name = L"dbx_" + std::to_wstring(i);
+		efi_status_t status = EFI_SUCCESS;
+
+		/* Force read-modify-write by hiding set_extended support */
+		m_uefi_variable_store.persistent_store.storage_support =
+			(i) ? PSA_STORAGE_SUPPORT_SET_EXTENDED : 0;
+		m_uefi_variable_store.persistent_store.reserve_append_capacity = (i != 0);
+
+		status = set_variable(var_name, entry, EFI_VARIABLE_NON_VOLATILE);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+		mock_store_clear_call_counts(&m_persistent_store);
+
+		for (unsigned int j = 0; j < num_appends; ++j) {
+
+			status = set_variable(var_name, entry,
+				EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_APPEND_WRITE);
+			UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+		}
+
+		UNSIGNED_LONGS_EQUAL((i) ? 0 : num_appends, m_persistent_store.call_counts.get);
+		UNSIGNED_LONGS_EQUAL((i) ? num_appends : 0,
+			m_persistent_store.call_counts.set_extended);
+
+		/* Check the size of the stored object as the data won't fit the get buffer */
+		struct psa_storage_info_t storage_info;
+
+		LONGS_EQUAL(PSA_SUCCESS, get_stored_info(var_name, &storage_info));
+		UNSIGNED_LONGS_EQUAL(max_size, storage_info.size);
+	}
+}
+
+TEST(UefiVariableStoreTests, journaledIndexUpdates)
+{
+	efi_status_t status = EFI_SUCCESS;
+	std::string input_data = "quick brown fox";
+	std::string output_data;
+
+	status = set_variable(L"nv_var_a", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_b", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_a", std::string(), EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	/* Expect index changes held in the journal to survive a power cycle */
+	power_cycle();
+
+	status = get_variable(L"nv_var_a", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+
+	status = get_variable(L"nv_var_b", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, input_data.compare(output_data));
+
+	/* Make enough index changes to overflow the journal a few times */
+	for (int i = 0; i < 50; ++i) {
+
+		status = set_variable(L"nv_var_c", input_data, EFI_VARIABLE_NON_VOLATILE);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+		status = set_variable(L"nv_var_c", std::string(), EFI_VARIABLE_NON_VOLATILE);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	}
+
+	status = set_variable(L"nv_var_d", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	power_cycle();
+
+	status = get_variable(L"nv_var_b", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = get_variable(L"nv_var_c", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+
+	status = get_variable(L"nv_var_d", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, input_data.compare(output_data));
+
+	/* Expect only the two remaining NV variables plus the index to be stored */
+	UNSIGNED_LONGS_EQUAL(3, mock_store_num_items(&m_persistent_store));
+}
+
+TEST(UefiVariableStoreTests, writeBackCoalescing)
+{
+	efi_status_t status = EFI_SUCCESS;
+	std::string input_data_a = "quick brown fox";
+	std::string input_data_a2 = " jumps over the lazy dog";
+	std::string input_data_b = "a second variable";
+	std::string output_data;
+
+	status = uefi_variable_store_set_write_back(&m_uefi_variable_store, 8);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_a", input_data_a, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_b", input_data_b, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_a", input_data_a2,
+		EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_APPEND_WRITE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_c", input_data_b, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_c", std::string(), EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	/* Expect nothing to have been written to the persistent store yet */
+	UNSIGNED_LONGS_EQUAL(0, mock_store_num_items(&m_persistent_store));
+
+	/* Expect pending updates to be visible */
+	status = get_variable(L"nv_var_a", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, (input_data_a + input_data_a2).compare(output_data));
+
+	status = get_variable(L"nv_var_c", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+
+	size_t max_variable_storage_size = 0;
+	size_t remaining_variable_storage_size = 0;
+	size_t max_variable_size = 0;
+
+	status = query_variable_info(
+		EFI_VARIABLE_NON_VOLATILE,
+		&max_variable_storage_size,
+		&remaining_variable_storage_size,
+		&max_variable_size);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGLONGS_EQUAL(
+		STORE_CAPACITY - (input_data_a.size() + input_data_a2.size() + input_data_b.size()),
+		remaining_variable_storage_size);
+
+	/* Flush and expect the coalesced updates to survive a power cycle */
+	status = uefi_variable_store_flush(&m_uefi_variable_store);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	power_cycle();
+
+	status = get_variable(L"nv_var_a", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, (input_data_a + input_data_a2).compare(output_data));
+
+	status = get_variable(L"nv_var_b", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, input_data_b.compare(output_data));
+
+	status = get_variable(L"nv_var_c", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+}
+
+TEST(UefiVariableStoreTests, writeBackPowerFailure)
+{
+	efi_status_t status = EFI_SUCCESS;
+	std::string old_data = "old value";
+	std::string new_data = "new value";
+	std::string output_data;
+
+	status = uefi_variable_store_set_write_back(&m_uefi_variable_store, 8);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_a", old_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_b", old_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = uefi_variable_store_flush(&m_uefi_variable_store);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	/* Make some updates that are still pending when power fails */
+	status = set_variable(L"nv_var_a", new_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_b", std::string(), EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_c", new_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	power_cycle();
+
+	/* Expect the store to be as it was at the last flush */
+	status = get_variable(L"nv_var_a", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, old_data.compare(output_data));
+
+	status = get_variable(L"nv_var_b", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, old_data.compare(output_data));
+
+	status = get_variable(L"nv_var_c", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+
+	/* Simulate a power failure part way through a flush, after the
+	 * variable index has been written but before one of the new
+	 * variables has been stored.
+	 */
+	status = uefi_variable_store_set_write_back(&m_uefi_variable_store, 8);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_a", new_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_c", new_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = uefi_variable_store_flush(&m_uefi_variable_store);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	zap_stored_variable(L"nv_var_c");
+	power_cycle();
+
+	status = get_variable(L"nv_var_a", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, new_data.compare(output_data));
+
+	status = get_variable(L"nv_var_c", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+}
+
+TEST(UefiVariableStoreTests, writeBackFlushTriggers)
+{
+	efi_status_t status = EFI_SUCCESS;
+	std::string input_data = "quick brown fox";
+	std::string output_data;
+
+	status = uefi_variable_store_set_write_back(&m_uefi_variable_store, 2);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_a", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	UNSIGNED_LONGS_EQUAL(0, mock_store_num_items(&m_persistent_store));
+
+	/* Reaching the pending write limit should force a flush */
+	status = set_variable(L"nv_var_b", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	CHECK_TRUE(mock_store_num_items(&m_persistent_store) > 0);
+
+	/* ExitBootServices should also force a flush */
+	status = set_variable(L"nv_var_c", input_data,
+		EFI_VARIABLE_NON_VOLATILE |
+		EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = uefi_variable_store_exit_boot_service(&m_uefi_variable_store);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	power_cycle();
+
+	status = get_variable(L"nv_var_a", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = get_variable(L"nv_var_b", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = get_variable(L"nv_var_c", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, input_data.compare(output_data));
+}
+
+TEST(UefiVariableStoreTests, writeBackFailedSet)
+{
+	efi_status_t status = EFI_SUCCESS;
+	std::string input_data = "quick brown fox";
+	std::string oversize_data(MAX_VARIABLE_SIZE + 1, 'x');
+	std::string output_data;
+
+	status = uefi_variable_store_set_write_back(&m_uefi_variable_store, 8);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	status = set_variable(L"nv_var_a", input_data, EFI_VARIABLE_NON_VOLATILE);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+
+	/* A failed update of an existing variable should leave its value unchanged */
+	status = set_variable(L"nv_var_a", oversize_data, EFI_VARIABLE_NON_VOLATILE);
+	CHECK_TRUE(status != EFI_SUCCESS);
+
+	status = get_variable(L"nv_var_a", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	LONGS_EQUAL(0, input_data.compare(output_data));
+
+	/* A failed create should leave no trace of the variable */
+	status = set_variable(L"nv_var_b", oversize_data, EFI_VARIABLE_NON_VOLATILE);
+	CHECK_TRUE(status != EFI_SUCCESS);
+
+	status = get_variable(L"nv_var_b", output_data);
+	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+
+	uint8_t msg_buffer[VARIABLE_BUFFER_SIZE];
+	SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME *next_name =
+		(SMM_VARIABLE_COMMUNICATE_GET_NEXT_VARIABLE_NAME*)msg_buffer;
+	size_t max_name_len = VARIABLE_BUFFER_SIZE -
+		SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE_NAME_OFFSET;
+	size_t total_len = 0;
+
+	/* Expect only the first variable to be enumerated, before and after a flush */
+	for (int i = 0; i < 2; ++i) {
+
+		next_name->NameSize = sizeof(int16_t);
+		next_name->Name[0] = 0;
+
+		status = uefi_variable_store_get_next_variable_name(
+			&m_uefi_variable_store,
+			next_name,
+			max_name_len,
+			&total_len);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+		CHECK_TRUE(compare_variable_name(L"nv_var_a", next_name->Name, next_name->NameSize));
+
+		status = uefi_variable_store_get_next_variable_name(
+			&m_uefi_variable_store,
+			next_name,
+			max_name_len,
+			&total_len);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
+
+		status = uefi_variable_store_flush(&m_uefi_variable_store);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	}
+}
+
 TEST(UefiVariableStoreTests, getWithSmallBuffer)
 {
 	efi_status_t status = EFI_SUCCESS;
@@ -691,6 +1255,42 @@ TEST(UefiVariableStoreTests, enumerateStoreContents)
 	UNSIGNED_LONGLONGS_EQUAL(EFI_NOT_FOUND, status);
 }
 
+TEST(UefiVariableStoreTests, batchedOrphanCheck)
+{
+	efi_status_t status = EFI_SUCCESS;
+	std::string input_data = "quick brown fox";
+	std::string output_data;
+
+	/* Add some NV variables and a volatile one */
+	for (int i = 0; i < 6; ++i) {
+
+		std::wstring var_name = L"var_" + std::to_wstring(i);
+		uint32_t attributes = (i == 5) ? 0 : EFI_VARIABLE_NON_VOLATILE;
+
+		status = set_variable(var_name, input_data, attributes);
+		UNSIGNED_LONGLONGS_EQUAL(EFI_SUCCESS, status);
+	}
+
+	/* Lose the stored object of one of the NV variables */
+	zap_stored_variable(L"var_2");
+
+	/* Expect the index to be checked with a single storage call at start-up */
+	mock_store_clear_call_counts(&m_persistent_store);
+	power_cycle();
+
+	UNSIGNED_LONGS_EQUAL(1, m_persistent_store.call_counts.get_info_multi);
+	UNSIGNED_LONGS_EQUAL(0, m_persistent_store.call_counts.get_info);
+
+	/* Only the orphaned variable should have been removed */
+	for (int i = 0; i < 5; ++i) {
+
+		std::wstring var_name = L"var_" + std::to_wstring(i);
+
+		status = get_variable(var_name, output_data);
+		UNSIGNED_LONGLONGS_EQUAL((i == 2) ? EFI_NOT_FOUND : EFI_SUCCESS, status);
+	}
+}
+
 TEST(UefiVariableStoreTests, failedNvSet)
 {
 	efi_status_t status = EFI_SUCCESS;
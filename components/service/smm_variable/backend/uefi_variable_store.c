@@ -19,6 +19,16 @@ static void load_variable_index(
 static efi_status_t sync_variable_index(
 	struct uefi_variable_store *context);
 
+static efi_status_t compact_variable_index(
+	struct uefi_variable_store *context);
+
+static psa_status_t append_index_journal(
+	struct uefi_variable_store *context,
+	size_t data_len);
+
+static void remove_index_journal(
+	struct uefi_variable_store *context);
+
 static efi_status_t check_capabilities(
 	const SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *var);
 
@@ -33,7 +43,7 @@ static efi_status_t check_access_permitted_on_set(
 
 static efi_status_t store_variable_data(
 	struct uefi_variable_store *context,
-	const struct variable_info *info,
+	struct variable_info *info,
 	const SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *var);
 
 static efi_status_t remove_variable_data(
@@ -51,26 +61,237 @@ static psa_status_t store_overwrite(
 	uint32_t client_id,
 	uint64_t uid,
 	size_t data_length,
-	const void *data);
+	const void *data,
+	bool is_new,
+	size_t *capacity);
 
 static psa_status_t store_append_write(
 	struct delegate_variable_store *delegate_store,
 	uint32_t client_id,
 	uint64_t uid,
+	size_t stored_size,
 	size_t data_length,
-	const void *data);
+	const void *data,
+	size_t *capacity);
 
 static void purge_orphan_index_entries(
 	struct uefi_variable_store *context);
 
+static struct pending_variable_write *find_pending_write(
+	const struct uefi_variable_store *context,
+	const struct variable_info *info);
+
+static psa_status_t buffer_variable_data(
+	struct uefi_variable_store *context,
+	const struct variable_info *info,
+	size_t data_length,
+	const void *data,
+	bool is_append);
+
+static void buffer_variable_removal(
+	struct uefi_variable_store *context,
+	const struct variable_info *info);
+
+static void discard_pending_writes(
+	struct uefi_variable_store *context);
+
+static void remove_unused_entry(
+	struct uefi_variable_store *context,
+	struct variable_info *info);
+
+static struct pending_variable_write *find_pending_write(
+	const struct uefi_variable_store *context,
+	const struct variable_info *info)
+{
+	for (size_t i = 0; i < context->num_pending_writes; i++) {
+
+		if (context->pending_writes[i].info == info)
+			return &context->pending_writes[i];
+	}
+
+	return NULL;
+}
+
+static struct pending_variable_write *add_pending_write(
+	struct uefi_variable_store *context,
+	const struct variable_info *info)
+{
+	struct pending_variable_write *pending = find_pending_write(context, info);
+
+	if (!pending && (context->num_pending_writes < context->max_pending_writes)) {
+
+		pending = &context->pending_writes[context->num_pending_writes++];
+
+		pending->info = (struct variable_info *)info;
+		pending->is_removed = false;
+		pending->data_len = 0;
+		pending->data = NULL;
+	}
+
+	return pending;
+}
+
+static psa_status_t buffer_variable_data(
+	struct uefi_variable_store *context,
+	const struct variable_info *info,
+	size_t data_length,
+	const void *data,
+	bool is_append)
+{
+	struct delegate_variable_store *delegate_store = &context->persistent_store;
+	struct pending_variable_write *pending = find_pending_write(context, info);
+	size_t old_size = 0;
+	uint8_t *buf = NULL;
+
+	if (!is_append) {
+
+		/* Police maximum variable size limit */
+		if (data_length > delegate_store->max_variable_size)
+			return PSA_ERROR_INVALID_ARGUMENT;
+
+		buf = malloc(data_length ? data_length : 1);
+		if (!buf) return PSA_ERROR_INSUFFICIENT_MEMORY;
+
+		memcpy(buf, data, data_length);
+	}
+	else {
+
+		if (data_length == 0) return PSA_SUCCESS;
+
+		if (pending && pending->is_removed) return PSA_ERROR_DOES_NOT_EXIST;
+
+		struct storage_backend *storage_backend = delegate_store->storage_backend;
+
+		if (pending) {
+
+			old_size = pending->data_len;
+		}
+		else {
+
+			if (!storage_backend) return PSA_ERROR_DOES_NOT_EXIST;
+
+			old_size = info->data_size;
+		}
+
+		size_t new_size = old_size + data_length;
+
+		/* Defend against integer overflow */
+		if (new_size < old_size) return PSA_ERROR_INVALID_ARGUMENT;
+
+		/* Police maximum variable size limit */
+		if (new_size > delegate_store->max_variable_size) return PSA_ERROR_INVALID_ARGUMENT;
+
+		buf = malloc(new_size);
+		if (!buf) return PSA_ERROR_INSUFFICIENT_MEMORY;
+
+		if (pending) {
+
+			memcpy(buf, pending->data, old_size);
+		}
+		else {
+
+			size_t got_len = 0;
+
+			psa_status_t psa_status = storage_backend->interface->get(
+				storage_backend->context,
+				context->owner_id,
+				info->metadata.uid,
+				0,
+				old_size,
+				buf,
+				&got_len);
+
+			if ((psa_status != PSA_SUCCESS) || (got_len != old_size)) {
+
+				free(buf);
+				return (psa_status != PSA_SUCCESS) ? psa_status : PSA_ERROR_STORAGE_FAILURE;
+			}
+		}
+
+		memcpy(&buf[old_size], data, data_length);
+		data_length = new_size;
+	}
+
+	if (!pending) {
+
+		pending = add_pending_write(context, info);
+
+		if (!pending) {
+
+			free(buf);
+			return PSA_ERROR_INSUFFICIENT_MEMORY;
+		}
+	}
+
+	free(pending->data);
+
+	pending->is_removed = false;
+	pending->data_len = data_length;
+	pending->data = buf;
+
+	return PSA_SUCCESS;
+}
+
+static void buffer_variable_removal(
+	struct uefi_variable_store *context,
+	const struct variable_info *info)
+{
+	struct pending_variable_write *pending = add_pending_write(context, info);
+
+	if (pending) {
+
+		free(pending->data);
+
+		pending->is_removed = true;
+		pending->data_len = 0;
+		pending->data = NULL;
+	}
+}
+
+static void discard_pending_writes(
+	struct uefi_variable_store *context)
+{
+	size_t num_pending = context->num_pending_writes;
+
+	/* Entries for pending writes are kept in the index until the pending
+	 * state has been dealt with so now is the time to remove them if
+	 * they're no longer used.
+	 */
+	context->num_pending_writes = 0;
+
+	for (size_t i = 0; i < num_pending; i++) {
+
+		struct pending_variable_write *pending = &context->pending_writes[i];
+
+		free(pending->data);
+		pending->data = NULL;
+
+		variable_index_remove_unused_entry(&context->variable_index, pending->info);
+	}
+}
+
+static void remove_unused_entry(
+	struct uefi_variable_store *context,
+	struct variable_info *info)
+{
+	/* Pending writes refer to their index entry so removal is deferred */
+	if (!find_pending_write(context, info))
+		variable_index_remove_unused_entry(&context->variable_index, info);
+}
+
 static struct delegate_variable_store *select_delegate_store(
 	struct uefi_variable_store *context,
 	uint32_t attributes);
 
-static size_t space_used(
+static void set_variable_data_size(
 	struct uefi_variable_store *context,
-	uint32_t attributes,
-	struct storage_backend *storage_backend);
+	struct variable_info *info,
+	size_t data_size);
+
+static void set_variable_capacity(
+	struct uefi_variable_store *context,
+	struct variable_info *info,
+	size_t capacity);
 
 static efi_status_t psa_to_efi_storage_status(
 	psa_status_t psa_status);
@@ -84,6 +305,35 @@ static efi_status_t check_name_terminator(
 #define SMM_VARIABLE_INDEX_STORAGE_UID			(1)
 #endif
 
+/* Private UID for the variable index journal - may be overridden at build-time */
+#ifndef SMM_VARIABLE_INDEX_JOURNAL_STORAGE_UID
+#define SMM_VARIABLE_INDEX_JOURNAL_STORAGE_UID		(2)
+#endif
+
+/* Maximum number of records held by the index journal before the full index is
+ * rewritten. Setting to zero disables journaling - may be overridden at build-time.
+ */
+#ifndef SMM_VARIABLE_INDEX_JOURNAL_MAX_RECORDS
+#define SMM_VARIABLE_INDEX_JOURNAL_MAX_RECORDS		(16)
+#endif
+
+/* Number of NV variables looked up per storage call when checking the
+ * index against the persistent store - may be overridden at build-time.
+ */
+#ifndef SMM_VARIABLE_PURGE_BATCH_SIZE
+#define SMM_VARIABLE_PURGE_BATCH_SIZE			(16)
+#endif
+
+/* Reserve capacity up to the maximum variable size when an NV variable is
+ * first stored, if the backend supports set_extended, so that appends may be
+ * written in place. The reserved capacity counts as used storage space so
+ * this is only worthwhile for platforms where variables are often appended
+ * to - may be overridden at build-time.
+ */
+#ifndef SMM_VARIABLE_RESERVE_APPEND_CAPACITY
+#define SMM_VARIABLE_RESERVE_APPEND_CAPACITY		(0)
+#endif
+
 /* Default maximum variable size -
  * may be overridden using uefi_variable_store_set_storage_limits()
  */
@@ -100,26 +350,48 @@ efi_status_t uefi_variable_store_init(
 
 	/* Initialise persistent store defaults */
 	context->persistent_store.is_nv = true;
+	context->persistent_store.reserve_append_capacity = SMM_VARIABLE_RESERVE_APPEND_CAPACITY;
+	context->persistent_store.total_used = 0;
 	context->persistent_store.max_variable_size = DEFAULT_MAX_VARIABLE_SIZE;
 	context->persistent_store.total_capacity = DEFAULT_MAX_VARIABLE_SIZE * max_variables;
+	context->persistent_store.storage_support = (persistent_store) ?
+		persistent_store->interface->get_support(persistent_store->context, owner_id) : 0;
 	context->persistent_store.storage_backend = persistent_store;
 
 	/* Initialise volatile store defaults */
 	context->volatile_store.is_nv = false;
+	context->volatile_store.reserve_append_capacity = false;
+	context->volatile_store.total_used = 0;
 	context->volatile_store.max_variable_size = DEFAULT_MAX_VARIABLE_SIZE;
 	context->volatile_store.total_capacity = DEFAULT_MAX_VARIABLE_SIZE * max_variables;
+	context->volatile_store.storage_support = (volatile_store) ?
+		volatile_store->interface->get_support(volatile_store->context, owner_id) : 0;
 	context->volatile_store.storage_backend = volatile_store;
 
 	context->owner_id = owner_id;
 	context->is_boot_service = true;
 
+	context->index_sync_buffer = NULL;
+	context->index_journal_buffer = NULL;
+	context->index_journal_buffer_size = 0;
+	context->index_journal_len = 0;
+
+	context->pending_writes = NULL;
+	context->max_pending_writes = 0;
+	context->num_pending_writes = 0;
+
 	status = variable_index_init(&context->variable_index, max_variables);
 
 	if (status == EFI_SUCCESS) {
 
+		/* Keep variables off the storage objects used for the index */
+		variable_index_reserve_uid(&context->variable_index,
+			SMM_VARIABLE_INDEX_STORAGE_UID);
+		variable_index_reserve_uid(&context->variable_index,
+			SMM_VARIABLE_INDEX_JOURNAL_STORAGE_UID);
+
 		/* Allocate a buffer for synchronizing the variable index with the persistent store */
 		context->index_sync_buffer_size = variable_index_max_dump_size(&context->variable_index);
-		context->index_sync_buffer = NULL;
 
 		if (context->index_sync_buffer_size) {
 
@@ -127,8 +399,18 @@ efi_status_t uefi_variable_store_init(
 			status = (context->index_sync_buffer) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
 		}
 
+		/* Allocate a buffer holding a copy of the index journal */
+		context->index_journal_buffer_size =
+			SMM_VARIABLE_INDEX_JOURNAL_MAX_RECORDS * sizeof(struct variable_index_record);
+
+		if (context->index_journal_buffer_size && (status == EFI_SUCCESS)) {
+
+			context->index_journal_buffer = malloc(context->index_journal_buffer_size);
+			status = (context->index_journal_buffer) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+		}
+
 		/* Load the variable index with NV variable info from the persistent store */
-		if (context->index_sync_buffer) {
+		if (context->index_sync_buffer && (status == EFI_SUCCESS)) {
 
 			load_variable_index(context);
 			purge_orphan_index_entries(context);
@@ -141,10 +423,19 @@ efi_status_t uefi_variable_store_init(
 void uefi_variable_store_deinit(
 	struct uefi_variable_store *context)
 {
+	discard_pending_writes(context);
+
+	free(context->pending_writes);
+	context->pending_writes = NULL;
+	context->max_pending_writes = 0;
+
 	variable_index_deinit(&context->variable_index);
 
 	free(context->index_sync_buffer);
 	context->index_sync_buffer = NULL;
+
+	free(context->index_journal_buffer);
+	context->index_journal_buffer = NULL;
 }
 
 void uefi_variable_store_set_storage_limits(
@@ -161,6 +452,101 @@ void uefi_variable_store_set_storage_limits(
 	delegate_store->max_variable_size = max_variable_size;
 }
 
+efi_status_t uefi_variable_store_set_write_back(
+	struct uefi_variable_store *context,
+	size_t max_pending_writes)
+{
+	efi_status_t status = uefi_variable_store_flush(context);
+
+	if (status != EFI_SUCCESS)
+		return status;
+
+	free(context->pending_writes);
+	context->pending_writes = NULL;
+	context->max_pending_writes = 0;
+
+	if (max_pending_writes) {
+
+		context->pending_writes = (struct pending_variable_write*)
+			calloc(max_pending_writes, sizeof(struct pending_variable_write));
+
+		if (!context->pending_writes)
+			return EFI_OUT_OF_RESOURCES;
+
+		context->max_pending_writes = max_pending_writes;
+	}
+
+	return EFI_SUCCESS;
+}
+
+efi_status_t uefi_variable_store_flush(
+	struct uefi_variable_store *context)
+{
+	bool any_failures = false;
+	efi_status_t status = EFI_SUCCESS;
+	struct storage_backend *storage_backend = context->persistent_store.storage_backend;
+
+	if (!context->num_pending_writes)
+		return EFI_SUCCESS;
+
+	/* The order of operations follows uefi_variable_store_set_variable().
+	 * Data for removed variables is removed before the variable index is
+	 * synchronized and new data is stored afterwards. If power fails part
+	 * way through, each variable is left with either its old or its new
+	 * value, or with an index entry but no data which is purged on the next
+	 * initialization.
+	 */
+	for (size_t i = 0; i < context->num_pending_writes; i++) {
+
+		struct pending_variable_write *pending = &context->pending_writes[i];
+
+		if (pending->is_removed && storage_backend) {
+
+			storage_backend->interface->remove(
+				storage_backend->context,
+				context->owner_id,
+				pending->info->metadata.uid);
+		}
+	}
+
+	status = sync_variable_index(context);
+
+	for (size_t i = 0; i < context->num_pending_writes; i++) {
+
+		struct pending_variable_write *pending = &context->pending_writes[i];
+
+		if (!pending->is_removed && storage_backend && (status == EFI_SUCCESS)) {
+
+			psa_status_t psa_status = storage_backend->interface->set(
+				storage_backend->context,
+				context->owner_id,
+				pending->info->metadata.uid,
+				pending->data_len,
+				pending->data,
+				PSA_STORAGE_FLAG_NONE);
+
+			if (psa_status == PSA_SUCCESS) {
+
+				/* The object is replaced without any reserved capacity */
+				set_variable_capacity(context, pending->info, 0);
+			}
+			else {
+
+				status = psa_to_efi_storage_status(psa_status);
+				any_failures = true;
+			}
+		}
+	}
+
+	discard_pending_writes(context);
+
+	/* Fix any mismatch between the variable index and stored NV variables */
+	if (any_failures || (status != EFI_SUCCESS))
+		purge_orphan_index_entries(context);
+
+	return status;
+}
+
 efi_status_t uefi_variable_store_set_variable(
 	struct uefi_variable_store *context,
 	const SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *var)
@@ -217,6 +603,8 @@ efi_status_t uefi_variable_store_set_variable(
 				 * the storage backend without a corresponding index entry.
 				 */
 				remove_variable_data(context, info);
+				set_variable_data_size(context, info, 0);
+				set_variable_capacity(context, info, 0);
 				variable_index_clear_variable(&context->variable_index, info);
 
 				should_sync_index = (var->Attributes & EFI_VARIABLE_NON_VOLATILE);
@@ -257,7 +645,7 @@ efi_status_t uefi_variable_store_set_variable(
 	 * store is detectable and may be corrected by purging the corresponding
 	 * index entry.
 	 */
-	if (should_sync_index) {
+	if (should_sync_index && !context->max_pending_writes) {
 
 		status = sync_variable_index(context);
 	}
@@ -268,7 +656,17 @@ efi_status_t uefi_variable_store_set_variable(
 		status = store_variable_data(context, info, var);
 	}
 
-	variable_index_remove_unused_entry(&context->variable_index, info);
+	remove_unused_entry(context, info);
+
+	/* Bound the number of NV updates that may be lost on power failure */
+	if (context->max_pending_writes &&
+		(context->num_pending_writes >= context->max_pending_writes)) {
+
+		efi_status_t flush_status = uefi_variable_store_flush(context);
+
+		if (status == EFI_SUCCESS)
+			status = flush_status;
+	}
 
 	return status;
 }
@@ -356,10 +754,7 @@ efi_status_t uefi_variable_store_query_variable_info(
 		context,
 		var_info->Attributes);
 
-	size_t total_used = space_used(
-		context,
-		var_info->Attributes,
-		delegate_store->storage_backend);
+	size_t total_used = (delegate_store->storage_backend) ? delegate_store->total_used : 0;
 
 	var_info->MaximumVariableSize = delegate_store->max_variable_size;
 	var_info->MaximumVariableStorageSize = delegate_store->total_capacity;
@@ -374,7 +769,7 @@ efi_status_t uefi_variable_store_exit_boot_service(
 	struct uefi_variable_store *context)
 {
 	context->is_boot_service = false;
-	return EFI_SUCCESS;
+	return uefi_variable_store_flush(context);
 }
 
 efi_status_t uefi_variable_store_set_var_check_property(
@@ -418,7 +813,7 @@ efi_status_t uefi_variable_store_set_var_check_property(
 		variable_index_set_constraints(info, &constraints);
 	}
 
-	variable_index_remove_unused_entry(&context->variable_index, info);
+	remove_unused_entry(context, info);
 
 	return status;
 }
@@ -472,42 +867,164 @@ static void load_variable_index(
 
 			variable_index_restore(&context->variable_index, data_len, context->index_sync_buffer);
 		}
+
+		/* Apply any changes journaled since the full index was last written */
+		if (context->index_journal_buffer) {
+
+			psa_status = persistent_store->interface->get(
+				persistent_store->context,
+				context->owner_id,
+				SMM_VARIABLE_INDEX_JOURNAL_STORAGE_UID,
+				0,
+				context->index_journal_buffer_size,
+				context->index_journal_buffer,
+				&data_len);
+
+			if (psa_status == PSA_SUCCESS) {
+
+				variable_index_replay(
+					&context->variable_index,
+					data_len,
+					context->index_journal_buffer);
+
+				/* Fold the journal into the full index to start with an empty journal */
+				compact_variable_index(context);
+			}
+		}
 	}
 }
 
 static efi_status_t sync_variable_index(
 	struct uefi_variable_store *context)
 {
-	efi_status_t status = EFI_SUCCESS;
+	size_t data_len = 0;
+	size_t journal_space = context->index_journal_buffer_size - context->index_journal_len;
+
+	/* Attempt to journal just the records for dirty index entries */
+	bool is_dirty = variable_index_dump_dirty(
+		&context->variable_index,
+		journal_space,
+		(journal_space) ? &context->index_journal_buffer[context->index_journal_len] : NULL,
+		&data_len);
+
+	if (!is_dirty)
+		return EFI_SUCCESS;
+
+	if (data_len) {
 
-	/* Sync the varibale index to storage if anything is dirty */
+		if (append_index_journal(context, data_len) == PSA_SUCCESS) {
+
+			context->index_journal_len += data_len;
+			return EFI_SUCCESS;
+		}
+	}
+
+	/* Either the journal is full or the append failed so rewrite the full index */
+	return compact_variable_index(context);
+}
+
+static efi_status_t compact_variable_index(
+	struct uefi_variable_store *context)
+{
+	efi_status_t status = EFI_SUCCESS;
 	size_t data_len = 0;
 
-	bool is_dirty = variable_index_dump(
+	variable_index_dump(
 		&context->variable_index,
 		context->index_sync_buffer_size,
 		context->index_sync_buffer,
 		&data_len);
 
-	if (is_dirty) {
+	struct storage_backend *persistent_store = context->persistent_store.storage_backend;
+
+	if (persistent_store) {
+
+		psa_status_t psa_status = persistent_store->interface->set(
+			persistent_store->context,
+			context->owner_id,
+			SMM_VARIABLE_INDEX_STORAGE_UID,
+			data_len,
+			context->index_sync_buffer,
+			PSA_STORAGE_FLAG_NONE);
 
-		struct storage_backend *persistent_store = context->persistent_store.storage_backend;
+		status = psa_to_efi_storage_status(psa_status);
 
-		if (persistent_store) {
+		/* The journal is only discarded once the full index has been written.
+		 * If power fails in between, replaying the stale journal can only
+		 * revert the change that triggered the compaction, whose variable
+		 * data has not been stored yet.
+		 */
+		if ((status == EFI_SUCCESS) && context->index_journal_buffer)
+			remove_index_journal(context);
+	}
+	else {
 
-			psa_status_t psa_status = persistent_store->interface->set(
+		context->index_journal_len = 0;
+	}
+
+	return status;
+}
+
+static psa_status_t append_index_journal(
+	struct uefi_variable_store *context,
+	size_t data_len)
+{
+	psa_status_t psa_status = PSA_SUCCESS;
+	struct storage_backend *persistent_store = context->persistent_store.storage_backend;
+
+	if (!persistent_store)
+		return PSA_SUCCESS;
+
+	if (context->persistent_store.storage_support & PSA_STORAGE_SUPPORT_SET_EXTENDED) {
+
+		/* Only the new records need to be written */
+		if (!context->index_journal_len) {
+
+			psa_status = persistent_store->interface->create(
 				persistent_store->context,
 				context->owner_id,
-				SMM_VARIABLE_INDEX_STORAGE_UID,
-				data_len,
-				context->index_sync_buffer,
+				SMM_VARIABLE_INDEX_JOURNAL_STORAGE_UID,
+				context->index_journal_buffer_size,
 				PSA_STORAGE_FLAG_NONE);
+		}
 
-			status = psa_to_efi_storage_status(psa_status);
+		if (psa_status == PSA_SUCCESS) {
+
+			psa_status = persistent_store->interface->set_extended(
+				persistent_store->context,
+				context->owner_id,
+				SMM_VARIABLE_INDEX_JOURNAL_STORAGE_UID,
+				context->index_journal_len,
+				data_len,
+				&context->index_journal_buffer[context->index_journal_len]);
 		}
 	}
+	else {
 
-	return status;
+		/* Backend can't write at an offset so rewrite the whole journal */
+		psa_status = persistent_store->interface->set(
+			persistent_store->context,
+			context->owner_id,
+			SMM_VARIABLE_INDEX_JOURNAL_STORAGE_UID,
+			context->index_journal_len + data_len,
+			context->index_journal_buffer,
+			PSA_STORAGE_FLAG_NONE);
+	}
+
+	return psa_status;
+}
+
+static void remove_index_journal(
+	struct uefi_variable_store *context)
+{
+	struct storage_backend *persistent_store = context->persistent_store.storage_backend;
+
+	persistent_store->interface->remove(
+		persistent_store->context,
+		context->owner_id,
+		SMM_VARIABLE_INDEX_JOURNAL_STORAGE_UID);
+
+	context->index_journal_len = 0;
 }
 
 static efi_status_t check_capabilities(
@@ -587,7 +1104,7 @@ static efi_status_t check_access_permitted_on_set(
 
 static efi_status_t store_variable_data(
 	struct uefi_variable_store *context,
-	const struct variable_info *info,
+	struct variable_info *info,
 	const SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *var)
 {
 	psa_status_t psa_status = PSA_SUCCESS;
@@ -599,8 +1116,40 @@ static efi_status_t store_variable_data(
 		context,
 		info->metadata.attributes);
 
+	if (delegate_store->is_nv && context->max_pending_writes) {
+
+		/* Hold the update in RAM until the next flush */
+		psa_status = buffer_variable_data(
+			context,
+			info,
+			data_len,
+			data,
+			var->Attributes & EFI_VARIABLE_APPEND_WRITE);
+
+		if (psa_status == PSA_SUCCESS) {
+
+			set_variable_data_size(context, info,
+				find_pending_write(context, info)->data_len);
+		}
+		else {
+
+			const struct pending_variable_write *pending =
+				find_pending_write(context, info);
+
+			/* Undo the creation of a variable that has no data, pending
+			 * or stored, so that it isn't left in the index.
+			 */
+			if ((!pending || pending->is_removed) && !info->data_size)
+				variable_index_clear_variable(&context->variable_index, info);
+		}
+
+		return psa_to_efi_storage_status(psa_status);
+	}
+
 	if (delegate_store->storage_backend) {
 
+		size_t capacity = info->capacity;
+
 		if (!(var->Attributes & EFI_VARIABLE_APPEND_WRITE)) {
 
 			/* Create or overwrite variable data */
@@ -609,7 +1158,12 @@ static efi_status_t store_variable_data(
 				context->owner_id,
 				info->metadata.uid,
 				data_len,
-				data);
+				data,
+				!info->data_size,
+				&capacity);
+
+			if (psa_status == PSA_SUCCESS)
+				set_variable_data_size(context, info, data_len);
 		}
 		else {
 
@@ -618,9 +1172,17 @@ static efi_status_t store_variable_data(
 				delegate_store,
 				context->owner_id,
 				info->metadata.uid,
+				info->data_size,
 				data_len,
-				data);
+				data,
+				&capacity);
+
+			if (psa_status == PSA_SUCCESS)
+				set_variable_data_size(context, info, info->data_size + data_len);
 		}
+
+		if (psa_status == PSA_SUCCESS)
+			set_variable_capacity(context, info, capacity);
 	}
 
 	if ((psa_status != PSA_SUCCESS) && delegate_store->is_nv) {
@@ -646,7 +1208,12 @@ static efi_status_t remove_variable_data(
 			context,
 			info->metadata.attributes);
 
-		if (delegate_store->storage_backend) {
+		if (delegate_store->is_nv && context->max_pending_writes) {
+
+			/* Defer the removal until the next flush */
+			buffer_variable_removal(context, info);
+		}
+		else if (delegate_store->storage_backend) {
 
 			psa_status = delegate_store->storage_backend->interface->remove(
 				delegate_store->storage_backend->context,
@@ -672,42 +1239,52 @@ static efi_status_t load_variable_data(
 		context,
 		info->metadata.attributes);
 
-	if (delegate_store->storage_backend) {
+	const struct pending_variable_write *pending = find_pending_write(context, info);
 
-		struct psa_storage_info_t storage_info;
+	if (pending) {
 
-		psa_status = delegate_store->storage_backend->interface->get_info(
-			delegate_store->storage_backend->context,
-			context->owner_id,
-			info->metadata.uid,
-			&storage_info);
+		/* Variable has been updated but not yet written back */
+		size_t get_limit = (var->DataSize < max_data_len) ?
+			var->DataSize :
+			max_data_len;
 
-		if (psa_status == PSA_SUCCESS) {
+		if (get_limit >= pending->data_len) {
 
-			size_t get_limit = (var->DataSize < max_data_len) ?
-				var->DataSize :
-				max_data_len;
+			memcpy(data, pending->data, pending->data_len);
+			var->DataSize = pending->data_len;
+		}
+		else {
 
-			if (get_limit >= storage_info.size) {
+			var->DataSize = pending->data_len;
+			psa_status = PSA_ERROR_BUFFER_TOO_SMALL;
+		}
+	}
+	else if (delegate_store->storage_backend) {
 
-				size_t got_len = 0;
+		/* The size of the stored data is known so no get_info() is needed */
+		size_t get_limit = (var->DataSize < max_data_len) ?
+			var->DataSize :
+			max_data_len;
 
-				psa_status = delegate_store->storage_backend->interface->get(
-					delegate_store->storage_backend->context,
-					context->owner_id,
-					info->metadata.uid,
-					0,
-					storage_info.size,
-					data,
-					&got_len);
+		if (get_limit >= info->data_size) {
 
-				var->DataSize = got_len;
-			}
-			else {
+			size_t got_len = 0;
 
-				var->DataSize = storage_info.size;
-				psa_status = PSA_ERROR_BUFFER_TOO_SMALL;
-			}
+			psa_status = delegate_store->storage_backend->interface->get(
+				delegate_store->storage_backend->context,
+				context->owner_id,
+				info->metadata.uid,
+				0,
+				info->data_size,
+				data,
+				&got_len);
+
+			var->DataSize = got_len;
+		}
+		else {
+
+			var->DataSize = info->data_size;
+			psa_status = PSA_ERROR_BUFFER_TOO_SMALL;
 		}
 	}
 
@@ -719,13 +1296,52 @@ static psa_status_t store_overwrite(
 	uint32_t client_id,
 	uint64_t uid,
 	size_t data_length,
-	const void *data)
+	const void *data,
+	bool is_new,
+	size_t *capacity)
 {
+	struct storage_backend *storage_backend = delegate_store->storage_backend;
+
 	/* Police maximum variable size limit */
 	if (data_length > delegate_store->max_variable_size) return PSA_ERROR_INVALID_ARGUMENT;
 
-	psa_status_t psa_status = delegate_store->storage_backend->interface->set(
-		delegate_store->storage_backend->context,
+	if (delegate_store->reserve_append_capacity && is_new &&
+		(delegate_store->storage_support & PSA_STORAGE_SUPPORT_SET_EXTENDED)) {
+
+		/* Create the object with room to grow so appends can be written in place.
+		 * Replacing an existing object is left to set(), which is atomic.
+		 */
+		psa_status_t psa_status = storage_backend->interface->create(
+			storage_backend->context,
+			client_id,
+			uid,
+			delegate_store->max_variable_size,
+			PSA_STORAGE_FLAG_NONE);
+
+		if (psa_status == PSA_SUCCESS) {
+
+			psa_status = storage_backend->interface->set_extended(
+				storage_backend->context,
+				client_id,
+				uid,
+				0,
+				data_length,
+				data);
+
+			if (psa_status == PSA_SUCCESS)
+				*capacity = delegate_store->max_variable_size;
+			else
+				storage_backend->interface->remove(storage_backend->context, client_id, uid);
+
+			return psa_status;
+		}
+	}
+
+	/* The object is replaced without any reserved capacity */
+	*capacity = 0;
+
+	psa_status_t psa_status = storage_backend->interface->set(
+		storage_backend->context,
 		client_id,
 		uid,
 		data_length,
@@ -739,38 +1355,43 @@ static psa_status_t store_append_write(
 	struct delegate_variable_store *delegate_store,
 	uint32_t client_id,
 	uint64_t uid,
+	size_t stored_size,
 	size_t data_length,
-	const void *data)
+	const void *data,
+	size_t *capacity)
 {
-	struct psa_storage_info_t storage_info;
-
 	if (data_length == 0) return PSA_SUCCESS;
 
-	psa_status_t psa_status = delegate_store->storage_backend->interface->get_info(
-		delegate_store->storage_backend->context,
-		client_id,
-		uid,
-		&storage_info);
-
-	if (psa_status != PSA_SUCCESS) return psa_status;
-
-	/* Determine size of appended variable */
-	size_t new_size = storage_info.size + data_length;
+	/* Determine size of appended variable from the cached size of the stored data */
+	size_t new_size = stored_size + data_length;
 
 	/* Defend against integer overflow */
-	if (new_size < storage_info.size) return PSA_ERROR_INVALID_ARGUMENT;
+	if (new_size < stored_size) return PSA_ERROR_INVALID_ARGUMENT;
 
-		/* Police maximum variable size limit */
+	/* Police maximum variable size limit */
 	if (new_size > delegate_store->max_variable_size) return PSA_ERROR_INVALID_ARGUMENT;
 
-	/* Storage backend doesn't support an append operation so we need
-	 * need to read the current variable data, extend it and write it back.
-	 */
+	/* Write just the new data if there's spare capacity to extend the object */
+	if ((delegate_store->storage_support & PSA_STORAGE_SUPPORT_SET_EXTENDED) &&
+		(*capacity >= new_size)) {
+
+		return delegate_store->storage_backend->interface->set_extended(
+			delegate_store->storage_backend->context,
+			client_id,
+			uid,
+			stored_size,
+			data_length,
+			data);
+	}
+
+	/* Otherwise read the current variable data, extend it and write it back */
+	*capacity = 0;
+
 	uint8_t *rw_buf = malloc(new_size);
 	if (!rw_buf) return PSA_ERROR_INSUFFICIENT_MEMORY;
 
 	size_t old_size = 0;
-	psa_status = delegate_store->storage_backend->interface->get(
+	psa_status_t psa_status = delegate_store->storage_backend->interface->get(
 		delegate_store->storage_backend->context,
 		client_id,
 		uid,
@@ -781,7 +1402,7 @@ static psa_status_t store_append_write(
 
 	if (psa_status == PSA_SUCCESS) {
 
-		if ((old_size + data_length) <= new_size) {
+		if (old_size == stored_size) {
 
 			/* Extend the variable data */
 			memcpy(&rw_buf[old_size], data, data_length);
@@ -790,14 +1411,14 @@ static psa_status_t store_append_write(
 				delegate_store->storage_backend->context,
 				client_id,
 				uid,
-				old_size + data_length,
+				new_size,
 				rw_buf,
-				storage_info.flags);
+				PSA_STORAGE_FLAG_NONE);
 		}
 		else {
 
-			/* There's a mismatch between the length obtained from
-			 * get_info() and the subsequent length returned by get().
+			/* There's a mismatch between the cached size and the
+			 * length of the stored data returned by get().
 			 */
 			psa_status = PSA_ERROR_STORAGE_FAILURE;
 		}
@@ -808,17 +1429,79 @@ static psa_status_t store_append_write(
 	return psa_status;
 }
 
+static bool purge_orphan_batch(
+	struct uefi_variable_store *context,
+	size_t num_entries,
+	struct variable_info **batch)
+{
+	bool any_orphans = false;
+	uint64_t uids[SMM_VARIABLE_PURGE_BATCH_SIZE] = { 0 };
+	struct psa_storage_info_t storage_info[SMM_VARIABLE_PURGE_BATCH_SIZE];
+	psa_status_t status[SMM_VARIABLE_PURGE_BATCH_SIZE];
+	struct storage_backend *storage_backend = context->persistent_store.storage_backend;
+
+	for (size_t i = 0; i < num_entries; i++)
+		uids[i] = batch[i]->metadata.uid;
+
+	psa_status_t psa_status = storage_backend->interface->get_info_multi(
+		storage_backend->context,
+		context->owner_id,
+		num_entries,
+		uids,
+		storage_info,
+		status);
+
+	for (size_t i = 0; i < num_entries; i++) {
+
+		struct variable_info *info = batch[i];
+
+		if (psa_status != PSA_SUCCESS) status[i] = psa_status;
+
+		if ((status[i] == PSA_SUCCESS) && storage_info[i].size) {
+
+			/* Refresh the cached size from the stored object */
+			set_variable_data_size(context, info, storage_info[i].size);
+			set_variable_capacity(context, info,
+				(storage_info[i].capacity > storage_info[i].size) ?
+					storage_info[i].capacity : 0);
+		}
+		else {
+
+			/* An empty object is left if power failed before the data of
+			 * a newly created object was written. Remove it so that no
+			 * object exists without an index entry.
+			 */
+			if (status[i] == PSA_SUCCESS)
+				storage_backend->interface->remove(
+					storage_backend->context,
+					context->owner_id,
+					info->metadata.uid);
+
+			/* Detected a mismatch between the index and storage */
+			set_variable_data_size(context, info, 0);
+			set_variable_capacity(context, info, 0);
+			variable_index_clear_variable(&context->variable_index, info);
+			any_orphans = true;
+		}
+	}
+
+	return any_orphans;
+}
+
 static void purge_orphan_index_entries(
 	struct uefi_variable_store *context)
 {
 	bool any_orphans = false;
+	struct variable_info *batch[SMM_VARIABLE_PURGE_BATCH_SIZE];
+	size_t num_entries = 0;
 	struct variable_index_iterator iter;
 	variable_index_iterator_first(&iter, &context->variable_index);
 
 	/* Iterate over variable index looking for any entries for NV
 	 * variables where there is no corresponding object in the
 	 * persistent store. This condition could arise due to
-	 * a power failure before an object is stored.
+	 * a power failure before an object is stored. The stored objects
+	 * are looked up in batches to limit the number of storage calls.
 	 */
 	while (!variable_index_iterator_is_done(&iter)) {
 
@@ -826,26 +1509,20 @@ static void purge_orphan_index_entries(
 
 		if (info->is_variable_set && (info->metadata.attributes & EFI_VARIABLE_NON_VOLATILE)) {
 
-			struct psa_storage_info_t storage_info;
-			struct storage_backend *storage_backend = context->persistent_store.storage_backend;
+			batch[num_entries++] = info;
 
-			psa_status_t psa_status = storage_backend->interface->get_info(
-				storage_backend->context,
-				context->owner_id,
-				info->metadata.uid,
-				&storage_info);
+			if (num_entries == SMM_VARIABLE_PURGE_BATCH_SIZE) {
 
-			if (psa_status != PSA_SUCCESS) {
-
-				/* Detected a mismatch between the index and storage */
-				variable_index_clear_variable(&context->variable_index, info);
-				any_orphans = true;
+				any_orphans |= purge_orphan_batch(context, num_entries, batch);
+				num_entries = 0;
 			}
 		}
 
 		variable_index_iterator_next(&iter);
 	}
 
+	if (num_entries) any_orphans |= purge_orphan_batch(context, num_entries, batch);
+
 	if (any_orphans) sync_variable_index(context);
 }
 
@@ -860,40 +1537,40 @@ static struct delegate_variable_store *select_delegate_store(
 		&context->volatile_store;
 }
 
-static size_t space_used(
-	struct uefi_variable_store *context,
-	uint32_t attributes,
-	struct storage_backend *storage_backend)
+static size_t storage_footprint(
+	const struct variable_info *info)
 {
-	if (!storage_backend) return 0;
-
-	size_t total_used = 0;
-	struct variable_index_iterator iter;
-	variable_index_iterator_first(&iter, &context->variable_index);
-
-	while (!variable_index_iterator_is_done(&iter)) {
-
-		struct variable_info *info = variable_index_iterator_current(&iter);
-
-		if (info->is_variable_set &&
-		    ((info->metadata.attributes & EFI_VARIABLE_NON_VOLATILE) ==
-			 (attributes & EFI_VARIABLE_NON_VOLATILE))) {
-
-			struct psa_storage_info_t storage_info;
+	return (info->capacity > info->data_size) ? info->capacity : info->data_size;
+}
 
-			psa_status_t psa_status = storage_backend->interface->get_info(
-				storage_backend->context,
-				context->owner_id,
-				info->metadata.uid,
-				&storage_info);
+static void set_variable_data_size(
+	struct uefi_variable_store *context,
+	struct variable_info *info,
+	size_t data_size)
+{
+	struct delegate_variable_store *delegate_store = select_delegate_store(
+		context,
+		info->metadata.attributes);
 
-			if (psa_status == PSA_SUCCESS) total_used += storage_info.size;
-		}
+	/* Keep the running total of space used in step with the variable */
+	delegate_store->total_used -= storage_footprint(info);
+	info->data_size = data_size;
+	delegate_store->total_used += storage_footprint(info);
+}
 
-		variable_index_iterator_next(&iter);
-	}
+static void set_variable_capacity(
+	struct uefi_variable_store *context,
+	struct variable_info *info,
+	size_t capacity)
+{
+	struct delegate_variable_store *delegate_store = select_delegate_store(
+		context,
+		info->metadata.attributes);
 
-	return total_used;
+	/* Reserved capacity counts as used space */
+	delegate_store->total_used -= storage_footprint(info);
+	info->capacity = capacity;
+	delegate_store->total_used += storage_footprint(info);
 }
 
 static efi_status_t psa_to_efi_storage_status(
@@ -24,23 +24,46 @@ extern "C" {
  * \brief delegate_variable_store structure definition
  *
  * A delegate_variable_store combines an association with a concrete
- * storage backend and a set of limits parameters.
+ * storage backend and a set of limits parameters. The optional features
+ * supported by the backend are queried once at initialization. The space
+ * used by stored variables, including any capacity reserved for appends,
+ * is kept as a running total.
  */
 struct delegate_variable_store
 {
 	bool is_nv;
+	bool reserve_append_capacity;
+	size_t total_used;
 	size_t total_capacity;
 	size_t max_variable_size;
+	uint32_t storage_support;
 	struct storage_backend *storage_backend;
 };
 
+/**
+ * \brief pending_variable_write structure definition
+ *
+ * Holds the state of an NV variable that has been modified but not yet
+ * written to the persistent store. Only used when write-back is enabled.
+ */
+struct pending_variable_write
+{
+	struct variable_info *info;
+	bool is_removed;
+	size_t data_len;
+	uint8_t *data;
+};
+
 /**
  * \brief uefi_variable_store structure definition
  *
  * A uefi_variable_store provides a variable store using a persistent and a
  * volatile storage backend.  The persistent storage backend may be realized
  * by another trusted service such as the protected storage or internal trusted
- * storage service.
+ * storage service.  Changes to the persistent copy of the variable index are
+ * normally appended to a journal, with the full index only being rewritten
+ * when the journal fills. Optionally, NV variable updates may be held in RAM
+ * and written back to the persistent store in batches.
  */
 struct uefi_variable_store
 {
@@ -48,6 +71,12 @@ struct uefi_variable_store
 	uint32_t owner_id;
 	uint8_t *index_sync_buffer;
 	size_t index_sync_buffer_size;
+	uint8_t *index_journal_buffer;
+	size_t index_journal_buffer_size;
+	size_t index_journal_len;
+	struct pending_variable_write *pending_writes;
+	size_t max_pending_writes;
+	size_t num_pending_writes;
 	struct variable_index variable_index;
 	struct delegate_variable_store persistent_store;
 	struct delegate_variable_store volatile_store;
@@ -78,6 +107,8 @@ efi_status_t uefi_variable_store_init(
 /**
  * @brief      De-initialises a uefi_variable_store
  *
+ * Any pending NV writes that haven't been flushed are discarded.
+ *
  * @param[in]  context uefi_variable_store instance
  */
 void uefi_variable_store_deinit(
@@ -100,6 +131,39 @@ void uefi_variable_store_set_storage_limits(
 	size_t total_capacity,
 	size_t max_variable_size);
 
+/**
+ * @brief      Set NV write-back mode
+ *
+ * By default, each NV SetVariable is written through to the persistent
+ * store before returning. When write-back is enabled, NV updates are held
+ * in RAM and written to the persistent store when max_pending_writes
+ * variables are pending, on ExitBootServices or on an explicit flush.
+ * Pending writes that haven't been flushed are lost on power failure but
+ * each variable always has either its old or new value. Any pending writes
+ * are flushed when the mode is changed.
+ *
+ * @param[in]  context uefi_variable_store instance
+ * @param[in]  max_pending_writes Pending write limit, zero to disable write-back
+ *
+ * @return     EFI_SUCCESS if successful
+ */
+efi_status_t uefi_variable_store_set_write_back(
+	struct uefi_variable_store *context,
+	size_t max_pending_writes);
+
+/**
+ * @brief      Flush pending NV writes
+ *
+ * Writes any NV variable updates held in RAM to the persistent store.
+ * Has no effect if write-back is not enabled.
+ *
+ * @param[in]  context uefi_variable_store instance
+ *
+ * @return     EFI_SUCCESS if successful
+ */
+efi_status_t uefi_variable_store_flush(
+	struct uefi_variable_store *context);
+
 /**
  * @brief      Set variable
  *
@@ -166,7 +230,7 @@ efi_status_t uefi_variable_store_query_variable_info(
  * @brief      Exit boot service
  *
  * Called when the UEFI boot phase is complete.  Used for boot only
- * access control.
+ * access control.  Any pending NV writes are flushed.
  *
  * @param[in]  context uefi_variable_store instance
   *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -38,6 +38,161 @@ static uint64_t name_hash(
 	return hash;
 }
 
+static size_t table_slot(
+	const struct variable_index *context,
+	uint64_t hash)
+{
+	/* Fibonacci hashing to spread the similar djb2 hashes of similar
+	 * names over the table. The table size is always a power of two.
+	 */
+	hash *= UINT64_C(0x9E3779B97F4A7C15);
+
+	return (size_t)(hash >> 32) & (context->table_size - 1);
+}
+
+static uint64_t entry_name_hash(
+	const struct variable_entry *entry)
+{
+	return name_hash(
+		&entry->info.metadata.guid,
+		entry->info.metadata.name_size,
+		entry->info.metadata.name);
+}
+
+static bool is_name_match(
+	const struct variable_entry *entry,
+	const EFI_GUID *guid,
+	size_t name_size,
+	const int16_t *name)
+{
+	const struct variable_metadata *metadata = &entry->info.metadata;
+	size_t stored_len = metadata->name_size / sizeof(int16_t);
+	size_t len = name_size / sizeof(int16_t);
+	size_t i = 0;
+
+	if (memcmp(&metadata->guid, guid, sizeof(EFI_GUID)) != 0)
+		return false;
+
+	/* Names are compared up to and including the first null terminator */
+	for (i = 0; i < len; ++i) {
+
+		if ((i >= stored_len) || (name[i] != metadata->name[i]))
+			return false;
+
+		if (!name[i])
+			return true;
+	}
+
+	return (i == stored_len) || !metadata->name[i];
+}
+
+static bool is_uid_reserved(
+	const struct variable_index *context,
+	uint64_t uid)
+{
+	for (size_t i = 0; i < context->num_reserved_uids; i++) {
+
+		if (context->reserved_uids[i] == uid)
+			return true;
+	}
+
+	return false;
+}
+
+static bool is_uid_in_use(
+	const struct variable_index *context,
+	uint64_t uid)
+{
+	size_t slot = table_slot(context, uid);
+
+	while (context->uid_table[slot]) {
+
+		const struct variable_entry *entry =
+			&context->entries[context->uid_table[slot] - 1];
+
+		if (entry->info.metadata.uid == uid)
+			return true;
+
+		slot = (slot + 1) & (context->table_size - 1);
+	}
+
+	return false;
+}
+
+static void table_insert(
+	const struct variable_index *context,
+	uint32_t *table,
+	uint64_t hash,
+	size_t pos)
+{
+	size_t slot = table_slot(context, hash);
+
+	/* The table is sized to always have free slots so this terminates */
+	while (table[slot])
+		slot = (slot + 1) & (context->table_size - 1);
+
+	table[slot] = (uint32_t)(pos + 1);
+}
+
+static void table_remove(
+	const struct variable_index *context,
+	uint32_t *table,
+	uint64_t hash,
+	size_t pos,
+	uint64_t (*entry_hash)(const struct variable_entry *entry))
+{
+	size_t mask = context->table_size - 1;
+	size_t hole = table_slot(context, hash);
+
+	while (table[hole] && (table[hole] != (uint32_t)(pos + 1)))
+		hole = (hole + 1) & mask;
+
+	if (!table[hole])
+		return;
+
+	/* Backward shift deletion to close the gap in the probe sequence
+	 * without needing tombstones.
+	 */
+	size_t next = (hole + 1) & mask;
+
+	while (table[next]) {
+
+		size_t home = table_slot(context,
+			entry_hash(&context->entries[table[next] - 1]));
+
+		/* Move the entry into the hole if its home slot doesn't lie
+		 * cyclically between the hole and its current slot.
+		 */
+		if (((next - home) & mask) >= ((next - hole) & mask)) {
+
+			table[hole] = table[next];
+			hole = next;
+		}
+
+		next = (next + 1) & mask;
+	}
+
+	table[hole] = 0;
+}
+
+static uint64_t entry_uid(
+	const struct variable_entry *entry)
+{
+	return entry->info.metadata.uid;
+}
+
+static void set_entry_uid(
+	struct variable_index *context,
+	size_t pos,
+	uint64_t uid)
+{
+	struct variable_entry *entry = &context->entries[pos];
+
+	table_remove(context, context->uid_table, entry->info.metadata.uid, pos, entry_uid);
+	entry->info.metadata.uid = uid;
+	table_insert(context, context->uid_table, uid, pos);
+}
+
 static uint64_t generate_uid(
 	const struct variable_index *context,
 	const EFI_GUID *guid,
@@ -46,8 +201,14 @@ static uint64_t generate_uid(
 {
 	uint64_t uid = name_hash(guid, name_size, name);
 
-	/* todo - handle collision  */
-	(void)context;
+	/* A hash collision with a different variable would result in two
+	 * variables sharing the same storage object. Resolve by probing for
+	 * an unused uid, skipping the invalid uid zero and any reserved uids.
+	 * The uid is persisted with the variable metadata so a variable keeps
+	 * its uid, whichever is chosen, across a restore.
+	 */
+	while (!uid || is_uid_reserved(context, uid) || is_uid_in_use(context, uid))
+		++uid;
 
 	return uid;
 }
@@ -58,20 +219,19 @@ static int find_variable(
 	size_t name_size,
 	const int16_t *name)
 {
-	int found_pos = -1;
-	uint64_t uid = name_hash(guid, name_size, name);
+	size_t slot = table_slot(context, name_hash(guid, name_size, name));
 
-	for (size_t pos = 0; pos < context->max_variables; pos++) {
+	while (context->name_table[slot]) {
 
-		if ((context->entries[pos].in_use) &&
-			(uid == context->entries[pos].info.metadata.uid)) {
+		size_t pos = context->name_table[slot] - 1;
 
-			found_pos = pos;
-			break;
-		}
+		if (is_name_match(&context->entries[pos], guid, name_size, name))
+			return (int)pos;
+
+		slot = (slot + 1) & (context->table_size - 1);
 	}
 
-	return found_pos;
+	return -1;
 }
 
 static int find_free(
@@ -79,16 +239,63 @@ static int find_free(
 {
 	int free_pos = -1;
 
-	for (size_t pos = 0; pos < context->max_variables; pos++) {
+	if (context->free_count)
+		free_pos = (int)context->free_stack[context->free_count - 1];
 
-		if (!context->entries[pos].in_use) {
+	return free_pos;
+}
 
-			free_pos = pos;
-			break;
-		}
-	}
+static void link_entry(
+	struct variable_index *context,
+	size_t pos)
+{
+	struct variable_entry *entry = &context->entries[pos];
 
-	return free_pos;
+	/* The entry must be the one at the top of the free stack */
+	--context->free_count;
+
+	table_insert(context, context->name_table, entry_name_hash(entry), pos);
+	table_insert(context, context->uid_table, entry->info.metadata.uid, pos);
+
+	/* Append to the tail of the insertion ordered list */
+	entry->prev = context->tail;
+	entry->next = 0;
+
+	if (context->tail)
+		context->entries[context->tail - 1].next = (uint32_t)(pos + 1);
+	else
+		context->head = (uint32_t)(pos + 1);
+
+	context->tail = (uint32_t)(pos + 1);
+
+	entry->in_use = true;
+}
+
+static void unlink_entry(
+	struct variable_index *context,
+	size_t pos)
+{
+	struct variable_entry *entry = &context->entries[pos];
+
+	table_remove(context, context->name_table, entry_name_hash(entry), pos, entry_name_hash);
+	table_remove(context, context->uid_table, entry->info.metadata.uid, pos, entry_uid);
+
+	if (entry->prev)
+		context->entries[entry->prev - 1].next = entry->next;
+	else
+		context->head = entry->next;
+
+	if (entry->next)
+		context->entries[entry->next - 1].prev = entry->prev;
+	else
+		context->tail = entry->prev;
+
+	entry->prev = 0;
+	entry->next = 0;
+
+	context->free_stack[context->free_count++] = (uint32_t)pos;
+
+	entry->in_use = false;
 }
 
 static void mark_dirty(struct variable_entry *entry)
@@ -109,21 +316,68 @@ efi_status_t variable_index_init(
 	struct variable_index *context,
 	size_t max_variables)
 {
+	/* Size hash tables for a load factor of at most 50% */
+	size_t table_size = 2;
+
+	while (table_size < (max_variables * 2))
+		table_size <<= 1;
+
 	context->max_variables = max_variables;
+	context->table_size = table_size;
+	context->free_count = 0;
+	context->num_reserved_uids = 0;
+
 	context->entries = (struct variable_entry*)
-		malloc(sizeof(struct variable_entry) * max_variables);
+		calloc(max_variables, sizeof(struct variable_entry));
+	context->name_table = (uint32_t*)calloc(table_size, sizeof(uint32_t));
+	context->uid_table = (uint32_t*)calloc(table_size, sizeof(uint32_t));
+	context->free_stack = (uint32_t*)calloc(max_variables, sizeof(uint32_t));
+
+	if (!context->entries || !context->name_table ||
+		!context->uid_table || (max_variables && !context->free_stack)) {
 
-	if (context->entries) {
-		memset(context->entries, 0, sizeof(struct variable_entry) * max_variables);
+		variable_index_deinit(context);
+		return EFI_OUT_OF_RESOURCES;
 	}
 
-	return (context->entries) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+	/* Stack free positions so that the lowest position is used first */
+	for (size_t i = 0; i < max_variables; i++)
+		context->free_stack[i] = (uint32_t)(max_variables - 1 - i);
+
+	context->free_count = max_variables;
+	context->head = 0;
+	context->tail = 0;
+
+	return EFI_SUCCESS;
 }
 
 void variable_index_deinit(
 	struct variable_index *context)
 {
 	free(context->entries);
+	free(context->name_table);
+	free(context->uid_table);
+	free(context->free_stack);
+
+	context->entries = NULL;
+	context->name_table = NULL;
+	context->uid_table = NULL;
+	context->free_stack = NULL;
+	context->free_count = 0;
+	context->head = 0;
+	context->tail = 0;
+}
+
+efi_status_t variable_index_reserve_uid(
+	struct variable_index *context,
+	uint64_t uid)
+{
+	if (context->num_reserved_uids >= VARIABLE_INDEX_MAX_RESERVED_UIDS)
+		return EFI_OUT_OF_RESOURCES;
+
+	context->reserved_uids[context->num_reserved_uids++] = uid;
+
+	return EFI_SUCCESS;
 }
 
 size_t variable_index_max_dump_size(
@@ -149,6 +403,24 @@ struct variable_info *variable_index_find(
 	return result;
 }
 
+static struct variable_info *find_set_from(
+	const struct variable_index *context,
+	uint32_t link)
+{
+	/* Follow the list from the given link to the first set variable */
+	while (link) {
+
+		struct variable_entry *entry = &context->entries[link - 1];
+
+		if (entry->info.is_variable_set)
+			return &entry->info;
+
+		link = entry->next;
+	}
+
+	return NULL;
+}
+
 struct variable_info *variable_index_find_next(
 	const struct variable_index *context,
 	const EFI_GUID *guid,
@@ -173,19 +445,7 @@ struct variable_info *variable_index_find_next(
 			if (pos >= 0) {
 
 				/* Iterate to next used entry */
-				++pos;
-				while (pos < (int)context->max_variables) {
-
-					if (context->entries[pos].in_use &&
-						context->entries[pos].info.is_variable_set) {
-
-						result = &context->entries[pos].info;
-						*status = EFI_SUCCESS;
-						break;
-					}
-
-					++pos;
-				}
+				result = find_set_from(context, context->entries[pos].next);
 			}
 			else {
 
@@ -196,21 +456,11 @@ struct variable_info *variable_index_find_next(
 		else {
 
 			/* Find first */
-			int pos = 0;
-
-			while (pos < (int)context->max_variables) {
-
-				if (context->entries[pos].in_use &&
-					context->entries[pos].info.is_variable_set) {
-
-					result = &context->entries[pos].info;
-					*status = EFI_SUCCESS;
-					break;
-				}
-
-				++pos;
-			}
+			result = find_set_from(context, context->head);
 		}
+
+		if (result)
+			*status = EFI_SUCCESS;
 	}
 
 	return result;
@@ -262,10 +512,12 @@ static struct variable_entry *add_entry(
 			info->metadata.attributes = 0;
 			set_variable_name(info, name_size, name);
 
+			info->data_size = 0;
+			info->capacity = 0;
 			info->is_constraints_set = false;
 			info->is_variable_set = false;
 
-			entry->in_use = true;
+			link_entry(context, pos);
 		}
 	}
 
@@ -293,14 +545,12 @@ void variable_index_remove_unused_entry(
 	struct variable_index *context,
 	struct variable_info *info)
 {
-	(void)context;
-
 	if (info &&
 		!info->is_constraints_set &&
 		!info->is_variable_set) {
 
 		struct variable_entry *entry = containing_entry(info);
-		entry->in_use = false;
+		unlink_entry(context, entry - context->entries);
 
 		memset(info, 0, sizeof(struct variable_info));
 	}
@@ -355,9 +605,12 @@ bool variable_index_dump(
 	uint8_t *dump_pos = buffer;
 	size_t bytes_dumped = 0;
 
-	for (size_t pos = 0; pos < context->max_variables; pos++) {
+	/* Dump in insertion order so that enumeration order is preserved
+	 * over a restore.
+	 */
+	for (uint32_t link = context->head; link; link = context->entries[link - 1].next) {
 
-		struct variable_entry *entry = &context->entries[pos];
+		struct variable_entry *entry = &context->entries[link - 1];
 		struct variable_metadata *metadata = &entry->info.metadata;
 
 		if (entry->in_use &&
@@ -380,30 +633,42 @@ bool variable_index_dump(
 }
 
 size_t variable_index_restore(
-	const struct variable_index *context,
+	struct variable_index *context,
 	size_t data_len,
 	const uint8_t *buffer)
 {
 	size_t bytes_loaded = 0;
 	const uint8_t *load_pos = buffer;
-	int pos = 0;
 
 	while (bytes_loaded < data_len) {
 
 		if ((data_len - bytes_loaded) >= sizeof(struct variable_metadata)) {
 
+			int pos = find_free(context);
+
+			/* Restored more variables than the index can hold */
+			if (pos < 0)
+				break;
+
 			struct variable_entry *entry = &context->entries[pos];
 			struct variable_metadata *metadata = &entry->info.metadata;
 
 			memcpy(metadata, load_pos, sizeof(struct variable_metadata));
 
-			entry->info.is_variable_set = true;
-			entry->in_use = true;
-
 			bytes_loaded += sizeof(struct variable_metadata);
 			load_pos += sizeof(struct variable_metadata);
 
-			++pos;
+			/* Skip any record with a corrupt name size */
+			if (metadata->name_size > sizeof(metadata->name)) {
+
+				memset(metadata, 0, sizeof(struct variable_metadata));
+				continue;
+			}
+
+			entry->info.data_size = 0;
+			entry->info.capacity = 0;
+			entry->info.is_variable_set = true;
+			link_entry(context, pos);
 		}
 		else {
 
@@ -414,3 +679,108 @@ size_t variable_index_restore(
 
 	return bytes_loaded;
 }
+
+bool variable_index_dump_dirty(
+	struct variable_index *context,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len)
+{
+	size_t required_len = 0;
+	struct variable_index_record *record = (struct variable_index_record*)buffer;
+
+	*data_len = 0;
+
+	for (uint32_t link = context->head; link; link = context->entries[link - 1].next) {
+
+		if (context->entries[link - 1].dirty)
+			required_len += sizeof(struct variable_index_record);
+	}
+
+	if (!required_len)
+		return false;
+
+	/* Leave entries dirty if the records won't all fit */
+	if (required_len > buffer_size)
+		return true;
+
+	for (uint32_t link = context->head; link; link = context->entries[link - 1].next) {
+
+		struct variable_entry *entry = &context->entries[link - 1];
+
+		if (entry->dirty) {
+
+			struct variable_index_record rec;
+
+			memset(&rec, 0, sizeof(rec));
+			rec.metadata = entry->info.metadata;
+			rec.is_variable_set = entry->info.is_variable_set;
+
+			memcpy(record, &rec, sizeof(rec));
+			++record;
+
+			entry->dirty = false;
+		}
+	}
+
+	*data_len = required_len;
+
+	return true;
+}
+
+size_t variable_index_replay(
+	struct variable_index *context,
+	size_t data_len,
+	const uint8_t *buffer)
+{
+	size_t bytes_loaded = 0;
+
+	while ((data_len - bytes_loaded) >= sizeof(struct variable_index_record)) {
+
+		struct variable_index_record rec;
+		const struct variable_metadata *metadata = &rec.metadata;
+
+		memcpy(&rec, &buffer[bytes_loaded], sizeof(rec));
+		bytes_loaded += sizeof(rec);
+
+		/* Skip any record with a corrupt name size */
+		if (metadata->name_size > sizeof(metadata->name))
+			continue;
+
+		int pos = find_variable(context, &metadata->guid, metadata->name_size, metadata->name);
+
+		if (rec.is_variable_set) {
+
+			if (pos < 0) {
+
+				struct variable_entry *entry = add_entry(
+					context,
+					&metadata->guid,
+					metadata->name_size,
+					metadata->name);
+
+				/* Replayed more variables than the index can hold */
+				if (!entry)
+					break;
+
+				pos = entry - context->entries;
+			}
+
+			/* Keep the recorded uid, which may have been collision adjusted */
+			if (context->entries[pos].info.metadata.uid != metadata->uid)
+				set_entry_uid(context, pos, metadata->uid);
+
+			context->entries[pos].info.metadata.attributes = metadata->attributes;
+			context->entries[pos].info.is_variable_set = true;
+		}
+		else if (pos >= 0) {
+
+			struct variable_info *info = &context->entries[pos].info;
+
+			info->is_variable_set = false;
+			variable_index_remove_unused_entry(context, info);
+		}
+	}
+
+	return bytes_loaded;
+}
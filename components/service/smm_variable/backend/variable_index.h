@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -23,6 +23,7 @@ extern "C" {
  * Implementation limits
  */
 #define VARIABLE_INDEX_MAX_NAME_SIZE		(32)
+#define VARIABLE_INDEX_MAX_RESERVED_UIDS	(4)
 
 /**
  * \brief variable_metadata structure definition
@@ -41,21 +42,42 @@ struct variable_metadata
 /**
  * \brief variable_info structure definition
  *
- * Holds information about a stored variable.
+ * Holds information about a stored variable. The data size is a cached
+ * copy of the size of the stored variable data and the capacity is any
+ * larger storage capacity reserved for the data. They are maintained by
+ * the owner of the index and are not part of the persistent index.
  */
 struct variable_info
 {
 	struct variable_metadata metadata;
 	struct variable_constraints check_constraints;
 
+	size_t data_size;
+	size_t capacity;
+
 	bool is_variable_set;
 	bool is_constraints_set;
 };
 
+/**
+ * \brief variable_index_record structure definition
+ *
+ * Records the state of a single NV variable. Used for journaling
+ * incremental changes to the persistent copy of the index.
+ */
+struct variable_index_record
+{
+	struct variable_metadata metadata;
+	uint32_t is_variable_set;
+	uint32_t reserved;
+};
+
 /**
  * \brief An entry in the index
  *
- * Represents a store variable in the variable index.
+ * Represents a store variable in the variable index. In-use entries are
+ * linked in insertion order to allow the index to be enumerated without
+ * searching. Links hold an entry position + 1, with zero meaning none.
  */
 struct variable_entry
 {
@@ -63,18 +85,37 @@ struct variable_entry
 
 	bool	in_use;
 	bool	dirty;
+
+	uint32_t prev;
+	uint32_t next;
 };
 
 /**
  * \brief variable_index structure definition
  *
  * Provides an index of stored variables to allow the uefi variable store
- * contents to be enumerated.
+ * contents to be enumerated. Entries are held in a fixed array and are
+ * located via two open-addressed hash tables, one keyed on the variable's
+ * (guid, name) and one keyed on the variable's storage uid. Table slots
+ * hold an entry position + 1, with zero indicating an empty slot.
  */
 struct variable_index
 {
 	size_t max_variables;
 	struct variable_entry *entries;
+
+	size_t table_size;
+	uint32_t *name_table;
+	uint32_t *uid_table;
+
+	size_t free_count;
+	uint32_t *free_stack;
+
+	uint32_t head;
+	uint32_t tail;
+
+	size_t num_reserved_uids;
+	uint64_t reserved_uids[VARIABLE_INDEX_MAX_RESERVED_UIDS];
 };
 
 /**
@@ -97,6 +138,22 @@ efi_status_t variable_index_init(
 void variable_index_deinit(
 	struct variable_index *context);
 
+/**
+ * @brief      Reserve a storage uid
+ *
+ * Prevents the uid from being given to a variable. Used for storage
+ * objects that don't hold variable data, such as the persistent copy
+ * of the index.
+ *
+ * @param[in]  context variable_index
+ * @param[in]  uid The uid to reserve
+ *
+ * @return     EFI_SUCCESS or EFI_OUT_OF_RESOURCES if no more uids may be reserved
+ */
+efi_status_t variable_index_reserve_uid(
+	struct variable_index *context,
+	uint64_t uid);
+
 /**
  * @brief      Returns the maximum dump size
  *
@@ -225,6 +282,27 @@ bool variable_index_dump(
 	uint8_t *buffer,
 	size_t *data_len);
 
+/**
+ * @brief      Dump records for dirty entries only
+ *
+ * Serializes a variable_index_record for each entry that has changed
+ * since the last dump. Dirty flags are only cleared if records for all
+ * dirty entries fit in the buffer. If they don't, data_len is set to
+ * zero and a full dump is needed to bring the persistent copy up to date.
+ *
+ * @param[in]  context variable_index
+ * @param[in]  buffer_size Size of destination buffer
+ * @param[in]  buffer Dump to this buffer
+ * @param[out] data_len Length of serialized data
+ *
+ * @return     True if there is unsaved data
+ */
+bool variable_index_dump_dirty(
+	struct variable_index *context,
+	size_t buffer_size,
+	uint8_t *buffer,
+	size_t *data_len);
+
 /**
  * @brief      Restore the serialized index contents
  *
@@ -238,7 +316,25 @@ bool variable_index_dump(
  * @return     Number of bytes loaded
  */
 size_t variable_index_restore(
-	const struct variable_index *context,
+	struct variable_index *context,
+	size_t data_len,
+	const uint8_t *buffer);
+
+/**
+ * @brief      Replay dumped records
+ *
+ * Applies records produced by variable_index_dump_dirty() in order. Should be
+ * called after the index has been restored from a full dump. Replaying a
+ * record whose change is already reflected in the index has no effect.
+ *
+ * @param[in]  context variable_index
+ * @param[in]  data_len The length of the record data
+ * @param[in]  buffer Load from this buffer
+ *
+ * @return     Number of bytes replayed
+ */
+size_t variable_index_replay(
+	struct variable_index *context,
 	size_t data_len,
 	const uint8_t *buffer);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -13,16 +13,9 @@ void variable_index_iterator_first(
 	const struct variable_index *variable_index)
 {
 	iter->variable_index = variable_index;
-	iter->current_pos = variable_index->max_variables;
-
-	for (size_t pos = 0; pos < variable_index->max_variables; pos++) {
-
-		if (variable_index->entries[pos].in_use) {
-
-			iter->current_pos = pos;
-			break;
-		}
-	}
+	iter->current_pos = (variable_index->head) ?
+		variable_index->head - 1 :
+		variable_index->max_variables;
 }
 
 bool variable_index_iterator_is_done(
@@ -48,15 +41,10 @@ void variable_index_iterator_next(
 	struct variable_index_iterator *iter)
 {
 	if (iter->current_pos < iter->variable_index->max_variables) {
-		size_t next_pos = iter->current_pos + 1;
-
-		while (next_pos < iter->variable_index->max_variables) {
-			if (iter->variable_index->entries[next_pos].in_use)
-				break;
-
-			++next_pos;
-		}
+		uint32_t next = iter->variable_index->entries[iter->current_pos].next;
 
-		iter->current_pos = next_pos;
+		iter->current_pos = (next) ?
+			next - 1 :
+			iter->variable_index->max_variables;
 	}
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, Arm Limited. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -19,7 +19,7 @@ extern "C" {
  * \brief An iterator for accessing variable_info
  *
  * Used for iterating over in-use entries held by the associated
- * variable_index.
+ * variable_index. Entries are visited in insertion order.
  */
 struct variable_index_iterator
 {
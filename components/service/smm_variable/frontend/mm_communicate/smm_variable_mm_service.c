@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: BSD-3-Clause
 /*
- * Copyright (c) 2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  */
 
 #include "protocols/common/mm/mm_smc.h"
@@ -89,6 +89,7 @@ struct mm_service_interface *smm_variable_mm_service_init(struct smm_variable_mm
 	service->iface = iface;
 	service->mm_service.context = service;
 	service->mm_service.receive = smm_var_receive;
+	service->mm_service.min_req_length = SMM_VARIABLE_COMMUNICATE_HEADER_SIZE;
 
 	return &service->mm_service;
 }
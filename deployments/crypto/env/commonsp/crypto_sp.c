@@ -7,8 +7,10 @@
 #include "components/rpc/ts_rpc/endpoint/sp/ts_rpc_endpoint_sp.h"
 #include "service/secure_storage/factory/storage_factory.h"
 #include "service/crypto/factory/crypto_provider_factory.h"
+#include "service/crypto/provider/crypto_context_pool.h"
 #include "service/crypto/backend/mbedcrypto/mbedcrypto_backend.h"
 #include "protocols/rpc/common/packed-c/status.h"
+#include "config/interface/config_store.h"
 #include "config/ramstore/config_ramstore.h"
 #include "config/loader/sp/sp_config_loader.h"
 #include "sp_api.h"
@@ -18,6 +20,7 @@
 #include "trace.h"
 
 static bool sp_init(uint16_t *own_sp_id);
+static void configure_crypto_context_pools(void);
 
 void __noreturn sp_main(union ffa_boot_info *boot_info)
 {
@@ -47,6 +50,8 @@ void __noreturn sp_main(union ffa_boot_info *boot_info)
 		goto fatal_error;
 	}
 
+	configure_crypto_context_pools();
+
 	/* Create a storage backend for persistent key storage - prefer ITS */
 	storage_backend = storage_factory_create(storage_factory_security_class_INTERNAL_TRUSTED);
 	if (!storage_backend) {
@@ -156,3 +161,17 @@ static bool sp_init(uint16_t *own_id)
 
 	return true;
 }
+
+static void configure_crypto_context_pools(void)
+{
+	uint32_t pool_size = CRYPTO_CONTEXT_POOL_SIZE;
+	uint32_t client_quota = CRYPTO_CONTEXT_POOL_CLIENT_QUOTA;
+
+	/* The build-time defaults are kept if the SP manifest doesn't set the parameters */
+	config_store_query(CONFIG_CLASSIFIER_PARAMETER, "crypto-context-pool-size", 0,
+			   &pool_size, sizeof(pool_size));
+	config_store_query(CONFIG_CLASSIFIER_PARAMETER, "crypto-context-client-quota", 0,
+			   &client_quota, sizeof(client_quota));
+
+	crypto_context_pool_set_defaults(pool_size, client_quota);
+}
@@ -23,6 +23,11 @@
 #define SMM_GATEWAY_MAX_UEFI_VARIABLES		(40)
 #endif
 
+/* Default to writing NV variable updates through to the NV store */
+#ifndef SMM_GATEWAY_NV_MAX_PENDING_VARIABLES
+#define SMM_GATEWAY_NV_MAX_PENDING_VARIABLES	(0)
+#endif
+
 /* The smm_gateway instance - it's a singleton */
 static struct smm_gateway
 {
@@ -73,5 +78,14 @@ struct rpc_service_interface *smm_gateway_create(uint32_t owner_id)
 		persistent_backend,
 		volatile_backend);
 
+	/* Optionally batch NV updates made during boot */
+	if (service_iface && SMM_GATEWAY_NV_MAX_PENDING_VARIABLES) {
+
+		if (uefi_variable_store_set_write_back(
+				&smm_gateway_instance.smm_variable_provider.variable_store,
+				SMM_GATEWAY_NV_MAX_PENDING_VARIABLES) != EFI_SUCCESS)
+			return NULL;
+	}
+
 	return service_iface;
 }
@@ -112,6 +112,14 @@ struct __attribute__ ((__packed__)) ts_block_storage_write_out
 	uint64_t num_written;
 };
 
+/****************************************
+ * \brief read_blocks and write_blocks operations
+ *
+ * As read and write but the data may span the blocks that follow the block
+ * identified by the specified LBA. Fewer bytes than requested may be transferred.
+ * Use the read and write messages.
+ */
+
 /****************************************
  * \brief erase operation
  *
@@ -126,4 +134,34 @@ struct __attribute__ ((__packed__)) ts_block_storage_erase_in
 	uint32_t num_blocks;
 };
 
+/****************************************
+ * \brief read_vec and write_vec operations
+ *
+ * Read or write a list of ranges. Each range starts at an offset into the block
+ * identified by the range LBA and may span the blocks that follow it. Data for
+ * each range is packed in range order. The operation stops at the first range
+ * that can't be transferred in full.
+ */
+
+/* Mandatory fixed sized input parameters */
+struct __attribute__ ((__packed__)) ts_block_storage_vec_in
+{
+	uint64_t handle;
+	uint32_t num_ranges;
+};
+
+/* Range descriptor. num_ranges of these follow the fixed size input message */
+struct __attribute__ ((__packed__)) ts_block_storage_range
+{
+	uint64_t lba;
+	uint32_t offset;
+	uint32_t len;
+};
+
+/* For read_vec, read data is returned in response */
+
+/* For write_vec, write data follows the range descriptors. The response uses
+ * the ts_block_storage_write_out message.
+ */
+
 #endif /* TS_BLOCK_STORAGE_PACKEDC_MESSAGES_H */
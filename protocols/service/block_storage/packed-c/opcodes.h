@@ -18,5 +18,9 @@
 #define TS_BLOCK_STORAGE_OPCODE_READ                 (TS_BLOCK_STORAGE_OPCODE_BASE + 4)
 #define TS_BLOCK_STORAGE_OPCODE_WRITE                (TS_BLOCK_STORAGE_OPCODE_BASE + 5)
 #define TS_BLOCK_STORAGE_OPCODE_ERASE                (TS_BLOCK_STORAGE_OPCODE_BASE + 6)
+#define TS_BLOCK_STORAGE_OPCODE_READ_BLOCKS          (TS_BLOCK_STORAGE_OPCODE_BASE + 7)
+#define TS_BLOCK_STORAGE_OPCODE_WRITE_BLOCKS         (TS_BLOCK_STORAGE_OPCODE_BASE + 8)
+#define TS_BLOCK_STORAGE_OPCODE_READ_VEC             (TS_BLOCK_STORAGE_OPCODE_BASE + 9)
+#define TS_BLOCK_STORAGE_OPCODE_WRITE_VEC            (TS_BLOCK_STORAGE_OPCODE_BASE + 10)
 
 #endif /* TS_BLOCK_STORAGE_OPCODES_H */
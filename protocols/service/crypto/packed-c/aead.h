@@ -161,5 +161,33 @@ struct __attribute__ ((__packed__)) ts_crypto_aead_abort_in
   uint32_t op_handle;
 };
 
+/****************************************
+ * aead_encrypt/aead_decrypt operation definition
+ *
+ * One-shot authenticated encryption or decryption of the complete
+ * input carried in a single request. The tag is appended to the
+ * ciphertext.
+ */
+
+/* Mandatory fixed sized input parameters */
+struct __attribute__ ((__packed__)) ts_crypto_aead_crypt_in
+{
+  uint32_t key_id;
+  uint32_t alg;
+};
+
+/* Variable length input parameter tags */
+enum
+{
+    TS_CRYPTO_AEAD_CRYPT_IN_TAG_NONCE  = 1,
+    TS_CRYPTO_AEAD_CRYPT_IN_TAG_ADDITIONAL_DATA  = 2,
+    TS_CRYPTO_AEAD_CRYPT_IN_TAG_DATA  = 3
+};
+
+/* Variable length output parameter tags */
+enum
+{
+    TS_CRYPTO_AEAD_CRYPT_OUT_TAG_DATA  = 1
+};
 
 #endif /* TS_CRYPTO_AEAD_H */
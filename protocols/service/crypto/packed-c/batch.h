@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TS_CRYPTO_BATCH_H
+#define TS_CRYPTO_BATCH_H
+
+#include <stdint.h>
+
+/*
+ * A batch request is a sequence of items that fills the request. Each item
+ * starts with this header which is followed by the packed-c request
+ * parameters of the item's operation.
+ */
+struct __attribute__ ((__packed__)) ts_crypto_batch_item_in
+{
+  uint32_t opcode;
+  uint32_t length;
+};
+
+/*
+ * The batch response holds one item per executed request item, in request
+ * order. Each item starts with this header which is followed by the packed-c
+ * response parameters of the item's operation. Items that didn't fit into
+ * the response buffer are not executed and have no response item.
+ */
+struct __attribute__ ((__packed__)) ts_crypto_batch_item_out
+{
+  int32_t rpc_status;
+  int32_t service_status;
+  uint32_t length;
+};
+
+#endif /* TS_CRYPTO_BATCH_H */
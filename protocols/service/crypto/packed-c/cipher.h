@@ -110,4 +110,30 @@ struct __attribute__ ((__packed__)) ts_crypto_cipher_abort_in
   uint32_t op_handle;
 };
 
+/****************************************
+ * cipher_encrypt/cipher_decrypt operation definition
+ *
+ * One-shot encryption or decryption of the complete input carried
+ * in a single request. The IV is prepended to the ciphertext.
+ */
+
+/* Mandatory fixed sized input parameters */
+struct __attribute__ ((__packed__)) ts_crypto_cipher_crypt_in
+{
+  uint32_t key_id;
+  uint32_t alg;
+};
+
+/* Variable length input parameter tags */
+enum
+{
+    TS_CRYPTO_CIPHER_CRYPT_IN_TAG_DATA  = 1
+};
+
+/* Variable length output parameter tags */
+enum
+{
+    TS_CRYPTO_CIPHER_CRYPT_OUT_TAG_DATA  = 1
+};
+
 #endif /* TS_CRYPTO_CIPHER_H */
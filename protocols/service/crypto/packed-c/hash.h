@@ -103,4 +103,28 @@ struct __attribute__ ((__packed__)) ts_crypto_hash_clone_out
   uint32_t target_op_handle;
 };
 
+/****************************************
+ * hash_compute operation definition
+ *
+ * One-shot hash of the complete input carried in a single request.
+ */
+
+/* Mandatory fixed sized input parameters */
+struct __attribute__ ((__packed__)) ts_crypto_hash_compute_in
+{
+  uint32_t alg;
+};
+
+/* Variable length input parameter tags */
+enum
+{
+    TS_CRYPTO_HASH_COMPUTE_IN_TAG_DATA  = 1
+};
+
+/* Variable length output parameter tags */
+enum
+{
+    TS_CRYPTO_HASH_COMPUTE_OUT_TAG_HASH  = 1
+};
+
 #endif /* TS_CRYPTO_HASH_H */
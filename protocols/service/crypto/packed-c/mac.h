@@ -88,4 +88,29 @@ struct __attribute__ ((__packed__)) ts_crypto_mac_abort_in
   uint32_t op_handle;
 };
 
+/****************************************
+ * mac_compute operation definition
+ *
+ * One-shot MAC of the complete input carried in a single request.
+ */
+
+/* Mandatory fixed sized input parameters */
+struct __attribute__ ((__packed__)) ts_crypto_mac_compute_in
+{
+  uint32_t key_id;
+  uint32_t alg;
+};
+
+/* Variable length input parameter tags */
+enum
+{
+    TS_CRYPTO_MAC_COMPUTE_IN_TAG_DATA  = 1
+};
+
+/* Variable length output parameter tags */
+enum
+{
+    TS_CRYPTO_MAC_COMPUTE_OUT_TAG_MAC  = 1
+};
+
 #endif /* TS_CRYPTO_MAC_H */
@@ -27,6 +27,7 @@
 #define TS_CRYPTO_OPCODE_GET_KEY_ATTRIBUTES     (TS_CRYPTO_OPCODE_BASE + 15)
 #define TS_CRYPTO_OPCODE_SIGN_MESSAGE           (TS_CRYPTO_OPCODE_BASE + 16)
 #define TS_CRYPTO_OPCODE_VERIFY_MESSAGE         (TS_CRYPTO_OPCODE_BASE + 17)
+#define TS_CRYPTO_OPCODE_BATCH                  (TS_CRYPTO_OPCODE_BASE + 18)
 
 /* Hash operations */
 #define TS_CRYPTO_OPCODE_HASH_BASE              (0x0200)
@@ -36,6 +37,7 @@
 #define TS_CRYPTO_OPCODE_HASH_ABORT             (TS_CRYPTO_OPCODE_HASH_BASE + 4)
 #define TS_CRYPTO_OPCODE_HASH_VERIFY            (TS_CRYPTO_OPCODE_HASH_BASE + 5)
 #define TS_CRYPTO_OPCODE_HASH_CLONE             (TS_CRYPTO_OPCODE_HASH_BASE + 6)
+#define TS_CRYPTO_OPCODE_HASH_COMPUTE           (TS_CRYPTO_OPCODE_HASH_BASE + 7)
 
 /* Cipher operations */
 #define TS_CRYPTO_OPCODE_CIPHER_BASE            (0x0300)
@@ -46,6 +48,8 @@
 #define TS_CRYPTO_OPCODE_CIPHER_UPDATE          (TS_CRYPTO_OPCODE_CIPHER_BASE + 5)
 #define TS_CRYPTO_OPCODE_CIPHER_FINISH          (TS_CRYPTO_OPCODE_CIPHER_BASE + 6)
 #define TS_CRYPTO_OPCODE_CIPHER_ABORT           (TS_CRYPTO_OPCODE_CIPHER_BASE + 7)
+#define TS_CRYPTO_OPCODE_CIPHER_ENCRYPT         (TS_CRYPTO_OPCODE_CIPHER_BASE + 8)
+#define TS_CRYPTO_OPCODE_CIPHER_DECRYPT         (TS_CRYPTO_OPCODE_CIPHER_BASE + 9)
 
 /* Key derivation operations */
 #define TS_CRYPTO_OPCODE_KEY_DERIVATION_BASE                (0x0400)
@@ -68,6 +72,7 @@
 #define TS_CRYPTO_OPCODE_MAC_SIGN_FINISH        (TS_CRYPTO_OPCODE_MAC_BASE + 4)
 #define TS_CRYPTO_OPCODE_MAC_VERIFY_FINISH      (TS_CRYPTO_OPCODE_MAC_BASE + 5)
 #define TS_CRYPTO_OPCODE_MAC_ABORT              (TS_CRYPTO_OPCODE_MAC_BASE + 6)
+#define TS_CRYPTO_OPCODE_MAC_COMPUTE            (TS_CRYPTO_OPCODE_MAC_BASE + 7)
 
 /* AEAD operations */
 #define TS_CRYPTO_OPCODE_AEAD_BASE              (0x0600)
@@ -81,5 +86,7 @@
 #define TS_CRYPTO_OPCODE_AEAD_FINISH            (TS_CRYPTO_OPCODE_AEAD_BASE + 8)
 #define TS_CRYPTO_OPCODE_AEAD_VERIFY            (TS_CRYPTO_OPCODE_AEAD_BASE + 9)
 #define TS_CRYPTO_OPCODE_AEAD_ABORT             (TS_CRYPTO_OPCODE_AEAD_BASE + 10)
+#define TS_CRYPTO_OPCODE_AEAD_ENCRYPT           (TS_CRYPTO_OPCODE_AEAD_BASE + 11)
+#define TS_CRYPTO_OPCODE_AEAD_DECRYPT           (TS_CRYPTO_OPCODE_AEAD_BASE + 12)
 
 #endif /* TS_CRYPTO_OPCODES_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -60,6 +60,21 @@ struct __attribute__ ((__packed__)) secure_storage_response_get_support {
 	uint32_t support;
 };
 
+/* Operation GET_INFO_MULTI request and response parameters. The response
+ * holds one secure_storage_response_get_info_multi per requested uid.
+ */
+struct __attribute__ ((__packed__)) secure_storage_request_get_info_multi {
+	uint32_t num_uids;
+	uint64_t uids[];
+};
+
+struct __attribute__ ((__packed__)) secure_storage_response_get_info_multi {
+	int32_t status;
+	uint64_t capacity;
+	uint64_t size;
+	uint32_t flags;
+};
+
 #define TS_SECURE_STORAGE_OPCODE_BASE			(0x100u)
 
 #define TS_SECURE_STORAGE_OPCODE_SET			(TS_SECURE_STORAGE_OPCODE_BASE + 0u)
@@ -69,6 +84,7 @@ struct __attribute__ ((__packed__)) secure_storage_response_get_support {
 #define TS_SECURE_STORAGE_OPCODE_CREATE			(TS_SECURE_STORAGE_OPCODE_BASE + 4u)
 #define TS_SECURE_STORAGE_OPCODE_SET_EXTENDED	(TS_SECURE_STORAGE_OPCODE_BASE + 5u)
 #define TS_SECURE_STORAGE_OPCODE_GET_SUPPORT	(TS_SECURE_STORAGE_OPCODE_BASE + 6u)
+#define TS_SECURE_STORAGE_OPCODE_GET_INFO_MULTI	(TS_SECURE_STORAGE_OPCODE_BASE + 7u)
 
 #define TS_SECURE_STORAGE_FLAG_NONE			(0u)
 #define TS_SECURE_STORAGE_FLAG_WRITE_ONCE		(1u << 0)